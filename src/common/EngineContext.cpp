@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "EngineContext.h"
+#include "audio/LoopbackOutput.h"
+#include "plugin/Host.h"
+
+namespace love
+{
+
+love::Type EngineContext::type("EngineContext", &Object::type);
+
+static thread_local EngineContext *currentContext = nullptr;
+
+EngineContext::EngineContext()
+	: instances()
+	, L(nullptr)
+	, parentWindow(nullptr)
+	, loopbackOutput(nullptr)
+	, host(nullptr)
+	, audioBackend("openal")
+{
+}
+
+EngineContext::~EngineContext()
+{
+	if (loopbackOutput)
+		loopbackOutput->release();
+	if (host)
+		host->release();
+}
+
+EngineContext *EngineContext::getCurrent()
+{
+	return currentContext != nullptr ? currentContext : getDefault();
+}
+
+EngineContext *EngineContext::getDefault()
+{
+	// Never freed: some modules are static globals which are destroyed after
+	// any function-local static would be.
+	static EngineContext *defaultContext = new EngineContext();
+	return defaultContext;
+}
+
+void EngineContext::setCurrent(EngineContext *context)
+{
+	currentContext = context;
+}
+
+EngineContext::Scope::Scope(EngineContext *context)
+	: previous(currentContext)
+{
+	currentContext = context;
+}
+
+EngineContext::Scope::~Scope()
+{
+	currentContext = previous;
+}
+
+void EngineContext::setLuaState(lua_State *L)
+{
+	this->L = L;
+}
+
+lua_State *EngineContext::getLuaState() const
+{
+	return L;
+}
+
+void EngineContext::setParentWindow(void *handle)
+{
+	parentWindow = handle;
+}
+
+void *EngineContext::getParentWindow() const
+{
+	return parentWindow;
+}
+
+void EngineContext::setLoopbackOutput(audio::LoopbackOutput *output)
+{
+	if (output)
+		output->retain();
+	if (loopbackOutput)
+		loopbackOutput->release();
+	loopbackOutput = output;
+}
+
+audio::LoopbackOutput *EngineContext::getLoopbackOutput() const
+{
+	return loopbackOutput;
+}
+
+void EngineContext::setHost(plugin::Host *host)
+{
+	if (host)
+		host->retain();
+	if (this->host)
+		this->host->release();
+	this->host = host;
+}
+
+plugin::Host *EngineContext::getHost() const
+{
+	return host;
+}
+
+void EngineContext::setAudioBackend(const std::string &name)
+{
+	audioBackend = name;
+}
+
+const std::string &EngineContext::getAudioBackend() const
+{
+	return audioBackend;
+}
+
+} // love
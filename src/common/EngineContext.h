@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_ENGINE_CONTEXT_H
+#define LOVE_ENGINE_CONTEXT_H
+
+// LOVE
+#include "Module.h"
+#include "Object.h"
+
+// C++
+#include <map>
+#include <string>
+
+struct lua_State;
+
+namespace love
+{
+
+namespace audio
+{
+class LoopbackOutput;
+}
+
+namespace plugin
+{
+class Host;
+}
+
+/**
+ * Everything which is global to one running instance of LOVE: the registry
+ * of loaded modules (and through it the window, graphics and audio pool),
+ * the main Lua state and resources provided by an embedding host. Several
+ * contexts can live in the same process, e.g. one per plugin instance, each
+ * driven from its own thread.
+ *
+ * Every thread has a current context. Threads started through
+ * love::thread::Threadable inherit the context of the thread which created
+ * them, and threads which never bind one use the process-wide default.
+ **/
+class EngineContext : public Object
+{
+public:
+
+	static love::Type type;
+
+	EngineContext();
+	virtual ~EngineContext();
+
+	/**
+	 * Gets the context bound to the calling thread, or the default context
+	 * if none is bound.
+	 **/
+	static EngineContext *getCurrent();
+
+	/**
+	 * Gets the process-wide context used by threads without a bound one.
+	 **/
+	static EngineContext *getDefault();
+
+	/**
+	 * Binds a context to the calling thread. Passing null reverts the thread
+	 * to the default context.
+	 **/
+	static void setCurrent(EngineContext *context);
+
+	/**
+	 * Binds a context to the calling thread for the lifetime of the Scope.
+	 **/
+	class Scope
+	{
+	public:
+
+		Scope(EngineContext *context);
+		~Scope();
+
+	private:
+
+		EngineContext *previous;
+	};
+
+	void setLuaState(lua_State *L);
+	lua_State *getLuaState() const;
+
+	/**
+	 * Sets the native handle (HWND on Windows) of the window the game's
+	 * window should be created inside of, if any.
+	 **/
+	void setParentWindow(void *handle);
+	void *getParentWindow() const;
+
+	/**
+	 * Sets the host buffer love.audio should mix into instead of opening a
+	 * playback device, if any. Must be set before love.audio is loaded.
+	 **/
+	void setLoopbackOutput(audio::LoopbackOutput *output);
+	audio::LoopbackOutput *getLoopbackOutput() const;
+
+	/**
+	 * Sets the plugin host love.plugin talks to, if any. Must be set before
+	 * love.plugin is loaded.
+	 **/
+	void setHost(plugin::Host *host);
+	plugin::Host *getHost() const;
+
+	/**
+	 * Sets the backend love.audio tries first when it's loaded in this
+	 * context. Defaults to "openal".
+	 **/
+	void setAudioBackend(const std::string &name);
+	const std::string &getAudioBackend() const;
+
+private:
+
+	friend class Module;
+
+	// Loaded modules, by full name and by base type.
+	std::map<std::string, Module *> registry;
+	Module *instances[Module::M_MAX_ENUM];
+
+	lua_State *L;
+	void *parentWindow;
+	audio::LoopbackOutput *loopbackOutput;
+	plugin::Host *host;
+	std::string audioBackend;
+
+}; // EngineContext
+
+} // love
+
+#endif // LOVE_ENGINE_CONTEXT_H
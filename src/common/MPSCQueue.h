@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_MPSC_QUEUE_H
+#define LOVE_MPSC_QUEUE_H
+
+// C++
+#include <atomic>
+#include <stddef.h>
+
+namespace love
+{
+
+/**
+ * Fixed-capacity, lock-free queue between any number of producer threads and
+ * a single consumer. Each slot carries a sequence number, so producers only
+ * contend on the head index and never wait on each other while copying.
+ * Consumers must be serialized externally (e.g. by only popping while a
+ * mutex is held.)
+ **/
+template <typename T, size_t Capacity>
+class MPSCQueue
+{
+public:
+
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "MPSCQueue capacity must be a power of two");
+
+	MPSCQueue()
+		: cells()
+		, head(0)
+		, tail(0)
+	{
+		for (size_t i = 0; i < Capacity; i++)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/**
+	 * [Producers] Adds an item to the back of the queue.
+	 * @return False if the queue is full, in which case nothing is added.
+	 **/
+	bool push(const T &item)
+	{
+		size_t pos = head.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			Cell &cell = cells[pos & (Capacity - 1)];
+			size_t seq = cell.sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) pos;
+
+			if (diff == 0)
+			{
+				if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.item = item;
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = head.load(std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * [Consumer] Removes the item at the front of the queue.
+	 * @return False if the queue is empty, or if the front item is still
+	 * being written by a producer.
+	 **/
+	bool pop(T &item)
+	{
+		size_t pos = tail.load(std::memory_order_relaxed);
+		Cell &cell = cells[pos & (Capacity - 1)];
+
+		if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+			return false;
+
+		item = cell.item;
+		cell.sequence.store(pos + Capacity, std::memory_order_release);
+		tail.store(pos + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	 * Approximate number of queued items.
+	 **/
+	size_t getCount() const
+	{
+		size_t h = head.load(std::memory_order_acquire);
+		size_t t = tail.load(std::memory_order_acquire);
+		return h > t ? h - t : 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return Capacity;
+	}
+
+private:
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T item;
+	};
+
+	Cell cells[Capacity];
+
+	// Only ever increase; wrapped into the array on access.
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+
+}; // MPSCQueue
+
+} // love
+
+#endif // LOVE_MPSC_QUEUE_H
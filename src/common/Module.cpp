@@ -20,6 +20,7 @@
 
 // LOVE
 #include "Module.h"
+#include "EngineContext.h"
 #include "Exception.h"
 #include "deprecation.h"
 
@@ -28,43 +29,15 @@
 #include <utility>
 #include <string>
 
-namespace
-{
-	typedef std::map<std::string, love::Module*> ModuleRegistry;
-
-	// The registry must be dynamically managed, because some modules
-	// (the math module) are static globals that are not guaranteed to
-	// be destroyed before other static globals.
-	ModuleRegistry *registry = nullptr;
-
-	ModuleRegistry &registryInstance()
-	{
-		if (!registry)
-			registry = new ModuleRegistry;
-
-		return *registry;
-	}
-
-	void freeEmptyRegistry()
-	{
-		if (registry && registry->empty())
-		{
-			delete registry;
-			registry = nullptr;
-		}
-	}
-
-} // anonymous namespace
-
 namespace love
 {
 
 love::Type Module::type("Module", &Object::type);
-Module *Module::instances[] = {};
 
 Module::Module(Module::ModuleType moduleType, const char *name)
 	: moduleType(moduleType)
 	, name(name)
+	, context(EngineContext::getCurrent())
 {
 	initDeprecation();
 	registerInstance(this);
@@ -72,7 +45,7 @@ Module::Module(Module::ModuleType moduleType, const char *name)
 
 Module::~Module()
 {
-	ModuleRegistry &registry = registryInstance();
+	auto &registry = context->registry;
 
 	// We can't use the overridden Module::getName() in this destructor.
 	for (auto it = registry.begin(); it != registry.end(); ++it)
@@ -87,12 +60,10 @@ Module::~Module()
 	// Same deal with Module::getModuleType().
 	for (int i = 0; i < (int) M_MAX_ENUM; i++)
 	{
-		if (instances[i] == this)
-			instances[i] = nullptr;
+		if (context->instances[i] == this)
+			context->instances[i] = nullptr;
 	}
 
-	freeEmptyRegistry();
-
 	deinitDeprecation();
 }
 
@@ -103,7 +74,7 @@ void Module::registerInstance(Module *instance)
 
 	std::string name(instance->getName());
 
-	ModuleRegistry &registry = registryInstance();
+	auto &registry = instance->context->registry;
 
 	auto it = registry.find(name);
 
@@ -120,6 +91,8 @@ void Module::registerInstance(Module *instance)
 
 	if (mtype != M_UNKNOWN)
 	{
+		Module **instances = instance->context->instances;
+
 		if (instances[mtype] != nullptr)
 		{
 			printf("Warning: overwriting module instance %s with new instance %s\n",
@@ -132,7 +105,7 @@ void Module::registerInstance(Module *instance)
 
 Module *Module::getInstance(const std::string &name)
 {
-	ModuleRegistry &registry = registryInstance();
+	auto &registry = EngineContext::getCurrent()->registry;
 
 	auto it = registry.find(name);
 
@@ -142,4 +115,9 @@ Module *Module::getInstance(const std::string &name)
 	return it->second;
 }
 
+Module *Module::getInstanceOfType(ModuleType type)
+{
+	return type != M_UNKNOWN ? EngineContext::getCurrent()->instances[type] : nullptr;
+}
+
 } // love
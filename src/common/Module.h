@@ -27,6 +27,9 @@
 
 namespace love
 {
+
+class EngineContext;
+
 /**
  * Abstract superclass for all modules.
  **/
@@ -51,6 +54,7 @@ class Module : public Object
 		M_MATH,
 		M_MOUSE,
 		M_PHYSICS,
+		M_PLUGIN,
 		M_SENSOR,
 		M_SOUND,
 		M_SYSTEM,
@@ -79,32 +83,35 @@ class Module : public Object
 	const char *getName() const { return name.c_str(); }
 
 	/**
-	 * Retrieve module instance from internal registry. May return NULL
-	 * if module not registered.
+	 * Retrieve module instance from the current EngineContext's registry.
+	 * May return NULL if module not registered.
 	 * @param name The full name of the module.
 	 * @return Module instance or NULL if the module is not registered.
 	 */
 	static Module *getInstance(const std::string &name);
 
 	/**
-	 * Retrieve module instance from the internal registry using the base
-	 * module type. May return null if the module is not registered.
+	 * Retrieve module instance from the current EngineContext's registry
+	 * using the base module type. May return null if the module is not
+	 * registered.
 	 * @param type The base type of the module.
 	 **/
 	template <typename T>
 	static T *getInstance(ModuleType type)
 	{
-		return type != M_UNKNOWN ? (T *) instances[type] : nullptr;
+		return (T *) getInstanceOfType(type);
 	}
 
 private:
 
+	static Module *getInstanceOfType(ModuleType type);
 	static void registerInstance(Module *instance);
 
 	ModuleType moduleType;
 	std::string name;
 
-	static Module *instances[M_MAX_ENUM];
+	// The context this module was registered in.
+	EngineContext *context;
 
 }; // Module
 
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SPSC_QUEUE_H
+#define LOVE_SPSC_QUEUE_H
+
+// C++
+#include <atomic>
+#include <stddef.h>
+
+namespace love
+{
+
+/**
+ * Fixed-capacity, wait-free queue between exactly one producer thread and
+ * exactly one consumer thread. Nothing is allocated after construction, so
+ * the producer side is safe to use from a real-time audio callback.
+ **/
+template <typename T, size_t Capacity>
+class SPSCQueue
+{
+public:
+
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+	SPSCQueue()
+		: items()
+		, head(0)
+		, tail(0)
+	{
+	}
+
+	/**
+	 * [Producer] Adds an item to the back of the queue.
+	 * @return False if the queue is full, in which case nothing is added.
+	 **/
+	bool push(const T &item)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= Capacity)
+			return false;
+
+		items[h & (Capacity - 1)] = item;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * [Producer] Adds several items, which the consumer sees all at once.
+	 * @return False if they don't all fit, in which case nothing is added.
+	 **/
+	bool push(const T *items, size_t count)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) + count > Capacity)
+			return false;
+
+		for (size_t i = 0; i < count; i++)
+			this->items[(h + i) & (Capacity - 1)] = items[i];
+
+		head.store(h + count, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * [Consumer] Removes the item at the front of the queue.
+	 * @return False if the queue is empty.
+	 **/
+	bool pop(T &item)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire))
+			return false;
+
+		item = items[t & (Capacity - 1)];
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Approximate number of queued items; exact when called from either end
+	 * while the other one is idle.
+	 **/
+	size_t getCount() const
+	{
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+
+	size_t getCapacity() const
+	{
+		return Capacity;
+	}
+
+private:
+
+	T items[Capacity];
+
+	// Only ever increase; wrapped into the array on access.
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+
+}; // SPSCQueue
+
+} // love
+
+#endif // LOVE_SPSC_QUEUE_H
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_TRIPLE_BUFFER_H
+#define LOVE_TRIPLE_BUFFER_H
+
+// C++
+#include <atomic>
+
+namespace love
+{
+
+/**
+ * Wait-free hand-off of the latest value of T from one writer thread to one
+ * reader thread. Neither side ever blocks or waits on the other: the writer
+ * always has a slot of its own to fill, and the reader keeps seeing the last
+ * value it picked up until a newer one has been published.
+ *
+ * Intended for state which is produced at one rate and consumed at another,
+ * e.g. written once per audio block and read once per game frame.
+ **/
+template <typename T>
+class TripleBuffer
+{
+public:
+
+	TripleBuffer()
+		: slots()
+		, writeIndex(0)
+		, middle(1)
+		, readIndex(2)
+	{
+	}
+
+	/**
+	 * Gets the slot owned by the writer. Only valid until the next publish().
+	 **/
+	T &getWriteSlot()
+	{
+		return slots[writeIndex];
+	}
+
+	/**
+	 * Makes the write slot the latest value and takes a new one to write to.
+	 **/
+	void publish()
+	{
+		writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	void write(const T &value)
+	{
+		getWriteSlot() = value;
+		publish();
+	}
+
+	/**
+	 * Picks up the latest published value, if there is one we haven't seen
+	 * yet, and returns it.
+	 **/
+	const T &read()
+	{
+		if (middle.load(std::memory_order_relaxed) & FRESH)
+			readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return slots[readIndex];
+	}
+
+	/**
+	 * Whether a value has been published since the last read().
+	 **/
+	bool hasNewValue() const
+	{
+		return (middle.load(std::memory_order_relaxed) & FRESH) != 0;
+	}
+
+private:
+
+	static const int INDEX_MASK = 0x3;
+	static const int FRESH = 0x4;
+
+	T slots[3];
+
+	// Owned by the writer.
+	int writeIndex;
+
+	// Index of the slot in between, plus FRESH if it hasn't been read yet.
+	std::atomic<int> middle;
+
+	// Owned by the reader.
+	int readIndex;
+
+}; // TripleBuffer
+
+} // love
+
+#endif // LOVE_TRIPLE_BUFFER_H
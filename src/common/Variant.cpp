@@ -26,6 +26,12 @@
 namespace love
 {
 
+Variant::FlatTable::~FlatTable()
+{
+	for (const Proxy &p : objects)
+		p.object->release();
+}
+
 Variant::Variant(Type vtype)
 	: type(vtype)
 {}
@@ -89,6 +95,13 @@ Variant::Variant(SharedTable *table)
 	data.table = table;
 }
 
+// Variant gets ownership of the buffer.
+Variant::Variant(FlatTable *table)
+	: type(FLATTABLE)
+{
+	data.flattable = table;
+}
+
 Variant::Variant(const Variant &v)
 	: type(v.type)
 	, data(v.data)
@@ -99,6 +112,8 @@ Variant::Variant(const Variant &v)
 		data.objectproxy.object->retain();
 	else if (type == TABLE)
 		data.table->retain();
+	else if (type == FLATTABLE)
+		data.flattable->retain();
 }
 
 Variant::Variant(Variant &&v)
@@ -116,6 +131,8 @@ Variant::~Variant()
 		data.objectproxy.object->release();
 	else if (type == TABLE)
 		data.table->release();
+	else if (type == FLATTABLE)
+		data.flattable->release();
 }
 
 Variant &Variant::operator = (const Variant &v)
@@ -126,6 +143,28 @@ Variant &Variant::operator = (const Variant &v)
 		v.data.objectproxy.object->retain();
 	else if (v.type == TABLE)
 		v.data.table->retain();
+	else if (v.type == FLATTABLE)
+		v.data.flattable->retain();
+
+	if (type == STRING)
+		data.string->release();
+	else if (type == LOVEOBJECT && data.objectproxy.object != nullptr)
+		data.objectproxy.object->release();
+	else if (type == TABLE)
+		data.table->release();
+	else if (type == FLATTABLE)
+		data.flattable->release();
+
+	type = v.type;
+	data = v.data;
+
+	return *this;
+}
+
+Variant &Variant::operator = (Variant &&v)
+{
+	if (this == &v)
+		return *this;
 
 	if (type == STRING)
 		data.string->release();
@@ -133,9 +172,12 @@ Variant &Variant::operator = (const Variant &v)
 		data.objectproxy.object->release();
 	else if (type == TABLE)
 		data.table->release();
+	else if (type == FLATTABLE)
+		data.flattable->release();
 
 	type = v.type;
 	data = v.data;
+	v.type = NIL;
 
 	return *this;
 }
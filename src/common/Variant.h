@@ -48,7 +48,8 @@ class LOVE_EXPORT Variant
 		LUSERDATA,
 		LOVEOBJECT,
 		NIL,
-		TABLE
+		TABLE,
+		FLATTABLE
 	};
 
 	class SharedString : public love::Object
@@ -78,6 +79,38 @@ class LOVE_EXPORT Variant
 		std::vector<std::pair<Variant, Variant>> pairs;
 	};
 
+	/**
+	 * A Lua table serialized into one buffer, so it can be passed between
+	 * threads without allocating every key and value separately. Each value
+	 * is a Tag followed by its data. Tables hold a uint32 array length and a
+	 * uint32 count of the other pairs, then the array values and the
+	 * key-value pairs. Love objects are referenced by index into 'objects'.
+	 **/
+	class FlatTable : public love::Object
+	{
+	public:
+
+		enum Tag
+		{
+			TAG_NIL,
+			TAG_FALSE,
+			TAG_TRUE,
+			TAG_NUMBER,
+			TAG_STRING,
+			TAG_LUSERDATA,
+			TAG_OBJECT,
+			TAG_TABLE
+		};
+
+		FlatTable() {}
+		virtual ~FlatTable();
+
+		std::vector<uint8> buffer;
+
+		// Retained until the FlatTable is destroyed.
+		std::vector<Proxy> objects;
+	};
+
 	union Data
 	{
 		bool boolean;
@@ -86,6 +119,7 @@ class LOVE_EXPORT Variant
 		void *userdata;
 		Proxy objectproxy;
 		SharedTable *table;
+		FlatTable *flattable;
 		struct
 		{
 			char str[MAX_SMALL_STRING_LENGTH];
@@ -101,11 +135,13 @@ class LOVE_EXPORT Variant
 	Variant(void *lightuserdata);
 	Variant(love::Type *type, love::Object *object);
 	Variant(SharedTable *table);
+	Variant(FlatTable *table);
 	Variant(const Variant &v);
 	Variant(Variant &&v);
 	~Variant();
 
 	Variant &operator = (const Variant &v);
+	Variant &operator = (Variant &&v);
 
 	Type getType() const { return type; }
 	const Data &getData() const { return data; }
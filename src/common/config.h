@@ -69,6 +69,17 @@
 #	endif
 #endif
 
+// SSE2 instructions (integer conversions.)
+#if defined(__SSE2__)
+#	define LOVE_SIMD_SSE2
+#elif defined(_MSC_VER)
+#	if defined(_M_AMD64) || defined(_M_X64)
+#		define LOVE_SIMD_SSE2
+#	elif _M_IX86_FP >= 2
+#		define LOVE_SIMD_SSE2
+#	endif
+#endif
+
 // NEON instructions.
 #if defined(__ARM_NEON) || defined(_M_ARM64)
 #	define LOVE_SIMD_NEON
@@ -156,6 +167,7 @@
 #	define LOVE_ENABLE_MATH
 #	define LOVE_ENABLE_MOUSE
 #	define LOVE_ENABLE_PHYSICS
+#	define LOVE_ENABLE_PLUGIN
 #	define LOVE_ENABLE_SENSOR
 #	define LOVE_ENABLE_SOUND
 #	define LOVE_ENABLE_SYSTEM
@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstddef>
+#include <cstring>
 #include <cmath>
 #include <sstream>
 
@@ -719,6 +720,224 @@ static Proxy *tryextractproxy(lua_State *L, int idx)
 	return nullptr;
 }
 
+static void writeFlat(Variant::FlatTable *t, const void *data, size_t size)
+{
+	const uint8 *bytes = (const uint8 *) data;
+	t->buffer.insert(t->buffer.end(), bytes, bytes + size);
+}
+
+static void writeFlatTag(Variant::FlatTable *t, Variant::FlatTable::Tag tag)
+{
+	t->buffer.push_back((uint8) tag);
+}
+
+static void writeFlatVarint(Variant::FlatTable *t, uint64 v)
+{
+	while (v >= 0x80)
+	{
+		t->buffer.push_back((uint8) (v | 0x80));
+		v >>= 7;
+	}
+	t->buffer.push_back((uint8) v);
+}
+
+static const uint8 *readFlatVarint(const uint8 *p, uint64 *v)
+{
+	*v = 0;
+	for (int shift = 0; ; shift += 7)
+	{
+		uint8 b = *p++;
+		*v |= (uint64) (b & 0x7F) << shift;
+		if ((b & 0x80) == 0)
+			return p;
+	}
+}
+
+// Appends the value at index n to the FlatTable. Returns false for values
+// which can't be copied.
+static bool flattenValue(lua_State *L, int n, Variant::FlatTable *t, bool allowuserdata, std::set<const void*> &tableSet)
+{
+	size_t len;
+	const char *str;
+	Proxy *p = nullptr;
+	double number;
+	void *userdata;
+
+	if (n < 0)
+		n += lua_gettop(L) + 1;
+
+	switch (lua_type(L, n))
+	{
+	case LUA_TNIL:
+		writeFlatTag(t, Variant::FlatTable::TAG_NIL);
+		return true;
+	case LUA_TBOOLEAN:
+		writeFlatTag(t, luax_toboolean(L, n) ? Variant::FlatTable::TAG_TRUE : Variant::FlatTable::TAG_FALSE);
+		return true;
+	case LUA_TNUMBER:
+		number = lua_tonumber(L, n);
+		writeFlatTag(t, Variant::FlatTable::TAG_NUMBER);
+		writeFlat(t, &number, sizeof(number));
+		return true;
+	case LUA_TSTRING:
+		str = lua_tolstring(L, n, &len);
+		writeFlatTag(t, Variant::FlatTable::TAG_STRING);
+		writeFlatVarint(t, len);
+		writeFlat(t, str, len);
+		return true;
+	case LUA_TLIGHTUSERDATA:
+		userdata = lua_touserdata(L, n);
+		writeFlatTag(t, Variant::FlatTable::TAG_LUSERDATA);
+		writeFlat(t, &userdata, sizeof(userdata));
+		return true;
+	case LUA_TUSERDATA:
+		if (!allowuserdata)
+		{
+			luax_typerror(L, n, "copyable Lua value");
+			return false;
+		}
+		p = tryextractproxy(L, n);
+		if (p == nullptr)
+		{
+			luax_typerror(L, n, "love type");
+			return false;
+		}
+		p->object->retain();
+		t->objects.push_back(*p);
+		writeFlatTag(t, Variant::FlatTable::TAG_OBJECT);
+		writeFlatVarint(t, t->objects.size() - 1);
+		return true;
+	case LUA_TTABLE:
+		break;
+	default:
+		return false;
+	}
+
+	// Now make sure this table wasn't already serialised
+	const void *tablePointer = lua_topointer(L, n);
+	if (!tableSet.insert(tablePointer).second)
+		throw love::Exception("Cycle detected in table");
+
+	writeFlatTag(t, Variant::FlatTable::TAG_TABLE);
+
+	// The counts are filled in at the end.
+	size_t countsOffset = t->buffer.size();
+	uint32 counts[2] = {0, 0};
+	writeFlat(t, counts, sizeof(counts));
+
+	bool success = true;
+
+	// The array part is stored without keys, up to the first nil.
+	for (int i = 1; success; i++)
+	{
+		lua_rawgeti(L, n, i);
+		if (lua_isnil(L, -1))
+		{
+			lua_pop(L, 1);
+			break;
+		}
+
+		success = flattenValue(L, -1, t, allowuserdata, tableSet);
+		lua_pop(L, 1);
+		counts[0]++;
+	}
+
+	if (success)
+		lua_pushnil(L);
+
+	while (success && lua_next(L, n))
+	{
+		// Skip what's already in the array part.
+		if (lua_type(L, -2) == LUA_TNUMBER)
+		{
+			lua_Number key = lua_tonumber(L, -2);
+			if (key >= 1 && key <= counts[0] && key == std::floor(key))
+			{
+				lua_pop(L, 1);
+				continue;
+			}
+		}
+
+		success = flattenValue(L, -2, t, allowuserdata, tableSet)
+			&& flattenValue(L, -1, t, allowuserdata, tableSet);
+
+		// Pop the key too when stopping early.
+		lua_pop(L, success ? 1 : 2);
+		counts[1]++;
+	}
+
+	memcpy(t->buffer.data() + countsOffset, counts, sizeof(counts));
+
+	// And remove the table from the set again
+	tableSet.erase(tablePointer);
+
+	return success;
+}
+
+static const uint8 *pushFlatValue(lua_State *L, const uint8 *p, const Variant::FlatTable *t)
+{
+	uint64 len;
+	double number;
+	void *userdata;
+
+	switch ((Variant::FlatTable::Tag) *p++)
+	{
+	case Variant::FlatTable::TAG_FALSE:
+		lua_pushboolean(L, 0);
+		return p;
+	case Variant::FlatTable::TAG_TRUE:
+		lua_pushboolean(L, 1);
+		return p;
+	case Variant::FlatTable::TAG_NUMBER:
+		memcpy(&number, p, sizeof(number));
+		lua_pushnumber(L, number);
+		return p + sizeof(number);
+	case Variant::FlatTable::TAG_STRING:
+		p = readFlatVarint(p, &len);
+		lua_pushlstring(L, (const char *) p, (size_t) len);
+		return p + len;
+	case Variant::FlatTable::TAG_LUSERDATA:
+		memcpy(&userdata, p, sizeof(userdata));
+		lua_pushlightuserdata(L, userdata);
+		return p + sizeof(userdata);
+	case Variant::FlatTable::TAG_OBJECT:
+	{
+		p = readFlatVarint(p, &len);
+		const Proxy &proxy = t->objects[(size_t) len];
+		luax_pushtype(L, *proxy.type, proxy.object);
+		return p;
+	}
+	case Variant::FlatTable::TAG_TABLE:
+	{
+		uint32 counts[2];
+		memcpy(counts, p, sizeof(counts));
+		p += sizeof(counts);
+
+		luaL_checkstack(L, 3, "Table is nested too deeply");
+		lua_createtable(L, (int) counts[0], (int) counts[1]);
+
+		for (uint32 i = 0; i < counts[0]; i++)
+		{
+			p = pushFlatValue(L, p, t);
+			lua_rawseti(L, -2, (int) i + 1);
+		}
+
+		for (uint32 i = 0; i < counts[1]; i++)
+		{
+			p = pushFlatValue(L, p, t);
+			p = pushFlatValue(L, p, t);
+			lua_rawset(L, -3);
+		}
+
+		return p;
+	}
+	case Variant::FlatTable::TAG_NIL:
+	default:
+		lua_pushnil(L);
+		return p;
+	}
+}
+
 Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<const void*> *tableSet)
 {
 	size_t len;
@@ -757,7 +976,6 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 		return Variant();
 	case LUA_TTABLE:
 		{
-			bool success = true;
 			std::set<const void *> topTableSet;
 
 			// We can use a pointer to a stack-allocated variable because it's
@@ -765,41 +983,21 @@ Variant luax_checkvariant(lua_State *L, int n, bool allowuserdata, std::set<cons
 			if (tableSet == nullptr)
 				tableSet = &topTableSet;
 
-			// Now make sure this table wasn't already serialised
-			const void *tablePointer = lua_topointer(L, n);
+			// The whole table goes into one buffer, which is decoded straight
+			// into a new table by luax_pushvariant.
+			Variant::FlatTable *table = new Variant::FlatTable();
+			bool success = false;
+
+			try
 			{
-				auto result = tableSet->insert(tablePointer);
-				if (!result.second) // insertion failed
-					throw love::Exception("Cycle detected in table");
+				success = flattenValue(L, n, table, allowuserdata, *tableSet);
 			}
-
-			Variant::SharedTable *table = new Variant::SharedTable();
-
-			size_t len = luax_objlen(L, -1);
-			if (len > 0)
-				table->pairs.reserve(len);
-
-			lua_pushnil(L);
-
-			while (lua_next(L, n))
+			catch (love::Exception &)
 			{
-				table->pairs.emplace_back(
-					luax_checkvariant(L, -2, allowuserdata, tableSet),
-					luax_checkvariant(L, -1, allowuserdata, tableSet)
-				);
-				lua_pop(L, 1);
-
-				const auto &p = table->pairs.back();
-				if (p.first.getType() == Variant::UNKNOWN || p.second.getType() == Variant::UNKNOWN)
-				{
-					success = false;
-					break;
-				}
+				table->release();
+				throw;
 			}
 
-			// And remove the table from the set again
-			tableSet->erase(tablePointer);
-
 			if (success)
 				return Variant(table);
 			else
@@ -851,6 +1049,9 @@ void luax_pushvariant(lua_State *L, const Variant &v)
 
 		break;
 	}
+	case Variant::FLATTABLE:
+		pushFlatValue(L, data.flattable->buffer.data(), data.flattable);
+		break;
 	case Variant::NIL:
 	default:
 		lua_pushnil(L);
@@ -51,6 +51,9 @@ CPLUG_API uint32_t cplug_getLatencyInSamples(void*);
 CPLUG_API uint32_t cplug_getTailInSamples(void*);
 
 CPLUG_API void cplug_setSampleRateAndBlockSize(void*, double sampleRate, uint32_t maxBlockSize);
+// Called alongside cplug_setSampleRateAndBlockSize. When offline, process calls may run faster (or slower) than real
+// time, e.g. during a bounce
+CPLUG_API void cplug_setOfflineProcessing(void*, bool isOffline);
 
 enum
 {
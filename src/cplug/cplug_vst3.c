@@ -1210,15 +1210,17 @@ VST3Processor_setupProcessing(void* const self, struct Steinberg_Vst_ProcessSetu
         setup->symbolicSampleSize == Steinberg_Vst_SymbolicSampleSizes_kSample32,
         Steinberg_kInvalidArgument);
 
-    // TODO processMode can be:
+    // processMode can be:
     // Steinberg_Vst_ProcessModes_kRealtime
     // Steinberg_Vst_ProcessModes_kPrefetch,
     // Steinberg_Vst_ProcessModes_kOffline
+    // Prefetch is still paced by the host, so only offline counts
 
     CPLUG_LOG_ASSERT(setup->sampleRate > 0.0);
     CPLUG_LOG_ASSERT(setup->maxSamplesPerBlock >= 2);
 
     cplug_setSampleRateAndBlockSize(vst3->userPlugin, setup->sampleRate, setup->maxSamplesPerBlock);
+    cplug_setOfflineProcessing(vst3->userPlugin, setup->processMode == Steinberg_Vst_ProcessModes_kOffline);
 
     return Steinberg_kResultOk;
 }
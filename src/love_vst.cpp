@@ -7,7 +7,11 @@
 #include "common/version.h"
 #include "common/runtime.h"
 #include "common/Variant.h"
+#include "common/EngineContext.h"
 #include "modules/love/love.h"
+#include "modules/audio/LoopbackOutput.h"
+#include "modules/plugin/Host.h"
+#include "modules/timer/Timer.h"
 
 #include <SDL3/SDL.h>
 
@@ -82,13 +86,12 @@ enum DoneAction
 	DONE_RESTART,
 };
 
-lua_State *L;
-
 static DoneAction runlove(int argc, const char **argv, int &retval, love::Variant &restartvalue)
 {
 	// Create the virtual machine.
-	L = luaL_newstate();
+	lua_State *L = luaL_newstate();
 	luaL_openlibs(L);
+	love::EngineContext::getCurrent()->setLuaState(L);
 
 	// LuaJIT-specific setup needs to be done as early as possible - before
 	// get_app_arguments because that loads external library code. This is also
@@ -180,6 +183,7 @@ static DoneAction runlove(int argc, const char **argv, int &retval, love::Varian
 			restartvalue = love::luax_checkvariant(L, retidx + 1, false);
 	}
 
+	love::EngineContext::getCurrent()->setLuaState(nullptr);
 	lua_close(L);
     return done;
 }
@@ -199,15 +203,12 @@ std::string GetBalatroLovePath() {
 
 DWORD WINAPI runBalatro(LPVOID lpParam) 
 {
-    char tmpBuf[32768] = {0};
-    if (GetEnvironmentVariable("WNDVAL_BALATROVST", tmpBuf, 32768)) {
-        // An instance already exists so do nothing and show a message box
-        MessageBox((HWND)lpParam, "An instance of Balatro VST is already running, only one instance can exist at a time!", "Error", MB_OK);
-        return 0;
-    }
-    // Awful hack pt1
-    std::string wndStr = std::to_string((unsigned __int64)lpParam);
-    SetEnvironmentVariable("WNDVAL_BALATROVST", wndStr.c_str());
+    // The creating thread retained the context, host and loopback for us, so they outlive the plugin if the game
+    // doesn't quit when asked to (see destroyGUI)
+    love::StrongRef<love::EngineContext> context((love::EngineContext*)lpParam, love::Acquire::NORETAIN);
+    love::StrongRef<love::plugin::Host> host(context->getHost(), love::Acquire::NORETAIN);
+    love::StrongRef<love::audio::LoopbackOutput> loopback(context->getLoopbackOutput(), love::Acquire::NORETAIN);
+    love::EngineContext::Scope scope(context.get());
 
 	if (strcmp(LOVE_VERSION_STRING, love_version()) != 0)
 	{
@@ -246,11 +247,17 @@ typedef struct MyPlugin
     float    sampleRate;
     uint32_t maxBufferSize;
 
-    float paramValuesAudio[kParameterCount];
+    // Per-instance engine state (module registry, parent window, Lua state)
+    love::EngineContext* context;
+
+    // Shared with love.plugin; written from the audio thread
+    love::plugin::Host* host;
+    uint64_t            processedFrames;
 
-    float oscPhase; // 0-1
-    int   midiNote; // -1 == not playing, 0-127+ playing
-    float velocity; // 0-1
+    // Game audio mixed by love.audio, pulled on the audio thread
+    love::audio::LoopbackOutput* loopback;
+
+    float paramValuesAudio[kParameterCount];
 
     // GUI zone
     void* gui;
@@ -296,7 +303,15 @@ void* cplug_createPlugin()
     plugin->paramInfo[kParameterUTF8].max          = 1.0f;
     plugin->paramInfo[kParameterUTF8].defaultValue = 0.0f;
 
-    plugin->midiNote = -1;
+    plugin->sampleRate = 44100.0f;
+    plugin->loopback   = new love::audio::LoopbackOutput((int)plugin->sampleRate);
+
+    plugin->host = new love::plugin::Host();
+    plugin->host->setTargetFPS(60.0);
+
+    plugin->context = new love::EngineContext();
+    plugin->context->setLoopbackOutput(plugin->loopback);
+    plugin->context->setHost(plugin->host);
 
     return plugin;
 }
@@ -307,11 +322,11 @@ void cplug_destroyPlugin(void* ptr)
     MyPlugin* plugin = (MyPlugin*)ptr;
     if (!ptr)
         return;
-    if (plugin->gui) {
+    if (plugin->gui)
         destroyGUI(plugin->gui);
-        // Unset env var since it's also used as a marker that the VST is loaded
-        SetEnvironmentVariable("WNDVAL_BALATROVST", NULL);
-    }
+    plugin->context->release();
+    plugin->host->release();
+    plugin->loopback->release();
     free(ptr);
 }
 
@@ -476,7 +491,13 @@ uint32_t cplug_getParameterFlags(void* ptr, uint32_t index)
 /* --------------------------------------------------------------------------------------------------------
  * Audio/MIDI Processing */
 
-uint32_t cplug_getLatencyInSamples(void* ptr) { return 0; }
+// Game audio is buffered between the OpenAL mixer thread and cplug_process. The ring is kept at a fixed depth, so
+// that's exactly the latency we add. The soft mixer renders straight into the host's buffers and adds none.
+uint32_t cplug_getLatencyInSamples(void* ptr)
+{
+    MyPlugin* plugin = (MyPlugin*)ptr;
+    return (uint32_t)plugin->loopback->getLatency();
+}
 uint32_t cplug_getTailInSamples(void* ptr) { return 0; }
 
 void cplug_setSampleRateAndBlockSize(void* ptr, double sampleRate, uint32_t maxBlockSize)
@@ -484,6 +505,23 @@ void cplug_setSampleRateAndBlockSize(void* ptr, double sampleRate, uint32_t maxB
     MyPlugin* plugin      = (MyPlugin*)ptr;
     plugin->sampleRate    = (float)sampleRate;
     plugin->maxBufferSize = maxBlockSize;
+    plugin->loopback->setSampleRate((int)sampleRate);
+
+    // One block for the host to take, plus room for the mixer thread to be late refilling it. Smaller blocks still
+    // need a floor, as the mixer renders in chunks and only wakes up every millisecond or so.
+    static const uint32_t LOOPBACK_MIN_HEADROOM = 512;
+    uint32_t headroom = maxBlockSize > LOOPBACK_MIN_HEADROOM ? maxBlockSize : LOOPBACK_MIN_HEADROOM;
+    plugin->loopback->setDepth((int)(maxBlockSize + headroom));
+    plugin->host->setSampleRate((int)sampleRate);
+}
+
+void cplug_setOfflineProcessing(void* ptr, bool isOffline)
+{
+    MyPlugin* plugin = (MyPlugin*)ptr;
+    // Game time follows processed samples instead of the wall clock, see love::plugin::Host::advanceTick
+    plugin->host->setOfflineRendering(isOffline);
+    // Offline, the mixer only renders once the game has ticked through a block, see cplug_process
+    plugin->loopback->setWriteAhead(isOffline ? 0 : -1);
 }
 
 void cplug_process(void* ptr, CplugProcessContext* ctx)
@@ -492,6 +530,36 @@ void cplug_process(void* ptr, CplugProcessContext* ctx)
 
     MyPlugin* plugin = (MyPlugin*)ptr;
 
+    // Snapshot the transport once per block for love.plugin.getTransport
+    love::plugin::Transport transport;
+    transport.playing            = (ctx->flags & CPLUG_FLAG_TRANSPORT_IS_PLAYING) != 0;
+    transport.looping            = (ctx->flags & CPLUG_FLAG_TRANSPORT_IS_LOOPING) != 0;
+    transport.recording          = (ctx->flags & CPLUG_FLAG_TRANSPORT_IS_RECORDING) != 0;
+    transport.hasTempo           = (ctx->flags & CPLUG_FLAG_TRANSPORT_HAS_BPM) != 0;
+    transport.hasTimeSignature   = (ctx->flags & CPLUG_FLAG_TRANSPORT_HAS_TIME_SIGNATURE) != 0;
+    transport.hasPlayhead        = (ctx->flags & CPLUG_FLAG_TRANSPORT_HAS_PLAYHEAD_BEATS) != 0;
+    transport.bpm                = ctx->bpm;
+    transport.beat               = ctx->playheadBeats;
+    transport.loopStart          = ctx->loopStartBeats;
+    transport.loopEnd            = ctx->loopEndBeats;
+    transport.timeSigNumerator   = (int)ctx->timeSigNumerator;
+    transport.timeSigDenominator = (int)ctx->timeSigDenominator;
+    transport.sampleTime         = plugin->processedFrames;
+    transport.sampleRate         = (int)plugin->sampleRate;
+    transport.time               = love::timer::Timer::getTime();
+    plugin->host->setTransport(transport);
+
+    // Offline, nothing paces the game but us: let it tick through this block, and wait for the audio it produced.
+    // The game then waits for the next block, so the mixer renders this one from the state those ticks left behind
+    // rather than racing them, and a bounce sounds the same every time. Timeouts keep a stalled game from hanging the
+    // host.
+    if (plugin->host->isOfflineRendering())
+    {
+        plugin->host->waitForTicks(ctx->numFrames, 1000);
+        plugin->loopback->setWriteAhead(ctx->numFrames);
+        plugin->loopback->waitForReadable(ctx->numFrames, 100);
+    }
+
     // Audio thread has chance to respond to incoming GUI events before being sent to the host
     int head = cplug_atomic_load_i32(&plugin->mainToAudioHead) & CPLUG_EVENT_QUEUE_MASK;
     int tail = cplug_atomic_load_i32(&plugin->mainToAudioTail);
@@ -522,26 +590,15 @@ void cplug_process(void* ptr, CplugProcessContext* ctx)
             break;
         case CPLUG_EVENT_MIDI:
         {
-            static const uint8_t MIDI_NOTE_OFF         = 0x80;
-            static const uint8_t MIDI_NOTE_ON          = 0x90;
-            static const uint8_t MIDI_NOTE_PITCH_WHEEL = 0xe0;
-
-            if ((event.midi.status & 0xf0) == MIDI_NOTE_ON)
-            {
-                plugin->midiNote = event.midi.data1;
-                plugin->velocity = (float)event.midi.data2 / 127.0f;
-            }
-            if ((event.midi.status & 0xf0) == MIDI_NOTE_OFF)
-            {
-                int note = event.midi.data1;
-                if (note == plugin->midiNote)
-                    plugin->midiNote = -1;
-                plugin->velocity = (float)event.midi.data2 / 127.0f;
-            }
-            if ((event.midi.status & 0xf0) == MIDI_NOTE_PITCH_WHEEL)
-            {
-                int pb = (int)event.midi.data1 | ((int)event.midi.data2 << 7);
-            }
+            // Forward to love.event; midipressed/midireleased/midicc are dispatched on the game thread
+            love::plugin::MidiMessage message;
+            message.status     = event.midi.status;
+            message.data1      = event.midi.data1;
+            message.data2      = event.midi.data2;
+            message.offset     = (int)event.midi.frame;
+            message.sampleTime = plugin->processedFrames + event.midi.frame;
+            message.time       = transport.time + event.midi.frame / (double)plugin->sampleRate;
+            plugin->host->pushMidi(message);
             break;
         }
         case CPLUG_EVENT_PROCESS_AUDIO:
@@ -554,43 +611,16 @@ void cplug_process(void* ptr, CplugProcessContext* ctx)
             CPLUG_LOG_ASSERT(output[0] != NULL);
             CPLUG_LOG_ASSERT(output[1] != NULL);
 
-            if (plugin->midiNote == -1)
-            {
-                // Silence
-                memset(&output[0][frame], 0, sizeof(float) * (event.processAudio.endFrame - frame));
-                memset(&output[1][frame], 0, sizeof(float) * (event.processAudio.endFrame - frame));
-                frame = event.processAudio.endFrame;
-            }
-            else
-            {
-                float phase = plugin->oscPhase;
-
-                float Hz  = 440.0f * exp2f(((float)plugin->midiNote - 69.0f) * 0.0833333f);
-                float inc = Hz / plugin->sampleRate;
-                float dB  = -60.0f + plugin->velocity * 54; // -6dB max
-                float vol = powf(10.0f, dB / 20.0f);
-
-                for (; frame < event.processAudio.endFrame; frame++)
-                {
-                    static const float pi = 3.141592653589793f;
-
-                    float sample = vol * sinf(2 * pi * phase);
-
-                    for (int ch = 0; ch < 2; ch++)
-                        output[ch][frame] = sample;
-
-                    phase += inc;
-                    phase -= (int)phase;
-                }
-
-                plugin->oscPhase = phase;
-            }
+            // Game audio mixed by love.audio through the loopback device. Pads with silence on underrun.
+            plugin->loopback->read(output, frame, event.processAudio.endFrame - frame);
+            frame = event.processAudio.endFrame;
             break;
         }
         default:
             break;
         }
     }
+    plugin->processedFrames += ctx->numFrames;
     ENABLE_DENORMALS
 }
 
@@ -669,10 +699,15 @@ typedef struct MyGUI
 void* cplug_createGUI(void* userPlugin)
 {
     MyPlugin* plugin = (MyPlugin*)userPlugin;
-    if (plugin->gui && ((MyGUI*)(plugin->gui))->window) { // Do not recreate if window already exists
-        auto wnd = ((MyGUI*)(plugin->gui))->window;
-        ((MyGUI*)(plugin->gui))->plugin = plugin;
-        return plugin->gui;
+    if (plugin->gui) {
+        MyGUI* existing = (MyGUI*)plugin->gui;
+        // The game keeps running while the editor is closed (see cplug_destroyGUI), so reopening only needs
+        // cplug_setParent to reattach its window
+        if (existing->window && existing->balatroThread &&
+            WaitForSingleObject((HANDLE)existing->balatroThread, 0) == WAIT_TIMEOUT)
+            return existing;
+        // The game quit by itself in the meantime, boot a new one
+        destroyGUI(existing);
     }
     MyGUI*    gui    = (MyGUI*)malloc(sizeof(MyGUI));
     memset(gui, 0, sizeof(*gui));
@@ -717,7 +752,13 @@ void* cplug_createGUI(void* userPlugin)
 
     SetWindowLongPtrA((HWND)gui->window, 0, (LONG_PTR)gui);
 
-    gui->balatroThread = CreateThread(NULL, 0, runBalatro, gui->window, 0, NULL);
+    // SDL parents its window to ours; love.audio renders into the plugin's output bus
+    plugin->context->setParentWindow(gui->window);
+    plugin->context->retain(); // Released by runBalatro
+    plugin->host->retain();
+    plugin->loopback->retain();
+
+    gui->balatroThread = CreateThread(NULL, 0, runBalatro, plugin->context, 0, NULL);
 
     return gui;
 }
@@ -725,8 +766,16 @@ void* cplug_createGUI(void* userPlugin)
 void destroyGUI(void* userGUI)
 {
     MyGUI* gui       = (MyGUI*)userGUI;
-    if (gui->balatroThread && gui->window) {
-        SendMessage((HWND)gui->window, WM_CLOSE, 0, 0);
+    if (gui->balatroThread) {
+        // Let love.quit run and the Lua state close before the plugin goes away. If the game doesn't stop in time,
+        // leave it running: it holds its own references to everything it uses, but its code lives in this DLL, so
+        // pin the module to keep the host from unloading it underneath the thread.
+        gui->plugin->host->requestQuit();
+        if (WaitForSingleObject((HANDLE)gui->balatroThread, 5000) == WAIT_TIMEOUT) {
+            HMODULE hm = NULL;
+            GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN, (LPCSTR)&runlove, &hm);
+        }
+        CloseHandle((HANDLE)gui->balatroThread);
     }
     gui->plugin->gui = NULL;
 
@@ -738,6 +787,9 @@ void destroyGUI(void* userGUI)
     free(gui);
 }
 
+// Closing the editor only suspends the game: cplug_setVisible(false) stops love.run from rendering, and
+// cplug_setParent(NULL) takes our window out of the host's before it gets destroyed. The Lua state, textures and
+// audio stay resident until the plugin itself is destroyed.
 void cplug_destroyGUI(void* userGUI) {}
 
 void cplug_setParent(void* userGUI, void* newParent)
@@ -754,6 +806,10 @@ void cplug_setParent(void* userGUI, void* newParent)
         DefWindowProcA((HWND)gui->window, WM_UPDATEUISTATE, UIS_SET, WS_POPUP);
     }
 
+    // Editor closed: keep the window around, hidden and parentless, until it's reattached
+    if (newParent == NULL)
+        return;
+
     SetParent((HWND)gui->window, (HWND)newParent);
     memcpy(gui->plugin->paramValuesMain, gui->plugin->paramValuesAudio, sizeof(gui->plugin->paramValuesMain));
     DefWindowProcA((HWND)gui->window, WM_UPDATEUISTATE, UIS_CLEAR, WS_POPUP);
@@ -766,6 +822,9 @@ void cplug_setVisible(void* userGUI, bool visible)
 {
     MyGUI* gui = (MyGUI*)userGUI;
     ShowWindow((HWND)gui->window, visible ? SW_SHOW : SW_HIDE);
+
+    // Stops love.run from rendering while nobody can see it
+    gui->plugin->host->setVisible(visible);
 }
 
 void cplug_setScaleFactor(void* userGUI, float scale)
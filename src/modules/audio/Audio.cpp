@@ -20,6 +20,7 @@
 
 #include "Audio.h"
 #include "common/config.h"
+#include "common/EngineContext.h"
 
 #if defined(LOVE_IOS)
 #include "common/ios.h"
@@ -34,6 +35,16 @@ namespace audio
 
 static bool requestRecPermission = false;
 
+void setBackend(const std::string &name)
+{
+	EngineContext::getCurrent()->setAudioBackend(name);
+}
+
+const std::string &getBackend()
+{
+	return EngineContext::getCurrent()->getAudioBackend();
+}
+
 void setRequestRecordingPermission(bool rec)
 {
 	requestRecPermission = rec;
@@ -70,6 +81,7 @@ void showRecordingPermissionMissingDialog()
 
 Audio::Audio(const char *name)
 	: Module(M_AUDIO, name)
+	, loadResampling(true)
 {}
 
 bool Audio::setMixWithSystem(bool mix)
@@ -87,6 +99,67 @@ void Audio::setPlaybackDevice(const char */*name*/)
 	throw love::Exception("Re-setting output device is not supported.");
 }
 
+bool Audio::isFloatSupported() const
+{
+	return false;
+}
+
+void Audio::setStreamReadAhead(int /*chunks*/)
+{
+}
+
+int Audio::getStreamReadAhead() const
+{
+	return 0;
+}
+
+int Audio::getOutputSampleRate() const
+{
+	return 0;
+}
+
+void Audio::setLoadResamplingEnabled(bool enable)
+{
+	loadResampling = enable;
+}
+
+bool Audio::isLoadResamplingEnabled() const
+{
+	return loadResampling;
+}
+
+Source *Audio::newCachedSource(uint64 /*key*/)
+{
+	return nullptr;
+}
+
+Source *Audio::newSource(love::sound::SoundData *soundData, uint64 /*key*/)
+{
+	return newSource(soundData);
+}
+
+void Audio::setCacheLimit(int64 /*bytes*/)
+{
+}
+
+int64 Audio::getCacheLimit() const
+{
+	return 0;
+}
+
+Audio::CacheStats Audio::getCacheStats() const
+{
+	CacheStats stats = {};
+	return stats;
+}
+
+Audio::Stats Audio::getStats() const
+{
+	Stats stats = {};
+	stats.activeSources = getActiveSourceCount();
+	return stats;
+}
+
 StringMap<Audio::DistanceModel, Audio::DISTANCE_MAX_ENUM>::Entry Audio::distanceModelEntries[] =
 {
 	{"none", Audio::DISTANCE_NONE},
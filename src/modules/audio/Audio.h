@@ -23,10 +23,12 @@
 
 // STL
 #include <vector>
+#include <string>
 
 // LOVE
 #include "common/Module.h"
 #include "common/StringMap.h"
+#include "common/int.h"
 #include "Source.h"
 #include "Effect.h"
 #include "RecordingDevice.h"
@@ -73,6 +75,14 @@ void requestRecordingPermission();
  */
 void showRecordingPermissionMissingDialog();
 
+/**
+ * Sets the backend love.audio tries first when it's loaded in the current
+ * EngineContext: "openal" (the default), "soft" or "null". The others are
+ * tried if it can't be opened.
+ */
+void setBackend(const std::string &name);
+const std::string &getBackend();
+
 /**
  * The Audio module is responsible for playing back raw sound samples.
  **/
@@ -95,6 +105,43 @@ class Audio : public Module
 		DISTANCE_MAX_ENUM
 	};
 
+	/**
+	 * Counters of the cache static Sources share their audio through.
+	 **/
+	struct CacheStats
+	{
+		int64 hits;
+		int64 misses;
+		int64 evictions;
+		int entries;
+		int64 size;
+		int64 limit;
+	};
+
+	/**
+	 * Counters of the work done by the audio engine since it was created.
+	 * Times are in microseconds.
+	 **/
+	struct Stats
+	{
+		int activeSources;
+		int virtualSources;
+
+		// Totals of the per-Source counters, including stopped Sources.
+		Source::Stats sources;
+
+		// Time spent waiting for the lock guarding playing Sources, and time
+		// it was held while servicing them.
+		int64 lockWaitTime;
+		int64 lockHoldTime;
+
+		// Streaming decoders which are still alive.
+		int prefetchers;
+
+		// Streaming and queueable Sources which are currently playing.
+		std::vector<StrongRef<Source>> streams;
+	};
+
 	static bool getConstant(const char *in, DistanceModel &out);
 	static bool getConstant(DistanceModel in, const char  *&out);
 	static std::vector<std::string> getConstants(DistanceModel);
@@ -105,6 +152,18 @@ class Audio : public Module
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a static Source from the cache, keyed by a hash of the encoded
+	 * data its audio was decoded from.
+	 * @return A new Source, or null if the key isn't cached.
+	 **/
+	virtual Source *newCachedSource(uint64 key);
+
+	/**
+	 * Creates a static Source and caches its audio under the given key.
+	 **/
+	virtual Source *newSource(love::sound::SoundData *soundData, uint64 key);
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -309,12 +368,51 @@ class Audio : public Module
 	 */
 	virtual void setPlaybackDevice(const char *name);
 
+	/**
+	 * Whether Sources can play 32-bit float samples, which lets streams be
+	 * decoded to floats instead of being converted to integers and back.
+	 **/
+	virtual bool isFloatSupported() const;
+
+	/**
+	 * Sets how many chunks of each streaming Source are decoded ahead of
+	 * playback on worker threads. 0 decodes on demand. Only affects Sources
+	 * created afterwards.
+	 **/
+	virtual void setStreamReadAhead(int chunks);
+	virtual int getStreamReadAhead() const;
+
+	/**
+	 * Sets the memory budget in bytes of the cache shared by static Sources.
+	 * 0 disables the cache.
+	 **/
+	/**
+	 * Gets the sample rate the backend mixes at, or 0 if it isn't known.
+	 **/
+	virtual int getOutputSampleRate() const;
+
+	/**
+	 * Sets whether Sources created from files are resampled to the output
+	 * sample rate when they're loaded, so the backend doesn't resample them
+	 * while they play. Only affects Sources created afterwards.
+	 **/
+	void setLoadResamplingEnabled(bool enable);
+	bool isLoadResamplingEnabled() const;
+
+	virtual void setCacheLimit(int64 bytes);
+	virtual int64 getCacheLimit() const;
+	virtual CacheStats getCacheStats() const;
+
+	virtual Stats getStats() const;
+
 protected:
 
 	Audio(const char *name);
 
 private:
 
+	bool loadResampling;
+
 	static StringMap<DistanceModel, DISTANCE_MAX_ENUM>::Entry distanceModelEntries[];
 	static StringMap<DistanceModel, DISTANCE_MAX_ENUM> distanceModels;
 }; // Audio
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LoopbackOutput.h"
+#include "common/EngineContext.h"
+#include "common/delay.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace audio
+{
+
+void setLoopbackOutput(LoopbackOutput *output)
+{
+	EngineContext::getCurrent()->setLoopbackOutput(output);
+}
+
+LoopbackOutput *getLoopbackOutput()
+{
+	return EngineContext::getCurrent()->getLoopbackOutput();
+}
+
+LoopbackOutput::LoopbackOutput(int sampleRate, int frames)
+	: capacity(1)
+	, sampleRate(sampleRate)
+	, depth(0)
+	, underruns(0)
+	, underrunFrames(0)
+	, overruns(0)
+	, overrunFrames(0)
+	, writePos(0)
+	, readPos(0)
+	, writeLimit(SIZE_MAX)
+	, renderer(nullptr)
+	, renderSerial(0)
+{
+	while (capacity < (size_t) std::max(frames, 1))
+		capacity <<= 1;
+
+	mask = capacity - 1;
+	data.resize(capacity * CHANNELS, 0.0f);
+
+	setDepth(DEFAULT_DEPTH);
+}
+
+LoopbackOutput::~LoopbackOutput()
+{
+}
+
+void LoopbackOutput::setSampleRate(int sampleRate)
+{
+	this->sampleRate.store(sampleRate);
+}
+
+int LoopbackOutput::getSampleRate() const
+{
+	return sampleRate.load();
+}
+
+int LoopbackOutput::getCapacity() const
+{
+	return (int) capacity;
+}
+
+void LoopbackOutput::setDepth(int frames)
+{
+	depth.store(std::max(std::min(frames, (int) capacity), 1));
+}
+
+int LoopbackOutput::getDepth() const
+{
+	return depth.load();
+}
+
+int LoopbackOutput::getLatency() const
+{
+	return hasRenderer() ? 0 : getDepth();
+}
+
+void LoopbackOutput::setWriteAhead(int frames)
+{
+	if (frames < 0)
+		writeLimit.store(SIZE_MAX, std::memory_order_release);
+	else
+		writeLimit.store(readPos.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+}
+
+LoopbackOutput::Stats LoopbackOutput::getStats() const
+{
+	Stats stats;
+	stats.underruns = underruns.load(std::memory_order_relaxed);
+	stats.underrunFrames = underrunFrames.load(std::memory_order_relaxed);
+	stats.overruns = overruns.load(std::memory_order_relaxed);
+	stats.overrunFrames = overrunFrames.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void LoopbackOutput::resetStats()
+{
+	underruns.store(0, std::memory_order_relaxed);
+	underrunFrames.store(0, std::memory_order_relaxed);
+	overruns.store(0, std::memory_order_relaxed);
+	overrunFrames.store(0, std::memory_order_relaxed);
+}
+
+int LoopbackOutput::getReadableCount() const
+{
+	return (int) (writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_acquire));
+}
+
+int LoopbackOutput::getWriteRegion(float *&dst)
+{
+	size_t w = writePos.load(std::memory_order_relaxed);
+	size_t r = readPos.load(std::memory_order_acquire);
+
+	size_t index = w & mask;
+	size_t used = w - r;
+	size_t limit = (size_t) depth.load(std::memory_order_relaxed);
+	size_t free = used < limit ? limit - used : 0;
+
+	size_t ahead = writeLimit.load(std::memory_order_acquire);
+	free = std::min(free, ahead > w ? ahead - w : 0);
+
+	dst = &data[index * CHANNELS];
+	return (int) std::min(free, capacity - index);
+}
+
+void LoopbackOutput::commitWrite(int frames)
+{
+	size_t w = writePos.load(std::memory_order_relaxed);
+	writePos.store(w + frames, std::memory_order_release);
+}
+
+void LoopbackOutput::setRenderer(Renderer *renderer)
+{
+	this->renderer.store(renderer, std::memory_order_seq_cst);
+
+	// A render which started before the store may still be using the old
+	// Renderer. Any render starting after it sees the new one.
+	uint32 serial = renderSerial.load(std::memory_order_seq_cst);
+	if ((serial & 1) != 0)
+	{
+		while (renderSerial.load(std::memory_order_acquire) == serial)
+			love::sleep(0);
+	}
+}
+
+bool LoopbackOutput::hasRenderer() const
+{
+	return renderer.load() != nullptr;
+}
+
+bool LoopbackOutput::waitForReadable(int frames, int timeoutMS)
+{
+	// A Renderer produces frames on demand.
+	if (hasRenderer())
+		return true;
+
+	frames = std::min(frames, getDepth());
+
+	// The producer never signals, so poll at a fraction of a render chunk.
+	const double interval = 0.1;
+	for (double waited = 0.0; getReadableCount() < frames; waited += interval)
+	{
+		if (waited >= timeoutMS)
+			return false;
+		love::sleep(interval);
+	}
+
+	return true;
+}
+
+int LoopbackOutput::read(float * const *out, int offset, int frames)
+{
+	if (renderer.load(std::memory_order_relaxed) != nullptr)
+	{
+		renderSerial.fetch_add(1, std::memory_order_seq_cst);
+		Renderer *r = renderer.load(std::memory_order_seq_cst);
+		if (r != nullptr)
+			r->render(out, offset, frames, getSampleRate());
+		renderSerial.fetch_add(1, std::memory_order_release);
+
+		if (r != nullptr)
+			return frames;
+	}
+
+	size_t r = readPos.load(std::memory_order_relaxed);
+	size_t w = writePos.load(std::memory_order_acquire);
+
+	// Never let more than the depth build up, so the latency stays what we
+	// reported to the host.
+	size_t limit = (size_t) depth.load(std::memory_order_relaxed);
+	if (w - r > limit)
+	{
+		overruns.fetch_add(1, std::memory_order_relaxed);
+		overrunFrames.fetch_add(w - r - limit, std::memory_order_relaxed);
+		r = w - limit;
+	}
+
+	int count = (int) std::min(w - r, (size_t) std::max(frames, 0));
+
+	// Nothing is written until love.audio starts, which isn't an underrun.
+	if (count < frames && w > 0)
+	{
+		underruns.fetch_add(1, std::memory_order_relaxed);
+		underrunFrames.fetch_add(frames - count, std::memory_order_relaxed);
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		const float *frame = &data[((r + i) & mask) * CHANNELS];
+		for (int c = 0; c < CHANNELS; c++)
+			out[c][offset + i] = frame[c];
+	}
+
+	// Underrun: pad with silence rather than stalling the host.
+	for (int c = 0; c < CHANNELS; c++)
+		std::fill(out[c] + offset + count, out[c] + offset + frames, 0.0f);
+
+	readPos.store(r + count, std::memory_order_release);
+	return count;
+}
+
+} // audio
+} // love
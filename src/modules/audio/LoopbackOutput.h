@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_LOOPBACK_OUTPUT_H
+#define LOVE_AUDIO_LOOPBACK_OUTPUT_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/int.h"
+
+// C++
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+namespace love
+{
+namespace audio
+{
+
+/**
+ * Single-producer single-consumer ring buffer of interleaved stereo float
+ * frames. The audio backend renders its mix into it, and a host (e.g. a
+ * plugin's process callback) pulls the frames out on its own audio thread.
+ * Neither side ever blocks or allocates.
+ **/
+class LoopbackOutput : public love::Object
+{
+public:
+
+	static const int CHANNELS = 2;
+	static const int DEFAULT_CAPACITY = 16384;
+	static const int DEFAULT_DEPTH = 4096;
+
+	/**
+	 * A mixer which renders straight into the consumer's buffers on the
+	 * consumer's thread, bypassing the ring.
+	 **/
+	class Renderer
+	{
+	public:
+		virtual ~Renderer() {}
+
+		/**
+		 * Renders 'frames' frames into non-interleaved output buffers,
+		 * starting at frame 'offset'.
+		 **/
+		virtual void render(float * const *out, int offset, int frames, int sampleRate) = 0;
+	};
+
+	struct Stats
+	{
+		// Reads which found fewer frames than requested, and the number of
+		// frames replaced by silence as a result.
+		uint64 underruns;
+		uint64 underrunFrames;
+
+		// Reads which found more than the depth buffered (e.g. after the depth
+		// was lowered), and the number of frames dropped to get back to it.
+		uint64 overruns;
+		uint64 overrunFrames;
+	};
+
+	/**
+	 * @param sampleRate The rate the host consumes frames at.
+	 * @param capacity Capacity of the ring, rounded up to a power of two.
+	 **/
+	LoopbackOutput(int sampleRate, int capacity = DEFAULT_CAPACITY);
+	virtual ~LoopbackOutput();
+
+	void setSampleRate(int sampleRate);
+	int getSampleRate() const;
+
+	/**
+	 * Gets the total capacity of the ring, in frames.
+	 **/
+	int getCapacity() const;
+
+	/**
+	 * Sets how many frames the producer keeps buffered ahead of the consumer,
+	 * which is the latency the ring adds. Clamped to the capacity.
+	 **/
+	void setDepth(int frames);
+	int getDepth() const;
+
+	/**
+	 * Gets the latency the output adds, in frames: the depth, or 0 when a
+	 * Renderer produces the frames on demand.
+	 **/
+	int getLatency() const;
+
+	/**
+	 * Lets the producer write at most 'frames' frames past what has been read
+	 * so far, or removes the limit when negative. Hosts which drive the game
+	 * clock use this to keep the mix from running ahead of the game ticks it
+	 * depends on. Call it from the consumer side.
+	 **/
+	void setWriteAhead(int frames);
+
+	Stats getStats() const;
+	void resetStats();
+
+	/**
+	 * Gets the number of frames currently waiting to be read.
+	 **/
+	int getReadableCount() const;
+
+	/**
+	 * Makes read() pull from the given Renderer instead of the ring, or go
+	 * back to the ring when null. Returns once a render in progress is done,
+	 * so the previous Renderer can be destroyed afterwards. This may wait on
+	 * the consumer; read() never waits on it.
+	 **/
+	void setRenderer(Renderer *renderer);
+	bool hasRenderer() const;
+
+	/**
+	 * Producer side. Gets the largest region which can be written without
+	 * wrapping around the end of the ring, or exceeding the depth or the
+	 * write-ahead limit.
+	 * @param dst Receives a pointer to the first interleaved frame.
+	 * @return The number of frames which can be written to dst.
+	 **/
+	int getWriteRegion(float *&dst);
+
+	/**
+	 * Producer side. Publishes frames written through getWriteRegion.
+	 **/
+	void commitWrite(int frames);
+
+	/**
+	 * Consumer side. Deinterleaves up to 'frames' frames into the given
+	 * channel buffers and fills whatever could not be read with silence.
+	 * @param out Array of CHANNELS non-interleaved output buffers.
+	 * @param offset First frame in the output buffers to write to.
+	 * @param frames Number of frames to write.
+	 * @return The number of frames actually read from the ring.
+	 **/
+	int read(float * const *out, int offset, int frames);
+
+	/**
+	 * Consumer side. Waits until at least 'frames' frames can be read, for
+	 * hosts which don't consume in real time (e.g. offline rendering).
+	 * @return False if they didn't arrive within the timeout.
+	 **/
+	bool waitForReadable(int frames, int timeoutMS);
+
+private:
+
+	std::vector<float> data;
+	size_t capacity;
+	size_t mask;
+
+	std::atomic<int> sampleRate;
+	std::atomic<int> depth;
+
+	std::atomic<uint64> underruns;
+	std::atomic<uint64> underrunFrames;
+	std::atomic<uint64> overruns;
+	std::atomic<uint64> overrunFrames;
+
+	// Monotonic frame counters. Only the producer writes writePos and only
+	// the consumer writes readPos.
+	std::atomic<size_t> writePos;
+	std::atomic<size_t> readPos;
+
+	// Position the producer may write up to, or SIZE_MAX when unlimited.
+	std::atomic<size_t> writeLimit;
+
+	// The consumer bumps renderSerial before and after using the renderer, so
+	// it's odd while a render is in progress. setRenderer waits for that
+	// render to finish instead of the consumer ever taking a lock.
+	std::atomic<Renderer *> renderer;
+	std::atomic<uint32> renderSerial;
+
+}; // LoopbackOutput
+
+/**
+ * When set on the current EngineContext before love.audio is loaded, the
+ * audio backend mixes into the given output instead of opening a playback
+ * device.
+ **/
+void setLoopbackOutput(LoopbackOutput *output);
+LoopbackOutput *getLoopbackOutput();
+
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_LOOPBACK_OUTPUT_H
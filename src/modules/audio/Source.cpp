@@ -29,9 +29,24 @@ love::Type Source::type("Source", &Object::type);
 
 Source::Source(Type sourceType)
 	: sourceType(sourceType)
+	, priority(0)
+	, nextBlock(0)
 {
 }
 
+Source::Source(const Source &s)
+	: Object(s)
+	, sourceType(s.sourceType)
+	, priority(s.priority)
+	, nextBlock(0)
+{
+	if (!s.freeBlocks.empty())
+	{
+		love::sound::SoundData *b = s.freeBlocks[0].get();
+		allocateBlocks((int) s.freeBlocks.size(), b->getSampleCount(), b->getSampleRate(), b->getBitDepth(), b->getChannelCount());
+	}
+}
+
 Source::~Source()
 {
 }
@@ -41,6 +56,67 @@ Source::Type Source::getType() const
 	return sourceType;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+bool Source::isVirtual() const
+{
+	return false;
+}
+
+Source::Stats Source::getStats() const
+{
+	Stats stats = {};
+	return stats;
+}
+
+bool Source::queue(love::sound::SoundData *data, size_t offset, size_t length)
+{
+	return queue((uint8 *) data->getData() + offset, length,
+	             data->getSampleRate(), data->getBitDepth(), data->getChannelCount());
+}
+
+bool Source::isQueued(const love::sound::SoundData *) const
+{
+	return false;
+}
+
+void Source::allocateBlocks(int count, int samples, int sampleRate, int bitDepth, int channels)
+{
+	freeBlocks.clear();
+	nextBlock = 0;
+
+	for (int i = 0; i < count; i++)
+		freeBlocks.emplace_back(new love::sound::SoundData(samples, sampleRate, bitDepth, channels), Acquire::NORETAIN);
+}
+
+love::sound::SoundData *Source::getFreeBlock()
+{
+	if (freeBlocks.empty() || getFreeBufferCount() <= 0)
+		return nullptr;
+
+	// Blocks are played in the order they're queued, so the one after the
+	// last block handed out is usually the first to be free again.
+	for (size_t i = 0; i < freeBlocks.size(); i++)
+	{
+		size_t index = (nextBlock + i) % freeBlocks.size();
+		if (!isQueued(freeBlocks[index].get()))
+		{
+			nextBlock = (index + 1) % freeBlocks.size();
+			return freeBlocks[index].get();
+		}
+	}
+
+	return nullptr;
+}
+
 bool Source::getConstant(const char *in, Type &out)
 {
 	return types.find(in, out);
@@ -24,6 +24,8 @@
 // LOVE
 #include "common/Object.h"
 #include "common/StringMap.h"
+#include "common/int.h"
+#include "sound/SoundData.h"
 #include "Filter.h"
 
 #include <vector>
@@ -54,6 +56,19 @@ class Source : public Object
 		UNIT_MAX_ENUM
 	};
 
+	/**
+	 * Counters of the work done to play a streaming or queueable Source.
+	 * Times are in microseconds.
+	 **/
+	struct Stats
+	{
+		int64 decodeTime;
+		int64 buffersQueued;
+		int64 buffersProcessed;
+		int64 underruns;
+		int64 bytesUploaded;
+	};
+
 	Source(Type type);
 	virtual ~Source();
 
@@ -122,8 +137,37 @@ class Source : public Object
 	virtual int getFreeBufferCount() const = 0;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels) = 0;
 
+	/**
+	 * Queues part of a SoundData. Backends which can play it in place keep a
+	 * reference to it instead of copying it, so it must not be modified
+	 * while isQueued returns true.
+	 **/
+	virtual bool queue(love::sound::SoundData *data, size_t offset, size_t length);
+	virtual bool isQueued(const love::sound::SoundData *data) const;
+
+	/**
+	 * Allocates reusable SoundData blocks for a queueable Source, so
+	 * generated audio doesn't need a new SoundData per chunk.
+	 **/
+	void allocateBlocks(int count, int samples, int sampleRate, int bitDepth, int channels);
+
+	// Gets the next block which isn't queued, or null if there's none or
+	// no more data can be queued.
+	love::sound::SoundData *getFreeBlock();
+
 	virtual Type getType() const;
 
+	// Sources with a higher priority keep their voice when more Sources are
+	// playing than the backend can mix at once.
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+
+	// Whether this Source is playing without being mixed, because higher
+	// priority or louder Sources are using every available voice.
+	virtual bool isVirtual() const;
+
+	virtual Stats getStats() const;
+
 	static bool getConstant(const char *in, Type &out);
 	static bool getConstant(Type in, const char  *&out);
 	static std::vector<std::string> getConstants(Type);
@@ -134,6 +178,14 @@ class Source : public Object
 protected:
 
 	Type sourceType;
+	int priority;
+
+	// Copies the type and priority. Clones get their own free blocks of the
+	// same size, as a block can't be queued on two Sources at once.
+	Source(const Source &s);
+
+	std::vector<StrongRef<love::sound::SoundData>> freeBlocks;
+	size_t nextBlock;
 
 private:
 
@@ -23,6 +23,7 @@
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -61,12 +62,82 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		// Sleep until the next Source runs low on queued audio, or until
+		// something changes its schedule.
+		double timeout = pool->update();
+		pool->waitForWork(timeout);
 	}
 }
 
 void Audio::PoolThread::setFinish()
+{
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+	pool->wake();
+}
+
+Audio::LoopbackThread::LoopbackThread(ALCdevice *device, LoopbackOutput *output, const std::vector<ALCint> &attribs)
+	: device(device)
+	, output(output)
+	, attribs(attribs)
+	, finish(false)
+{
+	threadName = "AudioLoopback";
+
+	alcRenderSamplesSOFT = (LPALCRENDERSAMPLESSOFT) alcGetProcAddress(device, "alcRenderSamplesSOFT");
+	alcResetDeviceSOFT = alcIsExtensionPresent(device, "ALC_SOFT_HRTF") == ALC_TRUE
+		? (LPALCRESETDEVICESOFT) alcGetProcAddress(device, "alcResetDeviceSOFT")
+		: nullptr;
+}
+
+Audio::LoopbackThread::~LoopbackThread()
+{
+}
+
+void Audio::LoopbackThread::threadFunction()
+{
+	int sampleRate = output->getSampleRate();
+
+	while (true)
+	{
+		{
+			thread::Lock lock(mutex);
+			if (finish)
+				return;
+		}
+
+		// The host may change its sample rate while we're running.
+		if (output->getSampleRate() != sampleRate && alcResetDeviceSOFT != nullptr)
+		{
+			sampleRate = output->getSampleRate();
+
+			for (size_t i = 0; i + 1 < attribs.size(); i += 2)
+			{
+				if (attribs[i] == ALC_FREQUENCY)
+					attribs[i + 1] = sampleRate;
+			}
+
+			alcResetDeviceSOFT(device, attribs.data());
+		}
+
+		// Render straight into the ring until it's full. The host's pull rate
+		// is what paces the mixer.
+		float *dst = nullptr;
+		int frames = 0;
+		while ((frames = output->getWriteRegion(dst)) > 0)
+		{
+			frames = std::min(frames, (int) RENDER_FRAMES);
+			alcRenderSamplesSOFT(device, dst, frames);
+			output->commitWrite(frames);
+		}
+
+		sleep(1);
+	}
+}
+
+void Audio::LoopbackThread::setFinish()
 {
 	thread::Lock lock(mutex);
 	finish = true;
@@ -74,6 +145,29 @@ void Audio::PoolThread::setFinish()
 
 ALenum Audio::getFormat(int bitDepth, int channels)
 {
+	if (bitDepth == 32)
+	{
+#ifdef AL_EXT_float32
+		if (alIsExtensionPresent("AL_EXT_FLOAT32"))
+		{
+			if (channels == 1)
+				return AL_FORMAT_MONO_FLOAT32;
+			else if (channels == 2)
+				return AL_FORMAT_STEREO_FLOAT32;
+#ifdef AL_EXT_MCFORMATS
+			else if (alIsExtensionPresent("AL_EXT_MCFORMATS"))
+			{
+				if (channels == 6)
+					return AL_FORMAT_51CHN32;
+				else if (channels == 8)
+					return AL_FORMAT_71CHN32;
+			}
+#endif
+		}
+#endif
+		return AL_NONE;
+	}
+
 	if (bitDepth != 8 && bitDepth != 16)
 		return AL_NONE;
 
@@ -111,6 +205,9 @@ Audio::Audio()
 	, context(nullptr)
 	, pool(nullptr)
 	, poolThread(nullptr)
+	, bufferCache(nullptr)
+	, loopback(getLoopbackOutput())
+	, loopbackThread(nullptr)
 	, distanceModel(DISTANCE_INVERSE_CLAMPED)
 {
 	attribs.push_back(0);
@@ -131,8 +228,13 @@ Audio::Audio()
 		love::thread::ScopedDisableSignals disableSignals;
 #endif
 
-		// Passing null for default device.
-		device = alcOpenDevice(nullptr);
+		if (loopback.get() != nullptr)
+			device = openLoopbackDevice(loopback.get());
+		else
+		{
+			// Passing null for default device.
+			device = alcOpenDevice(nullptr);
+		}
 
 		if (device == nullptr)
 			throw love::Exception("Could not open device.");
@@ -151,6 +253,10 @@ Audio::Audio()
 			throw love::Exception("Could not make context current: %s", alcGetString(device, alcGetError(device)));
 	}
 
+	alBufferCallbackSOFT = alIsExtensionPresent("AL_SOFT_callback_buffer") == AL_TRUE
+		? (LPALBUFFERCALLBACKSOFT) alGetProcAddress("alBufferCallbackSOFT")
+		: nullptr;
+
 #ifdef ALC_EXT_EFX
 	initializeEFX();
 
@@ -206,6 +312,15 @@ Audio::Audio()
 
 	poolThread = new PoolThread(pool);
 	poolThread->start();
+
+	decodeWorkers.set(new DecodeWorkers(DecodeWorkers::getDefaultThreadCount()), Acquire::NORETAIN);
+	bufferCache = new BufferCache();
+
+	if (loopback.get() != nullptr)
+	{
+		loopbackThread = new LoopbackThread(device, loopback.get(), attribs);
+		loopbackThread->start();
+	}
 	
 #ifdef LOVE_IOS
 	love::ios::initAudioSessionInterruptionHandler();
@@ -227,12 +342,26 @@ Audio::~Audio()
 #ifdef LOVE_IOS
 	love::ios::destroyAudioSessionInterruptionHandler();
 #endif
+	if (loopbackThread)
+	{
+		loopbackThread->setFinish();
+		loopbackThread->wait();
+		delete loopbackThread;
+	}
+
 	poolThread->setFinish();
 	poolThread->wait();
 
 	delete poolThread;
 	delete pool;
 
+	// Sources may outlive the module; their Prefetchers keep the (stopped)
+	// workers alive and decode on demand from then on.
+	decodeWorkers->stop();
+
+	// The cached buffers need the context to be deleted.
+	delete bufferCache;
+
 	for (auto c : capture)
 		delete c;
 
@@ -257,6 +386,42 @@ Audio::~Audio()
 	alcCloseDevice(device);
 }
 
+ALCdevice *Audio::openLoopbackDevice(LoopbackOutput *output)
+{
+#ifdef ALC_SOFT_loopback
+	if (alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback") != ALC_TRUE)
+		throw love::Exception("Could not open loopback device: ALC_SOFT_loopback is not supported.");
+
+	auto alcLoopbackOpenDeviceSOFT = (LPALCLOOPBACKOPENDEVICESOFT) alcGetProcAddress(nullptr, "alcLoopbackOpenDeviceSOFT");
+	auto alcIsRenderFormatSupportedSOFT = (LPALCISRENDERFORMATSUPPORTEDSOFT) alcGetProcAddress(nullptr, "alcIsRenderFormatSupportedSOFT");
+
+	ALCdevice *loopbackDevice = alcLoopbackOpenDeviceSOFT(nullptr);
+	if (loopbackDevice == nullptr)
+		return nullptr;
+
+	ALCint sampleRate = output->getSampleRate();
+	if (!alcIsRenderFormatSupportedSOFT(loopbackDevice, sampleRate, ALC_STEREO_SOFT, ALC_FLOAT_SOFT))
+	{
+		alcCloseDevice(loopbackDevice);
+		throw love::Exception("Could not open loopback device: unsupported render format (%d Hz).", sampleRate);
+	}
+
+	// The render format is part of the context attributes for loopback
+	// devices. The trailing zero pair is kept at the end.
+	ALCint format[] = {
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+		ALC_FREQUENCY, sampleRate,
+	};
+	attribs.insert(attribs.begin(), std::begin(format), std::end(format));
+
+	return loopbackDevice;
+#else
+	LOVE_UNUSED(output);
+	throw love::Exception("Could not open loopback device: ALC_SOFT_loopback is not supported.");
+#endif
+}
+
 love::audio::Source *Audio::newSource(love::sound::Decoder *decoder)
 {
 	return new Source(pool, decoder);
@@ -264,7 +429,36 @@ love::audio::Source *Audio::newSource(love::sound::Decoder *decoder)
 
 love::audio::Source *Audio::newSource(love::sound::SoundData *soundData)
 {
-	return new Source(pool, soundData);
+	uint64 key = BufferCache::getKey(soundData);
+
+	love::audio::Source *source = newCachedSource(key);
+	if (source == nullptr)
+		source = newSource(soundData, key);
+
+	return source;
+}
+
+love::audio::Source *Audio::newCachedSource(uint64 key)
+{
+	BufferCache::Entry entry;
+	if (!bufferCache->find(key, entry))
+		return nullptr;
+
+	return new Source(pool, entry.buffer.get(), entry.sampleRate, entry.bitDepth, entry.channels);
+}
+
+love::audio::Source *Audio::newSource(love::sound::SoundData *soundData, uint64 key)
+{
+	Source *source = new Source(pool, soundData);
+
+	BufferCache::Entry entry;
+	entry.buffer.set(source->getStaticBuffer());
+	entry.sampleRate = soundData->getSampleRate();
+	entry.bitDepth = soundData->getBitDepth();
+	entry.channels = soundData->getChannelCount();
+	bufferCache->insert(key, entry);
+
+	return source;
 }
 
 love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels, int buffers)
@@ -388,6 +582,14 @@ void Audio::getPlaybackDevices(std::vector<std::string> &list)
 
 void Audio::setPlaybackDevice(const char* name)
 {
+	// There is no playback device to switch when mixing into a loopback
+	// buffer.
+	if (loopback.get() != nullptr)
+	{
+		love::audio::Audio::setPlaybackDevice(name);
+		return;
+	}
+
 #ifndef ALC_SOFT_reopen_device
 	typedef ALCboolean (ALC_APIENTRY*LPALCREOPENDEVICESOFT)(ALCdevice *device,
 		const ALCchar *deviceName, const ALCint *attribs);
@@ -408,6 +610,69 @@ void Audio::setPlaybackDevice(const char* name)
 		throw love::Exception("Cannot set output device: %s", alcGetString(device, alcGetError(device)));
 }
 
+void Audio::setCacheLimit(int64 bytes)
+{
+	bufferCache->setLimit(bytes);
+}
+
+int64 Audio::getCacheLimit() const
+{
+	return bufferCache->getLimit();
+}
+
+Audio::CacheStats Audio::getCacheStats() const
+{
+	return bufferCache->getStats();
+}
+
+Audio::Stats Audio::getStats() const
+{
+	Stats stats = {};
+	pool->getStats(stats);
+	stats.prefetchers = decodeWorkers->getPrefetcherCount();
+	return stats;
+}
+
+void Audio::setStreamReadAhead(int chunks)
+{
+	decodeWorkers->setReadAhead(chunks);
+}
+
+int Audio::getStreamReadAhead() const
+{
+	return decodeWorkers->getReadAhead();
+}
+
+bool Audio::isFloatSupported() const
+{
+	return getFormat(32, 1) != AL_NONE;
+}
+
+int Audio::getOutputSampleRate() const
+{
+	if (loopback.get() != nullptr)
+		return loopback->getSampleRate();
+
+	ALCint frequency = 0;
+	alcGetIntegerv(device, ALC_FREQUENCY, 1, &frequency);
+	return frequency;
+}
+
+double Audio::getOutputBufferSeconds() const
+{
+	if (loopback.get() != nullptr)
+		return loopback->getDepth() / (double) std::max(loopback->getSampleRate(), 1);
+
+	ALCint refresh = 0;
+	alcGetIntegerv(device, ALC_REFRESH, 1, &refresh);
+	return 1.0 / (refresh > 0 ? refresh : 50);
+}
+
+Prefetcher *Audio::newPrefetcher(love::sound::Decoder *decoder)
+{
+	return new Prefetcher(decodeWorkers, decoder, decodeWorkers->getReadAhead());
+}
+
 void Audio::setVolume(float volume)
 {
 	alListenerf(AL_GAIN, volume);
@@ -717,6 +982,8 @@ bool Audio::getEffectID(const char *name, ALuint &id)
 	return true;
 }
 
+LPALBUFFERCALLBACKSOFT alBufferCallbackSOFT = nullptr;
+
 #ifdef ALC_EXT_EFX
 LPALGENEFFECTS alGenEffects = nullptr;
 LPALDELETEEFFECTS alDeleteEffects = nullptr;
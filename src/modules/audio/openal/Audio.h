@@ -32,12 +32,15 @@
 #include "audio/Audio.h"
 #include "audio/RecordingDevice.h"
 #include "audio/Filter.h"
+#include "audio/LoopbackOutput.h"
 #include "common/config.h"
 #include "sound/SoundData.h"
 
 #include "Source.h"
 #include "Effect.h"
 #include "Pool.h"
+#include "Prefetcher.h"
+#include "BufferCache.h"
 #include "thread/threads.h"
 
 // OpenAL
@@ -73,7 +76,7 @@ class Audio : public love::audio::Audio
 	 * Gets the OpenAL format identifier based on number of
 	 * channels and bits.
 	 * @param channels.
-	 * @param bitDepth Either 8-bit samples, or 16-bit samples.
+	 * @param bitDepth Either 8-bit or 16-bit integer samples, or 32-bit float samples.
 	 * @return One of AL_FORMAT_*, or AL_NONE if unsupported format.
 	 **/
 	static ALenum getFormat(int bitDepth, int channels);
@@ -82,6 +85,8 @@ class Audio : public love::audio::Audio
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newCachedSource(uint64 key);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, uint64 key);
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 	bool play(love::audio::Source *source);
@@ -128,8 +133,33 @@ class Audio : public love::audio::Audio
 	void getPlaybackDevices(std::vector<std::string> &list);
 	void setPlaybackDevice(const char *name);
 
+	bool isFloatSupported() const;
+	int getOutputSampleRate() const;
+
+	/**
+	 * Gets how much audio the output consumes at a time, in seconds: the
+	 * loopback's depth, or one update period of the playback device.
+	 **/
+	double getOutputBufferSeconds() const;
+
+	void setStreamReadAhead(int chunks);
+	int getStreamReadAhead() const;
+
+	void setCacheLimit(int64 bytes);
+	int64 getCacheLimit() const;
+	CacheStats getCacheStats() const;
+
+	Stats getStats() const;
+
+	/**
+	 * Creates the Prefetcher a streaming Source reads its Decoder through.
+	 **/
+	Prefetcher *newPrefetcher(love::sound::Decoder *decoder);
+
 private:
 	void initializeEFX();
+	ALCdevice *openLoopbackDevice(LoopbackOutput *output);
+
 	// The OpenAL device.
 	ALCdevice *device;
 
@@ -176,6 +206,47 @@ class Audio : public love::audio::Audio
 
 	PoolThread *poolThread;
 
+	// Decodes streaming Sources ahead of the pool thread.
+	StrongRef<DecodeWorkers> decodeWorkers;
+
+	// Shares OpenAL buffers between static Sources with the same audio.
+	BufferCache *bufferCache;
+
+	// Set when mixing into a host-provided buffer through an
+	// ALC_SOFT_loopback device instead of a playback device.
+	StrongRef<LoopbackOutput> loopback;
+
+#ifndef ALC_SOFT_loopback
+	typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESSOFT)(ALCdevice *device, ALCvoid *buffer, ALCsizei samples);
+#endif
+#ifndef ALC_SOFT_HRTF
+	typedef ALCboolean (ALC_APIENTRY*LPALCRESETDEVICESOFT)(ALCdevice *device, const ALCint *attribs);
+#endif
+
+	class LoopbackThread : public thread::Threadable
+	{
+	protected:
+		ALCdevice *device;
+		StrongRef<LoopbackOutput> output;
+		std::vector<ALCint> attribs;
+		LPALCRENDERSAMPLESSOFT alcRenderSamplesSOFT;
+		LPALCRESETDEVICESOFT alcResetDeviceSOFT;
+
+		volatile bool finish;
+		love::thread::MutexRef mutex;
+
+	public:
+		// Largest block rendered with a single alcRenderSamplesSOFT call.
+		static const int RENDER_FRAMES = 256;
+
+		LoopbackThread(ALCdevice *device, LoopbackOutput *output, const std::vector<ALCint> &attribs);
+		virtual ~LoopbackThread();
+		void setFinish();
+		void threadFunction();
+	};
+
+	LoopbackThread *loopbackThread;
+
 	DistanceModel distanceModel;
 	//float metersPerUnit = 1.0;
 
@@ -190,6 +261,14 @@ class Audio : public love::audio::Audio
 #endif
 }; // Audio
 
+#ifndef AL_SOFT_callback_buffer
+typedef ALsizei (AL_APIENTRY*ALBUFFERCALLBACKTYPESOFT)(ALvoid *userptr, ALvoid *sampledata, ALsizei numbytes);
+typedef void (AL_APIENTRY*LPALBUFFERCALLBACKSOFT)(ALuint buffer, ALenum format, ALsizei freq, ALBUFFERCALLBACKTYPESOFT callback, ALvoid *userptr);
+#endif
+
+// Null unless AL_SOFT_callback_buffer is supported.
+extern LPALBUFFERCALLBACKSOFT alBufferCallbackSOFT;
+
 #ifdef ALC_EXT_EFX
  // Effect objects
 extern LPALGENEFFECTS alGenEffects;
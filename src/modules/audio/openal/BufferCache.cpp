@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "BufferCache.h"
+#include "Source.h"
+#include "sound/SoundData.h"
+
+#include "libraries/xxHash/xxhash.h"
+
+// STL
+#include <algorithm>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+BufferCache::BufferCache()
+	: size(0)
+	, limit(DEFAULT_LIMIT)
+	, hits(0)
+	, misses(0)
+	, evictions(0)
+{
+}
+
+BufferCache::~BufferCache()
+{
+}
+
+bool BufferCache::find(uint64 key, Entry &entry)
+{
+	thread::Lock lock(mutex);
+
+	if (limit <= 0)
+		return false;
+
+	auto it = items.find(key);
+	if (it == items.end())
+	{
+		misses++;
+		return false;
+	}
+
+	lru.splice(lru.begin(), lru, it->second.lru);
+	entry = it->second.entry;
+	hits++;
+	return true;
+}
+
+void BufferCache::insert(uint64 key, const Entry &entry)
+{
+	thread::Lock lock(mutex);
+
+	int64 bytes = entry.buffer->getSize();
+	if (bytes > limit || items.find(key) != items.end())
+		return;
+
+	lru.push_front(key);
+	items[key] = {entry, lru.begin()};
+	size += bytes;
+
+	trim();
+}
+
+void BufferCache::setLimit(int64 bytes)
+{
+	thread::Lock lock(mutex);
+	limit = std::max(bytes, (int64) 0);
+	trim();
+}
+
+int64 BufferCache::getLimit() const
+{
+	thread::Lock lock(mutex);
+	return limit;
+}
+
+love::audio::Audio::CacheStats BufferCache::getStats() const
+{
+	thread::Lock lock(mutex);
+
+	love::audio::Audio::CacheStats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.evictions = evictions;
+	stats.entries = (int) items.size();
+	stats.size = size;
+	stats.limit = limit;
+	return stats;
+}
+
+uint64 BufferCache::getKey(love::sound::SoundData *soundData)
+{
+	// Seeded with the format, so identical bytes in different formats (and
+	// encoded files, which are hashed with seed 0) don't collide.
+	uint64 format[] = {
+		(uint64) soundData->getSampleRate(),
+		(uint64) soundData->getBitDepth(),
+		(uint64) soundData->getChannelCount(),
+	};
+	XXH64_hash_t seed = XXH64(format, sizeof(format), 0);
+	return XXH64(soundData->getData(), soundData->getSize(), seed);
+}
+
+void BufferCache::trim()
+{
+	while (size > limit && !lru.empty())
+	{
+		auto it = items.find(lru.back());
+		size -= it->second.entry.buffer->getSize();
+		items.erase(it);
+		lru.pop_back();
+		evictions++;
+	}
+}
+
+} // openal
+} // audio
+} // love
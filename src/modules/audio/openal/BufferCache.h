@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_BUFFER_CACHE_H
+#define LOVE_AUDIO_OPENAL_BUFFER_CACHE_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+#include "audio/Audio.h"
+#include "thread/threads.h"
+
+// STL
+#include <list>
+#include <unordered_map>
+
+namespace love
+{
+namespace sound
+{
+class SoundData;
+}
+
+namespace audio
+{
+namespace openal
+{
+
+class StaticDataBuffer;
+
+/**
+ * Shares the OpenAL buffers of static Sources which were created from the
+ * same content. Entries are keyed by a hash of the data the audio came from
+ * (the encoded file, or the decoded samples), and the least recently used
+ * ones are dropped once the cached buffers exceed a memory limit. Sources
+ * keep using a buffer after it has been dropped from the cache.
+ **/
+class BufferCache
+{
+public:
+
+	struct Entry
+	{
+		StrongRef<StaticDataBuffer> buffer;
+		int sampleRate;
+		int bitDepth;
+		int channels;
+	};
+
+	BufferCache();
+	~BufferCache();
+
+	/**
+	 * Looks up a buffer, marking it as most recently used.
+	 * @return False on a cache miss.
+	 **/
+	bool find(uint64 key, Entry &entry);
+
+	/**
+	 * Adds a buffer and evicts older ones until the cache fits its limit.
+	 * Buffers larger than the limit aren't cached.
+	 **/
+	void insert(uint64 key, const Entry &entry);
+
+	/**
+	 * Sets the maximum total size of cached buffers in bytes. 0 disables the
+	 * cache.
+	 **/
+	void setLimit(int64 bytes);
+	int64 getLimit() const;
+
+	love::audio::Audio::CacheStats getStats() const;
+
+	/**
+	 * Hashes the samples and format of a SoundData.
+	 **/
+	static uint64 getKey(love::sound::SoundData *soundData);
+
+	static const int64 DEFAULT_LIMIT = 64 * 1024 * 1024;
+
+private:
+
+	struct Item
+	{
+		Entry entry;
+		std::list<uint64>::iterator lru;
+	};
+
+	// Evicts least recently used items until the cache fits its limit.
+	// mutex must be held.
+	void trim();
+
+	std::unordered_map<uint64, Item> items;
+
+	// Most recently used first.
+	std::list<uint64> lru;
+
+	int64 size;
+	int64 limit;
+
+	int64 hits;
+	int64 misses;
+	int64 evictions;
+
+	thread::MutexRef mutex;
+
+}; // BufferCache
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_BUFFER_CACHE_H
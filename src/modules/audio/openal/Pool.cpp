@@ -22,6 +22,10 @@
 
 #include "event/Event.h"
 #include "Source.h"
+#include "timer/Timer.h"
+
+// STD
+#include <algorithm>
 
 namespace love
 {
@@ -44,7 +48,16 @@ Pool::Pool(ALCdevice *device)
 	: device(device)
 	, sources()
 	, disconnectNotified(false)
+	, eventsEnabled(false)
 	, totalSources(0)
+	, playing()
+	, playingCount(0)
+	, unreserved(0)
+	, applyingCommands(false)
+	, totals()
+	, lockWaitTime(0.0)
+	, lockHoldTime(0.0)
+	, wakePending(false)
 {
 	// Clear errors.
 	alGetError();
@@ -82,10 +95,46 @@ Pool::Pool(ALCdevice *device)
 
 		available.push(sources[i]);
 	}
+
+	unreserved = totalSources;
+
+#ifdef AL_SOFT_events
+	// Let OpenAL tell us when a buffer has been consumed or a source has
+	// stopped, instead of estimating when that will happen.
+	if (alIsExtensionPresent("AL_SOFT_events"))
+	{
+		auto controlEvents = (LPALEVENTCONTROLSOFT) alGetProcAddress("alEventControlSOFT");
+		auto setEventCallback = (LPALEVENTCALLBACKSOFT) alGetProcAddress("alEventCallbackSOFT");
+
+		if (controlEvents != nullptr && setEventCallback != nullptr)
+		{
+			const ALenum types[] = {
+				AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT,
+				AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT,
+			};
+
+			alGetError();
+			setEventCallback(eventCallback, this);
+			controlEvents(2, types, AL_TRUE);
+			eventsEnabled = alGetError() == AL_NO_ERROR;
+
+			if (!eventsEnabled)
+				setEventCallback(nullptr, nullptr);
+		}
+	}
+#endif
 }
 
 Pool::~Pool()
 {
+#ifdef AL_SOFT_events
+	if (eventsEnabled)
+	{
+		auto setEventCallback = (LPALEVENTCALLBACKSOFT) alGetProcAddress("alEventCallbackSOFT");
+		setEventCallback(nullptr, nullptr);
+	}
+#endif
+
 	Source::stop(this);
 
 	// Free all sources.
@@ -104,21 +153,19 @@ bool Pool::isAvailable() const
 
 bool Pool::isPlaying(Source *s)
 {
-	bool p = false;
-	{
-		thread::Lock lock(mutex);
-		p = (playing.find(s) != playing.end());
-	}
-	return p;
+	thread::Lock l = lock();
+	ALuint out;
+	return findSource(s, out);
 }
 
-void Pool::update()
+double Pool::update()
 {
 #ifndef ALC_CONNECTED
 	constexpr ALCenum ALC_CONNECTED = 0x313;
 #endif
 
-	thread::Lock lock(mutex);
+	thread::Lock l = lock();
+	double start = timer::Timer::getTime();
 
 	static bool disconnectExtSupported = alcIsExtensionPresent(device, "ALC_EXT_Disconnect") == ALC_TRUE;
 
@@ -152,20 +199,162 @@ void Pool::update()
 	}
 
 	std::vector<Source *> torelease;
+	double deadline = MAX_UPDATE_INTERVAL;
 
-	for (const auto &i : playing)
+	for (int i = 0; i < playingCount; i++)
 	{
-		if (!i.first->update())
-			torelease.push_back(i.first);
+		Source *s = playing[i].source;
+
+		if (!s->update())
+			torelease.push_back(s);
+		else if (!eventsEnabled)
+		{
+			double d = s->getUpdateDeadline();
+			if (d >= 0.0)
+				deadline = std::min(deadline, d);
+		}
 	}
 
 	for (Source *s : torelease)
 		releaseSource(s);
+
+	updateVirtualVoices();
+
+	if (!virtualVoices.empty())
+		deadline = std::min(deadline, VIRTUAL_UPDATE_INTERVAL);
+
+	// Nothing to refill: sleep until a Source is played.
+	if (playingCount == 0 && virtualVoices.empty())
+		deadline = -1.0;
+
+	if (disconnectExtSupported && (deadline < 0.0 || deadline > DISCONNECT_POLL_INTERVAL))
+		deadline = DISCONNECT_POLL_INTERVAL;
+
+	lockHoldTime += timer::Timer::getTime() - start;
+
+	return deadline;
 }
 
-int Pool::getActiveSourceCount() const
+void Pool::waitForWork(double seconds)
 {
-	return (int) playing.size();
+	thread::Lock lock(wakeMutex);
+
+	if (!wakePending)
+	{
+		int timeout = -1;
+		if (seconds >= 0.0)
+			timeout = std::max((int) std::ceil(seconds * 1000.0), 1);
+
+		wakeCond->wait(wakeMutex, timeout);
+	}
+
+	wakePending = false;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(wakeMutex);
+	wakePending = true;
+	wakeCond->signal();
+}
+
+#ifdef AL_SOFT_events
+void AL_APIENTRY Pool::eventCallback(ALenum, ALuint, ALuint, ALsizei, const ALchar *, void *userParam) noexcept
+{
+	// Called from OpenAL's event thread.
+	((Pool *) userParam)->wake();
+}
+#endif
+
+bool Pool::post(Source *source, CommandType type)
+{
+	Command command = {source, type, false};
+
+	// A play command for a queueable Source which doesn't own an OpenAL
+	// source yet has to be able to get one when it's applied, so that play()
+	// can still report failure to the caller.
+	if (type == COMMAND_PLAY && source->getType() == Source::TYPE_QUEUE && !source->claimed.exchange(true))
+	{
+		if (!reserveSource())
+		{
+			source->claimed = false;
+			return false;
+		}
+		command.reserved = true;
+	}
+	else if (type == COMMAND_STOP)
+		source->claimed = false;
+
+	source->retain();
+	source->pendingCommand = type;
+	source->pendingCommands++;
+
+	if (commands.push(command))
+		wake();
+	else
+	{
+		thread::Lock l = lock();
+		applyCommand(command);
+	}
+
+	return true;
+}
+
+void Pool::applyCommands()
+{
+	if (applyingCommands)
+		return;
+
+	applyingCommands = true;
+
+	Command command;
+	while (commands.pop(command))
+		applyCommand(command);
+
+	applyingCommands = false;
+}
+
+void Pool::applyCommand(const Command &command)
+{
+	Source *source = command.source;
+
+	// Hand the reservation back; assignSource takes the OpenAL source it was
+	// made for.
+	if (command.reserved)
+		unreserved++;
+
+	switch (command.type)
+	{
+	case COMMAND_PLAY:
+		source->playImmediate();
+		break;
+	case COMMAND_STOP:
+		source->stopImmediate();
+		break;
+	case COMMAND_PAUSE:
+		source->pauseImmediate();
+		break;
+	}
+
+	source->pendingCommands--;
+	source->release();
+}
+
+bool Pool::reserveSource()
+{
+	int n = unreserved.load();
+	while (n > 0)
+	{
+		if (unreserved.compare_exchange_weak(n, n - 1))
+			return true;
+	}
+	return false;
+}
+
+int Pool::getActiveSourceCount()
+{
+	thread::Lock l = lock();
+	return playingCount + (int) virtualVoices.size();
 }
 
 int Pool::getMaxSources() const
@@ -173,6 +362,23 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
+void Pool::getStats(love::audio::Audio::Stats &stats)
+{
+	thread::Lock l = lock();
+
+	stats.activeSources = playingCount + (int) virtualVoices.size();
+	stats.virtualSources = (int) virtualVoices.size();
+	stats.sources = totals;
+	stats.lockWaitTime = (int64) (lockWaitTime * 1000000.0);
+	stats.lockHoldTime = (int64) (lockHoldTime * 1000000.0);
+
+	for (love::audio::Source *s : getPlayingSources())
+	{
+		if (s->getType() != Source::TYPE_STATIC)
+			stats.streams.emplace_back(s);
+	}
+}
+
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 {
 	out = 0;
@@ -187,23 +393,34 @@ bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 
 	out = available.front();
 	available.pop();
+	unreserved--;
 
-	playing.insert(std::make_pair(source, out));
+	playing[playingCount++] = {source, out};
+	source->claimed = true;
 	source->retain();
 	return true;
 }
 
 bool Pool::releaseSource(Source *source, bool stop)
 {
-	ALuint s;
-
-	if (findSource(source, s))
+	for (int i = 0; i < playingCount; i++)
 	{
+		if (playing[i].source != source)
+			continue;
+
+		ALuint s = playing[i].id;
+		playing[i] = playing[--playingCount];
+
 		if (stop)
 			source->stopAtomic();
-		source->release();
 		available.push(s);
-		playing.erase(source);
+		unreserved++;
+
+		// Only forget the claim if no play command is queued behind this.
+		if (source->pendingCommands == 0)
+			source->claimed = false;
+
+		source->release();
 		return true;
 	}
 
@@ -212,26 +429,149 @@ bool Pool::releaseSource(Source *source, bool stop)
 
 bool Pool::findSource(Source *source, ALuint &out)
 {
-	std::map<Source *, ALuint>::const_iterator i = playing.find(source);
+	for (int i = 0; i < playingCount; i++)
+	{
+		if (playing[i].source == source)
+		{
+			out = playing[i].id;
+			return true;
+		}
+	}
 
-	if (i == playing.end())
+	return false;
+}
+
+void Pool::addVirtual(Source *source)
+{
+	virtualVoices.push_back(source);
+	source->retain();
+}
+
+bool Pool::removeVirtual(Source *source)
+{
+	auto it = std::find(virtualVoices.begin(), virtualVoices.end(), source);
+	if (it == virtualVoices.end())
 		return false;
 
-	out = i->second;
+	virtualVoices.erase(it);
+	source->unvirtualizeAtomic();
+	source->release();
 	return true;
 }
 
+namespace
+{
+
+struct Voice
+{
+	Source *source;
+	int priority;
+	float audibility;
+};
+
+bool outranks(const Voice &a, const Voice &b, float threshold = 1.0f)
+{
+	if (a.priority != b.priority)
+		return a.priority > b.priority;
+	return a.audibility > b.audibility * threshold;
+}
+
+} // anonymous namespace
+
+void Pool::updateVirtualVoices()
+{
+	for (size_t i = 0; i < virtualVoices.size();)
+	{
+		if (virtualVoices[i]->updateVirtualAtomic())
+			i++;
+		else
+			removeVirtual(virtualVoices[i]);
+	}
+
+	if (virtualVoices.empty())
+		return;
+
+	float listener[3];
+	alGetListenerfv(AL_POSITION, listener);
+
+	std::vector<Voice> candidates;
+	for (Source *s : virtualVoices)
+	{
+		if (!s->virtualPaused)
+			candidates.push_back({s, s->getPriority(), s->getAudibility(listener)});
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Voice &a, const Voice &b) {
+		return outranks(a, b);
+	});
+
+	// Commands posted meanwhile must not change the voice lists under us, so
+	// they wait for the next lock.
+	bool wasApplying = applyingCommands;
+	applyingCommands = true;
+
+	for (const Voice &candidate : candidates)
+	{
+		// Voices reserved by posted play commands aren't up for grabs.
+		if (unreserved <= 0)
+		{
+			Voice victim = {nullptr, 0, 0.0f};
+
+			for (int i = 0; i < playingCount; i++)
+			{
+				Source *s = playing[i].source;
+				if (s->sourceType == Source::TYPE_QUEUE || s->pendingCommands > 0)
+					continue;
+
+				// Paused Sources give up their voice first.
+				float audibility = s->isPlayingAtomic() ? s->getAudibility(listener) : 0.0f;
+				Voice v = {s, s->getPriority(), audibility};
+
+				if (victim.source == nullptr || outranks(victim, v))
+					victim = v;
+			}
+
+			if (victim.source == nullptr || !outranks(candidate, victim, STEAL_THRESHOLD))
+				break;
+
+			Source *s = victim.source;
+			bool paused = !s->isPlayingAtomic();
+			double offset = s->tell(Source::UNIT_SECONDS);
+
+			s->retain();
+			releaseSource(s);
+			s->virtualizeAtomic(offset, paused);
+			s->release();
+		}
+
+		Source *s = candidate.source;
+		virtualVoices.erase(std::find(virtualVoices.begin(), virtualVoices.end(), s));
+
+		// A voice which can't start (e.g. a stream past its end) is done.
+		s->devirtualizeAtomic();
+		s->release();
+	}
+
+	applyingCommands = wasApplying;
+}
+
 thread::Lock Pool::lock()
 {
-	return thread::Lock(mutex);
+	double start = timer::Timer::getTime();
+	thread::Lock l(mutex);
+	lockWaitTime += timer::Timer::getTime() - start;
+	applyCommands();
+	return l;
 }
 
 std::vector<love::audio::Source*> Pool::getPlayingSources()
 {
 	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
-	for (auto &i : playing)
-		sources.push_back(i.first);
+	sources.reserve(playingCount + virtualVoices.size());
+	for (int i = 0; i < playingCount; i++)
+		sources.push_back(playing[i].source);
+	for (Source *s : virtualVoices)
+		sources.push_back(s);
 	return sources;
 }
 
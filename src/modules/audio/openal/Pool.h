@@ -23,15 +23,17 @@
 
 // STD
 #include <queue>
-#include <map>
 #include <vector>
 #include <cmath>
+#include <atomic>
 
 // LOVE
 #include "common/config.h"
 #include "common/Exception.h"
+#include "common/MPSCQueue.h"
 #include "thread/threads.h"
 #include "audio/Source.h"
+#include "audio/Audio.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -64,6 +66,13 @@ class Pool
 {
 public:
 
+	enum CommandType
+	{
+		COMMAND_PLAY,
+		COMMAND_STOP,
+		COMMAND_PAUSE,
+	};
+
 	Pool(ALCdevice *device);
 	~Pool();
 
@@ -78,17 +87,65 @@ class Pool
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Services every playing Source.
+	 * @return The number of seconds until a Source next needs servicing, or
+	 * a negative value if nothing needs servicing until the Pool is woken.
+	 **/
+	double update();
+
+	/**
+	 * Blocks the calling thread until the given number of seconds has passed
+	 * (forever if negative) or until wake() is called.
+	 **/
+	void waitForWork(double seconds);
+
+	/**
+	 * Wakes a thread blocked in waitForWork. Called whenever a Source's
+	 * refill schedule changes (play, seek, queue, pitch changes etc.)
+	 **/
+	void wake();
 
-	int getActiveSourceCount() const;
+	/**
+	 * Posts a Source state change without taking the Pool lock. Commands are
+	 * applied in order by the pool thread, or by whichever thread locks the
+	 * Pool next, so locked operations always see every earlier command.
+	 * @return False if the command plays a queueable Source and no OpenAL
+	 * source could be reserved for it. Other Sources become virtual voices
+	 * when no OpenAL source is available.
+	 **/
+	bool post(Source *source, CommandType type);
+
+	int getActiveSourceCount();
 	int getMaxSources() const;
 
+	/**
+	 * Fills in the engine-wide counters and the playing streams.
+	 **/
+	void getStats(love::audio::Audio::Stats &stats);
+
 private:
 
 	friend class Source;
 	LOVE_WARN_UNUSED thread::Lock lock();
 	std::vector<love::audio::Source*> getPlayingSources();
 
+	struct Command
+	{
+		Source *source;
+		CommandType type;
+
+		// Whether an OpenAL source was reserved for this command when it
+		// was posted.
+		bool reserved;
+	};
+
+	// Applies posted commands. The Pool must be locked.
+	void applyCommands();
+	void applyCommand(const Command &command);
+
+	bool reserveSource();
+
 	/**
 	 * Makes the specified OpenAL source available for use.
 	 * @param source The OpenAL source.
@@ -98,9 +155,43 @@ class Pool
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
 
+	// Adds a Source to the virtual voices. The Source must be virtualized.
+	void addVirtual(Source *source);
+	bool removeVirtual(Source *source);
+
+	/**
+	 * Retires finished virtual voices, then hands OpenAL sources to the most
+	 * important ones, taking them from less important playing Sources when
+	 * none are free.
+	 **/
+	void updateVirtualVoices();
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
+	// Upper bound on how long playing Sources go without being serviced, to
+	// catch state changes the deadlines can't predict (e.g. doppler shifts.)
+	static constexpr double MAX_UPDATE_INTERVAL = 0.25;
+
+	// How often an idle Pool polls for device disconnection.
+	static constexpr double DISCONNECT_POLL_INTERVAL = 1.0;
+
+	// How often virtual voices are ranked against the audible ones.
+	static constexpr double VIRTUAL_UPDATE_INTERVAL = 0.05;
+
+	// How much louder a virtual voice must be than a playing Source of the
+	// same priority to take its OpenAL source, so that voices of similar
+	// loudness don't keep trading places.
+	static constexpr float STEAL_THRESHOLD = 1.25f;
+
+	// Maximum number of posted commands waiting to be applied. Posting to a
+	// full queue falls back to locking the Pool.
+	static const size_t MAX_COMMANDS = 256;
+
+#ifdef AL_SOFT_events
+	static void AL_APIENTRY eventCallback(ALenum eventType, ALuint object, ALuint param, ALsizei length, const ALchar *message, void *userParam) noexcept;
+#endif
+
 	// Current OpenAL device
 	ALCdevice *device;
 
@@ -110,19 +201,55 @@ class Pool
 	// Is device disconnection has been notified?
 	bool disconnectNotified;
 
+	// Whether buffer completion and source state changes are reported through
+	// AL_SOFT_events, so per-Source deadlines aren't needed.
+	bool eventsEnabled;
+
 	// Total number of created sources in the pool.
 	int totalSources;
 
 	// A queue of available sources.
 	std::queue<ALuint> available;
 
-	// A map of playing sources.
-	std::map<Source *, ALuint> playing;
+	struct PlayingSource
+	{
+		Source *source;
+		ALuint id;
+	};
+
+	// Sources which currently own an OpenAL source, in no particular order.
+	// Removal moves the last entry into the freed slot.
+	PlayingSource playing[MAX_SOURCES];
+	int playingCount;
+
+	// Sources which are playing without an OpenAL source.
+	std::vector<Source *> virtualVoices;
+
+	// Number of available OpenAL sources minus the ones reserved by posted
+	// play commands. May briefly go negative when the Pool is exhausted.
+	std::atomic<int> unreserved;
+
+	MPSCQueue<Command, MAX_COMMANDS> commands;
+
+	// Set while applyCommands runs, since applying a command locks the Pool
+	// again.
+	bool applyingCommands;
+
+	// Counters reported by getStats. Guarded by the Pool lock, and updated by
+	// Sources as they stream. Lock times are in seconds.
+	love::audio::Source::Stats totals;
+	double lockWaitTime;
+	double lockHoldTime;
 
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	// Guards wakePending, used by waitForWork and wake.
+	love::thread::MutexRef wakeMutex;
+	love::thread::ConditionalRef wakeCond;
+	bool wakePending;
+
 }; // Pool
 
 } // openal
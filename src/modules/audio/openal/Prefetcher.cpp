@@ -0,0 +1,369 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Prefetcher.h"
+#include "timer/Timer.h"
+
+// STL
+#include <algorithm>
+#include <thread>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+DecodeWorkers::Worker::Worker(DecodeWorkers *owner)
+	: owner(owner)
+{
+	threadName = "AudioDecode";
+}
+
+void DecodeWorkers::Worker::threadFunction()
+{
+	while (true)
+	{
+		Prefetcher *prefetcher = nullptr;
+
+		{
+			thread::Lock lock(owner->mutex);
+
+			while (!owner->finish && owner->queue.empty())
+				owner->cond->wait(owner->mutex);
+
+			if (owner->finish)
+				return;
+
+			prefetcher = owner->queue.front();
+			owner->queue.pop_front();
+		}
+
+		// Clear the flag first, so chunks consumed while filling reschedule.
+		prefetcher->scheduled = false;
+		prefetcher->fill();
+		prefetcher->release();
+	}
+}
+
+DecodeWorkers::DecodeWorkers(int count)
+	: finish(false)
+	, readAhead(DEFAULT_READ_AHEAD)
+	, prefetcherCount(0)
+{
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker(this);
+		if (!worker->start())
+		{
+			delete worker;
+			break;
+		}
+		threads.push_back(worker);
+	}
+}
+
+DecodeWorkers::~DecodeWorkers()
+{
+	stop();
+}
+
+void DecodeWorkers::stop()
+{
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : threads)
+	{
+		worker->wait();
+		delete worker;
+	}
+	threads.clear();
+
+	for (Prefetcher *prefetcher : queue)
+	{
+		prefetcher->scheduled = false;
+		prefetcher->release();
+	}
+	queue.clear();
+}
+
+void DecodeWorkers::schedule(Prefetcher *prefetcher)
+{
+	thread::Lock lock(mutex);
+
+	if (finish)
+	{
+		prefetcher->scheduled = false;
+		return;
+	}
+
+	prefetcher->retain();
+	queue.push_back(prefetcher);
+	cond->signal();
+}
+
+void DecodeWorkers::setReadAhead(int chunks)
+{
+	readAhead = std::min(std::max(chunks, 0), MAX_READ_AHEAD);
+}
+
+int DecodeWorkers::getReadAhead() const
+{
+	return readAhead;
+}
+
+int DecodeWorkers::getPrefetcherCount() const
+{
+	return prefetcherCount;
+}
+
+int DecodeWorkers::getDefaultThreadCount()
+{
+	// Leave most cores to the game (and the host, when running as a plugin.)
+	int cores = (int) std::thread::hardware_concurrency();
+	return std::min(std::max(cores / 2, 1), 4);
+}
+
+Prefetcher::Prefetcher(DecodeWorkers *workers, love::sound::Decoder *decoder, int readAhead)
+	: workers(readAhead > 0 ? workers : nullptr)
+	, owner(workers)
+	, decoder(decoder)
+	, chunks(std::max(readAhead, 0) + 1)
+	, readIndex(0)
+	, count(0)
+	, acquired(false)
+	, exhausted(false)
+	, scheduled(false)
+	, decodeTime(0)
+	, chunkSize(decoder->getSize())
+{
+	for (Chunk &chunk : chunks)
+	{
+		chunk.data.resize(decoder->getSize());
+		chunk.size = 0;
+		chunk.endOfStream = false;
+	}
+
+	if (owner.get() != nullptr)
+		owner->prefetcherCount++;
+
+	schedule();
+}
+
+Prefetcher::~Prefetcher()
+{
+	if (owner.get() != nullptr)
+		owner->prefetcherCount--;
+}
+
+int Prefetcher::acquire(const void *&data, bool &endOfStream)
+{
+	data = nullptr;
+	endOfStream = false;
+
+	bool ready = false;
+	{
+		thread::Lock lock(mutex);
+		ready = count > 0 || exhausted;
+	}
+
+	// Nothing was decoded ahead; decode the chunk now, unless a worker
+	// finished it while we were waiting.
+	if (!ready)
+	{
+		thread::Lock lock(decodeMutex);
+		decodeChunk();
+	}
+
+	thread::Lock lock(mutex);
+
+	if (count == 0)
+	{
+		endOfStream = exhausted;
+		return 0;
+	}
+
+	const Chunk &chunk = chunks[readIndex];
+	acquired = true;
+	data = chunk.data.data();
+	endOfStream = chunk.endOfStream;
+	return chunk.size;
+}
+
+void Prefetcher::releaseChunk()
+{
+	{
+		thread::Lock lock(mutex);
+
+		if (!acquired)
+			return;
+
+		readIndex = (readIndex + 1) % chunks.size();
+		count--;
+		acquired = false;
+	}
+
+	schedule();
+}
+
+void Prefetcher::seek(double seconds)
+{
+	{
+		thread::Lock decodeLock(decodeMutex);
+		thread::Lock lock(mutex);
+		clear();
+		decoder->seek(seconds);
+	}
+
+	schedule();
+}
+
+void Prefetcher::rewind()
+{
+	{
+		thread::Lock decodeLock(decodeMutex);
+		thread::Lock lock(mutex);
+		clear();
+		decoder->rewind();
+	}
+
+	schedule();
+}
+
+bool Prefetcher::isFinished()
+{
+	thread::Lock lock(mutex);
+	return exhausted && count == 0;
+}
+
+double Prefetcher::getDuration()
+{
+	thread::Lock lock(decodeMutex);
+	return decoder->getDuration();
+}
+
+void Prefetcher::setChunkSize(int bytes)
+{
+	chunkSize = std::max(bytes, 1);
+}
+
+int Prefetcher::getChunkSize() const
+{
+	return chunkSize;
+}
+
+int64 Prefetcher::getDecodeTime() const
+{
+	return decodeTime.load(std::memory_order_relaxed);
+}
+
+void Prefetcher::fill()
+{
+	// Relock for every chunk so the consumer, seek and rewind aren't held up
+	// for the whole fill.
+	while (true)
+	{
+		thread::Lock lock(decodeMutex);
+		if (!decodeChunk())
+			break;
+	}
+}
+
+bool Prefetcher::decodeChunk()
+{
+	size_t slot = 0;
+	{
+		thread::Lock lock(mutex);
+		if (exhausted || count == chunks.size())
+			return false;
+		slot = (readIndex + count) % chunks.size();
+	}
+
+	// Only the decodeMutex holder writes to free chunks, and the consumer
+	// doesn't look at them, so this can happen without the ring locked.
+	Chunk &chunk = chunks[slot];
+	int target = chunkSize;
+	int step = decoder->getSize();
+	int size = 0;
+	bool endOfStream = false;
+
+	double start = timer::Timer::getTime();
+
+	while (size == 0 || size + step <= target)
+	{
+		int decoded = std::max(decoder->decode(), 0);
+
+		if ((size_t) (size + decoded) > chunk.data.size())
+			chunk.data.resize(size + decoded);
+
+		if (decoded > 0)
+			memcpy(chunk.data.data() + size, decoder->getBuffer(), decoded);
+
+		size += decoded;
+
+		if (decoded == 0 || decoder->isFinished())
+		{
+			endOfStream = true;
+			break;
+		}
+	}
+
+	decodeTime += (int64) ((timer::Timer::getTime() - start) * 1000000.0);
+
+	thread::Lock lock(mutex);
+	chunk.size = size;
+	chunk.endOfStream = endOfStream;
+	count++;
+	exhausted = endOfStream;
+	return !endOfStream;
+}
+
+void Prefetcher::schedule()
+{
+	if (workers.get() == nullptr)
+		return;
+
+	{
+		thread::Lock lock(mutex);
+		if (exhausted || count == chunks.size())
+			return;
+	}
+
+	if (!scheduled.exchange(true))
+		workers->schedule(this);
+}
+
+void Prefetcher::clear()
+{
+	readIndex = 0;
+	count = 0;
+	acquired = false;
+	exhausted = false;
+}
+
+} // openal
+} // audio
+} // love
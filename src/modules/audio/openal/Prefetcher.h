@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_PREFETCHER_H
+#define LOVE_AUDIO_OPENAL_PREFETCHER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/int.h"
+#include "sound/Decoder.h"
+#include "thread/threads.h"
+
+// STL
+#include <vector>
+#include <deque>
+#include <atomic>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class Prefetcher;
+
+/**
+ * A few threads which decode streaming audio ahead of the pool thread.
+ **/
+class DecodeWorkers : public Object
+{
+public:
+
+	DecodeWorkers(int threads);
+	virtual ~DecodeWorkers();
+
+	/**
+	 * Stops and joins the worker threads. Prefetchers scheduled afterwards
+	 * decode on demand only.
+	 **/
+	void stop();
+
+	/**
+	 * Queues a Prefetcher to be filled by the next idle worker.
+	 **/
+	void schedule(Prefetcher *prefetcher);
+
+	void setReadAhead(int chunks);
+	int getReadAhead() const;
+
+	// Number of chunks kept decoded ahead per stream, by default and at most.
+	static const int DEFAULT_READ_AHEAD = 2;
+	static const int MAX_READ_AHEAD = 16;
+
+	/**
+	 * Gets the number of Prefetchers created with these workers which are
+	 * still alive.
+	 **/
+	int getPrefetcherCount() const;
+
+	static int getDefaultThreadCount();
+
+private:
+
+	class Worker : public thread::Threadable
+	{
+	public:
+		Worker(DecodeWorkers *owner);
+		virtual ~Worker() {}
+		void threadFunction();
+	private:
+		DecodeWorkers *owner;
+	};
+
+	std::vector<Worker *> threads;
+	std::deque<Prefetcher *> queue;
+	bool finish;
+
+	std::atomic<int> readAhead;
+	std::atomic<int> prefetcherCount;
+
+	thread::MutexRef mutex;
+	thread::ConditionalRef cond;
+
+	friend class Prefetcher;
+
+}; // DecodeWorkers
+
+/**
+ * Decodes a streaming Source's Decoder ahead of playback. Worker threads keep
+ * up to a fixed number of chunks decoded in preallocated memory, and the pool
+ * thread only has to copy the next ready chunk into an OpenAL buffer. When no
+ * chunk is ready (or read-ahead is disabled) the chunk is decoded in place.
+ *
+ * Decoding stops at the end of the stream; looping is done by the consumer
+ * calling rewind(), as it needs to track the loop point itself.
+ **/
+class Prefetcher : public Object
+{
+public:
+
+	/**
+	 * @param workers The threads to decode on, or null to only decode on
+	 * demand.
+	 * @param chunks The number of chunks to keep decoded ahead.
+	 **/
+	Prefetcher(DecodeWorkers *workers, love::sound::Decoder *decoder, int chunks);
+	virtual ~Prefetcher();
+
+	/**
+	 * Gets the next decoded chunk, decoding it first if it isn't ready yet.
+	 * The data stays valid until releaseChunk() is called.
+	 * @param[out] data The decoded bytes.
+	 * @param[out] endOfStream Whether this is the last chunk of the stream.
+	 * @return The size of the chunk in bytes, 0 at the end of the stream.
+	 **/
+	int acquire(const void *&data, bool &endOfStream);
+
+	/**
+	 * Frees the chunk returned by acquire so it can be decoded into again.
+	 **/
+	void releaseChunk();
+
+	/**
+	 * Discards all decoded chunks and restarts decoding from the given
+	 * position, or from the start.
+	 **/
+	void seek(double seconds);
+	void rewind();
+
+	/**
+	 * Whether the end of the stream has been reached and every chunk before
+	 * it has been consumed.
+	 **/
+	bool isFinished();
+
+	double getDuration();
+
+	/**
+	 * Sets the size of a chunk in bytes. Chunks are filled with as many
+	 * decode() calls as fit (at least one), so consumers can size them from
+	 * their buffer depth rather than the Decoder's buffer size. Chunks which
+	 * are already decoded keep their size.
+	 **/
+	void setChunkSize(int bytes);
+	int getChunkSize() const;
+
+	/**
+	 * Gets the total time spent decoding, in microseconds.
+	 **/
+	int64 getDecodeTime() const;
+
+	/**
+	 * [Worker] Decodes chunks until the ring is full or the stream ends.
+	 **/
+	void fill();
+
+private:
+
+	struct Chunk
+	{
+		std::vector<char> data;
+		int size;
+		bool endOfStream;
+	};
+
+	// Decodes into the next free chunk. decodeMutex must be held.
+	bool decodeChunk();
+
+	void schedule();
+
+	// Discards decoded chunks. Both mutexes must be held.
+	void clear();
+
+	// The workers which decode ahead; null when read-ahead is disabled.
+	StrongRef<DecodeWorkers> workers;
+
+	// The workers this was created with, which count live Prefetchers.
+	StrongRef<DecodeWorkers> owner;
+
+	StrongRef<love::sound::Decoder> decoder;
+
+	std::vector<Chunk> chunks;
+	size_t readIndex;
+	size_t count;
+
+	// Whether the chunk at readIndex has been handed out by acquire.
+	bool acquired;
+
+	// Set once the chunk at the end of the stream has been decoded.
+	bool exhausted;
+
+	// Serializes access to the Decoder. Always locked before mutex.
+	thread::MutexRef decodeMutex;
+
+	// Guards the chunk ring.
+	thread::MutexRef mutex;
+
+	friend class DecodeWorkers;
+
+	// Whether this is in the workers' queue.
+	std::atomic<bool> scheduled;
+
+	std::atomic<int64> decodeTime;
+
+	std::atomic<int> chunkSize;
+
+}; // Prefetcher
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_PREFETCHER_H
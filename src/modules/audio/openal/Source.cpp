@@ -23,10 +23,12 @@
 #include "Pool.h"
 #include "Audio.h"
 #include "common/math.h"
+#include "timer/Timer.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -141,6 +143,24 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 		slotlist.push(i);
 }
 
+Source::Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, pool(pool)
+	, staticBuffer(buffer)
+	, sampleRate(sampleRate)
+	, channels(channels)
+	, bitDepth(bitDepth)
+{
+	float z[3] = {0, 0, 0};
+
+	setFloatv(position, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+
+	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
+		slotlist.push(i);
+}
+
 Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	: love::audio::Source(Source::TYPE_STREAM)
 	, pool(pool)
@@ -153,6 +173,8 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	if (Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount()) == AL_NONE)
 		throw InvalidFormatException(decoder->getChannelCount(), decoder->getBitDepth());
 
+	prefetcher.set(audiomodule()->newPrefetcher(decoder), Acquire::NORETAIN);
+
 	for (int i = 0; i < buffers; i++)
 	{
 		ALuint buf;
@@ -166,6 +188,9 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 		}
 	}
 
+	baseStreamChunkSize = getBaseStreamChunkSize();
+	prefetcher->setChunkSize(baseStreamChunkSize);
+
 	float z[3] = {0, 0, 0};
 
 	setFloatv(position, z);
@@ -193,7 +218,9 @@ Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int b)
 	if (buffers > MAX_BUFFERS)
 		buffers = MAX_BUFFERS;
 
-	for (int i = 0; i < buffers; i++)
+	initCallbackBuffer();
+
+	for (int i = 0; callbackBuffer == 0 && i < buffers; i++)
 	{
 		ALuint buf;
 		alGenBuffers(1, &buf);
@@ -217,7 +244,7 @@ Source::Source(Pool *pool, int sampleRate, int bitDepth, int channels, int b)
 }
 
 Source::Source(const Source &s)
-	: love::audio::Source(s.sourceType)
+	: love::audio::Source(s)
 	, pool(s.pool)
 	, valid(false)
 	, staticBuffer(s.staticBuffer)
@@ -242,9 +269,17 @@ Source::Source(const Source &s)
 	if (sourceType == TYPE_STREAM)
 	{
 		if (s.decoder.get())
+		{
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+			prefetcher.set(audiomodule()->newPrefetcher(decoder.get()), Acquire::NORETAIN);
+			prefetcher->setChunkSize(s.prefetcher->getChunkSize());
+			baseStreamChunkSize = s.baseStreamChunkSize;
+		}
 	}
-	if (sourceType != TYPE_STATIC)
+	if (sourceType == TYPE_QUEUE)
+		initCallbackBuffer();
+
+	if (sourceType != TYPE_STATIC && callbackBuffer == 0)
 	{
 		for (int i = 0; i < buffers; i++)
 		{
@@ -292,7 +327,10 @@ Source::Source(const Source &s)
 
 Source::~Source()
 {
-	stop();
+	stopImmediate();
+
+	if (callbackBuffer != 0)
+		alDeleteBuffers(1, &callbackBuffer);
 
 	if (sourceType != TYPE_STATIC)
 	{
@@ -323,14 +361,94 @@ love::audio::Source *Source::clone()
 	return new Source(*this);
 }
 
+int Source::getStreamChunkSize(double seconds) const
+{
+	int frames = (int) (sampleRate * seconds / std::max(buffers, 1));
+	return std::max(frames, 1) * (bitDepth / 8 * channels);
+}
+
+int Source::getBaseStreamChunkSize() const
+{
+	double seconds = std::max(audiomodule()->getOutputBufferSeconds(), MIN_STREAM_CHUNK_SECONDS);
+	seconds = std::min(seconds * std::max(buffers, 1), MAX_STREAM_BUFFER_SECONDS);
+	return getStreamChunkSize(seconds);
+}
+
+void Source::initCallbackBuffer()
+{
+	if (alBufferCallbackSOFT == nullptr)
+		return;
+
+	// Clear errors.
+	alGetError();
+
+	alGenBuffers(1, &callbackBuffer);
+	if (alGetError() != AL_NO_ERROR)
+	{
+		callbackBuffer = 0;
+		return;
+	}
+
+	alBufferCallbackSOFT(callbackBuffer, Audio::getFormat(bitDepth, channels), sampleRate, bufferCallback, this);
+	if (alGetError() != AL_NO_ERROR)
+	{
+		alDeleteBuffers(1, &callbackBuffer);
+		callbackBuffer = 0;
+		return;
+	}
+
+	callbackBlocks.resize(buffers);
+}
+
 bool Source::play()
+{
+	return pool->post(this, Pool::COMMAND_PLAY);
+}
+
+void Source::stop()
+{
+	if (!valid && !virtualized && pendingCommands == 0)
+		return;
+
+	pool->post(this, Pool::COMMAND_STOP);
+}
+
+void Source::pause()
+{
+	pool->post(this, Pool::COMMAND_PAUSE);
+}
+
+bool Source::playImmediate()
 {
 	Lock l = pool->lock();
 	ALuint out;
 
+	if (virtualized)
+	{
+		if (virtualPaused)
+		{
+			virtualTime = timer::Timer::getTime();
+			virtualPaused = false;
+		}
+		return true;
+	}
+
 	char wasPlaying;
 	if (!pool->assignSource(this, out, wasPlaying))
-		return valid = false;
+	{
+		// Every OpenAL source is in use. Keep time without being heard, and
+		// let the Pool decide whether this should take over another voice.
+		if (sourceType == TYPE_QUEUE)
+			return valid = false;
+
+		double offset = offsetSamples / (double) sampleRate;
+		offsetSamples = 0;
+		virtualizeAtomic(offset, false);
+		pool->wake();
+		return true;
+	}
+
+	pool->wake();
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -339,8 +457,15 @@ bool Source::play()
 	return valid = true;
 }
 
-void Source::stop()
+void Source::stopImmediate()
 {
+	if (virtualized)
+	{
+		Lock l = pool->lock();
+		pool->removeVirtual(this);
+		return;
+	}
+
 	if (!valid)
 		return;
 
@@ -348,15 +473,40 @@ void Source::stop()
 	pool->releaseSource(this);
 }
 
-void Source::pause()
+void Source::pauseImmediate()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (virtualized)
+	{
+		virtualOffset = getVirtualOffset();
+		virtualPaused = true;
+	}
+	else if (pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	// Answer for the state changes which haven't reached OpenAL yet.
+	if (pendingCommands > 0)
+		return pendingCommand == Pool::COMMAND_PLAY;
+
+	return isPlayingAtomic();
+}
+
+bool Source::isFinished() const
+{
+	if (pendingCommands > 0)
+		return false;
+
+	return isFinishedAtomic();
+}
+
+bool Source::isPlayingAtomic() const
+{
+	if (virtualized)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -365,12 +515,12 @@ bool Source::isPlaying() const
 	return state == AL_PLAYING;
 }
 
-bool Source::isFinished() const
+bool Source::isFinishedAtomic() const
 {
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (sourceType == TYPE_STREAM && (isLooping() || !prefetcher->isFinished()))
 		return false;
 
 	ALenum state;
@@ -390,14 +540,22 @@ bool Source::update()
 			// Looping mode could have changed.
 			// FIXME: make looping mode change atomically so this is not needed
 			alSourcei(source, AL_LOOPING, isLooping() ? AL_TRUE : AL_FALSE);
-			return !isFinished();
+			return !isFinishedAtomic();
 		}
 		case TYPE_STREAM:
-			if (!isFinished())
+			if (!isFinishedAtomic())
 			{
+				// A stream which isn't finished only stops when every queued
+				// buffer was played before it could be refilled.
+				ALint state;
+				alGetSourcei(source, AL_SOURCE_STATE, &state);
+
 				ALint processed;
 				alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
 
+				stats.buffersProcessed += processed;
+				pool->totals.buffersProcessed += processed;
+
 				// It would theoretically be better to unqueue all processed
 				// buffers in a single call to alSourceUnqueueBuffers, but on
 				// iOS I observed occasional (every ~5-10 seconds) pops in the
@@ -417,9 +575,18 @@ bool Source::update()
 					int newOffsetSamples;
 					alGetSourcei(source, AL_SAMPLE_OFFSET, &newOffsetSamples);
 
-					offsetSamples += (curOffsetSamples - newOffsetSamples);
+					if (state == AL_STOPPED)
+					{
+						// A stopped source reports no offset, but the whole
+						// buffer was played.
+						ALint size;
+						alGetBufferi(buffer, AL_SIZE, &size);
+						offsetSamples += size / (bitDepth / 8 * channels);
+					}
+					else
+						offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
+					if (streamAtomic(buffer, prefetcher.get()) > 0)
 						alSourceQueueBuffers(source, 1, &buffer);
 					else
 						unusedBuffers.push(buffer);
@@ -428,7 +595,7 @@ bool Source::update()
 				while (!unusedBuffers.empty())
 				{
 					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					if (streamAtomic(b, prefetcher.get()) > 0)
 					{
 						alSourceQueueBuffers(source, 1, &b);
 						unusedBuffers.pop();
@@ -437,11 +604,49 @@ bool Source::update()
 						break;
 				}
 
+				int chunkSize = prefetcher->getChunkSize();
+
+				if (state == AL_STOPPED)
+				{
+					stats.underruns++;
+					pool->totals.underruns++;
+
+					// Queue more audio ahead from now on, so a late update
+					// doesn't starve the stream again.
+					int maxChunkSize = getStreamChunkSize(MAX_STREAM_BUFFER_SECONDS);
+					if (chunkSize < maxChunkSize)
+						prefetcher->setChunkSize(std::min(chunkSize * 2, maxChunkSize));
+					streamResizeTime = timer::Timer::getTime();
+
+					ALint queued;
+					alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+					if (queued > 0)
+						alSourcePlay(source);
+				}
+				else if (chunkSize > baseStreamChunkSize)
+				{
+					// Give the latency back once updates keep up again.
+					double now = timer::Timer::getTime();
+					if (now - streamResizeTime >= STREAM_SHRINK_DELAY)
+					{
+						prefetcher->setChunkSize(std::max(chunkSize / 2, baseStreamChunkSize));
+						streamResizeTime = now;
+					}
+				}
+
 				return true;
 			}
 			return false;
 		case TYPE_QUEUE:
 		{
+			if (callbackBuffer != 0)
+			{
+				int processed = releaseCallbackBlocks(false);
+				stats.buffersProcessed += processed;
+				pool->totals.buffersProcessed += processed;
+				return !isFinishedAtomic();
+			}
+
 			ALint processed;
 			ALuint buffers[MAX_BUFFERS];
 
@@ -455,7 +660,10 @@ bool Source::update()
 				bufferedBytes -= size;
 				unusedBuffers.push(buffers[i]);
 			}
-			return !isFinished();
+
+			stats.buffersProcessed += processed;
+			pool->totals.buffersProcessed += processed;
+			return !isFinishedAtomic();
 		}
 		case TYPE_MAX_ENUM:
 			break;
@@ -464,10 +672,127 @@ bool Source::update()
 	return false;
 }
 
+double Source::getUpdateDeadline() const
+{
+	if (!valid)
+		return -1.0;
+
+	// Paused Sources are woken up by play().
+	ALint state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	if (state != AL_PLAYING)
+		return -1.0;
+
+	ALfloat curPitch = 1.0f;
+	alGetSourcef(source, AL_PITCH, &curPitch);
+	if (curPitch <= 0.0f)
+		return -1.0;
+
+	if (callbackBuffer != 0)
+	{
+		// Played blocks can be handed back as soon as the mixer moves past
+		// them. Once it runs out of blocks the source stops, which is
+		// caught by the next regular update.
+		uint64 head = callbackHead.load(std::memory_order_acquire);
+		if (head != callbackReleased)
+			return 0.0;
+		if (head == callbackTail.load(std::memory_order_relaxed))
+			return -1.0;
+
+		int64 remaining = (int64) callbackBlocks[head % callbackBlocks.size()].size - (int64) callbackOffset.load(std::memory_order_relaxed);
+		int64 frames = std::max(remaining, (int64) 0) / (bitDepth / 8 * channels);
+		return frames / ((double) sampleRate * curPitch);
+	}
+
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	ALint frames = 0;
+	ALint rate = sampleRate;
+
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+		// Only needs to be released once it stops.
+		if (isLooping())
+			return -1.0;
+		frames = (staticBuffer->getSize() / channels) / (bitDepth / 8);
+		break;
+	case TYPE_STREAM:
+	case TYPE_QUEUE:
+	{
+		// A buffer can be refilled (or handed back to the user) as soon as
+		// the one currently playing has been consumed.
+		ALint processed = 0;
+		alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+		if (processed > 0)
+			return 0.0;
+
+		ALint buffer = 0;
+		alGetSourcei(source, AL_BUFFER, &buffer);
+		if (buffer == 0)
+			return -1.0;
+
+		ALint size = 0, bits = 0, bufferChannels = 0;
+		alGetBufferi(buffer, AL_SIZE, &size);
+		alGetBufferi(buffer, AL_BITS, &bits);
+		alGetBufferi(buffer, AL_CHANNELS, &bufferChannels);
+		alGetBufferi(buffer, AL_FREQUENCY, &rate);
+
+		if (bits < 8 || bufferChannels <= 0)
+			return 0.0;
+
+		frames = size / (bits / 8 * bufferChannels);
+		break;
+	}
+	case TYPE_MAX_ENUM:
+		return -1.0;
+	}
+
+	if (rate <= 0)
+		return 0.0;
+
+	return std::max(frames - offset, 0) / ((double) rate * curPitch);
+}
+
+float Source::getAudibility(const float *listener) const
+{
+	float gain = volume;
+
+	// Approximates OpenAL's default inverse distance clamped model. Only mono
+	// Sources are spatialized.
+	if (channels == 1 && rolloffFactor > 0.0f)
+	{
+		float d[3];
+		for (int i = 0; i < 3; i++)
+			d[i] = relative ? position[i] : position[i] - listener[i];
+
+		float distance = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+		distance = std::min(std::max(distance, referenceDistance), maxDistance);
+
+		if (referenceDistance > 0.0f)
+			gain *= referenceDistance / (referenceDistance + rolloffFactor * (distance - referenceDistance));
+	}
+
+	return std::min(std::max(gain, minVolume), maxVolume);
+}
+
 void Source::setPitch(float pitch)
 {
+	if (virtualized)
+	{
+		Lock l = pool->lock();
+		virtualOffset = getVirtualOffset();
+		virtualTime = timer::Timer::getTime();
+		this->pitch = pitch;
+		return;
+	}
+
 	if (valid)
+	{
 		alSourcef(source, AL_PITCH, pitch);
+		pool->wake();
+	}
 
 	this->pitch = pitch;
 }
@@ -526,7 +851,14 @@ void Source::seek(double offset, Source::Unit unit)
 		break;
 	}
 
-	bool wasPlaying = isPlaying();
+	if (virtualized)
+	{
+		virtualOffset = offsetSeconds;
+		virtualTime = timer::Timer::getTime();
+		return;
+	}
+
+	bool wasPlaying = isPlayingAtomic();
 	switch (sourceType)
 	{
 		case TYPE_STATIC:
@@ -534,26 +866,40 @@ void Source::seek(double offset, Source::Unit unit)
 			{
 				alSourcei(source, AL_SAMPLE_OFFSET, offsetSamples);
 				offsetSamples = offsetSeconds = 0;
+				pool->wake();
 			}
 			break;
 		case TYPE_STREAM:
 		{
 			// To drain all buffers
 			if (valid)
-				stop();
+				stopImmediate();
 
-			decoder->seek(offsetSeconds);
+			prefetcher->seek(offsetSeconds);
 
 			if (wasPlaying)
-				play();
+				playImmediate();
 
 			break;
 		}
 		case TYPE_QUEUE:
-			if (valid)
+			if (callbackBuffer != 0)
+			{
+				// The mixer drops the data between the current position and
+				// the new one. Played data can't be sought back to.
+				int64 target = (int64) offsetSamples * (bitDepth / 8 * channels);
+				int64 skip = target - callbackPlayed.load() - (int64) callbackSkip.load();
+				if (skip > 0)
+					callbackSkip += (size_t) skip;
+				offsetSamples = 0;
+				if (valid)
+					pool->wake();
+			}
+			else if (valid)
 			{
 				alSourcei(source, AL_SAMPLE_OFFSET, offsetSamples);
 				offsetSamples = offsetSeconds = 0;
+				pool->wake();
 			}
 			else
 			{
@@ -580,11 +926,11 @@ void Source::seek(double offset, Source::Unit unit)
 			break;
 	}
 
-	if (wasPlaying && (alGetError() == AL_INVALID_VALUE || (sourceType == TYPE_STREAM && !isPlaying())))
+	if (wasPlaying && (alGetError() == AL_INVALID_VALUE || (sourceType == TYPE_STREAM && !isPlayingAtomic())))
 	{
-		stop();
+		stopImmediate();
 		if (isLooping())
-			play();
+			playImmediate();
 		return;
 	}
 
@@ -595,9 +941,17 @@ double Source::tell(Source::Unit unit)
 {
 	Lock l = pool->lock();
 
+	if (virtualized)
+	{
+		double offset = getVirtualOffset();
+		return unit == UNIT_SECONDS ? offset : offset * sampleRate;
+	}
+
 	int offset = 0;
 
-	if (valid)
+	if (callbackBuffer != 0)
+		offset = (int) (callbackPlayed.load() / (bitDepth / 8 * channels));
+	else if (valid)
 		alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
 
 	offset += offsetSamples;
@@ -626,12 +980,12 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
-		double seconds = decoder->getDuration();
+		double seconds = prefetcher->getDuration();
 
 		if (unit == UNIT_SECONDS)
 			return seconds;
 		else
-			return seconds * decoder->getSampleRate();
+			return seconds * sampleRate;
 	}
 	case TYPE_QUEUE:
 	{
@@ -771,7 +1125,10 @@ void Source::setLooping(bool enable)
 		throw QueueLoopingException();
 
 	if (valid && sourceType == TYPE_STATIC)
+	{
 		alSourcei(source, AL_LOOPING, enable ? AL_TRUE : AL_FALSE);
+		pool->wake();
+	}
 
 	looping = enable;
 }
@@ -797,6 +1154,9 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 
 	Lock l = pool->lock();
 
+	if (callbackBuffer != 0)
+		return queueCallback(nullptr, data, length);
+
 	if (unusedBuffers.empty())
 		return false;
 
@@ -805,14 +1165,185 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	alBufferData(buffer, Audio::getFormat(bitDepth, channels), data, length, sampleRate);
 	bufferedBytes += length;
 
+	stats.buffersQueued++;
+	stats.bytesUploaded += length;
+	pool->totals.buffersQueued++;
+	pool->totals.bytesUploaded += length;
+
 	if (valid)
+	{
 		alSourceQueueBuffers(source, 1, &buffer);
+		pool->wake();
+	}
 	else
 		streamBuffers.push(buffer);
 
 	return true;
 }
 
+bool Source::queue(love::sound::SoundData *data, size_t offset, size_t length)
+{
+	if (callbackBuffer == 0)
+		return love::audio::Source::queue(data, offset, length);
+
+	if (data->getSampleRate() != sampleRate || data->getBitDepth() != bitDepth || data->getChannelCount() != channels)
+		throw QueueFormatMismatchException();
+
+	if (length % (bitDepth / 8 * channels) != 0)
+		throw QueueMalformedLengthException(bitDepth / 8 * channels);
+
+	if (length == 0)
+		return true;
+
+	Lock l = pool->lock();
+	return queueCallback(data, (uint8 *) data->getData() + offset, length);
+}
+
+bool Source::isQueued(const love::sound::SoundData *data) const
+{
+	if (callbackBuffer == 0)
+		return false;
+
+	Lock l = pool->lock();
+
+	uint64 tail = callbackTail.load(std::memory_order_relaxed);
+	for (uint64 i = callbackReleased; i < tail; i++)
+	{
+		if (callbackBlocks[i % callbackBlocks.size()].data.get() == data)
+			return true;
+	}
+
+	return false;
+}
+
+bool Source::queueCallback(love::sound::SoundData *data, const void *bytes, size_t length)
+{
+	uint64 tail = callbackTail.load(std::memory_order_relaxed);
+	if (tail - callbackReleased >= callbackBlocks.size())
+		return false;
+
+	CallbackBlock &block = callbackBlocks[tail % callbackBlocks.size()];
+
+	if (data != nullptr)
+	{
+		block.data.set(data);
+		block.bytes = (const uint8 *) bytes;
+	}
+	else
+	{
+		block.copy.assign((const uint8 *) bytes, (const uint8 *) bytes + length);
+		block.bytes = block.copy.data();
+	}
+
+	block.size = length;
+	bufferedBytes += length;
+
+	stats.buffersQueued++;
+	pool->totals.buffersQueued++;
+
+	callbackTail.store(tail + 1, std::memory_order_release);
+
+	if (valid)
+		pool->wake();
+
+	return true;
+}
+
+int Source::releaseCallbackBlocks(bool all)
+{
+	uint64 head = callbackHead.load(std::memory_order_acquire);
+	uint64 end = all ? callbackTail.load(std::memory_order_relaxed) : head;
+	int played = 0;
+
+	for (; callbackReleased < end; callbackReleased++)
+	{
+		CallbackBlock &block = callbackBlocks[callbackReleased % callbackBlocks.size()];
+
+		bufferedBytes -= (ALsizei) block.size;
+		if (callbackReleased < head)
+		{
+			callbackPlayed -= (int64) block.size;
+			played++;
+		}
+
+		block.data.set(nullptr);
+		block.bytes = nullptr;
+		block.size = 0;
+	}
+
+	if (all)
+	{
+		// Only done once the mixer can no longer call readCallback.
+		callbackHead.store(end, std::memory_order_release);
+		callbackOffset = 0;
+		callbackSkip = 0;
+		callbackPlayed = 0;
+	}
+
+	return played;
+}
+
+ALsizei AL_APIENTRY Source::bufferCallback(ALvoid *userptr, ALvoid *sampledata, ALsizei numbytes)
+{
+	return ((Source *) userptr)->readCallback((uint8 *) sampledata, numbytes);
+}
+
+ALsizei Source::readCallback(uint8 *dst, ALsizei numbytes)
+{
+	uint64 head = callbackHead.load(std::memory_order_relaxed);
+	uint64 tail = callbackTail.load(std::memory_order_acquire);
+	size_t offset = callbackOffset.load(std::memory_order_relaxed);
+	size_t skip = callbackSkip.exchange(0);
+
+	size_t written = 0;
+	size_t consumed = 0;
+
+	while (head < tail && written < (size_t) numbytes)
+	{
+		const CallbackBlock &block = callbackBlocks[head % callbackBlocks.size()];
+
+		size_t skipped = std::min(skip, block.size - offset);
+		skip -= skipped;
+		offset += skipped;
+
+		size_t count = std::min(block.size - offset, (size_t) numbytes - written);
+		memcpy(dst + written, block.bytes + offset, count);
+		written += count;
+		offset += count;
+		consumed += skipped + count;
+
+		if (offset == block.size)
+		{
+			head++;
+			offset = 0;
+		}
+	}
+
+	// Skip into blocks which haven't been queued yet.
+	if (skip > 0)
+		callbackSkip += skip;
+
+	callbackOffset.store(offset, std::memory_order_relaxed);
+	callbackPlayed += (int64) consumed;
+	callbackHead.store(head, std::memory_order_release);
+
+	// Returning less than was asked for stops the source, like a buffer
+	// queue which ran out.
+	return (ALsizei) written;
+}
+
+bool Source::isVirtual() const
+{
+	Lock l = pool->lock();
+	return virtualized;
+}
+
+love::audio::Source::Stats Source::getStats() const
+{
+	Lock l = pool->lock();
+	return stats;
+}
+
 int Source::getFreeBufferCount() const
 {
 	switch (sourceType) //why not :^)
@@ -822,6 +1353,11 @@ int Source::getFreeBufferCount() const
 	case TYPE_STREAM:
 		return unusedBuffers.size();
 	case TYPE_QUEUE:
+		if (callbackBuffer != 0)
+		{
+			Lock l = pool->lock();
+			return (int) (callbackBlocks.size() - (callbackTail.load() - callbackReleased));
+		}
 		return unusedBuffers.size();
 	case TYPE_MAX_ENUM:
 		return 0;
@@ -845,18 +1381,25 @@ void Source::prepareAtomic()
 		while (!unusedBuffers.empty())
 		{
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b, prefetcher.get()) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
 
-			if (decoder->isFinished())
+			if (prefetcher->isFinished())
 				break;
 		}
 		break;
 	case TYPE_QUEUE:
 	{
+		if (callbackBuffer != 0)
+		{
+			// Pending seeks are applied by the mixer instead.
+			alSourcei(source, AL_BUFFER, callbackBuffer);
+			return;
+		}
+
 		while (!streamBuffers.empty())
 		{
 			alSourceQueueBuffers(source, 1, &streamBuffers.front());
@@ -884,7 +1427,7 @@ void Source::teardownAtomic()
 		ALuint buffers[MAX_BUFFERS];
 
 		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		prefetcher->rewind();
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -899,6 +1442,14 @@ void Source::teardownAtomic()
 	}
 	case TYPE_QUEUE:
 	{
+		if (callbackBuffer != 0)
+		{
+			// The source is stopped, so the mixer is done reading. Like
+			// unqueueing every buffer, this drops what hasn't played yet.
+			releaseCallbackBlocks(true);
+			break;
+		}
+
 		ALint queued;
 		ALuint buffers[MAX_BUFFERS];
 
@@ -934,15 +1485,15 @@ bool Source::playAtomic(ALuint source)
 
 	if (sourceType == TYPE_STREAM)
 	{
-		valid = true; //isPlaying() needs source to be valid
-		if (!isPlaying())
+		valid = true; //isPlayingAtomic() needs source to be valid
+		if (!isPlayingAtomic())
 			success = false;
 	}
 
 	if (!success)
 	{
-		valid = true; //stop() needs source to be valid
-		stop();
+		valid = true; //stopImmediate() needs source to be valid
+		stopImmediate();
 	}
 
 	// Static sources: reset the pending offset since it's not valid anymore.
@@ -968,13 +1519,13 @@ void Source::pauseAtomic()
 
 void Source::resumeAtomic()
 {
-	if (valid && !isPlaying())
+	if (valid && !isPlayingAtomic())
 	{
 		alSourcePlay(source);
 
 		//failed to play or nothing to play
 		if (alGetError() == AL_INVALID_VALUE || (sourceType == TYPE_STREAM && (int) unusedBuffers.size() == buffers))
-			stop();
+			stopImmediate();
 	}
 }
 
@@ -989,14 +1540,25 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	// NOTE: not bool, because std::vector<bool> is implemented as a bitvector
 	// which means no bool references can be created.
 	std::vector<char> wasPlaying(sources.size());
+	std::vector<char> wasVirtual(sources.size());
 	std::vector<ALuint> ids(sources.size());
 
 	for (size_t i = 0; i < sources.size(); i++)
 	{
-		if (!pool->assignSource((Source*) sources[i], ids[i], wasPlaying[i]))
+		Source *source = (Source*) sources[i];
+		ALuint id;
+
+		// Virtual voices (and ones which can't get an OpenAL source) play
+		// through playImmediate once the rest have started.
+		wasVirtual[i] = source->virtualized || (source->sourceType != TYPE_QUEUE
+			&& !pool->findSource(source, id) && !pool->isAvailable());
+		if (wasVirtual[i])
+			continue;
+
+		if (!pool->assignSource(source, ids[i], wasPlaying[i]))
 		{
 			for (size_t j = 0; j < i; j++)
-				if (!wasPlaying[j])
+				if (!wasPlaying[j] && !wasVirtual[j])
 					pool->releaseSource((Source*) sources[j], false);
 			return false;
 		}
@@ -1006,10 +1568,13 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	toPlay.reserve(sources.size());
 	for (size_t i = 0; i < sources.size(); i++)
 	{
+		if (wasVirtual[i])
+			continue;
+
 		// If the source was paused, wasPlaying[i] will be true but we still
 		// want to resume it. We don't want to call alSourcePlay on sources
 		// that are actually playing though.
-		if (wasPlaying[i] && sources[i]->isPlaying())
+		if (wasPlaying[i] && ((Source*) sources[i])->isPlayingAtomic())
 			continue;
 
 		if (!wasPlaying[i])
@@ -1022,13 +1587,26 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 		toPlay.push_back(ids[i]);
 	}
 
-	alGetError();
-	alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
-	bool success = alGetError() == AL_NO_ERROR;
+	bool success = true;
+	if (!toPlay.empty())
+	{
+		alGetError();
+		alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
+		success = alGetError() == AL_NO_ERROR;
+	}
 
-	for (auto &_source : sources)
+	pool->wake();
+
+	for (size_t i = 0; i < sources.size(); i++)
 	{
-		Source *source = (Source*) _source;
+		Source *source = (Source*) sources[i];
+
+		if (wasVirtual[i])
+		{
+			source->playImmediate();
+			continue;
+		}
+
 		source->valid = source->valid || success;
 
 		if (success && source->sourceType != TYPE_STREAM)
@@ -1055,12 +1633,15 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 			sourceIds.push_back(source->source);
 	}
 
-	alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
 
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
-		if (source->valid)
+		if (source->virtualized)
+			pool->removeVirtual(source);
+		else if (source->valid)
 			source->teardownAtomic();
 		pool->releaseSource(source, false);
 	}
@@ -1078,11 +1659,14 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
-		if (source->valid)
+		if (source->virtualized)
+			source->pauseImmediate();
+		else if (source->valid)
 			sourceIds.push_back(source->source);
 	}
 
-	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
 }
 
 std::vector<love::audio::Source*> Source::pause(Pool *pool)
@@ -1091,7 +1675,7 @@ std::vector<love::audio::Source*> Source::pause(Pool *pool)
 	std::vector<love::audio::Source*> sources = pool->getPlayingSources();
 
 	auto newend = std::remove_if(sources.begin(), sources.end(), [](love::audio::Source* s) {
-		return !s->isPlaying();
+		return !((Source*) s)->isPlayingAtomic();
 	});
 	sources.erase(newend, sources.end());
 
@@ -1144,22 +1728,39 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer, Prefetcher *p)
 {
-	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	// Get more sound data, usually already decoded by a worker thread.
+	const void *data = nullptr;
+	bool endOfStream = false;
+	int decoded = p->acquire(data, endOfStream);
+
+	// Decoding done ahead on a worker thread is counted when it's consumed.
+	int64 decodeTime = p->getDecodeTime();
+	stats.decodeTime += decodeTime - decodeTimeSeen;
+	pool->totals.decodeTime += decodeTime - decodeTimeSeen;
+	decodeTimeSeen = decodeTime;
 
 	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
 	if (decoded > 0)
 	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+		int fmt = Audio::getFormat(bitDepth, channels);
 
 		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
+		{
+			alBufferData(buffer, fmt, data, decoded, sampleRate);
+
+			stats.buffersQueued++;
+			stats.bytesUploaded += decoded;
+			pool->totals.buffersQueued++;
+			pool->totals.bytesUploaded += decoded;
+		}
 		else
 			decoded = 0;
 	}
 
+	p->releaseChunk();
+
 	// This shouldn't run after toLoop is calculated in this streamAtomic call,
 	// otherwise it'll decrease too quickly.
 	// TODO: this code is hard to understand, can it be made more clear?
@@ -1173,7 +1774,7 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 		}
 	}
 
-	if (decoder->isFinished() && isLooping())
+	if (endOfStream && isLooping())
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1182,12 +1783,85 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
+		p->rewind();
 	}
 
 	return decoded;
 }
 
+void Source::virtualizeAtomic(double offset, bool paused)
+{
+	virtualized = true;
+	virtualPaused = paused;
+	virtualOffset = offset;
+	virtualTime = timer::Timer::getTime();
+	pool->addVirtual(this);
+}
+
+bool Source::devirtualizeAtomic()
+{
+	double offset = getVirtualOffset();
+	virtualized = false;
+	virtualPaused = false;
+
+	// Streams start decoding at the offset, static Sources seek OpenAL to it.
+	if (sourceType == TYPE_STREAM)
+	{
+		prefetcher->seek(offset);
+		offsetSamples = 0;
+	}
+	else
+		offsetSamples = (int) (offset * sampleRate);
+
+	if (!playImmediate())
+		return false;
+
+	if (sourceType == TYPE_STREAM)
+		offsetSamples = (int) (offset * sampleRate);
+
+	return true;
+}
+
+void Source::unvirtualizeAtomic()
+{
+	virtualized = false;
+	virtualPaused = false;
+
+	if (sourceType == TYPE_STREAM)
+		prefetcher->rewind();
+}
+
+bool Source::updateVirtualAtomic()
+{
+	if (virtualPaused)
+		return true;
+
+	// Streams of unknown length keep playing until they're stopped or get a
+	// voice again.
+	double duration = getDuration(UNIT_SECONDS);
+	if (duration <= 0.0)
+		return true;
+
+	double offset = getVirtualOffset();
+	if (offset < duration)
+		return true;
+
+	if (!isLooping())
+		return false;
+
+	virtualOffset = fmod(offset, duration);
+	virtualTime = timer::Timer::getTime();
+	return true;
+}
+
+double Source::getVirtualOffset() const
+{
+	if (virtualPaused)
+		return virtualOffset;
+
+	return virtualOffset + (timer::Timer::getTime() - virtualTime) * pitch;
+}
+
 void Source::setMinVolume(float volume)
 {
 	if (valid)
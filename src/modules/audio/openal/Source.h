@@ -30,10 +30,12 @@
 #include "sound/Decoder.h"
 #include "Audio.h"
 #include "Filter.h"
+#include "Prefetcher.h"
 
 // STL
 #include <vector>
 #include <stack>
+#include <atomic>
 
 // C
 #include <float.h>
@@ -99,6 +101,7 @@ class Source : public love::audio::Source
 public:
 
 	Source(Pool *pool, love::sound::SoundData *soundData);
+	Source(Pool *pool, StaticDataBuffer *buffer, int sampleRate, int bitDepth, int channels);
 	Source(Pool *pool, love::sound::Decoder *decoder);
 	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers);
 	Source(const Source &s);
@@ -156,6 +159,25 @@ class Source : public love::audio::Source
 
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
+	virtual bool queue(love::sound::SoundData *data, size_t offset, size_t length);
+	virtual bool isQueued(const love::sound::SoundData *data) const;
+	virtual bool isVirtual() const;
+	virtual Stats getStats() const;
+
+	// Synchronous versions of play, stop and pause, used when applying the
+	// commands those post to the Pool.
+	bool playImmediate();
+	void stopImmediate();
+	void pauseImmediate();
+
+	inline StaticDataBuffer *getStaticBuffer() const
+	{
+		return staticBuffer.get();
+	}
+
+	// Query OpenAL directly, ignoring commands which haven't been applied.
+	bool isPlayingAtomic() const;
+	bool isFinishedAtomic() const;
 
 	void prepareAtomic();
 	void teardownAtomic();
@@ -165,6 +187,20 @@ class Source : public love::audio::Source
 	void pauseAtomic();
 	void resumeAtomic();
 
+	/**
+	 * Estimates how many seconds until this Source next needs update(), or
+	 * returns a negative value if it won't until its state changes.
+	 * The Pool must be locked.
+	 **/
+	double getUpdateDeadline() const;
+
+	/**
+	 * Estimates how loud this Source is at the listener, including distance
+	 * attenuation, to rank it against other Sources competing for a voice.
+	 * @param listener The listener position.
+	 **/
+	float getAudibility(const float *listener) const;
+
 	static bool play(const std::vector<love::audio::Source*> &sources);
 	static void stop(const std::vector<love::audio::Source*> &sources);
 	static void pause(const std::vector<love::audio::Source*> &sources);
@@ -174,23 +210,124 @@ class Source : public love::audio::Source
 
 private:
 
+	friend class Pool;
+
 	void reset();
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	int streamAtomic(ALuint buffer, Prefetcher *p);
+
+	// Keeps playing this Source without an OpenAL source, starting at the
+	// given offset in seconds. The Pool must be locked.
+	void virtualizeAtomic(double offset, bool paused);
+
+	// Gives this Source an OpenAL source again at its virtual playback
+	// position. The Pool must be locked and have a source available.
+	bool devirtualizeAtomic();
+
+	// Leaves the virtual voice list without playing.
+	void unvirtualizeAtomic();
+
+	// Advances the virtual playback position, wrapping it for looping
+	// Sources. Returns false once a non-looping Source has finished.
+	bool updateVirtualAtomic();
+
+	double getVirtualOffset() const;
+
+	// Gets the size of stream chunks which fill the buffers with the given
+	// duration of audio, whatever the sample format.
+	int getStreamChunkSize(double seconds) const;
+
+	// Gets the stream chunk size to start from, and to shrink back to.
+	int getBaseStreamChunkSize() const;
+
+	// Plays a queueable Source from an AL_SOFT_callback_buffer which reads
+	// queued data in place, instead of copying it into buffer objects.
+	void initCallbackBuffer();
+
+	// Adds data to the callback ring, referencing it when it comes from a
+	// SoundData and copying it otherwise. The Pool must be locked.
+	bool queueCallback(love::sound::SoundData *data, const void *bytes, size_t length);
+
+	// Drops the references to blocks the mixer is done with, or to every
+	// queued block. Returns the number of blocks which had been played.
+	// The Pool must be locked.
+	int releaseCallbackBlocks(bool all);
+
+	static ALsizei AL_APIENTRY bufferCallback(ALvoid *userptr, ALvoid *sampledata, ALsizei numbytes);
+
+	// Called from the OpenAL mixer.
+	ALsizei readCallback(uint8 *dst, ALsizei numbytes);
 
 	Pool *pool = nullptr;
 	ALuint source = 0;
 	bool valid = false;
 
+	// Updated by Pool::post without the Pool lock. claimed is set while this
+	// owns an OpenAL source or has a play command queued for one, and
+	// pendingCommand is the latest of pendingCommands unapplied commands.
+	std::atomic<bool> claimed {false};
+	std::atomic<int> pendingCommands {0};
+	std::atomic<int> pendingCommand {0};
+
+	// Virtual voices track their playback position from the time they were
+	// last (re)started, instead of from OpenAL.
+	bool virtualized = false;
+	bool virtualPaused = false;
+	double virtualOffset = 0.0;
+	double virtualTime = 0.0;
+
+	// Guarded by the Pool lock, like the Pool's totals which are updated
+	// alongside. decodeTimeSeen is the Prefetcher's decode time already
+	// counted.
+	Stats stats = {};
+	int64 decodeTimeSeen = 0;
+
 	const static int DEFAULT_BUFFERS = 8;
 	const static int MAX_BUFFERS = 64;
+
+	// Stream chunks start out holding as much audio as the output consumes
+	// at a time (see Audio::getOutputBufferSeconds), but at least
+	// MIN_STREAM_CHUNK_SECONDS. Each underrun doubles them, up to
+	// MAX_STREAM_BUFFER_SECONDS over all buffers, and they halve again for
+	// every STREAM_SHRINK_DELAY seconds played without one.
+	static constexpr double MIN_STREAM_CHUNK_SECONDS = 0.02;
+	static constexpr double MAX_STREAM_BUFFER_SECONDS = 3.0;
+	static constexpr double STREAM_SHRINK_DELAY = 5.0;
+	int baseStreamChunkSize = 0;
+	double streamResizeTime = 0.0;
 	std::queue<ALuint> streamBuffers;
 	std::stack<ALuint> unusedBuffers;
 
 	StrongRef<StaticDataBuffer> staticBuffer;
 
+	struct CallbackBlock
+	{
+		StrongRef<love::sound::SoundData> data;
+
+		// Holds data queued from a pointer. Reused as the ring wraps around.
+		std::vector<uint8> copy;
+
+		const uint8 *bytes = nullptr;
+		size_t size = 0;
+	};
+
+	// A single-producer, single-consumer ring of 'buffers' blocks. Blocks
+	// are added at callbackTail under the Pool lock, played from
+	// callbackHead by the OpenAL mixer, and released up to callbackHead by
+	// the Pool. callbackOffset is how far into the head block the mixer is,
+	// and callbackPlayed how many bytes it has played (or skipped, to seek)
+	// from blocks which aren't released yet.
+	ALuint callbackBuffer = 0;
+	std::vector<CallbackBlock> callbackBlocks;
+	std::atomic<uint64> callbackTail {0};
+	std::atomic<uint64> callbackHead {0};
+	uint64 callbackReleased = 0;
+	std::atomic<size_t> callbackOffset {0};
+	std::atomic<size_t> callbackSkip {0};
+	std::atomic<int64> callbackPlayed {0};
+
 	float pitch = 1.0f;
 	float volume = 1.0f;
 	float position[3];
@@ -220,6 +357,7 @@ class Source : public love::audio::Source
 	int bitDepth = 0;
 
 	StrongRef<love::sound::Decoder> decoder;
+	StrongRef<Prefetcher> prefetcher;
 
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
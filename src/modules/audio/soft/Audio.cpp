@@ -0,0 +1,374 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Audio.h"
+#include "common/delay.h"
+#include "timer/Timer.h"
+
+// STL
+#include <algorithm>
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+
+Audio::MixerThread::MixerThread(Mixer *mixer, bool device)
+	: mixer(mixer)
+	, device(device)
+	, finish(false)
+{
+	threadName = "AudioMixer";
+}
+
+Audio::MixerThread::~MixerThread()
+{
+}
+
+void Audio::MixerThread::threadFunction()
+{
+	std::vector<float> scratch(Source::MAX_MIX_FRAMES * 2);
+	float *out[2] = {scratch.data(), scratch.data() + Source::MAX_MIX_FRAMES};
+
+	double mixedTime = timer::Timer::getTime();
+
+	while (true)
+	{
+		{
+			thread::Lock lock(mutex);
+			if (finish)
+				return;
+		}
+
+		mixer->update();
+
+		// Keep the mix advancing in real time, as a playback device would.
+		if (device)
+		{
+			int frames = (int) ((timer::Timer::getTime() - mixedTime) * DEVICE_SAMPLE_RATE);
+			mixedTime += frames / (double) DEVICE_SAMPLE_RATE;
+
+			while (frames > 0)
+			{
+				int n = std::min(frames, (int) Source::MAX_MIX_FRAMES);
+				mixer->render(out, 0, n, DEVICE_SAMPLE_RATE);
+				frames -= n;
+			}
+		}
+
+		sleep(UPDATE_INTERVAL * 1000.0);
+	}
+}
+
+void Audio::MixerThread::setFinish()
+{
+	thread::Lock lock(mutex);
+	finish = true;
+}
+
+Audio::Audio()
+	: love::audio::Audio("love.audio.soft")
+	, mixer(nullptr)
+	, mixerThread(nullptr)
+	, loopback(getLoopbackOutput())
+	, dopplerScale(1.0f)
+{
+	mixer = new Mixer(Mixer::INTERPOLATION_CUBIC);
+
+	mixerThread = new MixerThread(mixer, loopback.get() == nullptr);
+	mixerThread->start();
+
+	if (loopback.get() != nullptr)
+		loopback->setRenderer(mixer);
+}
+
+Audio::~Audio()
+{
+	// Waits for a render in progress on the host's thread.
+	if (loopback.get() != nullptr)
+		loopback->setRenderer(nullptr);
+
+	mixerThread->setFinish();
+	mixerThread->wait();
+
+	delete mixerThread;
+	delete mixer;
+}
+
+love::audio::Source *Audio::newSource(love::sound::Decoder *decoder)
+{
+	return new Source(mixer, decoder);
+}
+
+love::audio::Source *Audio::newSource(love::sound::SoundData *soundData)
+{
+	return new Source(mixer, soundData);
+}
+
+love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels, int buffers)
+{
+	return new Source(mixer, sampleRate, bitDepth, channels, buffers);
+}
+
+int Audio::getActiveSourceCount() const
+{
+	thread::Lock l = mixer->lock();
+	return mixer->getVoiceCount();
+}
+
+int Audio::getMaxSources() const
+{
+	return Mixer::MAX_VOICES;
+}
+
+bool Audio::play(love::audio::Source *source)
+{
+	return source->play();
+}
+
+bool Audio::play(const std::vector<love::audio::Source*> &sources)
+{
+	for (auto s : sources)
+		((Source *) s)->prepare();
+
+	thread::Lock l = mixer->lock();
+
+	int added = 0;
+	for (auto s : sources)
+	{
+		if (!mixer->hasVoice((Source *) s))
+			added++;
+	}
+
+	if (mixer->getVoiceCount() + added > Mixer::MAX_VOICES)
+		return false;
+
+	// Start them all within the same render.
+	mixer->beginBatch();
+
+	bool success = true;
+	for (auto s : sources)
+		success = ((Source *) s)->playAtomic() && success;
+
+	mixer->endBatch();
+	return success;
+}
+
+void Audio::stop(love::audio::Source *source)
+{
+	source->stop();
+}
+
+void Audio::stop(const std::vector<love::audio::Source*> &sources)
+{
+	for (auto s : sources)
+		s->stop();
+}
+
+void Audio::stop()
+{
+	std::vector<love::audio::Source*> sources;
+	{
+		thread::Lock l = mixer->lock();
+		sources = mixer->getVoices();
+		for (auto s : sources)
+			s->retain();
+	}
+
+	for (auto s : sources)
+	{
+		s->stop();
+		s->release();
+	}
+}
+
+void Audio::pause(love::audio::Source *source)
+{
+	source->pause();
+}
+
+void Audio::pause(const std::vector<love::audio::Source*> &sources)
+{
+	thread::Lock l = mixer->lock();
+
+	mixer->beginBatch();
+	for (auto s : sources)
+		s->pause();
+	mixer->endBatch();
+}
+
+std::vector<love::audio::Source*> Audio::pause()
+{
+	thread::Lock l = mixer->lock();
+
+	std::vector<love::audio::Source*> sources = mixer->getVoices();
+	auto newend = std::remove_if(sources.begin(), sources.end(), [](love::audio::Source* s) {
+		return !s->isPlaying();
+	});
+	sources.erase(newend, sources.end());
+
+	mixer->beginBatch();
+	for (auto s : sources)
+		s->pause();
+	mixer->endBatch();
+
+	return sources;
+}
+
+void Audio::setVolume(float volume)
+{
+	mixer->setVolume(volume);
+}
+
+float Audio::getVolume() const
+{
+	return mixer->getVolume();
+}
+
+void Audio::getPosition(float *v) const
+{
+	mixer->getListenerPosition(v);
+}
+
+void Audio::setPosition(float *v)
+{
+	mixer->setListenerPosition(v);
+}
+
+void Audio::getOrientation(float *v) const
+{
+	mixer->getListenerOrientation(v);
+}
+
+void Audio::setOrientation(float *v)
+{
+	mixer->setListenerOrientation(v);
+}
+
+void Audio::getVelocity(float *v) const
+{
+	mixer->getListenerVelocity(v);
+}
+
+void Audio::setVelocity(float *v)
+{
+	mixer->setListenerVelocity(v);
+}
+
+void Audio::setDopplerScale(float scale)
+{
+	// Doppler shifts aren't simulated; kept for getDopplerScale.
+	dopplerScale = std::max(scale, 0.0f);
+}
+
+float Audio::getDopplerScale() const
+{
+	return dopplerScale;
+}
+
+const std::vector<love::audio::RecordingDevice*> &Audio::getRecordingDevices()
+{
+	return capture;
+}
+
+Audio::DistanceModel Audio::getDistanceModel() const
+{
+	return mixer->getDistanceModel();
+}
+
+void Audio::setDistanceModel(DistanceModel distanceModel)
+{
+	mixer->setDistanceModel(distanceModel);
+}
+
+bool Audio::setEffect(const char *, std::map<Effect::Parameter, float> &)
+{
+	return false;
+}
+
+bool Audio::unsetEffect(const char *)
+{
+	return false;
+}
+
+bool Audio::getEffect(const char *, std::map<Effect::Parameter, float> &)
+{
+	return false;
+}
+
+bool Audio::getActiveEffects(std::vector<std::string> &) const
+{
+	return false;
+}
+
+int Audio::getMaxSceneEffects() const
+{
+	return 0;
+}
+
+int Audio::getMaxSourceEffects() const
+{
+	return 0;
+}
+
+bool Audio::isEFXsupported() const
+{
+	return false;
+}
+
+bool Audio::isFloatSupported() const
+{
+	return true;
+}
+
+int Audio::getOutputSampleRate() const
+{
+	if (loopback.get() != nullptr)
+		return loopback->getSampleRate();
+
+	return DEVICE_SAMPLE_RATE;
+}
+
+void Audio::pauseContext()
+{
+	mixer->setPaused(true);
+}
+
+void Audio::resumeContext()
+{
+	mixer->setPaused(false);
+}
+
+std::string Audio::getPlaybackDevice()
+{
+	return loopback.get() != nullptr ? "Host" : "";
+}
+
+void Audio::getPlaybackDevices(std::vector<std::string> &list)
+{
+	if (loopback.get() != nullptr)
+		list.push_back("Host");
+}
+
+} // soft
+} // audio
+} // love
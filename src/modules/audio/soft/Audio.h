@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_SOFT_AUDIO_H
+#define LOVE_AUDIO_SOFT_AUDIO_H
+
+// LOVE
+#include "audio/Audio.h"
+#include "audio/LoopbackOutput.h"
+#include "thread/threads.h"
+
+#include "Mixer.h"
+#include "Source.h"
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+
+/**
+ * Mixes Sources in software instead of through OpenAL. With a LoopbackOutput
+ * the host's audio thread pulls the mix straight into its own buffers.
+ * Without one there's no device to play to, and a thread mixes in real time
+ * into a discarded buffer (e.g. for headless tests and benchmarks.)
+ **/
+class Audio : public love::audio::Audio
+{
+public:
+
+	Audio();
+	virtual ~Audio();
+
+	// Implements Audio.
+	love::audio::Source *newSource(love::sound::Decoder *decoder);
+	love::audio::Source *newSource(love::sound::SoundData *soundData);
+	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	int getActiveSourceCount() const;
+	int getMaxSources() const;
+	bool play(love::audio::Source *source);
+	bool play(const std::vector<love::audio::Source*> &sources);
+	void stop(love::audio::Source *source);
+	void stop(const std::vector<love::audio::Source*> &sources);
+	void stop();
+	void pause(love::audio::Source *source);
+	void pause(const std::vector<love::audio::Source*> &sources);
+	std::vector<love::audio::Source*> pause();
+	void setVolume(float volume);
+	float getVolume() const;
+
+	void getPosition(float *v) const;
+	void setPosition(float *v);
+	void getOrientation(float *v) const;
+	void setOrientation(float *v);
+	void getVelocity(float *v) const;
+	void setVelocity(float *v);
+
+	void setDopplerScale(float scale);
+	float getDopplerScale() const;
+
+	const std::vector<love::audio::RecordingDevice*> &getRecordingDevices();
+
+	DistanceModel getDistanceModel() const;
+	void setDistanceModel(DistanceModel distanceModel);
+
+	bool setEffect(const char *, std::map<Effect::Parameter, float> &params);
+	bool unsetEffect(const char *);
+	bool getEffect(const char *, std::map<Effect::Parameter, float> &params);
+	bool getActiveEffects(std::vector<std::string> &list) const;
+	int getMaxSceneEffects() const;
+	int getMaxSourceEffects() const;
+	bool isEFXsupported() const;
+	bool isFloatSupported() const;
+	int getOutputSampleRate() const;
+
+	void pauseContext();
+	void resumeContext();
+
+	std::string getPlaybackDevice();
+	void getPlaybackDevices(std::vector<std::string> &list);
+
+	// Sample rate the mixer runs at without a host.
+	static const int DEVICE_SAMPLE_RATE = 48000;
+
+private:
+
+	class MixerThread : public thread::Threadable
+	{
+	protected:
+		Mixer *mixer;
+
+		// Renders into a discarded buffer at DEVICE_SAMPLE_RATE when set.
+		bool device;
+
+		volatile bool finish;
+		love::thread::MutexRef mutex;
+
+	public:
+		// How often finished Sources are retired and streams decoded ahead.
+		static constexpr double UPDATE_INTERVAL = 0.005;
+
+		MixerThread(Mixer *mixer, bool device);
+		virtual ~MixerThread();
+		void setFinish();
+		void threadFunction();
+	};
+
+	Mixer *mixer;
+	MixerThread *mixerThread;
+
+	// Set when a host pulls the mix.
+	StrongRef<LoopbackOutput> loopback;
+
+	float dopplerScale;
+	std::vector<love::audio::RecordingDevice*> capture;
+
+}; // Audio
+
+} // soft
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_SOFT_AUDIO_H
@@ -0,0 +1,324 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Kernels.h"
+
+// C++
+#include <cstring>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+namespace kernels
+{
+
+void interleave(float *dst, const float *left, const float *right, size_t frames)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+	for (; i + 4 <= frames; i += 4)
+	{
+		__m128 l = _mm_loadu_ps(left + i);
+		__m128 r = _mm_loadu_ps(right + i);
+		_mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(l, r));
+		_mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(l, r));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 4 <= frames; i += 4)
+	{
+		float32x4x2_t lr;
+		lr.val[0] = vld1q_f32(left + i);
+		lr.val[1] = vld1q_f32(right + i);
+		vst2q_f32(dst + i * 2, lr);
+	}
+#endif
+
+	for (; i < frames; i++)
+	{
+		dst[i * 2 + 0] = left[i];
+		dst[i * 2 + 1] = right[i];
+	}
+}
+
+#if defined(LOVE_SIMD_SSE) || defined(LOVE_SIMD_NEON)
+
+// Just enough four-wide float math for the resamplers below, which are
+// otherwise the same for SSE and NEON. Plain multiplies and adds, never
+// fused, so the results round exactly like the scalar code.
+#if defined(LOVE_SIMD_SSE)
+typedef __m128 float4;
+
+static inline float4 load4(const float *p) { return _mm_loadu_ps(p); }
+static inline void store4(float *p, float4 x) { _mm_storeu_ps(p, x); }
+static inline float4 set4(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+static inline float4 splat4(float x) { return _mm_set1_ps(x); }
+static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+
+static inline void transpose4(float4 *v)
+{
+	_MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]);
+}
+#else
+typedef float32x4_t float4;
+
+static inline float4 load4(const float *p) { return vld1q_f32(p); }
+static inline void store4(float *p, float4 x) { vst1q_f32(p, x); }
+static inline float4 set4(float a, float b, float c, float d) { const float v[4] = {a, b, c, d}; return vld1q_f32(v); }
+static inline float4 splat4(float x) { return vdupq_n_f32(x); }
+static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+
+static inline void transpose4(float4 *v)
+{
+	float32x4x2_t a = vtrnq_f32(v[0], v[1]);
+	float32x4x2_t b = vtrnq_f32(v[2], v[3]);
+	v[0] = vcombine_f32(vget_low_f32(a.val[0]), vget_low_f32(b.val[0]));
+	v[1] = vcombine_f32(vget_low_f32(a.val[1]), vget_low_f32(b.val[1]));
+	v[2] = vcombine_f32(vget_high_f32(a.val[0]), vget_high_f32(b.val[0]));
+	v[3] = vcombine_f32(vget_high_f32(a.val[1]), vget_high_f32(b.val[1]));
+}
+#endif
+
+// Loads four floats at each of four offsets, transposed so that v[j] holds
+// the j'th float of every offset.
+static inline void load4x4(const float *src, const size_t *offset, float4 *v)
+{
+	for (int k = 0; k < 4; k++)
+		v[k] = load4(src + offset[k]);
+	transpose4(v);
+}
+
+static inline float4 gather4(const float *src, const size_t *offset)
+{
+	return set4(src[offset[0]], src[offset[1]], src[offset[2]], src[offset[3]]);
+}
+
+static inline float4 lerp4(float4 a, float4 b, float4 t)
+{
+	return add4(a, mul4(sub4(b, a), t));
+}
+
+static inline float4 catmullRom4(float4 x0, float4 x1, float4 x2, float4 x3, float4 t)
+{
+	const float4 half = splat4(0.5f);
+	const float4 neghalf = splat4(-0.5f);
+	const float4 k15 = splat4(1.5f);
+
+	float4 a = add4(sub4(add4(mul4(neghalf, x0), mul4(k15, x1)), mul4(k15, x2)), mul4(half, x3));
+	float4 b = sub4(add4(sub4(x0, mul4(splat4(2.5f), x1)), mul4(splat4(2.0f), x2)), mul4(half, x3));
+	float4 d = add4(mul4(neghalf, x0), mul4(half, x2));
+	return add4(mul4(add4(mul4(add4(mul4(a, t), b), t), d), t), x1);
+}
+
+#endif // LOVE_SIMD_SSE || LOVE_SIMD_NEON
+
+// Works out where four consecutive output frames read from: the offset of
+// each one's first input frame, and how far between frames it falls.
+static inline void getPositions(double pos, double step, size_t i, int channels, size_t *offset, float *frac)
+{
+	for (int k = 0; k < 4; k++)
+	{
+		// Multiply rather than accumulate, so rounding errors don't drift.
+		double p = pos + (i + k) * step;
+		size_t index = (size_t) p;
+		offset[k] = index * channels;
+		frac[k] = (float) (p - index);
+	}
+}
+
+void resampleLinear(float * const *dst, size_t frames, const float *src, int channels, double pos, double step)
+{
+	size_t i = 0;
+
+	// Unity rate at a whole frame is a straight deinterleave.
+	if (step == 1.0 && pos == (double) (size_t) pos)
+	{
+		const float *s = src + (size_t) pos * channels;
+		if (channels == 1)
+			memcpy(dst[0], s, frames * sizeof(float));
+		else
+		{
+#if defined(LOVE_SIMD_SSE) || defined(LOVE_SIMD_NEON)
+			if (channels == 2)
+			{
+				for (; i + 4 <= frames; i += 4)
+				{
+					float4 v[4];
+					size_t offset[4] = {0, 2, 4, 6};
+					load4x4(s + i * 2, offset, v);
+					store4(dst[0] + i, v[0]);
+					store4(dst[1] + i, v[1]);
+				}
+			}
+#endif
+
+			for (; i < frames; i++)
+			{
+				for (int c = 0; c < channels; c++)
+					dst[c][i] = s[i * channels + c];
+			}
+		}
+		return;
+	}
+
+#if defined(LOVE_SIMD_SSE) || defined(LOVE_SIMD_NEON)
+	// Four output frames at a time. Stereo reads both input frames of each
+	// output frame with one load and transposes them into place; other
+	// layouts gather sample by sample.
+	for (; i + 4 <= frames; i += 4)
+	{
+		size_t offset[4];
+		float frac[4];
+		getPositions(pos, step, i, channels, offset, frac);
+
+		float4 t = load4(frac);
+
+		if (channels == 2)
+		{
+			float4 v[4];
+			load4x4(src, offset, v);
+			store4(dst[0] + i, lerp4(v[0], v[2], t));
+			store4(dst[1] + i, lerp4(v[1], v[3], t));
+			continue;
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			float4 a = gather4(src + c, offset);
+			float4 b = gather4(src + c + channels, offset);
+			store4(dst[c] + i, lerp4(a, b, t));
+		}
+	}
+#endif
+
+	for (; i < frames; i++)
+	{
+		double p = pos + i * step;
+		size_t index = (size_t) p;
+		float frac = (float) (p - index);
+
+		const float *a = src + index * channels;
+		const float *b = a + channels;
+
+		for (int c = 0; c < channels; c++)
+			dst[c][i] = a[c] + (b[c] - a[c]) * frac;
+	}
+}
+
+void resampleCubic(float * const *dst, size_t frames, const float *src, int channels, double pos, double step)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE) || defined(LOVE_SIMD_NEON)
+	// As in resampleLinear. The four input frames of a mono output frame are
+	// one load, and two for stereo.
+	for (; i + 4 <= frames; i += 4)
+	{
+		size_t offset[4];
+		float frac[4];
+		getPositions(pos, step, i, channels, offset, frac);
+
+		float4 t = load4(frac);
+
+		// Offsets of the first of the four frames.
+		for (int k = 0; k < 4; k++)
+			offset[k] -= channels;
+
+		if (channels == 1)
+		{
+			float4 x[4];
+			load4x4(src, offset, x);
+			store4(dst[0] + i, catmullRom4(x[0], x[1], x[2], x[3], t));
+			continue;
+		}
+		else if (channels == 2)
+		{
+			float4 a[4], b[4];
+			load4x4(src, offset, a);
+			load4x4(src + 4, offset, b);
+			store4(dst[0] + i, catmullRom4(a[0], a[2], b[0], b[2], t));
+			store4(dst[1] + i, catmullRom4(a[1], a[3], b[1], b[3], t));
+			continue;
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			const float *x0 = src + c;
+			float4 v0 = gather4(x0, offset);
+			float4 v1 = gather4(x0 + channels, offset);
+			float4 v2 = gather4(x0 + channels * 2, offset);
+			float4 v3 = gather4(x0 + channels * 3, offset);
+			store4(dst[c] + i, catmullRom4(v0, v1, v2, v3, t));
+		}
+	}
+#endif
+
+	for (; i < frames; i++)
+	{
+		double p = pos + i * step;
+		size_t index = (size_t) p;
+		float t = (float) (p - index);
+
+		const float *x1 = src + index * channels;
+		const float *x0 = x1 - channels;
+		const float *x2 = x1 + channels;
+		const float *x3 = x2 + channels;
+
+		// Catmull-Rom spline through the four nearest frames.
+		for (int c = 0; c < channels; c++)
+		{
+			float a = -0.5f * x0[c] + 1.5f * x1[c] - 1.5f * x2[c] + 0.5f * x3[c];
+			float b = x0[c] - 2.5f * x1[c] + 2.0f * x2[c] - 0.5f * x3[c];
+			float d = -0.5f * x0[c] + 0.5f * x2[c];
+			dst[c][i] = ((a * t + b) * t + d) * t + x1[c];
+		}
+	}
+}
+
+void splitBands(float *buf, size_t count, float &state, float coefficient, float lowGain, float highGain)
+{
+	float low = state;
+	for (size_t i = 0; i < count; i++)
+	{
+		low += coefficient * (buf[i] - low);
+		buf[i] = low * lowGain + (buf[i] - low) * highGain;
+	}
+	state = low;
+}
+
+} // kernels
+} // soft
+} // audio
+} // love
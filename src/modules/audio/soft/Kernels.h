@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_SOFT_KERNELS_H
+#define LOVE_AUDIO_SOFT_KERNELS_H
+
+// LOVE
+#include "common/config.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+namespace kernels
+{
+
+// Sample conversion and gain are shared with SoundData, in sound/Kernels.h.
+
+/**
+ * Interleaves two planar channels into stereo frames.
+ **/
+void interleave(float *dst, const float *left, const float *right, size_t frames);
+
+/**
+ * Resamples interleaved input into planar output, starting at the fractional
+ * input frame 'pos' and advancing 'step' input frames per output frame.
+ * Linear interpolation reads input frames [floor(pos), floor(pos) + 1] and
+ * cubic interpolation reads [floor(pos) - 1, floor(pos) + 2], so the input
+ * must cover those for every output frame. With SSE or NEON, four output
+ * frames are interpolated at once, with the same results.
+ **/
+void resampleLinear(float * const *dst, size_t frames, const float *src, int channels, double pos, double step);
+void resampleCubic(float * const *dst, size_t frames, const float *src, int channels, double pos, double step);
+
+/**
+ * One-pole low/high band split of 'count' samples, recombined with separate
+ * gains. 'state' carries the low-passed signal across calls.
+ **/
+void splitBands(float *buf, size_t count, float &state, float coefficient, float lowGain, float highGain);
+
+} // kernels
+} // soft
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_SOFT_KERNELS_H
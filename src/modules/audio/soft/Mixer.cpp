@@ -0,0 +1,511 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Mixer.h"
+#include "Source.h"
+#include "Kernels.h"
+#include "sound/Kernels.h"
+#include "common/delay.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+
+Mixer::Mixer(Interpolation interpolation)
+	: heldVoices(0)
+	, params()
+	, batching(false)
+	, rendering(false)
+	, mixVoices()
+	, mixVoiceCount(0)
+	, mixParams()
+	, interpolation(interpolation)
+	, window(Source::WINDOW_FRAMES * 2)
+	, channelData(Source::MAX_MIX_FRAMES * 2)
+{
+	params.volume = 1.0f;
+	params.distanceModel = Audio::DISTANCE_INVERSE_CLAMPED;
+	params.paused = false;
+
+	// OpenAL's default orientation: facing -Z with +Y up.
+	params.listenerOrientation[2] = -1.0f;
+	params.listenerOrientation[4] = 1.0f;
+
+	mixParams = params;
+
+	channelBuffers[0] = channelData.data();
+	channelBuffers[1] = channelData.data() + Source::MAX_MIX_FRAMES;
+
+	voices.reserve(MAX_VOICES);
+}
+
+Mixer::~Mixer()
+{
+	// Nothing renders anymore. Settle the posted commands, then let go of
+	// every voice the audio thread still had.
+	applyCommands();
+
+	Source *s = nullptr;
+	while (stoppedVoices.pop(s))
+		s->release();
+
+	for (int i = 0; i < mixVoiceCount; i++)
+		mixVoices[i]->release();
+}
+
+void Mixer::render(float * const *out, int offset, int frames, int sampleRate)
+{
+	float *dst[2] = {out[0] + offset, out[1] + offset};
+	memset(dst[0], 0, frames * sizeof(float));
+	memset(dst[1], 0, frames * sizeof(float));
+
+	// A control thread is applying commands itself (see flush.) Output
+	// silence rather than wait for it.
+	if (rendering.exchange(true, std::memory_order_acquire))
+		return;
+
+	applyCommands();
+
+	if (!mixParams.paused && sampleRate > 0)
+	{
+		for (int done = 0; done < frames; done += Source::MAX_MIX_FRAMES)
+		{
+			int n = std::min(frames - done, (int) Source::MAX_MIX_FRAMES);
+			float *chunk[2] = {dst[0] + done, dst[1] + done};
+
+			for (int i = 0; i < mixVoiceCount; i++)
+			{
+				Source *s = mixVoices[i];
+				if (!s->mixPaused && !s->mixFinished)
+					s->mixAtomic(chunk, n, sampleRate);
+			}
+		}
+
+		love::sound::kernels::applyGain(dst[0], frames, mixParams.volume);
+		love::sound::kernels::applyGain(dst[1], frames, mixParams.volume);
+	}
+
+	rendering.store(false, std::memory_order_release);
+}
+
+void Mixer::update()
+{
+	std::vector<Source *> finished;
+	std::vector<Source *> streams;
+
+	{
+		thread::Lock l(mutex);
+
+		reclaimVoices();
+
+		for (size_t i = 0; i < voices.size();)
+		{
+			Source *s = voices[i];
+			s->reclaimBlocks();
+
+			if (s->isFinishedAtomic())
+			{
+				// The voice's own reference goes once the audio thread lets
+				// go of it, so keep the Source alive for resetFinished.
+				s->retain();
+				removeVoice(s);
+
+				s->playing = false;
+				s->paused = false;
+				finished.push_back(s);
+				continue;
+			}
+
+			if (s->getType() == Source::TYPE_STREAM)
+			{
+				s->retain();
+				streams.push_back(s);
+			}
+
+			i++;
+		}
+	}
+
+	// Decoding happens outside the lock so it never holds up other threads.
+	for (Source *s : streams)
+	{
+		s->decodeAhead();
+		s->release();
+	}
+
+	for (Source *s : finished)
+	{
+		s->resetFinished();
+		s->release();
+	}
+}
+
+thread::Lock Mixer::lock()
+{
+	return thread::Lock(mutex);
+}
+
+void Mixer::post(const Command &command)
+{
+	if (command.source != nullptr)
+		command.source->pendingCommands.fetch_add(1, std::memory_order_relaxed);
+
+	if (batching)
+	{
+		batch.push_back(command);
+		return;
+	}
+
+	// The audio thread isn't keeping up, or isn't being called at all.
+	while (!commands.push(command))
+		flush();
+}
+
+void Mixer::beginBatch()
+{
+	batching = true;
+}
+
+void Mixer::endBatch()
+{
+	batching = false;
+
+	if (batch.size() <= MAX_COMMANDS)
+	{
+		while (!batch.empty() && !commands.push(batch.data(), batch.size()))
+			flush();
+	}
+	else
+	{
+		// Too big to hand over at once.
+		for (const Command &command : batch)
+		{
+			while (!commands.push(command))
+				flush();
+		}
+	}
+
+	batch.clear();
+}
+
+void Mixer::flush()
+{
+	// Renders are short, so spin until the one in progress is done.
+	bool expected = false;
+	while (!rendering.compare_exchange_weak(expected, true, std::memory_order_acquire))
+	{
+		expected = false;
+		love::sleep(0.0);
+	}
+
+	applyCommands();
+
+	rendering.store(false, std::memory_order_release);
+}
+
+void Mixer::applyCommands()
+{
+	Command command;
+	while (commands.pop(command))
+		applyCommand(command);
+}
+
+void Mixer::applyCommand(const Command &command)
+{
+	Source *s = command.source;
+
+	switch (command.type)
+	{
+	case COMMAND_PLAY:
+		if (std::find(mixVoices, mixVoices + mixVoiceCount, s) == mixVoices + mixVoiceCount)
+			mixVoices[mixVoiceCount++] = s;
+
+		s->mixPlaySerial = command.serial;
+		s->mixPaused = false;
+		s->mixFinished = false;
+		break;
+	case COMMAND_STOP:
+		for (int i = 0; i < mixVoiceCount; i++)
+		{
+			if (mixVoices[i] == s)
+			{
+				mixVoices[i] = mixVoices[--mixVoiceCount];
+				break;
+			}
+		}
+
+		// The Source may be released as soon as it's handed back.
+		s->pendingCommands.fetch_sub(1, std::memory_order_release);
+		stoppedVoices.push(s);
+		return;
+	case COMMAND_PAUSE:
+		s->mixPaused = command.paused;
+		break;
+	case COMMAND_PARAMS:
+		if (!command.params.hasFilter)
+			s->filterState[0] = s->filterState[1] = 0.0f;
+		s->mixParams = command.params;
+		break;
+	case COMMAND_BLOCK:
+		s->addBlockAtomic(command.block);
+		break;
+	case COMMAND_SEEK:
+		s->applySeekAtomic(command.position);
+		s->seekDone.store(command.serial, std::memory_order_release);
+		break;
+	case COMMAND_RESET:
+		s->applyResetAtomic(command.position);
+		s->seekDone.store(command.serial, std::memory_order_release);
+		break;
+	case COMMAND_LISTENER:
+		mixParams = command.listener;
+		return;
+	}
+
+	s->pendingCommands.fetch_sub(1, std::memory_order_release);
+}
+
+void Mixer::reclaimVoices()
+{
+	Source *s = nullptr;
+	while (stoppedVoices.pop(s))
+	{
+		heldVoices--;
+		s->release();
+	}
+}
+
+bool Mixer::addVoice(Source *source)
+{
+	if (std::find(voices.begin(), voices.end(), source) == voices.end())
+	{
+		if ((int) voices.size() >= MAX_VOICES)
+			return false;
+
+		// Stopped voices still count until the audio thread hands them back.
+		if (heldVoices >= MAX_VOICES)
+		{
+			flush();
+			reclaimVoices();
+		}
+
+		voices.push_back(source);
+		source->retain();
+		heldVoices++;
+	}
+
+	Command command = {};
+	command.type = COMMAND_PLAY;
+	command.source = source;
+	command.serial = source->playSerial;
+	post(command);
+
+	return true;
+}
+
+bool Mixer::removeVoice(Source *source)
+{
+	auto it = std::find(voices.begin(), voices.end(), source);
+	if (it == voices.end())
+		return false;
+
+	voices.erase(it);
+
+	Command command = {};
+	command.type = COMMAND_STOP;
+	command.source = source;
+	post(command);
+
+	return true;
+}
+
+bool Mixer::hasVoice(Source *source) const
+{
+	return std::find(voices.begin(), voices.end(), source) != voices.end();
+}
+
+std::vector<love::audio::Source *> Mixer::getVoices() const
+{
+	return std::vector<love::audio::Source *>(voices.begin(), voices.end());
+}
+
+int Mixer::getVoiceCount() const
+{
+	return (int) voices.size();
+}
+
+void Mixer::postListener()
+{
+	Command command = {};
+	command.type = COMMAND_LISTENER;
+	command.listener = params;
+	post(command);
+}
+
+void Mixer::setVolume(float volume)
+{
+	thread::Lock l(mutex);
+	params.volume = volume;
+	postListener();
+}
+
+float Mixer::getVolume() const
+{
+	return params.volume;
+}
+
+void Mixer::setListenerPosition(const float *v)
+{
+	thread::Lock l(mutex);
+	memcpy(params.listenerPosition, v, sizeof(float) * 3);
+	postListener();
+}
+
+void Mixer::getListenerPosition(float *v) const
+{
+	memcpy(v, params.listenerPosition, sizeof(float) * 3);
+}
+
+void Mixer::setListenerOrientation(const float *v)
+{
+	thread::Lock l(mutex);
+	memcpy(params.listenerOrientation, v, sizeof(float) * 6);
+	postListener();
+}
+
+void Mixer::getListenerOrientation(float *v) const
+{
+	memcpy(v, params.listenerOrientation, sizeof(float) * 6);
+}
+
+void Mixer::setListenerVelocity(const float *v)
+{
+	thread::Lock l(mutex);
+	memcpy(params.listenerVelocity, v, sizeof(float) * 3);
+	postListener();
+}
+
+void Mixer::getListenerVelocity(float *v) const
+{
+	memcpy(v, params.listenerVelocity, sizeof(float) * 3);
+}
+
+void Mixer::setDistanceModel(Audio::DistanceModel model)
+{
+	thread::Lock l(mutex);
+	params.distanceModel = model;
+	postListener();
+}
+
+Audio::DistanceModel Mixer::getDistanceModel() const
+{
+	return params.distanceModel;
+}
+
+void Mixer::setPaused(bool paused)
+{
+	thread::Lock l(mutex);
+	params.paused = paused;
+	postListener();
+}
+
+const Mixer::Params &Mixer::getMixParams() const
+{
+	return mixParams;
+}
+
+float Mixer::getDistanceGain(float distance, float referenceDistance, float rolloffFactor, float maxDistance) const
+{
+	switch (mixParams.distanceModel)
+	{
+	case Audio::DISTANCE_INVERSE_CLAMPED:
+		distance = std::min(std::max(distance, referenceDistance), maxDistance);
+		// Fallthrough.
+	case Audio::DISTANCE_INVERSE:
+	{
+		float d = referenceDistance + rolloffFactor * (distance - referenceDistance);
+		return d > 0.0f ? referenceDistance / d : 1.0f;
+	}
+	case Audio::DISTANCE_LINEAR_CLAMPED:
+		distance = std::max(distance, referenceDistance);
+		// Fallthrough.
+	case Audio::DISTANCE_LINEAR:
+		distance = std::min(distance, maxDistance);
+		if (maxDistance <= referenceDistance)
+			return 1.0f;
+		return std::max(1.0f - rolloffFactor * (distance - referenceDistance) / (maxDistance - referenceDistance), 0.0f);
+	case Audio::DISTANCE_EXPONENT_CLAMPED:
+		distance = std::min(std::max(distance, referenceDistance), maxDistance);
+		// Fallthrough.
+	case Audio::DISTANCE_EXPONENT:
+		if (distance <= 0.0f || referenceDistance <= 0.0f)
+			return 1.0f;
+		return powf(distance / referenceDistance, -rolloffFactor);
+	case Audio::DISTANCE_NONE:
+	case Audio::DISTANCE_MAX_ENUM:
+		break;
+	}
+
+	return 1.0f;
+}
+
+void Mixer::getListenerRight(float *v) const
+{
+	const float *f = mixParams.listenerOrientation;
+	const float *u = mixParams.listenerOrientation + 3;
+
+	v[0] = f[1] * u[2] - f[2] * u[1];
+	v[1] = f[2] * u[0] - f[0] * u[2];
+	v[2] = f[0] * u[1] - f[1] * u[0];
+
+	float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	if (length > 0.0f)
+	{
+		for (int i = 0; i < 3; i++)
+			v[i] /= length;
+	}
+}
+
+Mixer::Interpolation Mixer::getInterpolation() const
+{
+	return interpolation;
+}
+
+float *Mixer::getWindow()
+{
+	return window.data();
+}
+
+float * const *Mixer::getChannelBuffers()
+{
+	return channelBuffers;
+}
+
+} // soft
+} // audio
+} // love
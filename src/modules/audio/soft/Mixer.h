@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_SOFT_MIXER_H
+#define LOVE_AUDIO_SOFT_MIXER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/SPSCQueue.h"
+#include "audio/Audio.h"
+#include "audio/LoopbackOutput.h"
+#include "thread/threads.h"
+
+#include "Source.h"
+
+// STL
+#include <atomic>
+#include <vector>
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+
+/**
+ * Mixes playing Sources into planar stereo float buffers. The Mixer is
+ * pulled either by the host's audio thread through a LoopbackOutput, or by
+ * the Audio module's own device thread when there's no host.
+ *
+ * Threads controlling Sources are serialized by the Mixer lock, which the
+ * audio thread never takes. Instead they post commands, which render()
+ * applies before mixing, and the audio thread publishes positions and
+ * retired blocks and voices back through atomics and queues.
+ **/
+class Mixer : public LoopbackOutput::Renderer
+{
+public:
+
+	enum Interpolation
+	{
+		INTERPOLATION_LINEAR,
+		INTERPOLATION_CUBIC,
+	};
+
+	// Upper bound on the number of Sources playing at once, which bounds
+	// the time a render can take.
+	static const int MAX_VOICES = 256;
+
+	enum CommandType
+	{
+		COMMAND_PLAY,
+		COMMAND_STOP,
+		COMMAND_PAUSE,
+		COMMAND_PARAMS,
+		COMMAND_BLOCK,
+		COMMAND_SEEK,
+		COMMAND_RESET,
+		COMMAND_LISTENER,
+	};
+
+	// Listener and output settings, copied to the audio thread as a whole.
+	struct Params
+	{
+		float volume;
+		float listenerPosition[3];
+		float listenerOrientation[6];
+		float listenerVelocity[3];
+		Audio::DistanceModel distanceModel;
+		bool paused;
+	};
+
+	struct Command
+	{
+		CommandType type;
+		Source *source;
+
+		// COMMAND_PLAY: the play serial. COMMAND_SEEK and COMMAND_RESET: the
+		// seek serial.
+		uint32 serial;
+
+		// COMMAND_PAUSE.
+		bool paused;
+
+		// COMMAND_SEEK and COMMAND_RESET, in frames.
+		double position;
+
+		Source::Block *block;
+		Source::Params params;
+		Params listener;
+	};
+
+	Mixer(Interpolation interpolation);
+	virtual ~Mixer();
+
+	// Implements LoopbackOutput::Renderer.
+	void render(float * const *out, int offset, int frames, int sampleRate) override;
+
+	/**
+	 * Retires finished Sources and keeps streams decoded ahead of the mix.
+	 * Called periodically off the audio thread.
+	 **/
+	void update();
+
+	LOVE_WARN_UNUSED thread::Lock lock();
+
+	/**
+	 * Posts a command for the audio thread, which applies it before its next
+	 * render. If the queue is full (e.g. the host stopped rendering) the
+	 * commands are applied right away instead. The Mixer must be locked.
+	 **/
+	void post(const Command &command);
+
+	/**
+	 * Holds back posted commands until endBatch, so that the audio thread
+	 * sees them all in the same render. The Mixer must be locked.
+	 **/
+	void beginBatch();
+	void endBatch();
+
+	/**
+	 * Applies every posted command now, waiting for a render in progress to
+	 * finish first. Used when a control thread needs what the audio thread
+	 * publishes to reflect its latest commands.
+	 **/
+	void flush();
+
+	// Voices. The Mixer must be locked. Adding a voice (again) posts a play
+	// command, and removing it a stop command.
+	bool addVoice(Source *source);
+	bool removeVoice(Source *source);
+	bool hasVoice(Source *source) const;
+	std::vector<love::audio::Source *> getVoices() const;
+	int getVoiceCount() const;
+
+	void setVolume(float volume);
+	float getVolume() const;
+
+	void setListenerPosition(const float *v);
+	void getListenerPosition(float *v) const;
+	void setListenerOrientation(const float *v);
+	void getListenerOrientation(float *v) const;
+	void setListenerVelocity(const float *v);
+	void getListenerVelocity(float *v) const;
+
+	void setDistanceModel(Audio::DistanceModel model);
+	Audio::DistanceModel getDistanceModel() const;
+
+	void setPaused(bool paused);
+
+	// The listener as the audio thread sees it. Audio thread only.
+	const Params &getMixParams() const;
+
+	/**
+	 * Gets the gain a Source at the given distance from the listener gets
+	 * from the current distance model, as OpenAL defines it. Audio thread
+	 * only.
+	 **/
+	float getDistanceGain(float distance, float referenceDistance, float rolloffFactor, float maxDistance) const;
+
+	/**
+	 * Gets the unit vector pointing to the listener's right. Audio thread
+	 * only.
+	 **/
+	void getListenerRight(float *v) const;
+
+	Interpolation getInterpolation() const;
+
+	// Scratch buffers for Source::mixAtomic. Only valid while rendering.
+	float *getWindow();
+	float * const *getChannelBuffers();
+
+private:
+
+	// Applies posted commands. The render flag must be held.
+	void applyCommands();
+	void applyCommand(const Command &command);
+
+	// Releases the voices the audio thread let go of. The Mixer must be
+	// locked.
+	void reclaimVoices();
+
+	void postListener();
+
+	// Maximum number of posted commands waiting for the audio thread.
+	static const size_t MAX_COMMANDS = 1024;
+
+	love::thread::MutexRef mutex;
+
+	// Control side voices. Each holds a reference, which the audio thread
+	// hands back through 'stoppedVoices' once it drops the voice.
+	std::vector<Source *> voices;
+
+	// Voices the audio thread still references, including stopped ones not
+	// yet reclaimed.
+	int heldVoices;
+
+	Params params;
+
+	bool batching;
+	std::vector<Command> batch;
+
+	SPSCQueue<Command, MAX_COMMANDS> commands;
+	SPSCQueue<Source *, MAX_VOICES> stoppedVoices;
+
+	// Held by render(), or by flush() on a control thread. Whoever holds it
+	// owns the mix side of the Mixer and of every Source.
+	std::atomic<bool> rendering;
+
+	// Mix side.
+	Source *mixVoices[MAX_VOICES];
+	int mixVoiceCount;
+	Params mixParams;
+
+	Interpolation interpolation;
+
+	std::vector<float> window;
+	std::vector<float> channelData;
+	float *channelBuffers[2];
+
+}; // Mixer
+
+} // soft
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_SOFT_MIXER_H
@@ -0,0 +1,1342 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Source.h"
+#include "Mixer.h"
+#include "Kernels.h"
+#include "sound/Kernels.h"
+#include "common/math.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+
+class InvalidFormatException : public love::Exception
+{
+public:
+
+	InvalidFormatException(int channels, int bitdepth)
+		: Exception("%d-channel Sources with %d bits per sample are not supported.", channels, bitdepth)
+	{
+	}
+
+};
+
+class SpatialSupportException : public love::Exception
+{
+public:
+
+	SpatialSupportException()
+		: Exception("This spatial audio functionality is only available for mono Sources. \
+Ensure the Source is not multi-channel before calling this function.")
+	{
+	}
+
+};
+
+class QueueFormatMismatchException : public love::Exception
+{
+public:
+
+	QueueFormatMismatchException()
+		: Exception("Queued sound data must have same format as sound Source.")
+	{
+	}
+
+};
+
+class QueueTypeMismatchException : public love::Exception
+{
+public:
+
+	QueueTypeMismatchException()
+		: Exception("Only queueable Sources can be queued with sound data.")
+	{
+	}
+
+};
+
+class QueueMalformedLengthException : public love::Exception
+{
+public:
+
+	QueueMalformedLengthException(int bytes)
+		: Exception("Data length must be a multiple of sample size (%d bytes).", bytes)
+	{
+	}
+
+};
+
+class QueueLoopingException : public love::Exception
+{
+public:
+
+	QueueLoopingException()
+		: Exception("Queueable Sources can not be looped.")
+	{
+	}
+
+};
+
+static bool isSupportedFormat(int bitDepth, int channels)
+{
+	return (bitDepth == 8 || bitDepth == 16 || bitDepth == 32) && (channels == 1 || channels == 2);
+}
+
+SampleBuffer::SampleBuffer(const void *data, size_t frames, int channels, int bitDepth)
+	: samples(frames * channels)
+	, frames(frames)
+{
+	love::sound::kernels::toFloat(samples.data(), data, samples.size(), bitDepth);
+}
+
+SampleBuffer::~SampleBuffer()
+{
+}
+
+Source::Source(Mixer *mixer, love::sound::SoundData *soundData)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, mixer(mixer)
+	, sampleRate(soundData->getSampleRate())
+	, channels(soundData->getChannelCount())
+	, bitDepth(soundData->getBitDepth())
+{
+	if (!isSupportedFormat(bitDepth, channels))
+		throw InvalidFormatException(channels, bitDepth);
+
+	staticBuffer.set(new SampleBuffer(soundData->getData(), soundData->getSampleCount(), channels, bitDepth), Acquire::NORETAIN);
+
+	float z[3] = {0, 0, 0};
+
+	setFloatv(sourcePosition, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+	filterState[0] = filterState[1] = 0.0f;
+	mixParams = getParams();
+}
+
+Source::Source(Mixer *mixer, love::sound::Decoder *decoder)
+	: love::audio::Source(Source::TYPE_STREAM)
+	, mixer(mixer)
+	, decoder(decoder)
+	, sampleRate(decoder->getSampleRate())
+	, channels(decoder->getChannelCount())
+	, bitDepth(decoder->getBitDepth())
+{
+	if (!isSupportedFormat(bitDepth, channels))
+		throw InvalidFormatException(channels, bitDepth);
+
+	float z[3] = {0, 0, 0};
+
+	setFloatv(sourcePosition, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+	filterState[0] = filterState[1] = 0.0f;
+	mixParams = getParams();
+}
+
+Source::Source(Mixer *mixer, int sampleRate, int bitDepth, int channels, int buffers)
+	: love::audio::Source(Source::TYPE_QUEUE)
+	, mixer(mixer)
+	, sampleRate(sampleRate)
+	, channels(channels)
+	, bitDepth(bitDepth)
+	, buffers(buffers)
+{
+	if (!isSupportedFormat(bitDepth, channels))
+		throw InvalidFormatException(channels, bitDepth);
+
+	if (this->buffers < 1)
+		this->buffers = DEFAULT_BUFFERS;
+	if (this->buffers > MAX_BUFFERS)
+		this->buffers = MAX_BUFFERS;
+
+	float z[3] = {0, 0, 0};
+
+	setFloatv(sourcePosition, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+	filterState[0] = filterState[1] = 0.0f;
+	mixParams = getParams();
+}
+
+Source::Source(const Source &s)
+	: love::audio::Source(s)
+	, mixer(s.mixer)
+	, staticBuffer(s.staticBuffer)
+	, pitch(s.pitch)
+	, volume(s.volume)
+	, relative(s.relative)
+	, looping(s.looping)
+	, minVolume(s.minVolume)
+	, maxVolume(s.maxVolume)
+	, referenceDistance(s.referenceDistance)
+	, rolloffFactor(s.rolloffFactor)
+	, absorptionFactor(s.absorptionFactor)
+	, maxDistance(s.maxDistance)
+	, cone(s.cone)
+	, sampleRate(s.sampleRate)
+	, channels(s.channels)
+	, bitDepth(s.bitDepth)
+	, buffers(s.buffers)
+	, hasFilter(s.hasFilter)
+	, filterParams(s.filterParams)
+{
+	if (sourceType == TYPE_STREAM && s.decoder.get())
+		decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+
+	setFloatv(sourcePosition, s.sourcePosition);
+	setFloatv(velocity, s.velocity);
+	setFloatv(direction, s.direction);
+	filterState[0] = filterState[1] = 0.0f;
+	mixParams = getParams();
+}
+
+Source::~Source()
+{
+	// Commands for this Source may still be waiting for the audio thread.
+	// Voices hold a reference, so it isn't mixing this Source otherwise.
+	if (pendingCommands.load(std::memory_order_acquire) > 0)
+		mixer->flush();
+
+	while (mixBlocks.count > 0)
+		delete mixBlocks.pop();
+
+	Block *block = nullptr;
+	while (playedBlocks.pop(block))
+		delete block;
+
+	for (Block *b : spareBlocks)
+		delete b;
+}
+
+love::audio::Source *Source::clone()
+{
+	return new Source(*this);
+}
+
+bool Source::play()
+{
+	prepare();
+
+	thread::Lock l = mixer->lock();
+	return playAtomic();
+}
+
+void Source::prepare()
+{
+	// A stream which just ran out has to start over from the beginning.
+	if (sourceType == TYPE_STREAM && isFinished())
+		resetStream(0.0);
+
+	// Have the first blocks ready before the Mixer can reach them.
+	decodeAhead();
+}
+
+bool Source::playAtomic()
+{
+	if (!playing || isFinishedAtomic())
+	{
+		// A new serial, so the audio thread running out of audio earlier
+		// doesn't count for this play.
+		playSerial++;
+		if (!mixer->addVoice(this))
+			return false;
+
+		playing = true;
+	}
+	else if (paused)
+		postPause(false);
+
+	paused = false;
+	return true;
+}
+
+void Source::stop()
+{
+	{
+		thread::Lock l = mixer->lock();
+
+		mixer->removeVoice(this);
+		playing = false;
+		paused = false;
+
+		if (sourceType == TYPE_STATIC)
+			postSeek(0.0);
+		else if (sourceType == TYPE_QUEUE)
+			postReset((double) decodedFrames);
+	}
+
+	if (sourceType == TYPE_STREAM)
+		resetStream(0.0);
+}
+
+void Source::pause()
+{
+	thread::Lock l = mixer->lock();
+	if (playing && !paused)
+	{
+		paused = true;
+		postPause(true);
+	}
+}
+
+bool Source::isPlaying() const
+{
+	thread::Lock l = mixer->lock();
+	return playing && !paused && !isFinishedAtomic();
+}
+
+bool Source::isFinished() const
+{
+	thread::Lock l = mixer->lock();
+	return playing && isFinishedAtomic();
+}
+
+bool Source::isFinishedAtomic() const
+{
+	return finishedSerial.load(std::memory_order_acquire) == playSerial;
+}
+
+bool Source::update()
+{
+	thread::Lock l = mixer->lock();
+	return playing && !isFinishedAtomic();
+}
+
+void Source::setPitch(float pitch)
+{
+	thread::Lock l = mixer->lock();
+	this->pitch = pitch;
+	postParams();
+}
+
+float Source::getPitch() const
+{
+	return pitch;
+}
+
+void Source::setVolume(float volume)
+{
+	thread::Lock l = mixer->lock();
+	this->volume = volume;
+	postParams();
+}
+
+float Source::getVolume() const
+{
+	return volume;
+}
+
+void Source::seek(double offset, Source::Unit unit)
+{
+	double seconds = unit == UNIT_SAMPLES ? offset / sampleRate : offset;
+	seconds = std::max(seconds, 0.0);
+
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+	{
+		thread::Lock l = mixer->lock();
+		postSeek(std::min(seconds * sampleRate, (double) staticBuffer->getFrameCount()));
+		break;
+	}
+	case TYPE_STREAM:
+		resetStream(seconds);
+		if (isPlaying())
+			decodeAhead();
+		break;
+	case TYPE_QUEUE:
+	{
+		thread::Lock l = mixer->lock();
+		postSeek(seconds * sampleRate);
+		break;
+	}
+	case TYPE_MAX_ENUM:
+		break;
+	}
+}
+
+double Source::tell(Source::Unit unit)
+{
+	thread::Lock l = mixer->lock();
+	flushPending();
+
+	double frames = playhead.load(std::memory_order_acquire);
+
+	if (unit == UNIT_SECONDS)
+		return frames / sampleRate;
+	else
+		return frames;
+}
+
+double Source::getDuration(Unit unit)
+{
+	double frames = 0.0;
+
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+		frames = (double) staticBuffer->getFrameCount();
+		break;
+	case TYPE_STREAM:
+	{
+		thread::Lock l(decodeMutex);
+		double seconds = decoder->getDuration();
+		if (seconds < 0.0)
+			return seconds;
+		frames = seconds * sampleRate;
+		break;
+	}
+	case TYPE_QUEUE:
+	{
+		// What's left of the queued blocks.
+		thread::Lock l = mixer->lock();
+		flushPending();
+		frames = (double) (int64) (framesQueued - framesPlayed.load(std::memory_order_acquire));
+		break;
+	}
+	case TYPE_MAX_ENUM:
+		break;
+	}
+
+	if (unit == UNIT_SECONDS)
+		return frames / sampleRate;
+	else
+		return frames;
+}
+
+void Source::setPosition(float *v)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	setFloatv(sourcePosition, v);
+	postParams();
+}
+
+void Source::getPosition(float *v) const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	setFloatv(v, sourcePosition);
+}
+
+void Source::setVelocity(float *v)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	setFloatv(velocity, v);
+}
+
+void Source::getVelocity(float *v) const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	setFloatv(v, velocity);
+}
+
+void Source::setDirection(float *v)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	setFloatv(direction, v);
+	postParams();
+}
+
+void Source::getDirection(float *v) const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	setFloatv(v, direction);
+}
+
+void Source::setCone(float innerAngle, float outerAngle, float outerVolume, float outerHighGain)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	cone.innerAngle = (int) LOVE_TODEG(innerAngle);
+	cone.outerAngle = (int) LOVE_TODEG(outerAngle);
+	cone.outerVolume = outerVolume;
+	cone.outerHighGain = outerHighGain;
+	postParams();
+}
+
+void Source::getCone(float &innerAngle, float &outerAngle, float &outerVolume, float &outerHighGain) const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	innerAngle = LOVE_TORAD(cone.innerAngle);
+	outerAngle = LOVE_TORAD(cone.outerAngle);
+	outerVolume = cone.outerVolume;
+	outerHighGain = cone.outerHighGain;
+}
+
+void Source::setRelative(bool enable)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	relative = enable;
+	postParams();
+}
+
+bool Source::isRelative() const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	return relative;
+}
+
+void Source::setLooping(bool enable)
+{
+	if (sourceType == TYPE_QUEUE)
+		throw QueueLoopingException();
+
+	thread::Lock l = mixer->lock();
+	looping = enable;
+	postParams();
+}
+
+bool Source::isLooping() const
+{
+	return looping;
+}
+
+void Source::setMinVolume(float volume)
+{
+	thread::Lock l = mixer->lock();
+	minVolume = volume;
+	postParams();
+}
+
+float Source::getMinVolume() const
+{
+	return minVolume;
+}
+
+void Source::setMaxVolume(float volume)
+{
+	thread::Lock l = mixer->lock();
+	maxVolume = volume;
+	postParams();
+}
+
+float Source::getMaxVolume() const
+{
+	return maxVolume;
+}
+
+void Source::setReferenceDistance(float distance)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	referenceDistance = distance;
+	postParams();
+}
+
+float Source::getReferenceDistance() const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	return referenceDistance;
+}
+
+void Source::setRolloffFactor(float factor)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	rolloffFactor = factor;
+	postParams();
+}
+
+float Source::getRolloffFactor() const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	return rolloffFactor;
+}
+
+void Source::setMaxDistance(float distance)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	thread::Lock l = mixer->lock();
+	maxDistance = std::min(distance, FLT_MAX);
+	postParams();
+}
+
+float Source::getMaxDistance() const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	return maxDistance;
+}
+
+void Source::setAirAbsorptionFactor(float factor)
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	// Stored for getAirAbsorptionFactor, but not applied by the mixer.
+	absorptionFactor = factor;
+}
+
+float Source::getAirAbsorptionFactor() const
+{
+	if (channels > 1)
+		throw SpatialSupportException();
+
+	return absorptionFactor;
+}
+
+int Source::getChannelCount() const
+{
+	return channels;
+}
+
+bool Source::setFilter(const std::map<Filter::Parameter, float> &params)
+{
+	thread::Lock l = mixer->lock();
+	filterParams = params;
+	hasFilter = true;
+	postParams();
+	return true;
+}
+
+bool Source::setFilter()
+{
+	thread::Lock l = mixer->lock();
+	filterParams.clear();
+	hasFilter = false;
+	postParams();
+	return true;
+}
+
+bool Source::getFilter(std::map<Filter::Parameter, float> &params)
+{
+	if (!hasFilter)
+		return false;
+
+	params = filterParams;
+	return true;
+}
+
+bool Source::setEffect(const char *)
+{
+	return false;
+}
+
+bool Source::setEffect(const char *, const std::map<Filter::Parameter, float> &)
+{
+	return false;
+}
+
+bool Source::unsetEffect(const char *)
+{
+	return false;
+}
+
+bool Source::getEffect(const char *, std::map<Filter::Parameter, float> &)
+{
+	return false;
+}
+
+bool Source::getActiveEffects(std::vector<std::string> &) const
+{
+	return false;
+}
+
+int Source::getFreeBufferCount() const
+{
+	if (sourceType != TYPE_QUEUE)
+		return 0;
+
+	thread::Lock l = mixer->lock();
+	flushPending();
+	return std::max(buffers - (int) (blocksQueued - blocksPlayed.load(std::memory_order_acquire)), 0);
+}
+
+bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels)
+{
+	if (sourceType != TYPE_QUEUE)
+		throw QueueTypeMismatchException();
+
+	if (dataSampleRate != sampleRate || dataBitDepth != bitDepth || dataChannels != channels)
+		throw QueueFormatMismatchException();
+
+	if (length % (bitDepth / 8 * channels) != 0)
+		throw QueueMalformedLengthException(bitDepth / 8 * channels);
+
+	if (length == 0)
+		return true;
+
+	Block *block = nullptr;
+
+	{
+		thread::Lock l = mixer->lock();
+		flushPending();
+		if ((int) (blocksQueued - blocksPlayed.load(std::memory_order_acquire)) >= buffers)
+			return false;
+
+		block = newBlock();
+		if (block == nullptr)
+			return false;
+	}
+
+	// Convert before locking again, so other threads aren't held up.
+	block->frames = length / (bitDepth / 8 * channels);
+	block->samples.resize(block->frames * channels);
+	block->last = false;
+	love::sound::kernels::toFloat(block->samples.data(), data, block->samples.size(), bitDepth);
+
+	thread::Lock l = mixer->lock();
+	postBlock(block);
+	return true;
+}
+
+bool Source::mixAtomic(float * const *out, int frames, int sampleRate)
+{
+	const Params &p = mixParams;
+
+	float left, right;
+	getGains(left, right);
+
+	float lowGain = 1.0f;
+	float highGain = 1.0f;
+	float coefficient = 0.0f;
+
+	if (p.hasFilter)
+	{
+		if (p.filterType == Filter::TYPE_LOWPASS || p.filterType == Filter::TYPE_BANDPASS)
+			highGain = p.highGain;
+		if (p.filterType == Filter::TYPE_HIGHPASS || p.filterType == Filter::TYPE_BANDPASS)
+			lowGain = p.lowGain;
+
+		coefficient = getFilterCoefficient(sampleRate);
+	}
+
+	// Pitches too high to resample from one window are capped.
+	double step = (double) this->sampleRate * p.pitch / sampleRate;
+	if (step <= 0.0)
+		return true;
+	step = std::min(step, (double) (WINDOW_FRAMES - 4));
+
+	float *window = mixer->getWindow();
+	float * const *tmp = mixer->getChannelBuffers();
+	bool cubic = mixer->getInterpolation() == Mixer::INTERPOLATION_CUBIC;
+
+	for (int done = 0; done < frames;)
+	{
+		int n = std::min(frames - done, std::max((int) ((WINDOW_FRAMES - 4) / step), 1));
+
+		// The window starts one frame before the read position, for cubic
+		// interpolation.
+		double whole = floor(mixPosition);
+		double frac = mixPosition - whole;
+		int count = (int) ceil(frac + (n - 1) * step) + 4;
+		fetchAtomic(window, (int64) whole - 1, count);
+
+		if (cubic)
+			kernels::resampleCubic(tmp, n, window, channels, 1.0 + frac, step);
+		else
+			kernels::resampleLinear(tmp, n, window, channels, 1.0 + frac, step);
+
+		if (p.hasFilter)
+		{
+			for (int c = 0; c < channels; c++)
+				kernels::splitBands(tmp[c], n, filterState[c], coefficient, lowGain, highGain);
+		}
+
+		love::sound::kernels::mixGain(out[0] + done, tmp[0], n, left);
+		love::sound::kernels::mixGain(out[1] + done, tmp[channels - 1], n, right);
+
+		done += n;
+
+		if (!advanceAtomic(n * step))
+		{
+			mixFinished = true;
+			publishAtomic();
+			finishedSerial.store(mixPlaySerial, std::memory_order_release);
+			return false;
+		}
+	}
+
+	publishAtomic();
+	return true;
+}
+
+void Source::decodeAhead()
+{
+	if (sourceType != TYPE_STREAM)
+		return;
+
+	const int64 target = (int64) (READ_AHEAD * sampleRate);
+	const int frameSize = bitDepth / 8 * channels;
+
+	while (true)
+	{
+		uint32 gen = 0;
+		Block *block = nullptr;
+
+		{
+			thread::Lock l = mixer->lock();
+
+			if (decoderFinished)
+				return;
+
+			flushPending();
+
+			int64 ahead = (int64) (framesQueued - framesPlayed.load(std::memory_order_acquire));
+			if (ahead >= target)
+				return;
+
+			block = newBlock();
+			if (block == nullptr)
+				return;
+
+			gen = generation;
+		}
+
+		block->frames = 0;
+		bool ended = false;
+		bool rewound = false;
+		bool empty = false;
+
+		{
+			thread::Lock l(decodeMutex);
+
+			int bytes = decoder->decode();
+			if (bytes > 0)
+			{
+				block->frames = bytes / frameSize;
+				block->samples.resize(block->frames * channels);
+				love::sound::kernels::toFloat(block->samples.data(), decoder->getBuffer(), block->samples.size(), bitDepth);
+			}
+
+			ended = bytes <= 0 || decoder->isFinished();
+			if (ended && isLooping())
+			{
+				decoder->rewind();
+				rewound = true;
+				ended = false;
+			}
+
+			// Nothing but an empty looping stream: don't spin.
+			empty = bytes <= 0 && rewound;
+		}
+
+		thread::Lock l = mixer->lock();
+
+		// A seek dropped the stream while this block was being decoded.
+		if (gen != generation)
+		{
+			recycleBlock(block);
+			continue;
+		}
+
+		if (block->frames > 0 || ended)
+		{
+			block->last = ended;
+			postBlock(block);
+		}
+		else
+			recycleBlock(block);
+
+		if (empty)
+			return;
+
+		if (rewound)
+			decodedFrames = 0;
+
+		if (ended)
+		{
+			decoderFinished = true;
+			return;
+		}
+	}
+}
+
+void Source::reclaimBlocks()
+{
+	Block *block = nullptr;
+	while (playedBlocks.pop(block))
+		recycleBlock(block);
+}
+
+Source::Block *Source::newBlock()
+{
+	reclaimBlocks();
+
+	if (activeBlocks >= MAX_BLOCKS)
+		return nullptr;
+
+	activeBlocks++;
+
+	if (spareBlocks.empty())
+		return new Block();
+
+	Block *block = spareBlocks.back();
+	spareBlocks.pop_back();
+	return block;
+}
+
+void Source::recycleBlock(Block *block)
+{
+	activeBlocks--;
+
+	int spares = sourceType == TYPE_QUEUE ? buffers : DEFAULT_BUFFERS;
+	if ((int) spareBlocks.size() < spares)
+		spareBlocks.push_back(block);
+	else
+		delete block;
+}
+
+void Source::postBlock(Block *block)
+{
+	block->start = decodedFrames;
+	decodedFrames += block->frames;
+	blocksQueued++;
+	framesQueued += block->frames;
+
+	Mixer::Command command = {};
+	command.type = Mixer::COMMAND_BLOCK;
+	command.source = this;
+	command.block = block;
+	mixer->post(command);
+}
+
+Source::Params Source::getParams() const
+{
+	Params p;
+	p.pitch = pitch;
+	p.volume = volume;
+	setFloatv(p.position, sourcePosition);
+	setFloatv(p.direction, direction);
+	p.relative = relative;
+	p.looping = looping;
+	p.minVolume = minVolume;
+	p.maxVolume = maxVolume;
+	p.referenceDistance = referenceDistance;
+	p.rolloffFactor = rolloffFactor;
+	p.maxDistance = maxDistance;
+	p.innerAngle = cone.innerAngle;
+	p.outerAngle = cone.outerAngle;
+	p.outerVolume = cone.outerVolume;
+	p.hasFilter = hasFilter;
+
+	auto get = [this](Filter::Parameter param, float value) {
+		auto it = filterParams.find(param);
+		return it == filterParams.end() ? value : it->second;
+	};
+
+	p.filterType = (Filter::Type) (int) get(Filter::FILTER_TYPE, (float) Filter::TYPE_BASIC);
+	p.lowGain = get(Filter::FILTER_LOWGAIN, 1.0f);
+	p.highGain = get(Filter::FILTER_HIGHGAIN, 1.0f);
+	p.filterVolume = get(Filter::FILTER_VOLUME, 1.0f);
+
+	return p;
+}
+
+void Source::postParams()
+{
+	Mixer::Command command = {};
+	command.type = Mixer::COMMAND_PARAMS;
+	command.source = this;
+	command.params = getParams();
+	mixer->post(command);
+}
+
+void Source::postSeek(double frames)
+{
+	Mixer::Command command = {};
+	command.type = Mixer::COMMAND_SEEK;
+	command.source = this;
+	command.serial = ++seekSerial;
+	command.position = frames;
+	mixer->post(command);
+}
+
+void Source::postReset(double frames)
+{
+	Mixer::Command command = {};
+	command.type = Mixer::COMMAND_RESET;
+	command.source = this;
+	command.serial = ++seekSerial;
+	command.position = frames;
+	mixer->post(command);
+}
+
+void Source::postPause(bool paused)
+{
+	Mixer::Command command = {};
+	command.type = Mixer::COMMAND_PAUSE;
+	command.source = this;
+	command.paused = paused;
+	mixer->post(command);
+}
+
+void Source::flushPending() const
+{
+	if (seekDone.load(std::memory_order_acquire) != seekSerial)
+		mixer->flush();
+}
+
+void Source::fetchAtomic(float *window, int64 first, int count) const
+{
+	const int ch = channels;
+	int i = 0;
+
+	if (sourceType == TYPE_STATIC)
+	{
+		const float *src = staticBuffer->getSamples();
+		int64 total = (int64) staticBuffer->getFrameCount();
+
+		while (i < count)
+		{
+			int64 k = first + i;
+			if (mixParams.looping && total > 0)
+				k = ((k % total) + total) % total;
+
+			if (k < 0 || k >= total)
+			{
+				for (int c = 0; c < ch; c++)
+					window[i * ch + c] = 0.0f;
+				i++;
+				continue;
+			}
+
+			int run = (int) std::min((int64) (count - i), total - k);
+			memcpy(window + i * ch, src + k * ch, run * ch * sizeof(float));
+			i += run;
+		}
+
+		return;
+	}
+
+	// Frames before the current block come from the previous one, if it's
+	// still around.
+	for (; i < count && first + i < 0; i++)
+	{
+		int64 k = first + i;
+		const Block *prev = mixCurrent > 0 ? mixBlocks[mixCurrent - 1] : nullptr;
+
+		for (int c = 0; c < ch; c++)
+		{
+			if (prev != nullptr && (int64) prev->frames + k >= 0)
+				window[i * ch + c] = prev->samples[(prev->frames + k) * ch + c];
+			else
+				window[i * ch + c] = 0.0f;
+		}
+	}
+
+	int64 k = first + i;
+	for (size_t b = mixCurrent; i < count && b < mixBlocks.count;)
+	{
+		const Block *block = mixBlocks[b];
+		if (k >= (int64) block->frames)
+		{
+			k -= block->frames;
+			b++;
+			continue;
+		}
+
+		int run = (int) std::min((int64) (count - i), (int64) block->frames - k);
+		memcpy(window + i * ch, block->samples.data() + k * ch, run * ch * sizeof(float));
+		i += run;
+		k += run;
+	}
+
+	// Past the end of what's been decoded or queued.
+	if (i < count)
+		memset(window + i * ch, 0, (count - i) * ch * sizeof(float));
+}
+
+bool Source::advanceAtomic(double frames)
+{
+	mixPosition += frames;
+
+	if (sourceType == TYPE_STATIC)
+	{
+		double total = (double) staticBuffer->getFrameCount();
+		if (mixPosition < total)
+			return true;
+
+		if (mixParams.looping && total > 0.0)
+		{
+			mixPosition = fmod(mixPosition, total);
+			return true;
+		}
+
+		mixPosition = 0.0;
+		return false;
+	}
+
+	while (mixCurrent < mixBlocks.count && mixPosition >= mixBlocks[mixCurrent]->frames)
+	{
+		mixPosition -= mixBlocks[mixCurrent]->frames;
+		passBlockAtomic();
+	}
+
+	trimAtomic();
+
+	if (mixCurrent < mixBlocks.count)
+		return true;
+
+	// Ran out of audio. Streams which haven't finished decoding just
+	// underran, and continue with the next block.
+	mixPosition = 0.0;
+	return sourceType == TYPE_STREAM && !mixLastBlock;
+}
+
+void Source::applySeekAtomic(double frames)
+{
+	mixPosition = 0.0;
+
+	if (sourceType == TYPE_STATIC)
+		mixPosition = frames;
+	else
+	{
+		// Like OpenAL, discard queued blocks the new position is past.
+		while (mixCurrent < mixBlocks.count && frames >= mixBlocks[mixCurrent]->frames)
+		{
+			frames -= mixBlocks[mixCurrent]->frames;
+			passBlockAtomic();
+		}
+
+		trimAtomic();
+
+		if (mixCurrent < mixBlocks.count)
+			mixPosition = frames;
+	}
+
+	publishAtomic();
+}
+
+void Source::applyResetAtomic(double frames)
+{
+	while (mixCurrent < mixBlocks.count)
+		passBlockAtomic();
+
+	while (mixBlocks.count > 0)
+		playedBlocks.push(mixBlocks.pop());
+
+	mixCurrent = 0;
+	mixPosition = 0.0;
+	mixEnd = frames;
+	mixLastBlock = false;
+
+	publishAtomic();
+}
+
+void Source::addBlockAtomic(Block *block)
+{
+	mixBlocks.push(block);
+	mixEnd = (double) (block->start + block->frames);
+
+	if (block->last)
+		mixLastBlock = true;
+
+	publishAtomic();
+}
+
+void Source::passBlockAtomic()
+{
+	mixFramesDone += mixBlocks[mixCurrent]->frames;
+	mixBlocksDone++;
+	mixCurrent++;
+}
+
+void Source::trimAtomic()
+{
+	// Keep one mixed block around for interpolating across its end.
+	while (mixCurrent > 1)
+	{
+		playedBlocks.push(mixBlocks.pop());
+		mixCurrent--;
+	}
+}
+
+void Source::publishAtomic()
+{
+	double frames = mixPosition;
+	if (sourceType != TYPE_STATIC)
+		frames = mixCurrent < mixBlocks.count ? mixBlocks[mixCurrent]->start + mixPosition : mixEnd;
+
+	playhead.store(frames, std::memory_order_relaxed);
+	blocksPlayed.store(mixBlocksDone, std::memory_order_relaxed);
+	framesPlayed.store(mixFramesDone + (uint64) mixPosition, std::memory_order_release);
+}
+
+void Source::resetStream(double offset)
+{
+	thread::Lock d(decodeMutex);
+
+	if (offset > 0.0)
+		decoder->seek(offset);
+	else
+		decoder->rewind();
+
+	thread::Lock l = mixer->lock();
+
+	decodedFrames = (int64) (offset * sampleRate);
+	decoderFinished = false;
+	generation++;
+	postReset((double) decodedFrames);
+}
+
+void Source::resetFinished()
+{
+	{
+		thread::Lock l = mixer->lock();
+		if (playing)
+			return;
+	}
+
+	if (sourceType == TYPE_STREAM)
+		resetStream(0.0);
+}
+
+void Source::getGains(float &left, float &right) const
+{
+	const Params &p = mixParams;
+	const float *listener = mixer->getMixParams().listenerPosition;
+
+	float gain = p.volume;
+	float pan = 0.0f;
+
+	if (channels == 1)
+	{
+
+		float d[3];
+		for (int i = 0; i < 3; i++)
+			d[i] = p.relative ? p.position[i] : p.position[i] - listener[i];
+
+		float distance = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+		gain *= mixer->getDistanceGain(distance, p.referenceDistance, p.rolloffFactor, p.maxDistance);
+
+		// Cone attenuation, by the angle between the Source's direction and
+		// the listener.
+		const float *dir = p.direction;
+		float dirLength = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+		if (distance > 0.0f && dirLength > 0.0f && p.innerAngle < 360)
+		{
+			float cosine = -(d[0] * dir[0] + d[1] * dir[1] + d[2] * dir[2]) / (distance * dirLength);
+			float angle = (float) LOVE_TODEG(acosf(std::min(std::max(cosine, -1.0f), 1.0f))) * 2.0f;
+
+			if (angle >= p.outerAngle)
+				gain *= p.outerVolume;
+			else if (angle > p.innerAngle && p.outerAngle > p.innerAngle)
+			{
+				float t = (angle - p.innerAngle) / (p.outerAngle - p.innerAngle);
+				gain *= 1.0f + (p.outerVolume - 1.0f) * t;
+			}
+		}
+
+		if (distance > 0.0f)
+		{
+			float side[3] = {1.0f, 0.0f, 0.0f};
+			if (!p.relative)
+				mixer->getListenerRight(side);
+			pan = (d[0] * side[0] + d[1] * side[1] + d[2] * side[2]) / distance;
+		}
+	}
+
+	gain = std::min(std::max(gain, p.minVolume), p.maxVolume);
+
+	if (p.hasFilter)
+		gain *= p.filterVolume;
+
+	if (channels == 1)
+	{
+		// Equal power panning.
+		float angle = (pan + 1.0f) * (float) LOVE_M_PI_4;
+		left = gain * cosf(angle);
+		right = gain * sinf(angle);
+	}
+	else
+		left = right = gain;
+}
+
+float Source::getFilterCoefficient(int sampleRate) const
+{
+	// Crossover frequencies of OpenAL's EFX low-pass and high-pass filters.
+	// Band-pass filters split between them.
+	const float LOWPASS_REFERENCE = 5000.0f;
+	const float HIGHPASS_REFERENCE = 250.0f;
+
+	float frequency = 0.0f;
+
+	switch (mixParams.filterType)
+	{
+	case Filter::TYPE_LOWPASS:
+		frequency = LOWPASS_REFERENCE;
+		break;
+	case Filter::TYPE_HIGHPASS:
+		frequency = HIGHPASS_REFERENCE;
+		break;
+	case Filter::TYPE_BANDPASS:
+		frequency = sqrtf(LOWPASS_REFERENCE * HIGHPASS_REFERENCE);
+		break;
+	default:
+		return 0.0f;
+	}
+
+	return 1.0f - expf(-2.0f * (float) LOVE_M_PI * frequency / sampleRate);
+}
+
+void Source::setFloatv(float *dst, const float *src) const
+{
+	dst[0] = src[0];
+	dst[1] = src[1];
+	dst[2] = src[2];
+}
+
+} // soft
+} // audio
+} // love
@@ -0,0 +1,431 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_SOFT_SOURCE_H
+#define LOVE_AUDIO_SOFT_SOURCE_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/int.h"
+#include "audio/Source.h"
+#include "audio/Filter.h"
+#include "sound/SoundData.h"
+#include "sound/Decoder.h"
+#include "common/SPSCQueue.h"
+#include "thread/threads.h"
+
+// STL
+#include <atomic>
+#include <vector>
+#include <map>
+
+// C
+#include <float.h>
+
+namespace love
+{
+namespace audio
+{
+namespace soft
+{
+
+class Mixer;
+
+// Float samples shared by static Sources and their clones.
+class SampleBuffer : public love::Object
+{
+public:
+
+	SampleBuffer(const void *data, size_t frames, int channels, int bitDepth);
+	virtual ~SampleBuffer();
+
+	inline const float *getSamples() const
+	{
+		return samples.data();
+	}
+
+	inline size_t getFrameCount() const
+	{
+		return frames;
+	}
+
+private:
+
+	std::vector<float> samples;
+	size_t frames;
+
+}; // SampleBuffer
+
+class Source : public love::audio::Source
+{
+public:
+
+	Source(Mixer *mixer, love::sound::SoundData *soundData);
+	Source(Mixer *mixer, love::sound::Decoder *decoder);
+	Source(Mixer *mixer, int sampleRate, int bitDepth, int channels, int buffers);
+	Source(const Source &s);
+	virtual ~Source();
+
+	virtual love::audio::Source *clone();
+	virtual bool play();
+	virtual void stop();
+	virtual void pause();
+	virtual bool isPlaying() const;
+	virtual bool isFinished() const;
+	virtual bool update();
+	virtual void setPitch(float pitch);
+	virtual float getPitch() const;
+	virtual void setVolume(float volume);
+	virtual float getVolume() const;
+	virtual void seek(double offset, Unit unit);
+	virtual double tell(Unit unit);
+	virtual double getDuration(Unit unit);
+	virtual void setPosition(float *v);
+	virtual void getPosition(float *v) const;
+	virtual void setVelocity(float *v);
+	virtual void getVelocity(float *v) const;
+	virtual void setDirection(float *v);
+	virtual void getDirection(float *v) const;
+	virtual void setCone(float innerAngle, float outerAngle, float outerVolume, float outerHighGain);
+	virtual void getCone(float &innerAngle, float &outerAngle, float &outerVolume, float &outerHighGain) const;
+	virtual void setRelative(bool enable);
+	virtual bool isRelative() const;
+	void setLooping(bool looping);
+	bool isLooping() const;
+	virtual void setMinVolume(float volume);
+	virtual float getMinVolume() const;
+	virtual void setMaxVolume(float volume);
+	virtual float getMaxVolume() const;
+	virtual void setReferenceDistance(float distance);
+	virtual float getReferenceDistance() const;
+	virtual void setRolloffFactor(float factor);
+	virtual float getRolloffFactor() const;
+	virtual void setMaxDistance(float distance);
+	virtual float getMaxDistance() const;
+	virtual void setAirAbsorptionFactor(float factor);
+	virtual float getAirAbsorptionFactor() const;
+	virtual int getChannelCount() const;
+
+	virtual bool setFilter(const std::map<Filter::Parameter, float> &params);
+	virtual bool setFilter();
+	virtual bool getFilter(std::map<Filter::Parameter, float> &params);
+
+	virtual bool setEffect(const char *effect);
+	virtual bool setEffect(const char *effect, const std::map<Filter::Parameter, float> &params);
+	virtual bool unsetEffect(const char *effect);
+	virtual bool getEffect(const char *effect, std::map<Filter::Parameter, float> &params);
+	virtual bool getActiveEffects(std::vector<std::string> &list) const;
+
+	virtual int getFreeBufferCount() const;
+	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
+
+	/**
+	 * Gets a Source ready to play: restarts streams which ran out and
+	 * decodes their first blocks. Must not be called with the Mixer locked.
+	 **/
+	void prepare();
+
+	// Starts or resumes playback. The Mixer must be locked.
+	bool playAtomic();
+
+	/**
+	 * Mixes the next 'frames' frames of this Source into the planar stereo
+	 * output. Called on the audio thread without the Mixer lock, so it only
+	 * touches the Source's mix state and never blocks or allocates.
+	 * @return False once the Source has finished playing.
+	 **/
+	bool mixAtomic(float * const *out, int frames, int sampleRate);
+
+	/**
+	 * Decodes until enough of a stream is buffered ahead of the mixer. Must
+	 * not be called with the Mixer locked.
+	 **/
+	void decodeAhead();
+
+	/**
+	 * Takes back the blocks the audio thread is done with, for reuse. The
+	 * Mixer must be locked.
+	 **/
+	void reclaimBlocks();
+
+	// Whether the audio thread ran out of audio since the last play. The
+	// Mixer must be locked.
+	bool isFinishedAtomic() const;
+
+	// Frames are mixed in chunks of at most this many.
+	static const int MAX_MIX_FRAMES = 512;
+
+	// Size of the contiguous window of input frames a chunk is resampled
+	// from, which bounds the pitch a chunk can be mixed at.
+	static const int WINDOW_FRAMES = 4096;
+
+	// Everything the audio thread needs to mix a Source, copied to it by a
+	// command whenever one of them changes.
+	struct Params
+	{
+		float pitch;
+		float volume;
+		float position[3];
+		float direction[3];
+		bool relative;
+		bool looping;
+		float minVolume;
+		float maxVolume;
+		float referenceDistance;
+		float rolloffFactor;
+		float maxDistance;
+		int innerAngle;
+		int outerAngle;
+		float outerVolume;
+		bool hasFilter;
+		Filter::Type filterType;
+		float lowGain;
+		float highGain;
+		float filterVolume;
+	};
+
+	struct Block
+	{
+		std::vector<float> samples;
+		size_t frames = 0;
+
+		// Position of the first frame in the whole stream, for tell().
+		int64 start = 0;
+
+		// Whether this is the end of a stream which isn't looping.
+		bool last = false;
+	};
+
+	// Upper bound on the blocks of a Source which are queued, decoded ahead
+	// or waiting to be reclaimed, so the audio thread's rings never fill up.
+	static const int MAX_BLOCKS = 128;
+
+private:
+
+	friend class Mixer;
+
+	// Blocks owned by the audio thread, oldest first. A fixed array so that
+	// handing blocks over never allocates.
+	struct BlockRing
+	{
+		Block *items[MAX_BLOCKS];
+		size_t first = 0;
+		size_t count = 0;
+
+		Block *operator [](size_t i) const
+		{
+			return items[(first + i) % MAX_BLOCKS];
+		}
+
+		void push(Block *block)
+		{
+			items[(first + count++) % MAX_BLOCKS] = block;
+		}
+
+		Block *pop()
+		{
+			Block *block = items[first];
+			first = (first + 1) % MAX_BLOCKS;
+			count--;
+			return block;
+		}
+	};
+
+	Params getParams() const;
+
+	// Copies the current parameters to the audio thread. The Mixer must be
+	// locked.
+	void postParams();
+
+	// Moves the audio thread's read position, or drops its blocks and starts
+	// again at 'frames' (streams and queues.) The Mixer must be locked.
+	void postSeek(double frames);
+	void postReset(double frames);
+	void postPause(bool paused);
+
+	// Hands a filled block to the audio thread. The Mixer must be locked.
+	void postBlock(Block *block);
+
+	// Applies commands still waiting for the audio thread if a seek or reset
+	// hasn't reached it yet, so what it publishes is up to date. The Mixer
+	// must be locked.
+	void flushPending() const;
+
+	// Gets an unused block, or null if the Source has too many. The Mixer
+	// must be locked.
+	Block *newBlock();
+	void recycleBlock(Block *block);
+
+	// Copies 'count' input frames starting at 'first' (relative to the read
+	// position, may be negative) into the window, with silence past the end
+	// or wrapped around for looping static Sources.
+	void fetchAtomic(float *window, int64 first, int count) const;
+
+	// Moves the read position forward by 'frames' input frames.
+	// Returns false if the end was reached.
+	bool advanceAtomic(double frames);
+
+	// Audio thread side of the Mixer's commands.
+	void applySeekAtomic(double frames);
+	void applyResetAtomic(double frames);
+	void addBlockAtomic(Block *block);
+
+	// Moves on to the next block, counting the current one as played.
+	void passBlockAtomic();
+
+	// Hands the blocks before the previous one back to the control side.
+	void trimAtomic();
+
+	// Publishes the read position for tell() and decodeAhead().
+	void publishAtomic();
+
+	// Restarts decoding at the given offset in seconds, dropping whatever
+	// was decoded ahead.
+	void resetStream(double offset);
+
+	// Rewinds a Source after the Mixer retired it, unless it was played
+	// again in the meantime.
+	void resetFinished();
+
+	void getGains(float &left, float &right) const;
+	float getFilterCoefficient(int sampleRate) const;
+
+	void setFloatv(float *dst, const float *src) const;
+
+	Mixer *mixer;
+
+	StrongRef<SampleBuffer> staticBuffer;
+	StrongRef<love::sound::Decoder> decoder;
+
+	// Guards the decoder, which is read outside the Mixer lock.
+	love::thread::MutexRef decodeMutex;
+
+	// Mix state. Only touched by the audio thread (or whichever thread holds
+	// the Mixer's render flag) once the Source exists.
+
+	Params mixParams;
+
+	// Decoded stream blocks, or queued blocks. Blocks before 'mixCurrent'
+	// have been mixed but are kept for interpolation.
+	BlockRing mixBlocks;
+	size_t mixCurrent = 0;
+
+	// Read position in frames, relative to the current block (or the start
+	// of the static buffer.)
+	double mixPosition = 0.0;
+
+	// Stream position of the end of the last block, for tell() at the end.
+	double mixEnd = 0.0;
+
+	// Whether the last block of a stream has arrived.
+	bool mixLastBlock = false;
+
+	// Frames and blocks which were played or dropped.
+	uint64 mixFramesDone = 0;
+	uint64 mixBlocksDone = 0;
+
+	uint32 mixPlaySerial = 0;
+	bool mixPaused = false;
+	bool mixFinished = false;
+	float filterState[2];
+
+	// Published by the audio thread. 'playhead' is the read position in
+	// stream frames; 'seekDone' the serial of the last seek or reset it
+	// applied; 'finishedSerial' the play serial it ran out of audio in. The
+	// played counts include blocks dropped by seeks and resets.
+	std::atomic<double> playhead {0.0};
+	std::atomic<uint32> seekDone {0};
+	std::atomic<uint32> finishedSerial {0};
+	std::atomic<uint64> blocksPlayed {0};
+	std::atomic<uint64> framesPlayed {0};
+
+	// Blocks the audio thread is done with, on their way back.
+	SPSCQueue<Block *, MAX_BLOCKS> playedBlocks;
+
+	// Commands posted for this Source which the audio thread hasn't applied.
+	std::atomic<int> pendingCommands {0};
+
+	// Control state. Guarded by the Mixer lock.
+
+	uint32 playSerial = 0;
+	uint32 seekSerial = 0;
+
+	// Blocks handed to the audio thread and their total length.
+	uint64 blocksQueued = 0;
+	uint64 framesQueued = 0;
+
+	// Blocks which exist and aren't in 'spareBlocks'.
+	int activeBlocks = 0;
+	std::vector<Block *> spareBlocks;
+
+	// Frames decoded so far, for Block::start.
+	int64 decodedFrames = 0;
+
+	// Bumped when a seek invalidates blocks which are being decoded.
+	uint32 generation = 0;
+	bool decoderFinished = false;
+
+	bool playing = false;
+	bool paused = false;
+
+	float pitch = 1.0f;
+	float volume = 1.0f;
+	float sourcePosition[3];
+	float velocity[3];
+	float direction[3];
+	bool relative = false;
+	bool looping = false;
+	float minVolume = 0.0f;
+	float maxVolume = 1.0f;
+	float referenceDistance = 1.0f;
+	float rolloffFactor = 1.0f;
+	float absorptionFactor = 0.0f;
+	float maxDistance = FLT_MAX;
+
+	struct Cone
+	{
+		int innerAngle = 360; // degrees
+		int outerAngle = 360; // degrees
+		float outerVolume = 0.0f;
+		float outerHighGain = 1.0f;
+	} cone;
+
+	int sampleRate = 0;
+	int channels = 0;
+	int bitDepth = 0;
+	int buffers = 0;
+
+	bool hasFilter = false;
+	std::map<Filter::Parameter, float> filterParams;
+
+	const static int DEFAULT_BUFFERS = 8;
+	const static int MAX_BUFFERS = 64;
+
+	// How far ahead of the mixer streams are decoded, in seconds.
+	static constexpr double READ_AHEAD = 0.25;
+
+}; // Source
+
+} // soft
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_SOFT_SOURCE_H
@@ -23,10 +23,13 @@
 #include "filesystem/wrap_Filesystem.h"
 
 #include "openal/Audio.h"
+#include "soft/Audio.h"
 #include "null/Audio.h"
 
 #include "common/runtime.h"
 
+#include "libraries/xxHash/xxhash.h"
+
 // C++
 #include <iostream>
 #include <cmath>
@@ -48,6 +51,15 @@ int w_newSource(lua_State *L)
 {
 	Source::Type stype = Source::TYPE_STREAM;
 
+	bool cacheable = false;
+	uint64 cacheKey = 0;
+
+	// Sources loaded from files are resampled to the output rate up front,
+	// instead of by the backend for every voice while they play.
+	int sampleRate = 0;
+	if (instance()->isLoadResamplingEnabled())
+		sampleRate = instance()->getOutputSampleRate();
+
 	if (!luax_istype(L, 1, love::sound::SoundData::type))
 	{
 		if (!luax_istype(L, 1, love::sound::Decoder::type))
@@ -62,6 +74,31 @@ int w_newSource(lua_State *L)
 
 		if (love::filesystem::luax_cangetdata(L, 1))
 		{
+			// Static Sources loaded from the same file share their audio, so
+			// loading one again doesn't need to decode anything.
+			if (stype == Source::TYPE_STATIC && love::filesystem::luax_cangetfiledata(L, 1))
+			{
+				love::filesystem::FileData *fd = love::filesystem::luax_getfiledata(L, 1);
+
+				// Decode from the data which was just read, on a cache miss.
+				luax_pushtype(L, fd);
+				fd->release();
+				lua_replace(L, 1);
+
+				cacheKey = XXH64(fd->getData(), fd->getSize(), (uint64) sampleRate);
+				cacheable = true;
+
+				Source *t = nullptr;
+				luax_catchexcept(L, [&]() { t = instance()->newCachedSource(cacheKey); });
+
+				if (t != nullptr)
+				{
+					luax_pushtype(L, t);
+					t->release();
+					return 1;
+				}
+			}
+
 			// stream type
 			if (stype == Source::TYPE_STATIC)
 				lua_pushstring(L, "memory");
@@ -73,9 +110,22 @@ int w_newSource(lua_State *L)
 			// buffer size
 			lua_pushnil(L);
 
-			// (file, buffer size, stream type)
-			int idxs[] = { 1, lua_gettop(L), lua_gettop(L) - 1 };
-			luax_convobj(L, idxs, 3, "sound", "newDecoder");
+			// bit depth: streams are decoded straight to floats when the
+			// backend can play them.
+			if (stype == Source::TYPE_STREAM && instance()->isFloatSupported())
+				lua_pushinteger(L, 32);
+			else
+				lua_pushnil(L);
+
+			// sample rate
+			if (sampleRate > 0)
+				lua_pushinteger(L, sampleRate);
+			else
+				lua_pushnil(L);
+
+			// (file, buffer size, stream type, bit depth, sample rate)
+			int idxs[] = { 1, lua_gettop(L) - 2, lua_gettop(L) - 3, lua_gettop(L) - 1, lua_gettop(L) };
+			luax_convobj(L, idxs, 5, "sound", "newDecoder");
 		}
 	}
 
@@ -85,7 +135,9 @@ int w_newSource(lua_State *L)
 	Source *t = nullptr;
 
 	luax_catchexcept(L, [&]() {
-		if (luax_istype(L, 1, love::sound::SoundData::type))
+		if (luax_istype(L, 1, love::sound::SoundData::type) && cacheable)
+			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1), cacheKey);
+		else if (luax_istype(L, 1, love::sound::SoundData::type))
 			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
@@ -107,10 +159,22 @@ int w_newQueueableSource(lua_State *L)
 	int bitdepth = (int) luaL_checkinteger(L, 2);
 	int channels = (int) luaL_checkinteger(L, 3);
 	int buffers = (int) luaL_optinteger(L, 4, 0);
+	int blocksamples = (int) luaL_optinteger(L, 5, 0);
+
+	if (blocksamples < 0)
+		return luaL_error(L, "Invalid block size: %d", blocksamples);
 
 	Source *t = nullptr;
 	luax_catchexcept(L, [&]() { t = instance()->newSource(samplerate, bitdepth, channels, buffers); });
 
+	if (blocksamples > 0)
+	{
+		luax_catchexcept(L,
+			[&]() { t->allocateBlocks(t->getFreeBufferCount(), blocksamples, samplerate, bitdepth, channels); },
+			[&](bool err) { if (err) t->release(); }
+		);
+	}
+
 	luax_pushtype(L, t);
 	t->release();
 	return 1;
@@ -592,6 +656,118 @@ int w_setPlaybackDevice(lua_State* L)
 	return 0;
 }
 
+int w_setCacheLimit(lua_State *L)
+{
+	instance()->setCacheLimit((int64) luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getCacheLimit(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getCacheLimit());
+	return 1;
+}
+
+int w_getCacheStats(lua_State *L)
+{
+	Audio::CacheStats stats = instance()->getCacheStats();
+
+	lua_createtable(L, 0, 6);
+
+	lua_pushnumber(L, (lua_Number) stats.hits);
+	lua_setfield(L, -2, "hits");
+
+	lua_pushnumber(L, (lua_Number) stats.misses);
+	lua_setfield(L, -2, "misses");
+
+	lua_pushnumber(L, (lua_Number) stats.evictions);
+	lua_setfield(L, -2, "evictions");
+
+	lua_pushinteger(L, stats.entries);
+	lua_setfield(L, -2, "entries");
+
+	lua_pushnumber(L, (lua_Number) stats.size);
+	lua_setfield(L, -2, "size");
+
+	lua_pushnumber(L, (lua_Number) stats.limit);
+	lua_setfield(L, -2, "limit");
+
+	return 1;
+}
+
+int w_getStats(lua_State *L)
+{
+	Audio::Stats stats = instance()->getStats();
+
+	// Engine-wide totals, in the same fields as Source:getStats.
+	luax_pushsourcestats(L, stats.sources);
+
+	lua_pushinteger(L, stats.activeSources);
+	lua_setfield(L, -2, "activesources");
+
+	lua_pushinteger(L, stats.virtualSources);
+	lua_setfield(L, -2, "virtualsources");
+
+	lua_pushnumber(L, (lua_Number) stats.lockWaitTime);
+	lua_setfield(L, -2, "lockwaittime");
+
+	lua_pushnumber(L, (lua_Number) stats.lockHoldTime);
+	lua_setfield(L, -2, "lockholdtime");
+
+	lua_pushinteger(L, stats.prefetchers);
+	lua_setfield(L, -2, "prefetchers");
+
+	// Per-stream counters, keyed by Source.
+	lua_createtable(L, 0, (int) stats.streams.size());
+	for (const StrongRef<Source> &s : stats.streams)
+	{
+		luax_pushtype(L, s.get());
+		luax_pushsourcestats(L, s->getStats());
+		lua_rawset(L, -3);
+	}
+	lua_setfield(L, -2, "streams");
+
+	return 1;
+}
+
+int w_setStreamReadAhead(lua_State *L)
+{
+	instance()->setStreamReadAhead((int) luaL_checkinteger(L, 1));
+	return 0;
+}
+
+int w_getStreamReadAhead(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getStreamReadAhead());
+	return 1;
+}
+
+int w_getOutputSampleRate(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getOutputSampleRate());
+	return 1;
+}
+
+int w_getBackend(lua_State *L)
+{
+	// Module names are "love.audio.<backend>".
+	std::string name = instance()->getName();
+	lua_pushstring(L, name.substr(name.rfind('.') + 1).c_str());
+	return 1;
+}
+
+int w_setLoadResamplingEnabled(lua_State *L)
+{
+	instance()->setLoadResamplingEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isLoadResamplingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isLoadResamplingEnabled());
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -626,6 +802,16 @@ static const luaL_Reg functions[] =
 	{ "getPlaybackDevice", w_getPlaybackDevice },
 	{ "getPlaybackDevices", w_getPlaybackDevices },
 	{ "setPlaybackDevice", w_setPlaybackDevice },
+	{ "setStreamReadAhead", w_setStreamReadAhead },
+	{ "getStreamReadAhead", w_getStreamReadAhead },
+	{ "getOutputSampleRate", w_getOutputSampleRate },
+	{ "getBackend", w_getBackend },
+	{ "setLoadResamplingEnabled", w_setLoadResamplingEnabled },
+	{ "isLoadResamplingEnabled", w_isLoadResamplingEnabled },
+	{ "setCacheLimit", w_setCacheLimit },
+	{ "getCacheLimit", w_getCacheLimit },
+	{ "getCacheStats", w_getCacheStats },
+	{ "getStats", w_getStats },
 
 	{ 0, 0 }
 };
@@ -643,32 +829,33 @@ extern "C" int luaopen_love_audio(lua_State *L)
 
 	if (instance == nullptr)
 	{
-		// Try OpenAL first.
-		try
-		{
-			instance = new love::audio::openal::Audio();
-		}
-		catch(love::Exception &e)
+		// Try the configured backend first, then OpenAL, then mixing in
+		// software, then nullaudio.
+		const std::string backends[] = {getBackend(), "openal", "soft", "null"};
+
+		for (const std::string &name : backends)
 		{
-			std::cout << e.what() << std::endl;
+			try
+			{
+				if (name == "openal")
+					instance = new love::audio::openal::Audio();
+				else if (name == "soft")
+					instance = new love::audio::soft::Audio();
+				else if (name == "null")
+					instance = new love::audio::null::Audio();
+			}
+			catch(love::Exception &e)
+			{
+				std::cout << e.what() << std::endl;
+			}
+
+			if (instance != nullptr)
+				break;
 		}
 	}
 	else
 		instance->retain();
 
-	if (instance == nullptr)
-	{
-		// Fall back to nullaudio.
-		try
-		{
-			instance = new love::audio::null::Audio();
-		}
-		catch(love::Exception &e)
-		{
-			std::cout << e.what() << std::endl;
-		}
-	}
-
 	if (instance == nullptr)
 		return luaL_error(L, "Could not open any audio module.");
 
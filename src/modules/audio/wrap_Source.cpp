@@ -538,6 +538,18 @@ int w_Source_getFreeBufferCount(lua_State *L)
 	return 1;
 }
 
+int w_Source_getFreeBlock(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	love::sound::SoundData *s = nullptr;
+	luax_catchexcept(L, [&]() { s = t->getFreeBlock(); });
+	if (s != nullptr)
+		luax_pushtype(L, s);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
 int w_Source_queue(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -562,8 +574,7 @@ int w_Source_queue(lua_State *L)
 			return luaL_error(L, "Data region out of bounds.");
 
 		luax_catchexcept(L, [&]() {
-			success = t->queue((unsigned char *)s->getData() + offset, length,
-			            s->getSampleRate(), s->getBitDepth(), s->getChannelCount());
+			success = t->queue(s, offset, length);
 		});
 	}
 	else if (lua_islightuserdata(L, 2))
@@ -601,6 +612,54 @@ int w_Source_getType(lua_State *L)
 	return 1;
 }
 
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	t->setPriority((int) luaL_checkinteger(L, 2));
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
+int w_Source_isVirtual(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	luax_pushboolean(L, t->isVirtual());
+	return 1;
+}
+
+void luax_pushsourcestats(lua_State *L, const Source::Stats &stats)
+{
+	lua_createtable(L, 0, 5);
+
+	lua_pushnumber(L, (lua_Number) stats.decodeTime);
+	lua_setfield(L, -2, "decodetime");
+
+	lua_pushnumber(L, (lua_Number) stats.buffersQueued);
+	lua_setfield(L, -2, "buffersqueued");
+
+	lua_pushnumber(L, (lua_Number) stats.buffersProcessed);
+	lua_setfield(L, -2, "buffersprocessed");
+
+	lua_pushnumber(L, (lua_Number) stats.underruns);
+	lua_setfield(L, -2, "underruns");
+
+	lua_pushnumber(L, (lua_Number) stats.bytesUploaded);
+	lua_setfield(L, -2, "bytesuploaded");
+}
+
+int w_Source_getStats(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	luax_pushsourcestats(L, t->getStats());
+	return 1;
+}
+
 static const luaL_Reg w_Source_functions[] =
 {
 	{ "clone", w_Source_clone },
@@ -650,10 +709,16 @@ static const luaL_Reg w_Source_functions[] =
 	{ "getActiveEffects", w_Source_getActiveEffects },
 
 	{ "getFreeBufferCount", w_Source_getFreeBufferCount },
+	{ "getFreeBlock", w_Source_getFreeBlock },
 	{ "queue", w_Source_queue },
 
 	{ "getType", w_Source_getType },
 
+	{ "setPriority", w_Source_setPriority },
+	{ "getPriority", w_Source_getPriority },
+	{ "isVirtual", w_Source_isVirtual },
+	{ "getStats", w_Source_getStats },
+
 	{ 0, 0 }
 };
 
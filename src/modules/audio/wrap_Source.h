@@ -31,6 +31,7 @@ namespace audio
 {
 
 Source *luax_checksource(lua_State *L, int idx);
+void luax_pushsourcestats(lua_State *L, const Source::Stats &stats);
 extern "C" int luaopen_source(lua_State *L);
 
 } // audio
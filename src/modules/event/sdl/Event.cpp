@@ -29,12 +29,17 @@
 #include "graphics/Graphics.h"
 #include "window/Window.h"
 #include "common/Exception.h"
+#include "common/EngineContext.h"
 #include "audio/Audio.h"
 #include "common/config.h"
 #include "timer/Timer.h"
 #include "sensor/sdl/Sensor.h"
+#include "thread/threads.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <vector>
 
 #include "joystick/sdl/Joystick.h"
 
@@ -79,6 +84,133 @@ static void normalizedToDPICoords(double *x, double *y)
 		*y = ((*y) * h);
 }
 
+// SDL has a single event queue per process, but every EngineContext (e.g. one
+// per plugin instance) has its own love.event and pumps from its own thread.
+// Whichever context pumps moves everything in SDL's queue to the context whose
+// window the event belongs to, in order. Events without a window (joysticks,
+// sensors, locale changes, quit...) are broadcast to every context.
+
+// Per context, and for events of a live window nobody has claimed yet (e.g. one
+// created by a context which hasn't pumped since). Past this, the oldest events
+// are dropped, so a context which stops pumping doesn't grow without bound.
+static const size_t MAX_PENDING_EVENTS = 1024;
+
+// How long a wait blocks in SDL before checking whether another context has
+// routed something to us.
+static const int ROUTED_WAIT_SLICE_MS = 10;
+
+static thread::Mutex *getRouterMutex()
+{
+	static thread::MutexRef mutex;
+	return mutex;
+}
+
+static std::vector<Event *> &getRouterTargets()
+{
+	static std::vector<Event *> targets;
+	return targets;
+}
+
+static std::deque<RoutedEvent> &getParkedEvents()
+{
+	static std::deque<RoutedEvent> parked;
+	return parked;
+}
+
+// Like SDL_GetWindowFromEvent, but also for windows which no longer exist.
+static SDL_WindowID getEventWindowID(const SDL_Event &e)
+{
+	if (e.type >= SDL_EVENT_WINDOW_FIRST && e.type <= SDL_EVENT_WINDOW_LAST)
+		return e.window.windowID;
+
+	switch (e.type)
+	{
+	case SDL_EVENT_KEY_DOWN:
+	case SDL_EVENT_KEY_UP:
+		return e.key.windowID;
+	case SDL_EVENT_TEXT_EDITING:
+		return e.edit.windowID;
+	case SDL_EVENT_TEXT_INPUT:
+		return e.text.windowID;
+	case SDL_EVENT_MOUSE_MOTION:
+		return e.motion.windowID;
+	case SDL_EVENT_MOUSE_BUTTON_DOWN:
+	case SDL_EVENT_MOUSE_BUTTON_UP:
+		return e.button.windowID;
+	case SDL_EVENT_MOUSE_WHEEL:
+		return e.wheel.windowID;
+	case SDL_EVENT_FINGER_DOWN:
+	case SDL_EVENT_FINGER_UP:
+	case SDL_EVENT_FINGER_MOTION:
+		return e.tfinger.windowID;
+	case SDL_EVENT_DROP_FILE:
+	case SDL_EVENT_DROP_TEXT:
+	case SDL_EVENT_DROP_BEGIN:
+	case SDL_EVENT_DROP_COMPLETE:
+	case SDL_EVENT_DROP_POSITION:
+		return e.drop.windowID;
+	default:
+		return 0;
+	}
+}
+
+static RoutedEvent makeRoutedEvent(const SDL_Event &e)
+{
+	RoutedEvent r;
+	r.event = e;
+
+	const char *text = nullptr;
+	switch (e.type)
+	{
+	case SDL_EVENT_TEXT_INPUT:
+		text = e.text.text;
+		break;
+	case SDL_EVENT_TEXT_EDITING:
+		text = e.edit.text;
+		break;
+	case SDL_EVENT_DROP_FILE:
+	case SDL_EVENT_DROP_TEXT:
+		text = e.drop.data;
+		break;
+	default:
+		break;
+	}
+
+	if (text != nullptr)
+		r.text = text;
+
+	return r;
+}
+
+static void deliver(std::deque<RoutedEvent> &queue, const SDL_Event &e)
+{
+	queue.push_back(makeRoutedEvent(e));
+	if (queue.size() > MAX_PENDING_EVENTS)
+		queue.pop_front();
+}
+
+// Points the event back at its own copy of its string.
+static const SDL_Event &getRoutedEvent(RoutedEvent &r)
+{
+	switch (r.event.type)
+	{
+	case SDL_EVENT_TEXT_INPUT:
+		r.event.text.text = r.text.c_str();
+		break;
+	case SDL_EVENT_TEXT_EDITING:
+		r.event.edit.text = r.text.c_str();
+		break;
+	case SDL_EVENT_DROP_FILE:
+	case SDL_EVENT_DROP_TEXT:
+		r.event.drop.data = r.text.c_str();
+		break;
+	default:
+		break;
+	}
+
+	return r.event;
+}
+
 // SDL's event watch callbacks trigger when the event is actually posted inside
 // SDL, unlike with SDL_PollEvents. This is useful for some events which require
 // handling inside the function which triggered them on some backends.
@@ -105,19 +237,120 @@ static bool SDLCALL watchAppEvents(void * /*udata*/, SDL_Event *event)
 
 Event::Event()
 	: love::event::Event("love.event.sdl")
+	, windowID(0)
 {
 	if (!SDL_InitSubSystem(SDL_INIT_EVENTS))
 		throw love::Exception("Could not initialize SDL events subsystem (%s)", SDL_GetError());
 
 	SDL_AddEventWatch(watchAppEvents, this);
+
+	thread::Lock lock(getRouterMutex());
+	getRouterTargets().push_back(this);
 }
 
 Event::~Event()
 {
+	{
+		thread::Lock lock(getRouterMutex());
+		auto &targets = getRouterTargets();
+		targets.erase(std::remove(targets.begin(), targets.end(), this), targets.end());
+	}
+
 	SDL_RemoveEventWatch(watchAppEvents, this);
 	SDL_QuitSubSystem(SDL_INIT_EVENTS);
 }
 
+void Event::routeEvents()
+{
+	auto &targets = getRouterTargets();
+	auto &parked = getParkedEvents();
+
+	// love.window may have (re)created our window since we last pumped.
+	SDL_WindowID id = 0;
+	auto window = Module::getInstance<window::Window>(Module::M_WINDOW);
+	if (window != nullptr && window->getHandle() != nullptr)
+		id = SDL_GetWindowID((SDL_Window *) window->getHandle());
+
+	if (id != windowID)
+	{
+		windowID = id;
+
+		// Anything still queued for the old window is stale.
+		routed.erase(std::remove_if(routed.begin(), routed.end(), [&](const RoutedEvent &r) {
+			SDL_WindowID target = getEventWindowID(r.event);
+			return target != 0 && target != id;
+		}), routed.end());
+
+		for (auto it = parked.begin(); it != parked.end();)
+		{
+			if (id != 0 && getEventWindowID(it->event) == id)
+			{
+				routed.push_back(std::move(*it));
+				it = parked.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	SDL_Event e;
+	while (SDL_PeepEvents(&e, 1, SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST) > 0)
+	{
+		SDL_WindowID target = getEventWindowID(e);
+
+		if (target == 0)
+		{
+			for (Event *event : targets)
+				deliver(event->routed, e);
+			continue;
+		}
+
+		auto owner = std::find_if(targets.begin(), targets.end(), [&](Event *event) { return event->windowID == target; });
+
+		if (owner != targets.end())
+			deliver((*owner)->routed, e);
+		else if (SDL_GetWindowFromID(target) != nullptr)
+			deliver(parked, e);
+		// Otherwise the window is gone, and so is whoever cared about it.
+	}
+}
+
+void Event::takeEvents(std::deque<RoutedEvent> &events, int timeoutMS)
+{
+	double deadline = love::timer::Timer::getTime() + timeoutMS / 1000.0;
+
+	while (true)
+	{
+		SDL_PumpEvents();
+
+		{
+			thread::Lock lock(getRouterMutex());
+			routeEvents();
+			while (!routed.empty())
+			{
+				events.push_back(std::move(routed.front()));
+				routed.pop_front();
+			}
+		}
+
+		if (!events.empty() || timeoutMS == 0)
+			return;
+
+		// Another context may route something to us without SDL waking us
+		// up, so only block in SDL for a little while at a time.
+		int slice = ROUTED_WAIT_SLICE_MS;
+		if (timeoutMS > 0)
+		{
+			double remaining = deadline - love::timer::Timer::getTime();
+			if (remaining <= 0.0)
+				return;
+			slice = std::min(slice, (int) std::ceil(remaining * 1000.0));
+		}
+
+		SDL_WaitEventTimeout(nullptr, slice);
+	}
+}
+
 void Event::pump(float waitTimeout)
 {
 	exceptionIfInRenderPass("love.event.pump");
@@ -128,21 +361,33 @@ void Event::pump(float waitTimeout)
 	else if (waitTimeout > 0.0f)
 		waitTimeoutMS = (int)std::min<int64>(LOVE_INT32_MAX, 1000LL * waitTimeout);
 
-	// Wait for the first event, if requested.
-	SDL_Event e;
-	if (SDL_WaitEventTimeout(&e, waitTimeoutMS))
+	std::deque<RoutedEvent> events;
+	takeEvents(events, waitTimeoutMS);
+
+	for (RoutedEvent &r : events)
 	{
-		StrongRef<Message> msg(convert(e), Acquire::NORETAIN);
+		StrongRef<Message> msg(convert(getRoutedEvent(r)), Acquire::NORETAIN);
 		if (msg)
 			push(msg);
+	}
 
-		// Fetch any extra events that came in during WaitEvent.
-		while (SDL_PollEvent(&e))
+	// MIDI from the plugin host, queued by the audio thread.
+	plugin::Host *host = EngineContext::getCurrent()->getHost();
+	if (host != nullptr)
+	{
+		plugin::MidiMessage m;
+		while (host->popMidi(m))
 		{
-			msg.set(convert(e), Acquire::NORETAIN);
+			StrongRef<Message> msg(convertMidiMessage(m), Acquire::NORETAIN);
 			if (msg)
 				push(msg);
 		}
+
+		if (host->takeQuitRequest())
+		{
+			StrongRef<Message> msg(new Message("quit"), Acquire::NORETAIN);
+			push(msg);
+		}
 	}
 }
 
@@ -150,23 +395,30 @@ Message *Event::wait()
 {
 	exceptionIfInRenderPass("love.event.wait");
 
-	SDL_Event e;
+	std::deque<RoutedEvent> events;
+	takeEvents(events, -1);
 
-	if (!SDL_WaitEvent(&e))
-		return nullptr;
+	Message *msg = convert(getRoutedEvent(events.front()));
+	events.pop_front();
 
-	return convert(e);
+	// Keep the rest for the next pump, in order.
+	thread::Lock lock(getRouterMutex());
+	routed.insert(routed.begin(), std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+
+	return msg;
 }
 
 void Event::clear()
 {
 	exceptionIfInRenderPass("love.event.clear");
 
-	SDL_Event e;
+	SDL_PumpEvents();
 
-	while (SDL_PollEvent(&e))
 	{
-		// Do nothing with 'e' ...
+		// Only drop our own events; other contexts' are routed to them.
+		thread::Lock lock(getRouterMutex());
+		routeEvents();
+		routed.clear();
 	}
 
 	love::event::Event::clear();
@@ -726,6 +978,43 @@ Message *Event::convertWindowEvent(const SDL_Event &e)
 	return msg;
 }
 
+Message *Event::convertMidiMessage(const plugin::MidiMessage &m) const
+{
+	static const uint8 MIDI_NOTE_OFF = 0x80;
+	static const uint8 MIDI_NOTE_ON = 0x90;
+	static const uint8 MIDI_CONTROL_CHANGE = 0xB0;
+
+	Message *msg = nullptr;
+
+	std::vector<Variant> vargs;
+	vargs.reserve(5);
+
+	// Note/controller number, velocity/value, 1-based channel.
+	vargs.emplace_back((double) m.data1);
+	vargs.emplace_back((double) m.data2);
+	vargs.emplace_back((double) ((m.status & 0x0F) + 1));
+	vargs.emplace_back((double) m.offset);
+	vargs.emplace_back(m.time);
+
+	switch (m.status & 0xF0)
+	{
+	case MIDI_NOTE_ON:
+		// A note on with no velocity is a note off, by convention.
+		msg = new Message(m.data2 > 0 ? "midipressed" : "midireleased", vargs);
+		break;
+	case MIDI_NOTE_OFF:
+		msg = new Message("midireleased", vargs);
+		break;
+	case MIDI_CONTROL_CHANGE:
+		msg = new Message("midicc", vargs);
+		break;
+	default:
+		break;
+	}
+
+	return msg;
+}
+
 } // sdl
 } // event
 } // love
@@ -24,10 +24,15 @@
 // LOVE
 #include "event/Event.h"
 #include "audio/Source.h"
+#include "plugin/Host.h"
 
 // SDL
 #include <SDL3/SDL_events.h>
 
+// C++
+#include <deque>
+#include <string>
+
 namespace love
 {
 namespace event
@@ -35,6 +40,14 @@ namespace event
 namespace sdl
 {
 
+// An SDL event routed to one context. Strings SDL attaches to events are only
+// valid on the thread which took the event from SDL, so they're copied along.
+struct RoutedEvent
+{
+	SDL_Event event;
+	std::string text;
+};
+
 class Event : public love::event::Event
 {
 public:
@@ -59,11 +72,24 @@ class Event : public love::event::Event
 
 private:
 
+	// Moves every event waiting in SDL's queue to the context it belongs to,
+	// and takes the ones routed to this context. Waits up to timeoutMS (-1
+	// forever) for at least one if there are none.
+	void takeEvents(std::deque<RoutedEvent> &events, int timeoutMS);
+
+	// Called with the router's mutex held.
+	void routeEvents();
+
 	void exceptionIfInRenderPass(const char *name);
 
 	Message *convert(const SDL_Event &e);
 	Message *convertJoystickEvent(const SDL_Event &e) const;
 	Message *convertWindowEvent(const SDL_Event &e);
+	Message *convertMidiMessage(const plugin::MidiMessage &m) const;
+
+	// Guarded by the router's mutex in Event.cpp.
+	SDL_WindowID windowID;
+	std::deque<RoutedEvent> routed;
 
 }; // Event
 
@@ -50,6 +50,8 @@ love::Type Filesystem::type("filesystem", &Module::type);
 
 Filesystem::Filesystem(const char *name)
 	: Module(M_FILESYSTEM, name)
+	, bytecodeCacheEnabled(true)
+	, seekCacheEnabled(false)
 {
 }
 
@@ -67,6 +69,26 @@ bool Filesystem::isAndroidSaveExternal() const
 	return useExternal;
 }
 
+void Filesystem::setBytecodeCacheEnabled(bool enable)
+{
+	bytecodeCacheEnabled = enable;
+}
+
+bool Filesystem::isBytecodeCacheEnabled() const
+{
+	return bytecodeCacheEnabled;
+}
+
+void Filesystem::setSeekCacheEnabled(bool enable)
+{
+	seekCacheEnabled = enable;
+}
+
+bool Filesystem::isSeekCacheEnabled() const
+{
+	return seekCacheEnabled;
+}
+
 FileData *Filesystem::newFileData(const void *data, size_t size, const char *filename) const
 {
 	FileData *fd = new FileData(size, std::string(filename));
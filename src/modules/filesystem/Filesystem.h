@@ -136,6 +136,20 @@ class Filesystem : public Module
 	**/
 	virtual bool isAndroidSaveExternal() const; 
 
+	/**
+	 * Sets whether Lua files loaded through love.filesystem have their
+	 * compiled bytecode cached in the save directory.
+	 **/
+	void setBytecodeCacheEnabled(bool enable);
+	bool isBytecodeCacheEnabled() const;
+
+	/**
+	 * Sets whether audio decoders store their seek indices in the save
+	 * directory. Disabled by default.
+	 **/
+	void setSeekCacheEnabled(bool enable);
+	bool isSeekCacheEnabled() const;
+
 	/**
 	 * Sets the name of the save folder.
 	 * @param ident The name of the game. Will be used to
@@ -330,6 +344,10 @@ class Filesystem : public Module
 	// Should we save external or internal for Android
 	bool useExternal;
 
+	bool bytecodeCacheEnabled;
+
+	bool seekCacheEnabled;
+
 }; // Filesystem
 
 } // filesystem
@@ -28,6 +28,7 @@
 #include "Filesystem.h"
 #include "File.h"
 #include "PhysfsIo.h"
+#include "thread/threads.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -106,6 +107,35 @@ static bool isAppCommonPath(Filesystem::CommonPath path)
 	}
 }
 
+// PhysFS can only be initialized once per process, but each EngineContext
+// (e.g. each plugin instance) has its own Filesystem.
+static thread::Mutex *getPhysfsMutex()
+{
+	static thread::MutexRef mutex;
+	return mutex;
+}
+
+static int physfsRefCount = 0;
+
+static bool retainPhysfs(const char *arg0)
+{
+	thread::Lock lock(getPhysfsMutex());
+
+	if (physfsRefCount == 0 && !PHYSFS_init(arg0))
+		return false;
+
+	physfsRefCount++;
+	return true;
+}
+
+static void releasePhysfs()
+{
+	thread::Lock lock(getPhysfsMutex());
+
+	if (--physfsRefCount == 0 && PHYSFS_isInit())
+		PHYSFS_deinit();
+}
+
 Filesystem::Filesystem()
 	: love::filesystem::Filesystem("love.filesystem.physfs")
 	, appendIdentityToPath(false)
@@ -114,6 +144,7 @@ Filesystem::Filesystem()
 	, fullPaths()
 	, commonPathMountInfo()
 	, saveDirectoryNeedsMounting(false)
+	, physfsReferenced(false)
 {
 	requirePath = {"?.lua", "?/init.lua"};
 	cRequirePath = {"??"};
@@ -125,8 +156,8 @@ Filesystem::~Filesystem()
 	love::android::deinitializeVirtualArchive();
 #endif
 
-	if (PHYSFS_isInit())
-		PHYSFS_deinit();
+	if (physfsReferenced)
+		releasePhysfs();
 }
 
 void Filesystem::init(const char *arg0)
@@ -135,8 +166,12 @@ void Filesystem::init(const char *arg0)
 	arg0 = love::android::getArg0();
 #endif
 
-	if (!PHYSFS_init(arg0))
-		throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+	if (!physfsReferenced)
+	{
+		if (!retainPhysfs(arg0))
+			throw love::Exception("Failed to initialize filesystem: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+		physfsReferenced = true;
+	}
 
 	// Enable symlinks by default.
 	setSymlinksEnabled(true);
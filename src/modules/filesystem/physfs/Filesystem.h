@@ -140,6 +140,10 @@ class Filesystem final : public love::filesystem::Filesystem
 
 	bool saveDirectoryNeedsMounting;
 
+	// Whether init() took a reference on PhysFS, which is shared by every
+	// EngineContext in the process.
+	bool physfsReferenced;
+
 }; // Filesystem
 
 } // physfs
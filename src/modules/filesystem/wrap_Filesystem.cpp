@@ -28,6 +28,7 @@
 #include "data/wrap_DataModule.h"
 
 #include "physfs/Filesystem.h"
+#include "libraries/xxHash/xxhash.h"
 
 #ifdef LOVE_ANDROID
 #include "common/android.h"
@@ -41,6 +42,7 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
 
 namespace love
 {
@@ -719,9 +721,110 @@ int w_lines(lua_State *L)
 	return 1;
 }
 
+// Compiled chunks are cached in the save directory, keyed by a hash of their
+// source, so big games don't have to be parsed again on every boot.
+static const char *BYTECODE_CACHE_DIRECTORY = "bytecodecache";
+
+// The cache starts over when it holds this many entries, so chunks which are
+// renamed or deleted don't pile up forever.
+static const size_t MAX_BYTECODE_CACHE_ENTRIES = 512;
+
+// Entries are named <chunk hash>-<source hash>, so the entries of a chunk
+// whose source has since changed can be found by their prefix.
+static const size_t BYTECODE_CACHE_PREFIX_LENGTH = 17;
+
+static std::string getBytecodeCachePath(const Data *source, const std::string &chunkname)
+{
+	// Bytecode embeds the chunk name, and is specific to the Lua build.
+	std::string key = chunkname;
+#ifdef LUA_JITLIBNAME
+	key += "|LuaJIT";
+#endif
+	key += "|" LUA_RELEASE "|" + std::to_string(sizeof(void *));
+
+	XXH64_hash_t chunkhash = XXH64(key.data(), key.size(), 0);
+	XXH64_hash_t sourcehash = XXH64(source->getData(), source->getSize(), chunkhash);
+
+	char name[34];
+	snprintf(name, sizeof(name), "%016llx-%016llx", (unsigned long long) chunkhash, (unsigned long long) sourcehash);
+
+	return std::string(BYTECODE_CACHE_DIRECTORY) + "/" + name;
+}
+
+static bool loadCachedBytecode(lua_State *L, const std::string &path, const std::string &chunkname)
+{
+	Filesystem::Info info = {};
+	if (!instance()->getInfo(path.c_str(), info) || info.type != Filesystem::FILETYPE_FILE)
+		return false;
+
+	StrongRef<Data> bytecode;
+	try
+	{
+		bytecode.set(instance()->read(path.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	if (luaL_loadbuffer(L, (const char *) bytecode->getData(), bytecode->getSize(), chunkname.c_str()) == 0)
+		return true;
+
+	// Truncated, or made by a different Lua build. It'll be overwritten.
+	lua_pop(L, 1);
+	return false;
+}
+
+static int writeBytecode(lua_State * /*L*/, const void *p, size_t size, void *ud)
+{
+	std::vector<char> *bytecode = (std::vector<char> *) ud;
+	bytecode->insert(bytecode->end(), (const char *) p, (const char *) p + size);
+	return 0;
+}
+
+static void saveBytecode(lua_State *L, const std::string &path)
+{
+	// Don't create a save directory for games which never write one.
+	if (!instance()->isRealDirectory(instance()->getSaveDirectory()))
+		return;
+
+	std::vector<char> bytecode;
+
+#if LUA_VERSION_NUM >= 503
+	lua_dump(L, writeBytecode, &bytecode, 0);
+#else
+	lua_dump(L, writeBytecode, &bytecode);
+#endif
+
+	try
+	{
+		std::string directory = std::string(BYTECODE_CACHE_DIRECTORY) + "/";
+		std::string prefix = path.substr(directory.size(), BYTECODE_CACHE_PREFIX_LENGTH);
+
+		// Drop the entries made from older versions of this chunk's source.
+		std::vector<std::string> items;
+		instance()->getDirectoryItems(BYTECODE_CACHE_DIRECTORY, items);
+
+		bool full = items.size() >= MAX_BYTECODE_CACHE_ENTRIES;
+		for (const std::string &item : items)
+		{
+			if (full || item.compare(0, prefix.size(), prefix) == 0)
+				instance()->remove((directory + item).c_str());
+		}
+
+		instance()->createDirectory(BYTECODE_CACHE_DIRECTORY);
+		instance()->write(path.c_str(), bytecode.data(), (int64) bytecode.size());
+	}
+	catch (love::Exception &)
+	{
+		// Read-only save directory: the chunk just doesn't get cached.
+	}
+}
+
 int w_load(lua_State *L)
 {
 	std::string filename = std::string(luaL_checkstring(L, 1));
+	std::string chunkname = "@" + filename;
 
 	Filesystem::LoadMode loadMode = Filesystem::LOADMODE_ANY;
 
@@ -745,15 +848,31 @@ int w_load(lua_State *L)
 
 	int status;
 
+	// Only text chunks are cached; precompiled ones are already fast to load.
+	bool cacheable = instance()->isBytecodeCacheEnabled()
+		&& loadMode == Filesystem::LOADMODE_ANY
+		&& data->getSize() > 0 && *(const char *) data->getData() != LUA_SIGNATURE[0];
+
+	std::string cachepath;
+	if (cacheable)
+	{
+		cachepath = getBytecodeCachePath(data, chunkname);
+		if (loadCachedBytecode(L, cachepath, chunkname))
+		{
+			data->release();
+			return 1;
+		}
+	}
+
 #if (LUA_VERSION_NUM > 501) || defined(LUA_JITLIBNAME)
 	// LuaJIT support this Lua 5.2 function.
 	const char *mode;
 	Filesystem::getConstant(loadMode, mode);
 
-	status = luaL_loadbufferx(L, (const char *)data->getData(), data->getSize(), ("@" + filename).c_str(), mode);
+	status = luaL_loadbufferx(L, (const char *)data->getData(), data->getSize(), chunkname.c_str(), mode);
 #else
 	if (loadMode == Filesystem::LOADMODE_ANY)
-		status = luaL_loadbuffer(L, (const char *)data->getData(), data->getSize(), ("@" + filename).c_str());
+		status = luaL_loadbuffer(L, (const char *)data->getData(), data->getSize(), chunkname.c_str());
 	else
 	{
 		// Unsupported
@@ -764,6 +883,9 @@ int w_load(lua_State *L)
 
 	data->release();
 
+	if (status == 0 && cacheable)
+		saveBytecode(L, cachepath);
+
 	// Load the chunk, but don't run it.
 	switch (status)
 	{
@@ -776,6 +898,30 @@ int w_load(lua_State *L)
 	}
 }
 
+int w_setBytecodeCacheEnabled(lua_State *L)
+{
+	instance()->setBytecodeCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isBytecodeCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isBytecodeCacheEnabled());
+	return 1;
+}
+
+int w_setSeekCacheEnabled(lua_State *L)
+{
+	instance()->setSeekCacheEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isSeekCacheEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isSeekCacheEnabled());
+	return 1;
+}
+
 int w_setSymlinksEnabled(lua_State *L)
 {
 	instance()->setSymlinksEnabled(luax_checkboolean(L, 1));
@@ -1048,6 +1194,10 @@ static const luaL_Reg functions[] =
 	{ "getInfo", w_getInfo },
 	{ "setSymlinksEnabled", w_setSymlinksEnabled },
 	{ "areSymlinksEnabled", w_areSymlinksEnabled },
+	{ "setBytecodeCacheEnabled", w_setBytecodeCacheEnabled },
+	{ "isBytecodeCacheEnabled", w_isBytecodeCacheEnabled },
+	{ "setSeekCacheEnabled", w_setSeekCacheEnabled },
+	{ "isSeekCacheEnabled", w_isSeekCacheEnabled },
 	{ "newFileData", w_newFileData },
 	{ "getRequirePath", w_getRequirePath },
 	{ "setRequirePath", w_setRequirePath },
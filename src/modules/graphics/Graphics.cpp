@@ -239,10 +239,10 @@ Graphics::~Graphics()
 	// Graphics destructor.
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
-		if (Shader::standardShaders[i])
+		if (shaderState.standardShaders[i])
 		{
-			Shader::standardShaders[i]->release();
-			Shader::standardShaders[i] = nullptr;
+			shaderState.standardShaders[i]->release();
+			shaderState.standardShaders[i] = nullptr;
 		}
 	}
 
@@ -704,7 +704,7 @@ Texture *Graphics::getTextureOrDefaultForActiveShader(Texture *tex)
 	if (tex != nullptr)
 		return tex;
 
-	Shader *shader = Shader::current;
+	Shader *shader = shaderState.current;
 
 	if (shader != nullptr)
 	{
@@ -1875,7 +1875,7 @@ void Graphics::dispatchThreadgroups(Shader *shader, int x, int y, int z)
 
 	flushBatchedDraws();
 
-	auto prevshader = Shader::current;
+	auto prevshader = shaderState.current;
 	shader->attach();
 
 	bool success = dispatch(shader, x, y, z);
@@ -1896,7 +1896,7 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 
 	flushBatchedDraws();
 
-	auto prevshader = Shader::current;
+	auto prevshader = shaderState.current;
 	shader->attach();
 
 	bool success = dispatch(shader, indirectargs, argsindex * indirectargs->getArrayStride());
@@ -1986,8 +1986,8 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 		if (Shader::isDefaultActive())
 			Shader::attachDefault(state.standardShaderType);
 
-		if (Shader::current != nullptr)
-			Shader::current->validateDrawState(cmd.primitiveMode, cmd.texture);
+		if (shaderState.current != nullptr)
+			shaderState.current->validateDrawState(cmd.primitiveMode, cmd.texture);
 	}
 
 	if (shouldresize)
@@ -2188,13 +2188,13 @@ void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int insta
 
 	flushBatchedDraws();
 
-	if (Shader::isDefaultActive() || !Shader::current)
+	if (Shader::isDefaultActive() || !shaderState.current)
 		throw love::Exception("drawFromShader can only be used with a custom shader.");
 
 	if (vertexcount < 0 || instancecount < 0)
 		throw love::Exception("drawFromShader vertex and instance count parameters must not be negative.");
 
-	Shader::current->validateDrawState(primtype, maintexture);
+	shaderState.current->validateDrawState(primtype, maintexture);
 
 	BufferBindings buffers;
 	DrawCommand cmd(noAttributesID, &buffers);
@@ -2223,10 +2223,10 @@ void Graphics::drawFromShader(Buffer *indexbuffer, int indexcount, int instancec
 	if ((size_t)(startindex + indexcount) > indexbuffer->getArrayLength() * indexbuffer->getDataMembers().size())
 		throw love::Exception("drawFromShader startindex and index count parameters do not fit in the given index buffer.");
 
-	if (Shader::isDefaultActive() || !Shader::current)
+	if (Shader::isDefaultActive() || !shaderState.current)
 		throw love::Exception("drawFromShader can only be used with a custom shader.");
 
-	Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
+	shaderState.current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
 
 	BufferBindings buffers;
 	DrawIndexedCommand cmd(noAttributesID, &buffers, indexbuffer);
@@ -2250,12 +2250,12 @@ void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectar
 	if (primtype == PRIMITIVE_TRIANGLE_FAN)
 		throw love::Exception("The fan draw mode is not supported in indirect draws.");
 
-	if (Shader::isDefaultActive() || !Shader::current)
+	if (Shader::isDefaultActive() || !shaderState.current)
 		throw love::Exception("drawFromShaderIndirect can only be used with a custom shader.");
 
 	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_VERTICES, indirectargs, argsindex);
 
-	Shader::current->validateDrawState(primtype, maintexture);
+	shaderState.current->validateDrawState(primtype, maintexture);
 
 	BufferBindings buffers;
 	DrawCommand cmd(noAttributesID, &buffers);
@@ -2275,12 +2275,12 @@ void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs,
 	if (!(indexbuffer->getUsageFlags() & BUFFERUSAGEFLAG_INDEX))
 		throw love::Exception("The buffer passed to the indexed variant of drawFromShaderIndirect must be an index buffer.");
 
-	if (Shader::isDefaultActive() || !Shader::current)
+	if (Shader::isDefaultActive() || !shaderState.current)
 		throw love::Exception("drawFromShaderIndirect can only be used with a custom shader.");
 
 	validateIndirectArgsBuffer(INDIRECT_ARGS_DRAW_INDICES, indirectargs, argsindex);
 
-	Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
+	shaderState.current->validateDrawState(PRIMITIVE_TRIANGLES, maintexture);
 
 	BufferBindings buffers;
 	DrawIndexedCommand cmd(noAttributesID, &buffers, indexbuffer);
@@ -1087,6 +1087,10 @@ class Graphics : public Module
 
 	Deprecations deprecations;
 
+	// The active and standard Shaders of this context; see Shader::contextState.
+	Shader::ContextState shaderState;
+	friend class Shader;
+
 	bool usingNoTextureCubeShadowBiasHack = false;
 
 	static const size_t MAX_USER_STACK_DEPTH = 128;
@@ -677,8 +677,8 @@ void Mesh::updateVertexAttributes(Graphics *gfx)
 
 		// Query the index from the shader as a fallback to support old code that
 		// hasn't set a binding location.
-		if (bindinglocation < 0 && Shader::current)
-			bindinglocation = Shader::current->getVertexAttributeIndex(attrib.name);
+		if (bindinglocation < 0 && Shader::contextState().current)
+			bindinglocation = Shader::contextState().current->getVertexAttributeIndex(attrib.name);
 
 		if (bindinglocation >= 0)
 		{
@@ -756,8 +756,9 @@ void Mesh::drawInternal(Graphics *gfx, const Matrix4 &m, int instancecount, Buff
 	if (Shader::isDefaultActive())
 		Shader::attachDefault(primitiveType == PRIMITIVE_POINTS ? Shader::STANDARD_POINTS : Shader::STANDARD_DEFAULT);
 
-	if (Shader::current)
-		Shader::current->validateDrawState(primitiveType, texture);
+	Shader *shader = Shader::contextState().current;
+	if (shader)
+		shader->validateDrawState(primitiveType, texture);
 
 	bool attributesIDneedsupdate = !attributesID.isValid();
 
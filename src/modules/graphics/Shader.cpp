@@ -562,8 +562,17 @@ static_assert(sizeof(Shader::BuiltinUniformData) == sizeof(float) * 4 * 12, "Upd
 
 love::Type Shader::type("Shader", &Object::type);
 
-Shader *Shader::current = nullptr;
-Shader *Shader::standardShaders[Shader::STANDARD_MAX_ENUM] = {nullptr};
+Shader::ContextState &Shader::contextState()
+{
+	Graphics *gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr)
+		return gfx->shaderState;
+
+	// Shaders can outlive the Graphics module; nothing is active then.
+	static thread_local ContextState orphaned;
+	orphaned = ContextState();
+	return orphaned;
+}
 
 Shader::SourceInfo Shader::getSourceInfo(const std::string &src)
 {
@@ -711,13 +720,15 @@ Shader::Shader(StrongRef<ShaderStage> _stages[], const CompileOptions &options)
 
 Shader::~Shader()
 {
+	ContextState &state = contextState();
+
 	for (int i = 0; i < STANDARD_MAX_ENUM; i++)
 	{
-		if (this == standardShaders[i])
-			standardShaders[i] = nullptr;
+		if (this == state.standardShaders[i])
+			state.standardShaders[i] = nullptr;
 	}
 
-	if (current == this)
+	if (state.current == this)
 		attachDefault(STANDARD_DEFAULT);
 
 	for (Texture *tex : activeTextures)
@@ -740,23 +751,26 @@ bool Shader::hasStage(ShaderStageType stage)
 
 void Shader::attachDefault(StandardShader defaultType)
 {
-	Shader *defaultshader = standardShaders[defaultType];
+	ContextState &state = contextState();
+	Shader *defaultshader = state.standardShaders[defaultType];
 
 	if (defaultshader == nullptr)
 	{
-		current = nullptr;
+		state.current = nullptr;
 		return;
 	}
 
-	if (current != defaultshader)
+	if (state.current != defaultshader)
 		defaultshader->attach();
 }
 
 bool Shader::isDefaultActive()
 {
+	const ContextState &state = contextState();
+
 	for (int i = 0; i < STANDARD_MAX_ENUM; i++)
 	{
-		if (current == standardShaders[i])
+		if (state.current == state.standardShaders[i])
 			return true;
 	}
 
@@ -832,7 +846,7 @@ void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count
 	if (basetype != UNIFORM_SAMPLER && basetype != UNIFORM_STORAGETEXTURE)
 		return;
 
-	if (!internalUpdate && current == this)
+	if (!internalUpdate && contextState().current == this)
 		flushBatchedDraws();
 
 	count = std::min(count, info->count);
@@ -873,7 +887,7 @@ void Shader::sendBuffers(const UniformInfo *info, Buffer **buffers, int count, b
 	if (basetype != UNIFORM_TEXELBUFFER && basetype != UNIFORM_STORAGEBUFFER)
 		return;
 
-	if (!internalUpdate && current == this)
+	if (!internalUpdate && contextState().current == this)
 		flushBatchedDraws();
 
 	count = std::min(count, info->count);
@@ -912,7 +926,7 @@ void Shader::sendBuffers(const UniformInfo *info, Buffer **buffers, int count, b
 
 void Shader::flushBatchedDraws() const
 {
-	if (current == this)
+	if (contextState().current == this)
 		Graphics::flushBatchedDrawsGlobal();
 }
 
@@ -190,11 +190,23 @@ class Shader : public Object, public Resource
 		Vector4 screenSizeParams;
  	};
 
-	// Pointer to currently active Shader.
-	static Shader *current;
+	/**
+	 * The active Shader and the standard Shaders. Each EngineContext has its
+	 * own, owned by its Graphics module.
+	 **/
+	struct ContextState
+	{
+		// Pointer to currently active Shader.
+		Shader *current = nullptr;
 
-	// Pointer to the default Shader.
-	static Shader *standardShaders[STANDARD_MAX_ENUM];
+		// Pointers to the default Shaders.
+		Shader *standardShaders[STANDARD_MAX_ENUM] = {};
+	};
+
+	/**
+	 * Gets the state of the current EngineContext's Graphics module.
+	 **/
+	static ContextState &contextState();
 
 	Shader(StrongRef<ShaderStage> stages[], const CompileOptions &options);
 	virtual ~Shader();
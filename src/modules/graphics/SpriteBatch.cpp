@@ -340,8 +340,8 @@ void SpriteBatch::updateVertexAttributes(Graphics *gfx)
 
 		// If the attribute is one of the LOVE-defined ones, use the constant
 		// attribute index for it, otherwise query the index from the shader.
-		if (bindingindex < 0 && Shader::current)
-			bindingindex = Shader::current->getVertexAttributeIndex(it.first);
+		if (bindingindex < 0 && Shader::contextState().current)
+			bindingindex = Shader::contextState().current->getVertexAttributeIndex(it.first);
 
 		if (bindingindex >= 0)
 		{
@@ -392,8 +392,9 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 		}
 	}
 
-	if (Shader::current)
-		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+	Shader *shader = Shader::contextState().current;
+	if (shader)
+		shader->validateDrawState(PRIMITIVE_TRIANGLES, texture);
 
 	flush(); // Upload any modified sprite data to the GPU.
 
@@ -268,8 +268,9 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 	if (!drawCommands.empty())
 		firsttex = drawCommands[0].texture;
 
-	if (Shader::current)
-		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, firsttex);
+	Shader *shader = Shader::contextState().current;
+	if (shader)
+		shader->validateDrawState(PRIMITIVE_TRIANGLES, firsttex);
 
 	int totalverts = 0;
 	for (const Font::DrawCommand &cmd : drawCommands)
@@ -117,9 +117,9 @@ void Video::draw(Graphics *gfx, const Matrix4 &m)
 
 	// setVideoTextures may call flushBatchedDraws before setting the textures, so
 	// we can't call it after requestBatchedDraw.
-	auto shader = Shader::current;
+	auto shader = Shader::contextState().current;
 	if (Shader::isDefaultActive())
-		shader = Shader::standardShaders[Shader::STANDARD_VIDEO];
+		shader = Shader::contextState().standardShaders[Shader::STANDARD_VIDEO];
 
 	if (shader != nullptr)
 		shader->setVideoTextures(textures[0], textures[1], textures[2]);
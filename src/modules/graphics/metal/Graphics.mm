@@ -367,20 +367,20 @@ Graphics::Graphics()
 	for (int i = 0; i < Shader::STANDARD_MAX_ENUM; i++)
 	{
 		auto stype = (Shader::StandardShader) i;
-		if (!Shader::standardShaders[i])
+		if (!shaderState.standardShaders[i])
 		{
 			std::vector<std::string> stages;
 			Shader::CompileOptions opts;
 			stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_VERTEX));
 			stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_PIXEL));
-			Shader::standardShaders[i] = newShader(stages, opts);
+			shaderState.standardShaders[i] = newShader(stages, opts);
 		}
 	}
 
 	// A shader should always be active, but the default shader shouldn't be
 	// returned by getShader(), so we don't do setShader(defaultShader).
-	if (!Shader::current)
-		Shader::standardShaders[Shader::STANDARD_DEFAULT]->attach();
+	if (!shaderState.current)
+		shaderState.standardShaders[Shader::STANDARD_DEFAULT]->attach();
 
 	auto window = Module::getInstance<love::window::Window>(M_WINDOW);
 
@@ -996,7 +996,7 @@ void Graphics::applyRenderState(id<MTLRenderCommandEncoder> encoder, VertexAttri
 
 		key.vertexAttributesID = attributesID;
 
-		Shader *shader = (Shader *) Shader::current;
+		Shader *shader = (Shader *) shaderState.current;
 		id<MTLRenderPipelineState> pipeline = nil;
 
 		if (shader)
@@ -1237,9 +1237,9 @@ void Graphics::draw(const DrawCommand &cmd)
 	}
 
 	applyRenderState(encoder, cmd.attributesID);
-	applyShaderUniforms(encoder, Shader::current, cmd.texture);
+	applyShaderUniforms(encoder, shaderState.current, cmd.texture);
 
-	setVertexBuffers(encoder, Shader::current, cmd.buffers, renderBindings);
+	setVertexBuffers(encoder, shaderState.current, cmd.buffers, renderBindings);
 
 	if (cmd.indirectBuffer != nullptr)
 	{
@@ -1269,9 +1269,9 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 	}
 
 	applyRenderState(encoder, cmd.attributesID);
-	applyShaderUniforms(encoder, Shader::current, cmd.texture);
+	applyShaderUniforms(encoder, shaderState.current, cmd.texture);
 
-	setVertexBuffers(encoder, Shader::current, cmd.buffers, renderBindings);
+	setVertexBuffers(encoder, shaderState.current, cmd.buffers, renderBindings);
 
 	auto indexType = cmd.indexType == INDEX_UINT32 ? MTLIndexTypeUInt32 : MTLIndexTypeUInt16;
 
@@ -1334,14 +1334,14 @@ void Graphics::drawQuads(int start, int count, VertexAttributesID attributesID,
 	}
 
 	applyRenderState(encoder, attributesID);
-	applyShaderUniforms(encoder, Shader::current, texture);
+	applyShaderUniforms(encoder, shaderState.current, texture);
 
 	id<MTLBuffer> ib = getMTLBuffer(quadIndexBuffer);
 
 	// Some older iOS devices don't support base vertex rendering.
 	if (families.apple[3] || families.mac[1] || families.macCatalyst[1])
 	{
-		setVertexBuffers(encoder, Shader::current, &buffers, renderBindings);
+		setVertexBuffers(encoder, shaderState.current, &buffers, renderBindings);
 
 		int basevertex = start * 4;
 
@@ -1373,7 +1373,7 @@ void Graphics::drawQuads(int start, int count, VertexAttributesID attributesID,
 
 		for (int quadindex = 0; quadindex < count; quadindex += MAX_QUADS_PER_DRAW)
 		{
-			setVertexBuffers(encoder, Shader::current, &bufferscopy, renderBindings);
+			setVertexBuffers(encoder, shaderState.current, &bufferscopy, renderBindings);
 
 			int quadcount = std::min(MAX_QUADS_PER_DRAW, count - quadindex);
 
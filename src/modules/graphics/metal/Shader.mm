@@ -705,12 +705,14 @@ Shader::~Shader()
 
 void Shader::attach()
 {
-	if (current != this)
+	ContextState &state = contextState();
+
+	if (state.current != this)
 	{
 		Graphics *gfx = Graphics::getInstance();
 		gfx->flushBatchedDraws();
 		gfx->setShaderChanged();
-		current = this;
+		state.current = this;
 	}
 }
 
@@ -730,7 +732,7 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 	if (info->dataSize == 0)
 		return;
 
-	if (current == this)
+	if (contextState().current == this)
 		Graphics::flushBatchedDrawsGlobal();
 
 	count = std::min(count, info->count);
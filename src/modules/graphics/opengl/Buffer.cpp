@@ -110,7 +110,7 @@ Buffer::Buffer(love::graphics::Graphics *gfx, const Settings &settings, const st
 
 	if (settings.zeroInitialize && data == nullptr && GLAD_VERSION_4_3)
 	{
-		gl.bindBuffer(mapUsage, buffer);
+		getGL().bindBuffer(mapUsage, buffer);
 		glClearBufferData(target, GL_R8UI, GL_RED, GL_UNSIGNED_BYTE, nullptr);
 	}
 }
@@ -134,10 +134,10 @@ void Buffer::unloadVolatile()
 {
 	mapped = false;
 	if (buffer != 0)
-		gl.deleteBuffer(buffer);
+		getGL().deleteBuffer(buffer);
 	buffer = 0;
 	if (texture != 0)
-		gl.deleteTexture(texture);
+		getGL().deleteTexture(texture);
 	texture = 0;
 }
 
@@ -147,7 +147,7 @@ bool Buffer::load(const void *initialdata)
 		/* Clear the error buffer. */;
 
 	glGenBuffers(1, &buffer);
-	gl.bindBuffer(mapUsage, buffer);
+	getGL().bindBuffer(mapUsage, buffer);
 
 	GLenum gldatausage = OpenGL::getGLBufferDataUsage(getDataUsage());
 
@@ -157,7 +157,7 @@ bool Buffer::load(const void *initialdata)
 	if (getUsageFlags() & BUFFERUSAGEFLAG_TEXEL)
 	{
 		glGenTextures(1, &texture);
-		gl.bindBufferTextureToUnit(texture, 0, false, true);
+		getGL().bindBufferTextureToUnit(texture, 0, false, true);
 
 		GLenum glformat = getGLFormat(getDataMember(0).decl.format);
 
@@ -195,7 +195,7 @@ void *Buffer::map(MapType map, size_t offset, size_t size)
 
 	if (map == MAP_READ_ONLY)
 	{
-		gl.bindBuffer(mapUsage, buffer);
+		getGL().bindBuffer(mapUsage, buffer);
 		data = (char *) glMapBufferRange(target, offset, size, GL_MAP_READ_BIT);
 	}
 	else if (ownsMemoryMap)
@@ -233,7 +233,7 @@ void Buffer::unmap(size_t usedoffset, size_t usedsize)
 
 	if (mappedType == MAP_READ_ONLY)
 	{
-		gl.bindBuffer(mapUsage, buffer);
+		getGL().bindBuffer(mapUsage, buffer);
 		glUnmapBuffer(target);
 		if (!ownsMemoryMap)
 			memoryMap = nullptr;
@@ -271,7 +271,7 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 
 	GLenum gldatausage = OpenGL::getGLBufferDataUsage(dataUsage);
 
-	gl.bindBuffer(mapUsage, buffer);
+	getGL().bindBuffer(mapUsage, buffer);
 
 	if (supportsOrphan() && size == buffersize)
 	{
@@ -281,7 +281,7 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 
 #if LOVE_WINDOWS
 		// TODO: Verify that this intel codepath is a useful optimization.
-		if (gl.getVendor() == OpenGL::VENDOR_INTEL)
+		if (getGL().getVendor() == OpenGL::VENDOR_INTEL)
 			glBufferData(target, (GLsizeiptr) buffersize, data, gldatausage);
 		else
 #endif
@@ -299,7 +299,7 @@ void Buffer::clearInternal(size_t offset, size_t size)
 {
 	if (GLAD_VERSION_4_3)
 	{
-		gl.bindBuffer(mapUsage, buffer);
+		getGL().bindBuffer(mapUsage, buffer);
 		glClearBufferSubData(target, GL_R8UI, offset, size, GL_RED, GL_UNSIGNED_BYTE, nullptr);
 	}
 	else
@@ -89,6 +89,18 @@ static GLenum getGLBlendFactor(BlendFactor factor)
 	return 0;
 }
 
+OpenGL &getGL()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr)
+		return gfx->gl;
+
+	// Objects released after love.graphics is gone have no GL context left to
+	// talk to, and nobody else's state to touch.
+	static thread_local OpenGL orphanState;
+	return orphanState;
+}
+
 love::graphics::Graphics *createInstance()
 {
 	love::graphics::Graphics *instance = nullptr;
@@ -115,8 +127,6 @@ Graphics::Graphics()
 	, bufferMapMemorySize(2 * 1024 * 1024)
 	, pixelFormatUsage()
 {
-	gl = OpenGL();
-
 	try
 	{
 		bufferMapMemory = new char[bufferMapMemorySize];
@@ -375,7 +385,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 	{
 		auto stype = (Shader::StandardShader) i;
 
-		if (!Shader::standardShaders[i])
+		if (!shaderState.standardShaders[i])
 		{
 			std::vector<std::string> stages;
 			Shader::CompileOptions opts;
@@ -384,7 +394,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 
 			try
 			{
-				Shader::standardShaders[i] = newShader(stages, opts);
+				shaderState.standardShaders[i] = newShader(stages, opts);
 			}
 			catch (love::Exception &)
 			{
@@ -393,7 +403,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 				if (!isUsingNoTextureCubeShadowBiasHack())
 				{
 					usingNoTextureCubeShadowBiasHack = true;
-					Shader::standardShaders[i] = newShader(stages, opts);
+					shaderState.standardShaders[i] = newShader(stages, opts);
 				}
 				else
 				{
@@ -405,8 +415,8 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 
 	// A shader should always be active, but the default shader shouldn't be
 	// returned by getShader(), so we don't do setShader(defaultShader).
-	if (!Shader::current)
-		Shader::standardShaders[Shader::STANDARD_DEFAULT]->attach();
+	if (!shaderState.current)
+		shaderState.standardShaders[Shader::STANDARD_DEFAULT]->attach();
 
 	return true;
 }
@@ -921,12 +931,12 @@ void Graphics::clear(OptionalColorD c, OptionalInt stencil, OptionalDouble depth
 		glClear(flags);
 	}
 
-	if (c.hasValue && gl.bugs.clearRequiresDriverTextureStateUpdate && Shader::current)
+	if (c.hasValue && gl.bugs.clearRequiresDriverTextureStateUpdate && shaderState.current)
 	{
 		// This seems to be enough to fix the bug for me. Other methods I've
 		// tried (e.g. dummy draws) don't work in all cases.
 		gl.useProgram(0);
-		gl.useProgram((GLuint) Shader::current->getHandle());
+		gl.useProgram((GLuint) shaderState.current->getHandle());
 	}
 }
 
@@ -1000,12 +1010,12 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 		glClear(flags);
 	}
 
-	if (gl.bugs.clearRequiresDriverTextureStateUpdate && Shader::current)
+	if (gl.bugs.clearRequiresDriverTextureStateUpdate && shaderState.current)
 	{
 		// This seems to be enough to fix the bug for me. Other methods I've
 		// tried (e.g. dummy draws) don't work in all cases.
 		gl.useProgram(0);
-		gl.useProgram((GLuint) Shader::current->getHandle());
+		gl.useProgram((GLuint) shaderState.current->getHandle());
 	}
 }
 
@@ -49,7 +49,15 @@ namespace graphics
 namespace opengl
 {
 
-class Graphics final : public love::graphics::Graphics
+// Owns the GL state cache of one Graphics. A base class rather than a member,
+// so it outlives love::graphics::Graphics' destructor, which still releases GL
+// objects.
+struct GraphicsGLState
+{
+	OpenGL gl;
+};
+
+class Graphics final : private GraphicsGLState, public love::graphics::Graphics
 {
 public:
 
@@ -115,6 +123,8 @@ class Graphics final : public love::graphics::Graphics
 
 private:
 
+	friend OpenGL &getGL();
+
 	struct CachedFBOHasher
 	{
 		size_t operator() (const RenderTargets &rts) const
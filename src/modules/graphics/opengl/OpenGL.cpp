@@ -93,37 +93,37 @@ OpenGL::TempDebugGroup::~TempDebugGroup()
 
 OpenGL::CleanClearState::CleanClearState(GLbitfield clearFlags)
 	: clearFlags(clearFlags)
-	, colorWriteMask(gl.getColorWriteMask())
-	, stencilWriteMask(gl.getStencilWriteMask())
-	, depthWrites(gl.hasDepthWrites())
-	, scissor(gl.isStateEnabled(ENABLE_SCISSOR_TEST))
+	, colorWriteMask(getGL().getColorWriteMask())
+	, stencilWriteMask(getGL().getStencilWriteMask())
+	, depthWrites(getGL().hasDepthWrites())
+	, scissor(getGL().isStateEnabled(ENABLE_SCISSOR_TEST))
 {
 	if ((clearFlags & GL_COLOR_BUFFER_BIT) != 0 && colorWriteMask != LOVE_UINT32_MAX)
-		gl.setColorWriteMask(LOVE_UINT32_MAX);
+		getGL().setColorWriteMask(LOVE_UINT32_MAX);
 
 	if ((clearFlags & GL_DEPTH_BUFFER_BIT) != 0 && !depthWrites)
-		gl.setDepthWrites(true);
+		getGL().setDepthWrites(true);
 
 	if ((clearFlags & GL_STENCIL_BUFFER_BIT) != 0 && (stencilWriteMask & 0xFF) != 0xFF)
-		gl.setStencilWriteMask(LOVE_UINT32_MAX);
+		getGL().setStencilWriteMask(LOVE_UINT32_MAX);
 
 	if (clearFlags != 0 && scissor)
-		gl.setEnableState(ENABLE_SCISSOR_TEST, false);
+		getGL().setEnableState(ENABLE_SCISSOR_TEST, false);
 }
 
 OpenGL::CleanClearState::~CleanClearState()
 {
 	if ((clearFlags & GL_COLOR_BUFFER_BIT) != 0 && colorWriteMask != LOVE_UINT32_MAX)
-		gl.setColorWriteMask(colorWriteMask);
+		getGL().setColorWriteMask(colorWriteMask);
 
 	if ((clearFlags & GL_DEPTH_BUFFER_BIT) != 0 && !depthWrites)
-		gl.setDepthWrites(depthWrites);
+		getGL().setDepthWrites(depthWrites);
 
 	if ((clearFlags & GL_STENCIL_BUFFER_BIT) != 0 && (stencilWriteMask & 0xFF) != 0xFF)
-		gl.setStencilWriteMask(stencilWriteMask);
+		getGL().setStencilWriteMask(stencilWriteMask);
 
 	if (clearFlags != 0 && scissor)
-		gl.setEnableState(ENABLE_SCISSOR_TEST, scissor);
+		getGL().setEnableState(ENABLE_SCISSOR_TEST, scissor);
 }
 
 OpenGL::OpenGL()
@@ -181,13 +181,13 @@ bool OpenGL::initContext()
 	if (getVendor() == VENDOR_AMD)
 	{
 		bugs.clearRequiresDriverTextureStateUpdate = true;
-		if (!gl.isCoreProfile() && !GLAD_ES_VERSION_2_0)
+		if (!isCoreProfile() && !GLAD_ES_VERSION_2_0)
 			bugs.generateMipmapsRequiresTexture2DEnable = true;
 	}
 #endif
 
 #ifdef LOVE_WINDOWS
-	if (getVendor() == VENDOR_INTEL && gl.isCoreProfile())
+	if (getVendor() == VENDOR_INTEL && isCoreProfile())
 	{
 		const char *device = (const char *) glGetString(GL_RENDERER);
 		if (strstr(device, "HD Graphics 4000") || strstr(device, "HD Graphics 2500"))
@@ -454,10 +454,10 @@ void OpenGL::prepareDraw(love::graphics::Graphics *gfx)
 	TempDebugGroup debuggroup("Prepare OpenGL draw");
 
 	// Make sure the active shader's love-provided uniforms are up to date.
-	if (Shader::current != nullptr)
+	if (Shader::contextState().current != nullptr)
 	{
 		Rect viewport = getViewport();
-		((Shader *)Shader::current)->updateBuiltinUniforms(gfx, viewport.w, viewport.h);
+		((Shader *)Shader::contextState().current)->updateBuiltinUniforms(gfx, viewport.w, viewport.h);
 	}
 }
 
@@ -1241,7 +1241,7 @@ bool OpenGL::rawTexStorage(TextureType target, int levels, PixelFormat pixelform
 
 bool OpenGL::isTexStorageSupported()
 {
-	if (gl.bugs.texStorageBreaksSubImage)
+	if (getGL().bugs.texStorageBreaksSubImage)
 		return false;
 
 	return GLAD_ES_VERSION_3_0 || GLAD_VERSION_4_2 || GLAD_ARB_texture_storage;
@@ -1396,7 +1396,7 @@ OpenGL::TextureFormat OpenGL::convertPixelFormat(PixelFormat pixelformat)
 	switch (pixelformat)
 	{
 	case PIXELFORMAT_R8_UNORM:
-		if (!gl.bugs.brokenR8PixelFormat)
+		if (!getGL().bugs.brokenR8PixelFormat)
 		{
 			f.internalformat = GL_R8;
 			f.externalformat = GL_RED;
@@ -1575,7 +1575,7 @@ OpenGL::TextureFormat OpenGL::convertPixelFormat(PixelFormat pixelformat)
 		break;
 
 	case PIXELFORMAT_LA8_UNORM:
-		if (gl.isCoreProfile() || GLAD_ES_VERSION_3_0)
+		if (getGL().isCoreProfile() || GLAD_ES_VERSION_3_0)
 		{
 			f.internalformat = GL_RG8;
 			f.externalformat = GL_RG;
@@ -1878,7 +1878,7 @@ uint32 OpenGL::getPixelFormatUsageFlags(PixelFormat pixelformat)
 			flags |= computewrite;
 		break;
 	case PIXELFORMAT_RGBA8_sRGB:
-		if (gl.bugs.brokenSRGB)
+		if (getGL().bugs.brokenSRGB)
 			break;
 		flags |= commonsample | commonrender;
 		break;
@@ -2255,10 +2255,6 @@ const char *OpenGL::debugTypeString(GLenum type)
 	}
 }
 
-
-// OpenGL class instance singleton.
-OpenGL gl;
-
 } // opengl
 } // graphics
 } // love
@@ -521,8 +521,11 @@ class OpenGL
 
 }; // OpenGL
 
-// OpenGL class instance singleton.
-extern OpenGL gl;
+/**
+ * Gets the GL state cache of the current EngineContext's love.graphics. Each
+ * context renders into its own GL context, so they can't share one.
+ **/
+OpenGL &getGL();
 
 } // opengl
 } // graphics
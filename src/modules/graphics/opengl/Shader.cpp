@@ -92,7 +92,7 @@ void Shader::mapActiveUniforms()
 	GLint activeprogram = 0;
 	glGetIntegerv(GL_CURRENT_PROGRAM, &activeprogram);
 
-	gl.useProgram(program);
+	getGL().useProgram(program);
 
 	GLint numuniforms;
 	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numuniforms);
@@ -211,7 +211,7 @@ void Shader::mapActiveUniforms()
 			sendBuffers(&u, &activeBuffers[u.resourceIndex], u.count, true);
 	}
 
-	if (gl.isBufferUsageSupported(BUFFERUSAGE_SHADER_STORAGE))
+	if (getGL().isBufferUsageSupported(BUFFERUSAGE_SHADER_STORAGE))
 	{
 		GLint numstoragebuffers = 0;
 		glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &numstoragebuffers);
@@ -275,7 +275,7 @@ void Shader::mapActiveUniforms()
 		}
 	}
 
-	gl.useProgram(activeprogram);
+	getGL().useProgram(activeprogram);
 }
 
 bool Shader::loadVolatile()
@@ -288,7 +288,7 @@ bool Shader::loadVolatile()
 
 	activeStorageBufferBindings.clear();
 
-	storageBufferBindingIndexToActiveBinding.resize(gl.getMaxShaderStorageBufferBindings(), std::make_pair(-1, -1));
+	storageBufferBindingIndexToActiveBinding.resize(getGL().getMaxShaderStorageBufferBindings(), std::make_pair(-1, -1));
 	activeStorageBufferBindings.clear();
 	activeWritableStorageBuffers.clear();
 
@@ -336,10 +336,10 @@ bool Shader::loadVolatile()
 	// Get all active uniform variables in this shader from OpenGL.
 	mapActiveUniforms();
 
-	if (current == this)
+	if (contextState().current == this)
 	{
 		// make sure glUseProgram gets called.
-		current = nullptr;
+		contextState().current = nullptr;
 		attach();
 	}
 
@@ -350,8 +350,8 @@ void Shader::unloadVolatile()
 {
 	if (program != 0)
 	{
-		if (current == this)
-			gl.useProgram(0);
+		if (contextState().current == this)
+			getGL().useProgram(0);
 
 		glDeleteProgram(program);
 		program = 0;
@@ -411,12 +411,14 @@ std::string Shader::getWarnings() const
 
 void Shader::attach()
 {
-	if (current != this)
+	ContextState &state = contextState();
+
+	if (state.current != this)
 	{
 		Graphics::flushBatchedDrawsGlobal();
 
-		gl.useProgram(program);
-		current = this;
+		getGL().useProgram(program);
+		state.current = this;
 		// retain/release happens in Graphics::setShader.
 
 		// Make sure all textures are bound to their respective texture units.
@@ -426,9 +428,9 @@ void Shader::attach()
 			if (unit.active)
 			{
 				if (unit.isTexelBuffer)
-					gl.bindBufferTextureToUnit(unit.texture, i, false, false);
+					getGL().bindBufferTextureToUnit(unit.texture, i, false, false);
 				else
-					gl.bindTextureToUnit(unit.type, unit.texture, i, false, false);
+					getGL().bindTextureToUnit(unit.type, unit.texture, i, false, false);
 			}
 		}
 
@@ -439,7 +441,7 @@ void Shader::attach()
 		}
 
 		for (auto bufferbinding : activeStorageBufferBindings)
-			gl.bindIndexedBuffer(bufferbinding.buffer, BUFFERUSAGE_SHADER_STORAGE, bufferbinding.bindingindex);
+			getGL().bindIndexedBuffer(bufferbinding.buffer, BUFFERUSAGE_SHADER_STORAGE, bufferbinding.bindingindex);
 
 		// send any pending uniforms to the shader program.
 		for (const auto &p : pendingUniformUpdates)
@@ -461,7 +463,7 @@ void Shader::updateUniform(const UniformInfo *info, int count)
 
 void Shader::updateUniform(const UniformInfo *info, int count, bool internalupdate)
 {
-	if (current != this && !internalupdate)
+	if (contextState().current != this && !internalupdate)
 	{
 		pendingUniformUpdates.push_back(std::make_pair(info, count));
 		return;
@@ -555,7 +557,7 @@ void Shader::updateUniform(const UniformInfo *info, int count, bool internalupda
 
 void Shader::applyTexture(const UniformInfo *info, int i, love::graphics::Texture *texture, UniformType basetype, bool isdefault)
 {
-	bool shaderactive = current == this;
+	bool shaderactive = contextState().current == this;
 
 	if (basetype == UNIFORM_STORAGETEXTURE)
 	{
@@ -585,7 +587,7 @@ void Shader::applyTexture(const UniformInfo *info, int i, love::graphics::Textur
 		int texunit = info->ints[i];
 
 		if (shaderactive)
-			gl.bindTextureToUnit(info->textureType, gltex, texunit, false, false);
+			getGL().bindTextureToUnit(info->textureType, gltex, texunit, false, false);
 
 		// Store texture id so it can be re-bound to the texture unit later.
 		textureUnits[texunit].texture = gltex;
@@ -594,7 +596,7 @@ void Shader::applyTexture(const UniformInfo *info, int i, love::graphics::Textur
 
 void Shader::applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer *buffer, UniformType basetype, bool isdefault)
 {
-	bool shaderactive = current == this;
+	bool shaderactive = contextState().current == this;
 
 	if (basetype == UNIFORM_TEXELBUFFER)
 	{
@@ -602,7 +604,7 @@ void Shader::applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer
 		int texunit = info->ints[i];
 
 		if (shaderactive)
-			gl.bindBufferTextureToUnit(gltex, texunit, false, false);
+			getGL().bindBufferTextureToUnit(gltex, texunit, false, false);
 
 		// Store texture id so it can be re-bound to the texture unit later.
 		textureUnits[texunit].texture = gltex;
@@ -613,7 +615,7 @@ void Shader::applyBuffer(const UniformInfo *info, int i, love::graphics::Buffer
 		int bindingindex = info->ints[i];
 
 		if (shaderactive)
-			gl.bindIndexedBuffer(glbuffer, BUFFERUSAGE_SHADER_STORAGE, bindingindex);
+			getGL().bindIndexedBuffer(glbuffer, BUFFERUSAGE_SHADER_STORAGE, bindingindex);
 
 		auto activeindex = storageBufferBindingIndexToActiveBinding[bindingindex];
 
@@ -644,7 +646,7 @@ int Shader::getVertexAttributeIndex(const std::string &name)
 
 void Shader::updateBuiltinUniforms(love::graphics::Graphics *gfx, int viewportW, int viewportH)
 {
-	if (current != this)
+	if (contextState().current != this)
 		return;
 
 	bool rt = gfx->isRenderTargetActive();
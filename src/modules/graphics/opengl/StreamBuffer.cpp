@@ -127,7 +127,7 @@ class StreamBufferSubDataOrphan final : public love::graphics::StreamBuffer, pub
 		{
 			orphan = false;
 			frameGPUReadOffset = 0;
-			gl.bindBuffer(mode, vbo);
+			getGL().bindBuffer(mode, vbo);
 			glBufferData(glMode, bufferSize, nullptr, GL_STREAM_DRAW);
 		}
 
@@ -136,7 +136,7 @@ class StreamBufferSubDataOrphan final : public love::graphics::StreamBuffer, pub
 
 	size_t unmap(size_t usedsize) override
 	{
-		gl.bindBuffer(mode, vbo);
+		getGL().bindBuffer(mode, vbo);
 		glBufferSubData(glMode, frameGPUReadOffset, usedsize, data);
 		return frameGPUReadOffset;
 	}
@@ -161,7 +161,7 @@ class StreamBufferSubDataOrphan final : public love::graphics::StreamBuffer, pub
 			return true;
 
 		glGenBuffers(1, &vbo);
-		gl.bindBuffer(mode, vbo);
+		getGL().bindBuffer(mode, vbo);
 		glBufferData(glMode, bufferSize, nullptr, GL_STREAM_DRAW);
 
 		frameGPUReadOffset = 0;
@@ -175,7 +175,7 @@ class StreamBufferSubDataOrphan final : public love::graphics::StreamBuffer, pub
 		if (vbo == 0)
 			return;
 
-		gl.deleteBuffer(vbo);
+		getGL().deleteBuffer(vbo);
 		vbo = 0;
 	}
 
@@ -250,7 +250,7 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		gl.bindBuffer(mode, vbo);
+		getGL().bindBuffer(mode, vbo);
 
 		// Make sure this frame's section of the buffer is done being used.
 		syncs[frameIndex].cpuWait();
@@ -268,7 +268,7 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 
 	size_t unmap(size_t usedsize) override
 	{
-		gl.bindBuffer(mode, vbo);
+		getGL().bindBuffer(mode, vbo);
 		glFlushMappedBufferRange(glMode, 0, usedsize);
 		glUnmapBuffer(glMode);
 
@@ -283,7 +283,7 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 			return true;
 
 		glGenBuffers(1, &vbo);
-		gl.bindBuffer(mode, vbo);
+		getGL().bindBuffer(mode, vbo);
 		glBufferData(glMode, bufferSize * BUFFER_FRAMES, nullptr, GL_STREAM_DRAW);
 
 		frameGPUReadOffset = 0;
@@ -296,7 +296,7 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 	{
 		if (vbo != 0)
 		{
-			gl.deleteBuffer(vbo);
+			getGL().deleteBuffer(vbo);
 			vbo = 0;
 		}
 
@@ -349,7 +349,7 @@ class StreamBufferPersistentMapSync final : public StreamBufferSync, public Vola
 
 		if (!coherent)
 		{
-			gl.bindBuffer(mode, vbo);
+			getGL().bindBuffer(mode, vbo);
 			glFlushMappedBufferRange(glMode, offset, usedsize);
 		}
 
@@ -364,7 +364,7 @@ class StreamBufferPersistentMapSync final : public StreamBufferSync, public Vola
 			return true;
 
 		glGenBuffers(1, &vbo);
-		gl.bindBuffer(mode, vbo);
+		getGL().bindBuffer(mode, vbo);
 
 		GLbitfield storageflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
 		GLbitfield mapflags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
@@ -385,9 +385,9 @@ class StreamBufferPersistentMapSync final : public StreamBufferSync, public Vola
 	{
 		if (vbo != 0)
 		{
-			gl.bindBuffer(mode, vbo);
+			getGL().bindBuffer(mode, vbo);
 			glUnmapBuffer(glMode);
-			gl.deleteBuffer(vbo);
+			getGL().deleteBuffer(vbo);
 			vbo = 0;
 		}
 
@@ -469,7 +469,7 @@ class StreamBufferPinnedMemory final : public StreamBufferSync, public Volatile
 
 		if (glGetError() != GL_NO_ERROR)
 		{
-			gl.deleteBuffer(vbo);
+			getGL().deleteBuffer(vbo);
 			vbo = 0;
 			return false;
 		}
@@ -488,8 +488,8 @@ class StreamBufferPinnedMemory final : public StreamBufferSync, public Volatile
 			// memory. glFlush+sync.cpuWait doesn't seem to be enough.
 			glFinish();
 
-			gl.bindBuffer(mode, vbo);
-			gl.deleteBuffer(vbo);
+			getGL().bindBuffer(mode, vbo);
+			getGL().deleteBuffer(vbo);
 			vbo = 0;
 		}
 
@@ -508,13 +508,13 @@ class StreamBufferPinnedMemory final : public StreamBufferSync, public Volatile
 
 love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size)
 {
-	if (gl.isCoreProfile())
+	if (getGL().isCoreProfile())
 	{
-		if (!gl.bugs.clientWaitSyncStalls)
+		if (!getGL().bugs.clientWaitSyncStalls)
 		{
 			// AMD's pinned memory seems to be faster than persistent mapping,
 			// on AMD GPUs.
-			if (GLAD_AMD_pinned_memory && gl.getVendor() == OpenGL::VENDOR_AMD)
+			if (GLAD_AMD_pinned_memory && getGL().getVendor() == OpenGL::VENDOR_AMD)
 			{
 				try
 				{
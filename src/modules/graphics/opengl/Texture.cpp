@@ -38,10 +38,10 @@ namespace opengl
 static GLenum createFBO(GLuint &framebuffer, TextureType texType, PixelFormat format, GLuint texture, int mips, int layers, bool clear)
 {
 	// get currently bound fbo to reset to it later
-	GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
+	GLuint current_fbo = getGL().getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
 
 	glGenFramebuffers(1, &framebuffer);
-	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, framebuffer);
+	getGL().bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, framebuffer);
 
 	if (texture != 0)
 	{
@@ -70,7 +70,7 @@ static GLenum createFBO(GLuint &framebuffer, TextureType texType, PixelFormat fo
 						if (attachment == GL_NONE)
 							continue;
 
-						gl.framebufferTexture(attachment, texType, texture, mip, layer, face);
+						getGL().framebufferTexture(attachment, texType, texture, mip, layer, face);
 					}
 
 					if (clear && isPixelFormatInteger(format))
@@ -96,7 +96,7 @@ static GLenum createFBO(GLuint &framebuffer, TextureType texType, PixelFormat fo
 
 						if (ds)
 						{
-							gl.clearDepth(1.0);
+							getGL().clearDepth(1.0);
 							glClearStencil(0);
 						}
 						else
@@ -113,7 +113,7 @@ static GLenum createFBO(GLuint &framebuffer, TextureType texType, PixelFormat fo
 
 	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 
-	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
+	getGL().bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
 
 	return status;
 }
@@ -122,12 +122,12 @@ static GLenum newRenderbuffer(int width, int height, int &samples, PixelFormat p
 {
 	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(pixelformat);
 
-	GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
+	GLuint current_fbo = getGL().getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
 
 	// Temporary FBO used to clear the renderbuffer.
 	GLuint fbo = 0;
 	glGenFramebuffers(1, &fbo);
-	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, fbo);
+	getGL().bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, fbo);
 
 	if (isPixelFormatDepthStencil(pixelformat))
 	{
@@ -185,7 +185,7 @@ static GLenum newRenderbuffer(int width, int height, int &samples, PixelFormat p
 
 			if (ds)
 			{
-				gl.clearDepth(1.0);
+				getGL().clearDepth(1.0);
 				glClearStencil(0);
 			}
 			else
@@ -204,8 +204,8 @@ static GLenum newRenderbuffer(int width, int height, int &samples, PixelFormat p
 		samples = 1;
 	}
 
-	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
-	gl.deleteFramebuffer(fbo);
+	getGL().bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
+	getGL().deleteFramebuffer(fbo);
 
 	return status;
 }
@@ -270,7 +270,7 @@ void Texture::createTexture()
 
 	if (parentView.texture != this)
 	{
-		OpenGL::TextureFormat fmt = gl.convertPixelFormat(format);
+		OpenGL::TextureFormat fmt = getGL().convertPixelFormat(format);
 		Texture *basetex = (Texture *) parentView.texture;
 		int layers = texType == TEXTURE_CUBE ? 6 : getLayerCount();
 
@@ -278,12 +278,12 @@ void Texture::createTexture()
 		              parentView.startMipmap, getMipmapCount(),
 		              parentView.startLayer, layers);
 
-		gl.bindTextureToUnit(this, 0, false);
+		getGL().bindTextureToUnit(this, 0, false);
 		setSamplerState(samplerState);
 		return;
 	}
 
-	gl.bindTextureToUnit(this, 0, false);
+	getGL().bindTextureToUnit(this, 0, false);
 
 	if (renderTarget && GLAD_ANGLE_texture_usage)
 		glTexParameteri(gltype, GL_TEXTURE_USAGE_ANGLE, GL_FRAMEBUFFER_ATTACHMENT_ANGLE);
@@ -306,7 +306,7 @@ void Texture::createTexture()
 	// remember some driver issues on some old Android systems, maybe...
 	// For now, the base class enforces data on init for compressed textures.
 	if (!isCompressed())
-		gl.rawTexStorage(texType, mipcount, format, pixelWidth, pixelHeight, texType == TEXTURE_VOLUME ? depth : layers);
+		getGL().rawTexStorage(texType, mipcount, format, pixelWidth, pixelHeight, texType == TEXTURE_VOLUME ? depth : layers);
 
 	// rawTexStorage handles this for uncompressed textures.
 	if (isCompressed())
@@ -316,7 +316,7 @@ void Texture::createTexture()
 	int h = pixelHeight;
 	int d = depth;
 
-	OpenGL::TextureFormat fmt = gl.convertPixelFormat(format);
+	OpenGL::TextureFormat fmt = getGL().convertPixelFormat(format);
 
 	for (int mip = 0; mip < mipcount; mip++)
 	{
@@ -405,7 +405,7 @@ bool Texture::loadVolatile()
 
 	OpenGL::TempDebugGroup debuggroup("Texture load");
 
-	actualSamples = std::max(1, std::min(getRequestedMSAA(), gl.getMaxSamples()));
+	actualSamples = std::max(1, std::min(getRequestedMSAA(), getGL().getMaxSamples()));
 
 	while (glGetError() != GL_NO_ERROR); // Clear errors.
 
@@ -457,13 +457,13 @@ void Texture::unloadVolatile()
 	}
 
 	if (fbo != 0)
-		gl.deleteFramebuffer(fbo);
+		getGL().deleteFramebuffer(fbo);
 
 	if (renderbuffer != 0)
 		glDeleteRenderbuffers(1, &renderbuffer);
 
 	if (texture != 0)
-		gl.deleteTexture(texture);
+		getGL().deleteTexture(texture);
 
 	fbo = 0;
 	renderbuffer = 0;
@@ -476,7 +476,7 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 {
 	OpenGL::TempDebugGroup debuggroup("Texture data upload");
 
-	gl.bindTextureToUnit(this, 0, false);
+	getGL().bindTextureToUnit(this, 0, false);
 
 	OpenGL::TextureFormat fmt = OpenGL::convertPixelFormat(format);
 	GLenum gltarget = OpenGL::getGLTextureType(texType);
@@ -508,11 +508,11 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 
 void Texture::generateMipmapsInternal()
 {
-	gl.bindTextureToUnit(this, 0, false);
+	getGL().bindTextureToUnit(this, 0, false);
 
 	GLenum gltextype = OpenGL::getGLTextureType(texType);
 
-	if (gl.bugs.generateMipmapsRequiresTexture2DEnable)
+	if (getGL().bugs.generateMipmapsRequiresTexture2DEnable)
 		glEnable(gltextype);
 
 	glGenerateMipmap(gltextype);
@@ -524,11 +524,11 @@ void Texture::readbackInternal(int slice, int mipmap, const Rect &rect, int dest
 	if (!isCompressed())
 		glPixelStorei(GL_PACK_ROW_LENGTH, destwidth);
 
-	gl.bindTextureToUnit(this, 0, false);
+	getGL().bindTextureToUnit(this, 0, false);
 
-	OpenGL::TextureFormat fmt = gl.convertPixelFormat(format);
+	OpenGL::TextureFormat fmt = getGL().convertPixelFormat(format);
 
-	if (gl.isCopyTextureToBufferSupported())
+	if (getGL().isCopyTextureToBufferSupported())
 	{
 		if (isCompressed())
 			glGetCompressedTextureSubImage(texture, mipmap, rect.x, rect.y, slice, rect.w, rect.h, 1, size, dest);
@@ -537,22 +537,22 @@ void Texture::readbackInternal(int slice, int mipmap, const Rect &rect, int dest
 	}
 	else if (fbo)
 	{
-		GLuint current_fbo = gl.getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
-		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getFBO());
+		GLuint current_fbo = getGL().getFramebuffer(OpenGL::FRAMEBUFFER_ALL);
+		getGL().bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getFBO());
 
 		if (slice > 0 || mipmap > 0)
 		{
 			int layer = texType == TEXTURE_CUBE ? 0 : slice;
 			int face = texType == TEXTURE_CUBE ? slice : 0;
-			gl.framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, mipmap, layer, face);
+			getGL().framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, mipmap, layer, face);
 		}
 
 		glReadPixels(rect.x, rect.y, rect.w, rect.h, fmt.externalformat, fmt.type, dest);
 
 		if (slice > 0 || mipmap > 0)
-			gl.framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, 0, 0, 0);
+			getGL().framebufferTexture(GL_COLOR_ATTACHMENT0, texType, texture, 0, 0, 0);
 
-		gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
+		getGL().bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, current_fbo);
 	}
 
 	if (!isCompressed())
@@ -598,8 +598,8 @@ void Texture::setSamplerState(const SamplerState &s)
 {
 	samplerState = validateSamplerState(s);
 
-	gl.bindTextureToUnit(this, 0, false);
-	gl.setSamplerState(texType, samplerState);
+	getGL().bindTextureToUnit(this, 0, false);
+	getGL().setSamplerState(texType, samplerState);
 }
 
 ptrdiff_t Texture::getHandle() const
@@ -699,7 +699,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 		}
 
 		createDefaultShaders();
-		Shader::current = Shader::standardShaders[Shader::StandardShader::STANDARD_DEFAULT];
+		shaderState.current = shaderState.standardShaders[Shader::StandardShader::STANDARD_DEFAULT];
 		createQuadIndexBuffer();
 		createFanIndexBuffer();
 
@@ -2158,12 +2158,12 @@ void Graphics::createDefaultShaders()
 	{
 		auto stype = (Shader::StandardShader)i;
 
-		if (!Shader::standardShaders[i])
+		if (!shaderState.standardShaders[i])
 		{
 			std::vector<std::string> stages;
 			stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_VERTEX));
 			stages.push_back(Shader::getDefaultCode(stype, SHADERSTAGE_PIXEL));
-			Shader::standardShaders[i] = newShader(stages, {});
+			shaderState.standardShaders[i] = newShader(stages, {});
 		}
 	}
 }
@@ -2416,7 +2416,7 @@ void Graphics::prepareDraw(VertexAttributesID attributesID, const BufferBindings
 	if (!renderPassState.active)
 		startRenderPass();
 
-	auto s = dynamic_cast<Shader*>(Shader::current);
+	auto s = dynamic_cast<Shader*>(shaderState.current);
 
 	usedShadersInFrame.insert(s);
 
@@ -330,10 +330,10 @@ void Shader::attach()
 {
 	if (!isCompute)
 	{
-		if (Shader::current != this)
+		if (Shader::contextState().current != this)
 		{
 			Graphics::flushBatchedDrawsGlobal();
-			Shader::current = this;
+			Shader::contextState().current = this;
 			Vulkan::shaderSwitch();
 		}
 	}
@@ -352,7 +352,7 @@ const Shader::UniformInfo *Shader::getUniformInfo(BuiltinUniform builtin) const
 
 void Shader::updateUniform(const UniformInfo *info, int count)
 {
-	if (current == this)
+	if (contextState().current == this)
 		Graphics::flushBatchedDrawsGlobal();
 
 	count = std::min(count, info->count);
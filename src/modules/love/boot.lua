@@ -194,6 +194,7 @@ function love.init()
 			audio = true,
 			math = true,
 			physics = true,
+			plugin = true,
 			sensor = true,
 			sound = true,
 			system = true,
@@ -205,6 +206,7 @@ function love.init()
 		audio = {
 			mixwithsystem = true, -- Only relevant for Android / iOS.
 			mic = false, -- Only relevant for Android.
+			backend = "openal", -- "openal", "soft" (software mixer) or "null".
 		},
 		console = false, -- Only relevant for windows.
 		identity = false,
@@ -295,6 +297,10 @@ function love.init()
 		end
 	end
 
+	if love._setAudioBackend and c.audio and c.audio.backend then
+		love._setAudioBackend(c.audio.backend)
+	end
+
 	if love._requestRecordingPermission then
 		love._requestRecordingPermission(c.audio and c.audio.mic)
 	end
@@ -320,6 +326,7 @@ function love.init()
 		"graphics",
 		"math",
 		"physics",
+		"plugin",
 	} do
 		if c.modules[v] then
 			require("love." .. v)
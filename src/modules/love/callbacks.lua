@@ -140,6 +140,15 @@ function love.createhandlers()
 		sensorupdated = function (sensorType, x, y, z)
 			if love.sensorupdated then return love.sensorupdated(sensorType, x, y, z) end
 		end,
+		midipressed = function (note, velocity, channel, offset, time)
+			if love.midipressed then return love.midipressed(note, velocity, channel, offset, time) end
+		end,
+		midireleased = function (note, velocity, channel, offset, time)
+			if love.midireleased then return love.midireleased(note, velocity, channel, offset, time) end
+		end,
+		midicc = function (controller, value, channel, offset, time)
+			if love.midicc then return love.midicc(controller, value, channel, offset, time) end
+		end,
 	}, {
 		__index = function(self, name)
 			error("Unknown event: " .. name)
@@ -158,6 +167,20 @@ function love.run()
 	-- We don't want the first frame's dt to include time taken by love.load.
 	if love.timer then love.timer.step() end
 
+	-- When the next frame is due, if the frame rate is capped.
+	local nextframe = love.timer and love.timer.getTime() or 0
+
+	-- Target frame rate (0 = uncapped), lowered while nobody can see us.
+	local function getframerate()
+		if not love.plugin then return 0 end
+		-- Offline, love.timer.step paces us against the host's sample clock.
+		if love.plugin.isOfflineRendering() then return 0 end
+		if love.plugin.isHosted() and love.window and love.window.isOpen() and (love.window.isMinimized() or love.window.isOccluded()) then
+			return love.plugin.getBackgroundFPS()
+		end
+		return love.plugin.getTargetFPS()
+	end
+
 	-- Main loop time.
 	return function()
 		-- Process events.
@@ -173,6 +196,19 @@ function love.run()
 			end
 		end
 
+		-- The plugin's editor is closed or hidden: skip the frame entirely, but
+		-- keep handling events every so often.
+		-- Offline rendering has to keep ticking regardless.
+		if love.plugin and not love.plugin.isVisible() and not love.plugin.isOfflineRendering() then
+			love.plugin.waitUntilVisible(0.1)
+			-- Don't let the time spent hidden show up as one huge dt.
+			if love.timer then
+				love.timer.step()
+				nextframe = love.timer.getTime()
+			end
+			return
+		end
+
 		-- Update dt, as we'll be passing it to update
 		local dt = love.timer and love.timer.step() or 0
 
@@ -188,7 +224,21 @@ function love.run()
 			love.graphics.present()
 		end
 
-		if love.timer then love.timer.sleep(0.001) end
+		if love.timer then
+			local fps = getframerate()
+			local now = love.timer.getTime()
+			if fps > 0 then
+				-- Sleep off the rest of this frame's time slice. Don't try to
+				-- catch up on frames we were too slow for.
+				nextframe = math.max(nextframe + 1 / fps, now)
+				love.timer.sleep(math.max(nextframe - now, 0.001))
+			else
+				nextframe = now
+				if not (love.plugin and love.plugin.isOfflineRendering()) then
+					love.timer.sleep(0.001)
+				end
+			end
+		end
 	end
 end
 
@@ -139,6 +139,9 @@ extern "C"
 #if defined(LOVE_ENABLE_PHYSICS)
 	extern int luaopen_love_physics(lua_State*);
 #endif
+#if defined(LOVE_ENABLE_PLUGIN)
+	extern int luaopen_love_plugin(lua_State*);
+#endif
 #if defined(LOVE_ENABLE_SENSOR)
 	extern int luaopen_love_sensor(lua_State*);
 #endif
@@ -211,6 +214,9 @@ static const luaL_Reg modules[] = {
 #if defined(LOVE_ENABLE_PHYSICS)
 	{ "love.physics", luaopen_love_physics },
 #endif
+#if defined(LOVE_ENABLE_PLUGIN)
+	{ "love.plugin", luaopen_love_plugin },
+#endif
 #if defined(LOVE_ENABLE_SENSOR)
 	{ "love.sensor", luaopen_love_sensor },
 #endif
@@ -444,6 +450,14 @@ static int w__setAudioMixWithSystem(lua_State *L)
 	return 1;
 }
 
+static int w__setAudioBackend(lua_State *L)
+{
+#ifdef LOVE_ENABLE_AUDIO
+	love::audio::setBackend(luaL_checkstring(L, 1));
+#endif
+	return 0;
+}
+
 static int w__requestRecordingPermission(lua_State *L)
 {
 #ifdef LOVE_ENABLE_AUDIO
@@ -563,6 +577,8 @@ int luaopen_love(lua_State *L)
 	// module is initialized.
 	lua_pushcfunction(L, w__setAudioMixWithSystem);
 	lua_setfield(L, -2, "_setAudioMixWithSystem");
+	lua_pushcfunction(L, w__setAudioBackend);
+	lua_setfield(L, -2, "_setAudioBackend");
 	lua_pushcfunction(L, w__requestRecordingPermission);
 	lua_setfield(L, -2, "_requestRecordingPermission");
 
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Host.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace plugin
+{
+
+love::Type Host::type("PluginHost", &Object::type);
+
+Host::Host()
+	: droppedMidi(0)
+	, visible(true)
+	, quitRequested(false)
+	, targetFPS(0.0)
+	, backgroundFPS(10.0)
+	, sampleRate(44100)
+	, offline(false)
+	, tickFrames(0)
+	, clockFrames(0)
+	, tickedFrames(0)
+	, tickRunning(false)
+	, gameStalled(false)
+{
+}
+
+Host::~Host()
+{
+}
+
+void Host::setTransport(const Transport &t)
+{
+	transport.write(t);
+}
+
+const Transport &Host::getTransport()
+{
+	return transport.read();
+}
+
+bool Host::pushMidi(const MidiMessage &message)
+{
+	if (midi.push(message))
+		return true;
+
+	droppedMidi.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+bool Host::popMidi(MidiMessage &message)
+{
+	return midi.pop(message);
+}
+
+uint64 Host::getDroppedMidiCount() const
+{
+	return droppedMidi.load(std::memory_order_relaxed);
+}
+
+void Host::setVisible(bool visible)
+{
+	thread::Lock lock(visibleMutex);
+	this->visible = visible;
+	visibleCond->broadcast();
+}
+
+bool Host::isVisible() const
+{
+	return visible;
+}
+
+bool Host::waitUntilVisible(double timeout)
+{
+	thread::Lock lock(visibleMutex);
+	if (!visible && !quitRequested)
+		visibleCond->wait(visibleMutex, (int) (timeout * 1000.0));
+	return visible;
+}
+
+void Host::requestQuit()
+{
+	thread::Lock lock(visibleMutex);
+	quitRequested = true;
+	visibleCond->broadcast();
+}
+
+bool Host::takeQuitRequest()
+{
+	return quitRequested.exchange(false);
+}
+
+void Host::setTargetFPS(double fps)
+{
+	targetFPS = std::max(fps, 0.0);
+}
+
+double Host::getTargetFPS() const
+{
+	return targetFPS;
+}
+
+void Host::setBackgroundFPS(double fps)
+{
+	backgroundFPS = std::max(fps, 0.0);
+}
+
+double Host::getBackgroundFPS() const
+{
+	return backgroundFPS;
+}
+
+void Host::setSampleRate(int sampleRate)
+{
+	this->sampleRate = sampleRate;
+}
+
+int Host::getSampleRate() const
+{
+	return sampleRate;
+}
+
+void Host::setOfflineRendering(bool offline)
+{
+	thread::Lock lock(clockMutex);
+
+	if (offline == this->offline)
+		return;
+
+	this->offline = offline;
+	clockFrames = 0;
+	tickedFrames = 0;
+	tickRunning = false;
+	gameStalled = false;
+
+	clockCond->broadcast();
+}
+
+bool Host::isOfflineRendering() const
+{
+	return offline;
+}
+
+void Host::setTickFrames(int frames)
+{
+	thread::Lock lock(clockMutex);
+	tickFrames = std::max(frames, 0);
+}
+
+int Host::getTickFrames() const
+{
+	thread::Lock lock(clockMutex);
+	return tickFrames;
+}
+
+int Host::getTickLength() const
+{
+	thread::Lock lock(clockMutex);
+
+	if (tickFrames > 0)
+		return tickFrames;
+
+	// Default to the target frame rate, or 60 ticks per second.
+	double fps = targetFPS > 0.0 ? (double) targetFPS : 60.0;
+	return std::max((int) (sampleRate / fps + 0.5), 1);
+}
+
+bool Host::waitForTicks(int frames, int timeoutMS)
+{
+	thread::Lock lock(clockMutex);
+
+	clockFrames += frames;
+	clockCond->broadcast();
+
+	while (offline && tickedFrames < clockFrames)
+	{
+		if (gameStalled || !clockCond->wait(clockMutex, timeoutMS))
+		{
+			gameStalled = true;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+double Host::advanceTick()
+{
+	int frames = getTickLength();
+
+	thread::Lock lock(clockMutex);
+
+	if (!offline)
+		return -1.0;
+
+	if (tickRunning)
+	{
+		tickedFrames += frames;
+		tickRunning = false;
+		gameStalled = false;
+		clockCond->broadcast();
+	}
+
+	// Don't wait too long: the game still has to handle events if the host
+	// stops processing without leaving offline mode.
+	if (tickedFrames >= clockFrames)
+		clockCond->wait(clockMutex, 100);
+
+	if (!offline || tickedFrames >= clockFrames)
+		return 0.0;
+
+	tickRunning = true;
+	return frames / (double) sampleRate;
+}
+
+} // plugin
+} // love
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PLUGIN_HOST_H
+#define LOVE_PLUGIN_HOST_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/TripleBuffer.h"
+#include "common/SPSCQueue.h"
+#include "common/int.h"
+#include "thread/threads.h"
+
+namespace love
+{
+namespace plugin
+{
+
+/**
+ * The host's transport as of the start of one audio block.
+ **/
+struct Transport
+{
+	bool playing = false;
+	bool looping = false;
+	bool recording = false;
+
+	// Which of the optional fields below the host provided.
+	bool hasTempo = false;
+	bool hasTimeSignature = false;
+	bool hasPlayhead = false;
+
+	double bpm = 0.0;
+	double beat = 0.0;
+	double loopStart = 0.0;
+	double loopEnd = 0.0;
+	int timeSigNumerator = 4;
+	int timeSigDenominator = 4;
+
+	// Frames processed by the plugin before this block.
+	uint64 sampleTime = 0;
+	int sampleRate = 0;
+
+	// love.timer.getTime() when the block started processing.
+	double time = 0.0;
+};
+
+/**
+ * A short (1-3 byte) MIDI message received from the host.
+ **/
+struct MidiMessage
+{
+	uint8 status = 0;
+	uint8 data1 = 0;
+	uint8 data2 = 0;
+
+	// Frame within the audio block the message is timestamped at.
+	int offset = 0;
+
+	// Frames processed by the plugin before the message.
+	uint64 sampleTime = 0;
+
+	// The message's timestamp on the love.timer.getTime() clock.
+	double time = 0.0;
+};
+
+/**
+ * Everything the embedding plugin shares with the game running inside it.
+ * Owned by the plugin instance and handed to the game through its
+ * EngineContext.
+ *
+ * Members are written from the host's audio thread, which must never block,
+ * so all communication with the game thread is lock-free.
+ **/
+class Host : public Object
+{
+public:
+
+	static love::Type type;
+
+	Host();
+	virtual ~Host();
+
+	/**
+	 * [Audio thread] Publishes the transport state for the current block.
+	 **/
+	void setTransport(const Transport &transport);
+
+	/**
+	 * [Game thread] Gets the most recently published transport state. Only one
+	 * thread may call this.
+	 **/
+	const Transport &getTransport();
+
+	/**
+	 * [Audio thread] Queues an incoming MIDI message for the game. Wait-free;
+	 * the message is dropped (and counted) if the game has fallen too far
+	 * behind.
+	 **/
+	bool pushMidi(const MidiMessage &message);
+
+	/**
+	 * [Game thread] Takes the oldest queued MIDI message, if any. Only one
+	 * thread may call this.
+	 **/
+	bool popMidi(MidiMessage &message);
+
+	uint64 getDroppedMidiCount() const;
+
+	/**
+	 * [GUI thread] Sets whether the host is showing the plugin's editor.
+	 **/
+	void setVisible(bool visible);
+	bool isVisible() const;
+
+	/**
+	 * Blocks until the editor is shown or the timeout (in seconds) expires.
+	 * @return Whether the editor is visible.
+	 **/
+	bool waitUntilVisible(double timeout);
+
+	/**
+	 * [GUI thread] Asks the game to quit, as if its window was closed. Wakes
+	 * waitUntilVisible so a hidden game notices too.
+	 **/
+	void requestQuit();
+
+	/**
+	 * [Game thread] Returns whether a quit was requested since the last call.
+	 **/
+	bool takeQuitRequest();
+
+	/**
+	 * Sets the frame rate the game should be paced to while it's on screen,
+	 * or 0 to leave pacing to vsync.
+	 **/
+	void setTargetFPS(double fps);
+	double getTargetFPS() const;
+
+	/**
+	 * Sets the frame rate to fall back to while the game's window is
+	 * minimized or covered by other windows.
+	 **/
+	void setBackgroundFPS(double fps);
+	double getBackgroundFPS() const;
+
+	void setSampleRate(int sampleRate);
+	int getSampleRate() const;
+
+	/**
+	 * Offline rendering (e.g. bouncing a project) runs the audio thread as
+	 * fast as possible instead of in real time. The game is then driven in
+	 * lock-step by the host's sample clock: exactly one game tick, of
+	 * getTickLength() frames, per that many frames processed.
+	 **/
+	void setOfflineRendering(bool offline);
+	bool isOfflineRendering() const;
+
+	/**
+	 * Sets the length of one offline tick in frames, or 0 to derive it from
+	 * the target frame rate. getTickFrames returns the value set, and
+	 * getTickLength the length actually used.
+	 **/
+	void setTickFrames(int frames);
+	int getTickFrames() const;
+	int getTickLength() const;
+
+	/**
+	 * [Audio thread, offline only] Advances the sample clock and waits for
+	 * the game to tick past it. Once the game has missed a timeout, this
+	 * stops waiting until the game ticks again.
+	 * @return False if the game didn't catch up.
+	 **/
+	bool waitForTicks(int frames, int timeoutMS);
+
+	/**
+	 * [Game thread] Finishes the current tick, and waits for the sample clock
+	 * to allow the next one.
+	 * @return The next tick's duration in seconds, 0 if the host has stopped
+	 * asking for audio, or a negative value when not rendering offline.
+	 **/
+	double advanceTick();
+
+	// Enough for several frames' worth of dense controller data.
+	static const size_t MIDI_QUEUE_SIZE = 1024;
+
+private:
+
+	TripleBuffer<Transport> transport;
+
+	// Not the plugin's CplugEvent queues: those connect the audio thread with
+	// the host's main thread, while MIDI is consumed by the game's own thread,
+	// and needs its sample time and timestamp carried along.
+	SPSCQueue<MidiMessage, MIDI_QUEUE_SIZE> midi;
+	std::atomic<uint64> droppedMidi;
+
+	std::atomic<bool> visible;
+	thread::MutexRef visibleMutex;
+	thread::ConditionalRef visibleCond;
+
+	std::atomic<bool> quitRequested;
+
+	std::atomic<double> targetFPS;
+	std::atomic<double> backgroundFPS;
+
+	std::atomic<int> sampleRate;
+
+	// Offline rendering state, protected by clockMutex.
+	thread::MutexRef clockMutex;
+	thread::ConditionalRef clockCond;
+	std::atomic<bool> offline;
+	int tickFrames;
+	uint64 clockFrames;
+	uint64 tickedFrames;
+	bool tickRunning;
+	bool gameStalled;
+
+}; // Host
+
+} // plugin
+} // love
+
+#endif // LOVE_PLUGIN_HOST_H
@@ -0,0 +1,180 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Plugin.h"
+#include "common/EngineContext.h"
+#include "common/delay.h"
+#include "timer/Timer.h"
+
+// C++
+#include <cmath>
+
+#ifdef LOVE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace love
+{
+namespace plugin
+{
+
+Plugin::Plugin()
+	: Module(M_PLUGIN, "love.plugin")
+	, host(EngineContext::getCurrent()->getHost())
+	, hosted(host.get() != nullptr)
+{
+	if (!hosted)
+		host.set(new Host(), Acquire::NORETAIN);
+}
+
+Plugin::~Plugin()
+{
+}
+
+bool Plugin::isHosted() const
+{
+	return hosted;
+}
+
+Transport Plugin::getTransport()
+{
+	if (!hosted)
+		return Transport();
+
+	Transport t;
+	{
+		thread::Lock lock(readMutex);
+		t = host->getTransport();
+	}
+
+	// The snapshot is taken once per audio block, so move the playhead up to
+	// now to get smooth motion at frame rate.
+	if (t.playing && t.hasPlayhead && t.hasTempo && t.time > 0.0)
+	{
+		double elapsed = timer::Timer::getTime() - t.time;
+		if (elapsed > 0.0)
+			t.beat += elapsed * t.bpm / 60.0;
+
+		double looplength = t.loopEnd - t.loopStart;
+		if (t.looping && looplength > 0.0 && t.beat >= t.loopEnd)
+			t.beat = t.loopStart + std::fmod(t.beat - t.loopStart, looplength);
+	}
+
+	return t;
+}
+
+bool Plugin::isHostWindowMinimized() const
+{
+#ifdef LOVE_WINDOWS
+	// Hosts only tell plugins when the editor itself is closed, not when the
+	// window it's docked in gets minimized.
+	HWND parent = (HWND) EngineContext::getCurrent()->getParentWindow();
+	if (parent != nullptr)
+		return IsIconic(GetAncestor(parent, GA_ROOT)) != FALSE;
+#endif
+	return false;
+}
+
+bool Plugin::isVisible() const
+{
+	return host->isVisible() && !isHostWindowMinimized();
+}
+
+bool Plugin::waitUntilVisible(double timeout)
+{
+	// Nothing will wake us when the host window is restored, so just sleep.
+	if (host->waitUntilVisible(timeout) && isHostWindowMinimized())
+		love::sleep(timeout * 1000.0);
+
+	return isVisible();
+}
+
+void Plugin::setTargetFPS(double fps)
+{
+	host->setTargetFPS(fps);
+}
+
+double Plugin::getTargetFPS() const
+{
+	return host->getTargetFPS();
+}
+
+void Plugin::setBackgroundFPS(double fps)
+{
+	host->setBackgroundFPS(fps);
+}
+
+double Plugin::getBackgroundFPS() const
+{
+	return host->getBackgroundFPS();
+}
+
+bool Plugin::isOfflineRendering() const
+{
+	return host->isOfflineRendering();
+}
+
+void Plugin::setTickFrames(int frames)
+{
+	host->setTickFrames(frames);
+}
+
+int Plugin::getTickFrames() const
+{
+	return host->getTickFrames();
+}
+
+int Plugin::getLatency() const
+{
+	audio::LoopbackOutput *output = EngineContext::getCurrent()->getLoopbackOutput();
+	return output != nullptr ? output->getLatency() : 0;
+}
+
+int Plugin::getSampleRate() const
+{
+	return host->getSampleRate();
+}
+
+uint64 Plugin::getDroppedMidiCount() const
+{
+	return host->getDroppedMidiCount();
+}
+
+audio::LoopbackOutput::Stats Plugin::getBufferStats() const
+{
+	audio::LoopbackOutput *output = EngineContext::getCurrent()->getLoopbackOutput();
+	if (output != nullptr)
+		return output->getStats();
+
+	audio::LoopbackOutput::Stats stats = {};
+	return stats;
+}
+
+void Plugin::resetBufferStats()
+{
+	audio::LoopbackOutput *output = EngineContext::getCurrent()->getLoopbackOutput();
+	if (output != nullptr)
+		output->resetStats();
+}
+
+} // plugin
+} // love
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PLUGIN_PLUGIN_H
+#define LOVE_PLUGIN_PLUGIN_H
+
+// LOVE
+#include "common/Module.h"
+#include "thread/threads.h"
+#include "audio/LoopbackOutput.h"
+#include "Host.h"
+
+namespace love
+{
+namespace plugin
+{
+
+/**
+ * Gives the game access to the plugin host it is running inside of, if any.
+ * When LOVE isn't embedded in a plugin every query returns a sensible
+ * stand-alone default.
+ **/
+class Plugin : public Module
+{
+public:
+
+	Plugin();
+	virtual ~Plugin();
+
+	/**
+	 * Whether we're running inside a plugin host.
+	 **/
+	bool isHosted() const;
+
+	/**
+	 * Gets the host transport, with the beat position extrapolated from the
+	 * start of the last audio block to the current time.
+	 **/
+	Transport getTransport();
+
+	/**
+	 * Whether the game is currently on screen in the host: the host shows the
+	 * plugin's editor, and the window containing it isn't minimized.
+	 **/
+	bool isVisible() const;
+
+	/**
+	 * Blocks until the game is visible or the timeout (in seconds) expires.
+	 * @return Whether the game is visible.
+	 **/
+	bool waitUntilVisible(double timeout);
+
+	void setTargetFPS(double fps);
+	double getTargetFPS() const;
+
+	void setBackgroundFPS(double fps);
+	double getBackgroundFPS() const;
+
+	/**
+	 * Whether the host is rendering offline, in which case love.timer follows
+	 * the host's sample clock in ticks of a fixed number of frames.
+	 **/
+	bool isOfflineRendering() const;
+
+	/**
+	 * Sets the length of one game tick while rendering offline, in frames, or
+	 * 0 to derive it from the target frame rate. getTickFrames returns the
+	 * value set; love.timer.getDelta reports the length in effect.
+	 **/
+	void setTickFrames(int frames);
+	int getTickFrames() const;
+
+	/**
+	 * Gets the latency game audio has in the host, in frames. This is the
+	 * depth of the buffer between love.audio and the host's audio thread, or
+	 * 0 when the soft backend renders on the host's audio thread directly.
+	 **/
+	int getLatency() const;
+
+	/**
+	 * Gets the host's sample rate.
+	 **/
+	int getSampleRate() const;
+
+	/**
+	 * Gets the number of MIDI messages dropped because the game fell too far
+	 * behind the host to take them.
+	 **/
+	uint64 getDroppedMidiCount() const;
+
+	/**
+	 * Gets the number of underruns and overruns of the buffer between
+	 * love.audio and the host, and the number of frames involved.
+	 **/
+	audio::LoopbackOutput::Stats getBufferStats() const;
+	void resetBufferStats();
+
+private:
+
+	bool isHostWindowMinimized() const;
+
+	// Stand-alone, this is a private Host so settings still round-trip.
+	StrongRef<Host> host;
+	bool hosted;
+
+	// Host::getTransport only supports one reader, but love.plugin can be
+	// used from any love.thread.
+	love::thread::MutexRef readMutex;
+
+}; // Plugin
+
+} // plugin
+} // love
+
+#endif // LOVE_PLUGIN_PLUGIN_H
@@ -0,0 +1,242 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_Plugin.h"
+
+namespace love
+{
+namespace plugin
+{
+
+#define instance() (Module::getInstance<Plugin>(Module::M_PLUGIN))
+
+int w_isHosted(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isHosted());
+	return 1;
+}
+
+int w_getTransport(lua_State *L)
+{
+	Transport t = instance()->getTransport();
+
+	lua_createtable(L, 0, 12);
+
+	luax_pushboolean(L, t.playing);
+	lua_setfield(L, -2, "playing");
+
+	luax_pushboolean(L, t.looping);
+	lua_setfield(L, -2, "looping");
+
+	luax_pushboolean(L, t.recording);
+	lua_setfield(L, -2, "recording");
+
+	// Fields the host didn't provide are left nil.
+	if (t.hasTempo)
+	{
+		lua_pushnumber(L, t.bpm);
+		lua_setfield(L, -2, "bpm");
+	}
+
+	if (t.hasPlayhead)
+	{
+		lua_pushnumber(L, t.beat);
+		lua_setfield(L, -2, "beat");
+	}
+
+	if (t.looping)
+	{
+		lua_pushnumber(L, t.loopStart);
+		lua_setfield(L, -2, "loopstart");
+
+		lua_pushnumber(L, t.loopEnd);
+		lua_setfield(L, -2, "loopend");
+	}
+
+	if (t.hasTimeSignature)
+	{
+		lua_pushinteger(L, t.timeSigNumerator);
+		lua_setfield(L, -2, "beatsperbar");
+
+		lua_pushinteger(L, t.timeSigDenominator);
+		lua_setfield(L, -2, "beatunit");
+	}
+
+	lua_pushnumber(L, (lua_Number) t.sampleTime);
+	lua_setfield(L, -2, "sampletime");
+
+	lua_pushinteger(L, t.sampleRate);
+	lua_setfield(L, -2, "samplerate");
+
+	lua_pushnumber(L, t.time);
+	lua_setfield(L, -2, "time");
+
+	return 1;
+}
+
+int w_isVisible(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isVisible());
+	return 1;
+}
+
+int w_waitUntilVisible(lua_State *L)
+{
+	double timeout = luaL_checknumber(L, 1);
+	luax_pushboolean(L, instance()->waitUntilVisible(timeout));
+	return 1;
+}
+
+int w_setTargetFPS(lua_State *L)
+{
+	instance()->setTargetFPS(luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getTargetFPS(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getTargetFPS());
+	return 1;
+}
+
+int w_setBackgroundFPS(lua_State *L)
+{
+	instance()->setBackgroundFPS(luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getBackgroundFPS(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getBackgroundFPS());
+	return 1;
+}
+
+int w_isOfflineRendering(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isOfflineRendering());
+	return 1;
+}
+
+int w_setTickFrames(lua_State *L)
+{
+	instance()->setTickFrames((int) luaL_checkinteger(L, 1));
+	return 0;
+}
+
+int w_getTickFrames(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getTickFrames());
+	return 1;
+}
+
+int w_getLatency(lua_State *L)
+{
+	int frames = instance()->getLatency();
+	int sampleRate = instance()->getSampleRate();
+
+	lua_pushinteger(L, frames);
+	lua_pushnumber(L, sampleRate > 0 ? (double) frames / sampleRate : 0.0);
+	return 2;
+}
+
+int w_getSampleRate(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getSampleRate());
+	return 1;
+}
+
+int w_getDroppedMidiCount(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getDroppedMidiCount());
+	return 1;
+}
+
+int w_getBufferStats(lua_State *L)
+{
+	audio::LoopbackOutput::Stats stats = instance()->getBufferStats();
+
+	lua_createtable(L, 0, 4);
+
+	lua_pushnumber(L, (lua_Number) stats.underruns);
+	lua_setfield(L, -2, "underruns");
+
+	lua_pushnumber(L, (lua_Number) stats.underrunFrames);
+	lua_setfield(L, -2, "underrunframes");
+
+	lua_pushnumber(L, (lua_Number) stats.overruns);
+	lua_setfield(L, -2, "overruns");
+
+	lua_pushnumber(L, (lua_Number) stats.overrunFrames);
+	lua_setfield(L, -2, "overrunframes");
+
+	return 1;
+}
+
+int w_resetBufferStats(lua_State * /*L*/)
+{
+	instance()->resetBufferStats();
+	return 0;
+}
+
+// List of functions to wrap.
+static const luaL_Reg functions[] =
+{
+	{ "isHosted", w_isHosted },
+	{ "getTransport", w_getTransport },
+	{ "isVisible", w_isVisible },
+	{ "waitUntilVisible", w_waitUntilVisible },
+	{ "setTargetFPS", w_setTargetFPS },
+	{ "getTargetFPS", w_getTargetFPS },
+	{ "setBackgroundFPS", w_setBackgroundFPS },
+	{ "getBackgroundFPS", w_getBackgroundFPS },
+	{ "isOfflineRendering", w_isOfflineRendering },
+	{ "setTickFrames", w_setTickFrames },
+	{ "getTickFrames", w_getTickFrames },
+	{ "getLatency", w_getLatency },
+	{ "getSampleRate", w_getSampleRate },
+	{ "getBufferStats", w_getBufferStats },
+	{ "getDroppedMidiCount", w_getDroppedMidiCount },
+	{ "resetBufferStats", w_resetBufferStats },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_love_plugin(lua_State *L)
+{
+	Plugin *instance = instance();
+	if (instance == nullptr)
+	{
+		luax_catchexcept(L, [&](){ instance = new love::plugin::Plugin(); });
+	}
+	else
+		instance->retain();
+
+	WrappedModule w;
+	w.module = instance;
+	w.name = "plugin";
+	w.type = &Module::type;
+	w.functions = functions;
+	w.types = 0;
+
+	return luax_register_module(L, w);
+}
+
+} // plugin
+} // love
@@ -35,8 +35,10 @@ Decoder::Decoder(Stream *stream, int bufferSize)
 	, sampleRate(DEFAULT_SAMPLE_RATE)
 	, buffer(0)
 	, eof(false)
+	, floatOutput(false)
 {
-	if (!stream->isReadable() || !stream->isSeekable())
+	// Decoders which wrap another Decoder have no Stream of their own.
+	if (stream != nullptr && (!stream->isReadable() || !stream->isSeekable()))
 		throw love::Exception("Decoder input stream must be readable and seekable.");
 
 	try
@@ -75,6 +77,17 @@ bool Decoder::isFinished()
 	return eof;
 }
 
+bool Decoder::setFloatOutput(bool enable)
+{
+	floatOutput = false;
+	return !enable;
+}
+
+bool Decoder::isFloatOutput() const
+{
+	return floatOutput;
+}
+
 STRINGMAP_CLASS_BEGIN(Decoder, Decoder::StreamSource, Decoder::STREAM_MAX_ENUM, streamSource)
 {
 	{ "memory", Decoder::STREAM_MEMORY },
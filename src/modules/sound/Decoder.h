@@ -134,11 +134,22 @@ class Decoder : public Object
 	virtual int getChannelCount() const = 0;
 
 	/**
-	 * Gets the number of bits per sample. Supported values are 8 or 16.
-	 * @return Either 8, 16, or 0 if unsupported.
+	 * Gets the number of bits per sample. Supported values are 8 or 16, or
+	 * 32 for float samples.
+	 * @return Either 8, 16, 32, or 0 if unsupported.
 	 **/
 	virtual int getBitDepth() const = 0;
 
+	/**
+	 * Makes decode() write 32-bit float samples instead of integer PCM.
+	 * Only decoders which produce floats natively support this, so nothing
+	 * downstream has to convert the samples again.
+	 * @param enable Whether to decode float samples.
+	 * @return True if the output format is now the requested one.
+	 **/
+	virtual bool setFloatOutput(bool enable);
+	bool isFloatOutput() const;
+
 	/**
 	 * Gets the sample rate for the Decoder, that is, samples per second.
 	 * @return The sample rate, eg. 44100.
@@ -155,7 +166,7 @@ class Decoder : public Object
 
 protected:
 
-	// A readable stream containing the encoded data.
+	// A readable stream containing the encoded data. May be null.
 	StrongRef<Stream> stream;
 
 	// When the decoder decodes data incrementally, it writes
@@ -171,6 +182,9 @@ class Decoder : public Object
 	// Set this to true when eof has been reached.
 	bool eof;
 
+	// Whether decode() writes 32-bit float samples.
+	bool floatOutput;
+
 }; // Decoder
 
 } // sound
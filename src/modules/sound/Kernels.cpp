@@ -0,0 +1,297 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Kernels.h"
+#include "common/int.h"
+
+// C++
+#include <cstring>
+#include <algorithm>
+
+#if defined(LOVE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace love
+{
+namespace sound
+{
+namespace kernels
+{
+
+// Power of two scales, so converting to float and back is exact. Full
+// scale positive samples come out just under 1.0, which differs from
+// SoundData::getSample by less than one step.
+static const float INT16_SCALE = 1.0f / 32768.0f;
+static const float UINT8_SCALE = 1.0f / 128.0f;
+
+static inline float clampSample(float x)
+{
+	return std::min(std::max(x, -1.0f), 1.0f);
+}
+
+void toFloat(float *dst, const void *src, size_t count, int bitDepth)
+{
+	size_t i = 0;
+
+	if (bitDepth == 32)
+		memcpy(dst, src, count * sizeof(float));
+	else if (bitDepth == 16)
+	{
+		const int16 *s = (const int16 *) src;
+
+#if defined(LOVE_SIMD_SSE2)
+		const __m128 scale = _mm_set1_ps(INT16_SCALE);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i x = _mm_loadu_si128((const __m128i *) (s + i));
+			// Sign-extend by placing each value in the high half of a 32 bit lane.
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+			_mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+#elif defined(LOVE_SIMD_NEON)
+		for (; i + 8 <= count; i += 8)
+		{
+			int16x8_t x = vld1q_s16(s + i);
+			vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), INT16_SCALE));
+			vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), INT16_SCALE));
+		}
+#endif
+
+		for (; i < count; i++)
+			dst[i] = s[i] * INT16_SCALE;
+	}
+	else
+	{
+		const uint8 *s = (const uint8 *) src;
+
+#if defined(LOVE_SIMD_SSE2)
+		const __m128 scale = _mm_set1_ps(UINT8_SCALE);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bias = _mm_set1_epi16(128);
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i x = _mm_loadu_si128((const __m128i *) (s + i));
+			__m128i w[2] = {
+				_mm_sub_epi16(_mm_unpacklo_epi8(x, zero), bias),
+				_mm_sub_epi16(_mm_unpackhi_epi8(x, zero), bias),
+			};
+
+			for (int j = 0; j < 2; j++)
+			{
+				__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(w[j], w[j]), 16);
+				__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(w[j], w[j]), 16);
+				_mm_storeu_ps(dst + i + j * 8 + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+				_mm_storeu_ps(dst + i + j * 8 + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+			}
+		}
+#elif defined(LOVE_SIMD_NEON)
+		for (; i + 8 <= count; i += 8)
+		{
+			// The wrapped unsigned difference is the signed value.
+			int16x8_t w = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(s + i), vdup_n_u8(128)));
+			vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(w))), UINT8_SCALE));
+			vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(w))), UINT8_SCALE));
+		}
+#endif
+
+		for (; i < count; i++)
+			dst[i] = ((int) s[i] - 128) * UINT8_SCALE;
+	}
+}
+
+void fromFloat(void *dst, const float *src, size_t count, int bitDepth)
+{
+	size_t i = 0;
+
+	// Integer samples are rounded to nearest (halves away from zero) rather
+	// than truncated, and 1.0 saturates to the largest positive sample.
+	if (bitDepth == 32)
+		memcpy(dst, src, count * sizeof(float));
+	else if (bitDepth == 16)
+	{
+		int16 *d = (int16 *) dst;
+
+#if defined(LOVE_SIMD_SSE2)
+		const __m128 lo = _mm_set1_ps(-1.0f);
+		const __m128 hi = _mm_set1_ps(1.0f);
+		const __m128 scale = _mm_set1_ps(32768.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 0), lo), hi), scale);
+			__m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lo), hi), scale);
+			a = _mm_add_ps(a, _mm_or_ps(_mm_and_ps(a, sign), half));
+			b = _mm_add_ps(b, _mm_or_ps(_mm_and_ps(b, sign), half));
+			__m128i p = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+			_mm_storeu_si128((__m128i *) (d + i), p);
+		}
+#elif defined(LOVE_SIMD_NEON)
+		const float32x4_t lo = vdupq_n_f32(-1.0f);
+		const float32x4_t hi = vdupq_n_f32(1.0f);
+		const float32x4_t zero = vdupq_n_f32(0.0f);
+		const float32x4_t posHalf = vdupq_n_f32(0.5f);
+		const float32x4_t negHalf = vdupq_n_f32(-0.5f);
+		for (; i + 8 <= count; i += 8)
+		{
+			float32x4_t a = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i + 0), lo), hi), 32768.0f);
+			float32x4_t b = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lo), hi), 32768.0f);
+			a = vaddq_f32(a, vbslq_f32(vcltq_f32(a, zero), negHalf, posHalf));
+			b = vaddq_f32(b, vbslq_f32(vcltq_f32(b, zero), negHalf, posHalf));
+			vst1q_s16(d + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			float v = clampSample(src[i]) * 32768.0f;
+			d[i] = (int16) std::min(v + (v < 0.0f ? -0.5f : 0.5f), 32767.0f);
+		}
+	}
+	else
+	{
+		uint8 *d = (uint8 *) dst;
+
+#if defined(LOVE_SIMD_SSE2)
+		const __m128 lo = _mm_set1_ps(-1.0f);
+		const __m128 hi = _mm_set1_ps(1.0f);
+		const __m128 scale = _mm_set1_ps(128.0f);
+		const __m128 bias = _mm_set1_ps(128.5f);
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i v[4];
+			for (int j = 0; j < 4; j++)
+			{
+				__m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + j * 4), lo), hi);
+				v[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, scale), bias));
+			}
+
+			__m128i p = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+			_mm_storeu_si128((__m128i *) (d + i), p);
+		}
+#elif defined(LOVE_SIMD_NEON)
+		const float32x4_t lo = vdupq_n_f32(-1.0f);
+		const float32x4_t hi = vdupq_n_f32(1.0f);
+		const float32x4_t bias = vdupq_n_f32(128.5f);
+		for (; i + 8 <= count; i += 8)
+		{
+			float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 0), lo), hi);
+			float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), lo), hi);
+			uint32x4_t ua = vcvtq_u32_f32(vmlaq_n_f32(bias, a, 128.0f));
+			uint32x4_t ub = vcvtq_u32_f32(vmlaq_n_f32(bias, b, 128.0f));
+			vst1_u8(d + i, vqmovn_u16(vcombine_u16(vqmovn_u32(ua), vqmovn_u32(ub))));
+		}
+#endif
+
+		for (; i < count; i++)
+			d[i] = (uint8) std::min(clampSample(src[i]) * 128.0f + 128.5f, 255.0f);
+	}
+}
+
+void mixGain(float *dst, const float *src, size_t count, float gain)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	__m128 g = _mm_set1_ps(gain);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 d = _mm_loadu_ps(dst + i);
+		__m128 s = _mm_loadu_ps(src + i);
+		_mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+	}
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 4 <= count; i += 4)
+		vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+#endif
+
+	for (; i < count; i++)
+		dst[i] += src[i] * gain;
+}
+
+void applyGain(float *dst, size_t count, float gain)
+{
+	size_t i = 0;
+
+#if defined(LOVE_SIMD_SSE2)
+	__m128 g = _mm_set1_ps(gain);
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), g));
+#elif defined(LOVE_SIMD_NEON)
+	for (; i + 4 <= count; i += 4)
+		vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(dst + i), gain));
+#endif
+
+	for (; i < count; i++)
+		dst[i] *= gain;
+}
+
+float dot(const float *a, const float *b, size_t count)
+{
+	size_t i = 0;
+	float sum = 0.0f;
+
+#if defined(LOVE_SIMD_SSE2)
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	for (; i + 8 <= count; i += 8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i + 0), _mm_loadu_ps(b + i + 0)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+	}
+	for (; i + 4 <= count; i += 4)
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+	__m128 acc = _mm_add_ps(acc0, acc1);
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+	sum = _mm_cvtss_f32(acc);
+#elif defined(LOVE_SIMD_NEON)
+	float32x4_t acc0 = vdupq_n_f32(0.0f);
+	float32x4_t acc1 = vdupq_n_f32(0.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		acc0 = vmlaq_f32(acc0, vld1q_f32(a + i + 0), vld1q_f32(b + i + 0));
+		acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+	}
+	for (; i + 4 <= count; i += 4)
+		acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+
+	float32x4_t acc = vaddq_f32(acc0, acc1);
+	float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+
+	for (; i < count; i++)
+		sum += a[i] * b[i];
+
+	return sum;
+}
+
+} // kernels
+} // sound
+} // love
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_KERNELS_H
+#define LOVE_SOUND_KERNELS_H
+
+// LOVE
+#include "common/config.h"
+
+// C
+#include <stddef.h>
+
+namespace love
+{
+namespace sound
+{
+namespace kernels
+{
+
+/**
+ * Converts unsigned 8, signed 16 or 32 bit samples to floats in [-1, 1),
+ * dividing by 128 or 32768. 32 bit samples are already floats, and are
+ * copied as is. Shared by SoundData and the software audio backend.
+ **/
+void toFloat(float *dst, const void *src, size_t count, int bitDepth);
+
+/**
+ * Converts floats to 8, 16 or 32 bit samples, the inverse of toFloat.
+ * Integer samples are clamped to [-1, 1] first.
+ **/
+void fromFloat(void *dst, const float *src, size_t count, int bitDepth);
+
+/**
+ * dst[i] += src[i] * gain
+ **/
+void mixGain(float *dst, const float *src, size_t count, float gain);
+
+/**
+ * dst[i] *= gain
+ **/
+void applyGain(float *dst, size_t count, float gain);
+
+/**
+ * Sum of a[i] * b[i].
+ **/
+float dot(const float *a, const float *b, size_t count);
+
+} // kernels
+} // sound
+} // love
+
+#endif // LOVE_SOUND_KERNELS_H
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ResampledDecoder.h"
+#include "Kernels.h"
+
+#include "common/Exception.h"
+
+namespace love
+{
+namespace sound
+{
+
+ResampledDecoder::ResampledDecoder(Decoder *source, int sampleRate)
+	: Decoder(nullptr, source->getSize())
+	, source(source)
+	, resampler(source->getSampleRate(), sampleRate, source->getChannelCount())
+	, sourceBitDepth(source->getBitDepth())
+	, bitDepth(source->getBitDepth())
+	, channels(source->getChannelCount())
+{
+	this->sampleRate = sampleRate;
+
+	if (bitDepth != 8 && bitDepth != 16)
+		bitDepth = DEFAULT_BIT_DEPTH;
+
+	floatOutput = source->isFloatOutput();
+
+	// Filtering happens on floats anyway, so skip the source's conversion
+	// to integers when it can.
+	if (source->setFloatOutput(true))
+		sourceBitDepth = 32;
+
+	if (sourceBitDepth != 8 && sourceBitDepth != 16 && sourceBitDepth != 32)
+		throw love::Exception("Invalid bit depth: %d", sourceBitDepth);
+}
+
+ResampledDecoder::~ResampledDecoder()
+{
+}
+
+Decoder *ResampledDecoder::clone()
+{
+	StrongRef<Decoder> s(source->clone(), Acquire::NORETAIN);
+	ResampledDecoder *d = new ResampledDecoder(s, sampleRate);
+	d->bitDepth = bitDepth;
+	d->floatOutput = floatOutput;
+	return d;
+}
+
+int ResampledDecoder::decode()
+{
+	int sampleSize = getBitDepth() / 8;
+	size_t frames = (size_t) bufferSize / (channels * sampleSize);
+	size_t decoded = 0;
+
+	output.resize(frames * channels);
+
+	while (decoded < frames)
+	{
+		decoded += resampler.read(output.data() + decoded * channels, frames - decoded);
+		if (decoded == frames)
+			break;
+
+		if (resampler.isFlushed())
+		{
+			eof = true;
+			break;
+		}
+
+		int bytes = source->decode();
+		if (bytes > 0)
+		{
+			size_t count = (size_t) bytes / (sourceBitDepth / 8);
+			count -= count % channels;
+
+			input.resize(count);
+			kernels::toFloat(input.data(), source->getBuffer(), count, sourceBitDepth);
+			resampler.write(input.data(), count / channels);
+		}
+		else
+			resampler.flush();
+	}
+
+	kernels::fromFloat(buffer, output.data(), decoded * channels, getBitDepth());
+	return (int) (decoded * channels * sampleSize);
+}
+
+bool ResampledDecoder::seek(double s)
+{
+	if (!source->seek(s))
+		return false;
+
+	resampler.reset();
+	eof = false;
+	return true;
+}
+
+bool ResampledDecoder::rewind()
+{
+	if (!source->rewind())
+		return false;
+
+	resampler.reset();
+	eof = false;
+	return true;
+}
+
+bool ResampledDecoder::isSeekable()
+{
+	return source->isSeekable();
+}
+
+int ResampledDecoder::getChannelCount() const
+{
+	return channels;
+}
+
+int ResampledDecoder::getBitDepth() const
+{
+	return floatOutput ? 32 : bitDepth;
+}
+
+bool ResampledDecoder::setFloatOutput(bool enable)
+{
+	floatOutput = enable;
+	return true;
+}
+
+double ResampledDecoder::getDuration()
+{
+	return source->getDuration();
+}
+
+Decoder *ResampledDecoder::getSource() const
+{
+	return source.get();
+}
+
+} // sound
+} // love
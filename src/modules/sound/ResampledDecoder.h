@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_RESAMPLED_DECODER_H
+#define LOVE_SOUND_RESAMPLED_DECODER_H
+
+// LOVE
+#include "Decoder.h"
+#include "Resampler.h"
+
+// STL
+#include <vector>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * Decodes another Decoder's output at a different sample rate. The other
+ * Decoder is owned by this one, and shouldn't be used directly anymore.
+ **/
+class ResampledDecoder : public Decoder
+{
+public:
+
+	ResampledDecoder(Decoder *source, int sampleRate);
+	virtual ~ResampledDecoder();
+
+	Decoder *clone() override;
+	int decode() override;
+	bool seek(double s) override;
+	bool rewind() override;
+	bool isSeekable() override;
+	int getChannelCount() const override;
+	int getBitDepth() const override;
+	bool setFloatOutput(bool enable) override;
+	double getDuration() override;
+
+	Decoder *getSource() const;
+
+private:
+
+	StrongRef<Decoder> source;
+	Resampler resampler;
+
+	// The source's sample format, which is floats when the source supports
+	// them, and ours when not decoding floats.
+	int sourceBitDepth;
+	int bitDepth;
+	int channels;
+
+	// Decoded source samples converted to floats.
+	std::vector<float> input;
+	std::vector<float> output;
+
+}; // ResampledDecoder
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_RESAMPLED_DECODER_H
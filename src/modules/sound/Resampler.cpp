@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Resampler.h"
+#include "Kernels.h"
+#include "common/Exception.h"
+#include "common/math.h"
+
+// C++
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+namespace love
+{
+namespace sound
+{
+
+// Fraction of the output's Nyquist frequency that passes unattenuated.
+static const double ROLLOFF = 0.945;
+
+// Kaiser window shape; about 80 dB of stopband attenuation.
+static const double KAISER_BETA = 8.0;
+
+// Longest filter, for extreme downsampling ratios.
+static const int MAX_TAPS = 512;
+
+// Consumed input is dropped from the history once there's this much of it.
+static const size_t COMPACT_FRAMES = 4096;
+
+static double besselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 32; k++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+Resampler::Resampler(int inRate, int outRate, int channels)
+	: inRate(inRate)
+	, outRate(outRate)
+	, channels(channels)
+	, L(1)
+	, M(1)
+	, phases(1)
+	, taps(0)
+	, history(channels > 0 ? channels : 0)
+	, position(0)
+	, fraction(0)
+	, inputFrames(0)
+	, outputFrames(0)
+	, flushed(false)
+{
+	if (inRate <= 0 || outRate <= 0)
+		throw love::Exception("Invalid sample rate for resampling: %d to %d", inRate, outRate);
+
+	if (channels <= 0)
+		throw love::Exception("Invalid channel count: %d", channels);
+
+	uint64 g = (uint64) std::gcd(inRate, outRate);
+	L = (uint64) outRate / g;
+	M = (uint64) inRate / g;
+
+	buildFilter();
+	reset();
+}
+
+void Resampler::buildFilter()
+{
+	// Equal rates are passed through untouched.
+	if (L == M)
+		return;
+
+	phases = (int) std::min<uint64>(L, MAX_PHASES);
+
+	// Downsampling lowers the cutoff, which widens the filter by as much.
+	double scale = std::min(1.0, (double) L / (double) M);
+	int half = (int) std::ceil(ZERO_CROSSINGS / scale);
+	half = std::min((half + 1) & ~1, MAX_TAPS / 2);
+	taps = half * 2;
+
+	double cutoff = scale * ROLLOFF;
+	double window = besselI0(KAISER_BETA);
+
+	filter.resize((size_t) phases * taps);
+
+	for (int p = 0; p < phases; p++)
+	{
+		float *h = filter.data() + (size_t) p * taps;
+		double offset = (double) p / phases;
+		double sum = 0.0;
+
+		for (int j = 0; j < taps; j++)
+		{
+			// Distance from the output's position to this tap's input frame.
+			double x = (j - (half - 1)) - offset;
+			double u = x / half;
+
+			double w = std::abs(u) < 1.0 ? besselI0(KAISER_BETA * std::sqrt(1.0 - u * u)) / window : 0.0;
+			double t = cutoff * x * LOVE_M_PI;
+			double sinc = std::abs(t) < 1e-9 ? 1.0 : std::sin(t) / t;
+
+			h[j] = (float) (cutoff * sinc * w);
+			sum += h[j];
+		}
+
+		// Unity gain at DC for every phase.
+		for (int j = 0; j < taps; j++)
+			h[j] = (float) (h[j] / sum);
+	}
+}
+
+void Resampler::reset()
+{
+	// Output frame 0 lines up with input frame 0 when the filter's left side
+	// starts out over silence.
+	size_t prime = taps > 0 ? (size_t) (taps / 2 - 1) : 0;
+
+	for (std::vector<float> &h : history)
+		h.assign(prime, 0.0f);
+
+	position = prime;
+	fraction = 0;
+	inputFrames = 0;
+	outputFrames = 0;
+	flushed = false;
+}
+
+void Resampler::write(const float *in, size_t frames)
+{
+	for (int c = 0; c < channels; c++)
+	{
+		std::vector<float> &h = history[c];
+		size_t start = h.size();
+		h.resize(start + frames);
+
+		for (size_t i = 0; i < frames; i++)
+			h[start + i] = in[i * channels + c];
+	}
+
+	inputFrames += frames;
+}
+
+void Resampler::flush()
+{
+	if (flushed)
+		return;
+
+	// Enough silence for the filter's right side past the last input frame.
+	for (std::vector<float> &h : history)
+		h.resize(h.size() + taps / 2, 0.0f);
+
+	flushed = true;
+}
+
+bool Resampler::isFlushed() const
+{
+	return flushed;
+}
+
+size_t Resampler::read(float *out, size_t frames)
+{
+	uint64 limit = flushed ? getOutputLength((size_t) inputFrames) : UINT64_MAX;
+	size_t available = history[0].size();
+	size_t half = (size_t) taps / 2;
+	size_t n = 0;
+
+	if (taps == 0)
+	{
+		for (; n < frames && outputFrames < limit && position < available; n++, position++, outputFrames++)
+		{
+			for (int c = 0; c < channels; c++)
+				out[n * channels + c] = history[c][position];
+		}
+	}
+	else
+	{
+		for (; n < frames && outputFrames < limit && position + half < available; n++, outputFrames++)
+		{
+			uint64 phase = phases == (int) L ? fraction : fraction * phases / L;
+			const float *h = filter.data() + phase * taps;
+			size_t first = position - (half - 1);
+
+			for (int c = 0; c < channels; c++)
+				out[n * channels + c] = kernels::dot(history[c].data() + first, h, taps);
+
+			fraction += M;
+			position += (size_t) (fraction / L);
+			fraction %= L;
+		}
+	}
+
+	compact();
+	return n;
+}
+
+void Resampler::compact()
+{
+	size_t keep = taps > 0 ? (size_t) (taps / 2 - 1) : 0;
+	if (position < keep + COMPACT_FRAMES)
+		return;
+
+	size_t drop = std::min(position - keep, history[0].size());
+	for (std::vector<float> &h : history)
+		h.erase(h.begin(), h.begin() + drop);
+
+	position -= drop;
+}
+
+size_t Resampler::getOutputLength(size_t inputFrames) const
+{
+	return (size_t) (((uint64) inputFrames * L + M - 1) / M);
+}
+
+int Resampler::getInputRate() const
+{
+	return inRate;
+}
+
+int Resampler::getOutputRate() const
+{
+	return outRate;
+}
+
+} // sound
+} // love
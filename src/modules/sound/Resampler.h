@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_RESAMPLER_H
+#define LOVE_SOUND_RESAMPLER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+
+// STL
+#include <vector>
+#include <cstddef>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * Converts interleaved float audio between sample rates with a polyphase
+ * windowed-sinc filter. Input is written in any amount, and as much output
+ * as the input allows is read back, so it works on whole buffers as well as
+ * on decoded streams.
+ *
+ * Output is aligned with the input (there's no added delay), and after
+ * flush() exactly ceil(inputFrames * outRate / inRate) frames are read.
+ **/
+class Resampler
+{
+public:
+
+	Resampler(int inRate, int outRate, int channels);
+
+	/**
+	 * Appends input frames.
+	 **/
+	void write(const float *in, size_t frames);
+
+	/**
+	 * Marks the end of the input, so the last frames can be read.
+	 **/
+	void flush();
+	bool isFlushed() const;
+
+	/**
+	 * Reads up to 'frames' output frames.
+	 * @return The number of frames read.
+	 **/
+	size_t read(float *out, size_t frames);
+
+	/**
+	 * Discards all input and output, e.g. after seeking the input.
+	 **/
+	void reset();
+
+	/**
+	 * Gets how many frames are read after flush(), for a given input length.
+	 **/
+	size_t getOutputLength(size_t inputFrames) const;
+
+	int getInputRate() const;
+	int getOutputRate() const;
+
+	// Filter zero crossings on each side, at the cutoff frequency.
+	static const int ZERO_CROSSINGS = 16;
+
+	// Ratios needing more phases than this are quantized to this many.
+	static const int MAX_PHASES = 1024;
+
+private:
+
+	void buildFilter();
+	void compact();
+
+	int inRate;
+	int outRate;
+	int channels;
+
+	// outRate / inRate reduced: each output frame advances M/L input frames.
+	uint64 L;
+	uint64 M;
+
+	int phases;
+	int taps;
+
+	// phases * taps coefficients.
+	std::vector<float> filter;
+
+	// Planar input, per channel. History is kept for the filter's left side.
+	std::vector<std::vector<float>> history;
+
+	// Input frame (in history) and fraction (in 1/L) of the next output.
+	size_t position;
+	uint64 fraction;
+
+	uint64 inputFrames;
+	uint64 outputFrames;
+	bool flushed;
+
+}; // Resampler
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_RESAMPLER_H
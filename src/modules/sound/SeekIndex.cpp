@@ -0,0 +1,334 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SeekIndex.h"
+#include "common/Module.h"
+#include "common/Exception.h"
+#include "filesystem/Filesystem.h"
+#include "thread/threads.h"
+#include "libraries/xxHash/xxhash.h"
+
+// STL
+#include <algorithm>
+#include <unordered_map>
+#include <list>
+#include <cstring>
+#include <cstdio>
+
+namespace love
+{
+namespace sound
+{
+
+// Indices are cached in the save directory next to the bytecode cache.
+static const char *SEEK_CACHE_DIRECTORY = "seekcache";
+
+// Bump when the file layout or the way points are chosen changes.
+static const char SEEK_CACHE_MAGIC[4] = {'L', 'S', 'K', '1'};
+
+// Bytes hashed from each end of a Stream for its key.
+static const int64 KEY_SAMPLE_SIZE = 64 * 1024;
+
+// Indices kept in memory. The least recently used one is dropped past this;
+// decoders that already hold it keep it alive.
+static const size_t MAX_CACHED_INDICES = 64;
+
+static const size_t POINT_SIZE = 8 + 8 + 2 + 2;
+static const size_t HEADER_SIZE = 4 + 4 + 8 + 8;
+
+static thread::Mutex *getCacheMutex()
+{
+	static thread::MutexRef mutex;
+	return mutex;
+}
+
+struct CacheEntry
+{
+	std::shared_ptr<const SeekIndex> index;
+	std::list<uint64>::iterator use;
+};
+
+// Most recently used keys first.
+static std::list<uint64> &getCacheUses()
+{
+	static std::list<uint64> uses;
+	return uses;
+}
+
+static std::unordered_map<uint64, CacheEntry> &getCache()
+{
+	static std::unordered_map<uint64, CacheEntry> cache;
+	return cache;
+}
+
+// The cache mutex must be held.
+static std::shared_ptr<const SeekIndex> findCached(uint64 key)
+{
+	auto it = getCache().find(key);
+	if (it == getCache().end())
+		return nullptr;
+
+	auto &uses = getCacheUses();
+	uses.splice(uses.begin(), uses, it->second.use);
+	return it->second.index;
+}
+
+// The cache mutex must be held.
+static void addCached(uint64 key, const std::shared_ptr<const SeekIndex> &index)
+{
+	auto &cache = getCache();
+	auto &uses = getCacheUses();
+
+	auto it = cache.find(key);
+	if (it != cache.end())
+	{
+		it->second.index = index;
+		uses.splice(uses.begin(), uses, it->second.use);
+		return;
+	}
+
+	if (cache.size() >= MAX_CACHED_INDICES)
+	{
+		cache.erase(uses.back());
+		uses.pop_back();
+	}
+
+	uses.push_front(key);
+	cache[key] = {index, uses.begin()};
+}
+
+static filesystem::Filesystem *getCacheFilesystem()
+{
+	auto fs = Module::getInstance<filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs == nullptr || !fs->isSeekCacheEnabled())
+		return nullptr;
+	return fs;
+}
+
+static std::string getCachePath(uint64 key)
+{
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+	return std::string(SEEK_CACHE_DIRECTORY) + "/" + name;
+}
+
+template <typename T>
+static void writeValue(std::vector<uint8> &out, T value)
+{
+	const uint8 *bytes = (const uint8 *) &value;
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static T readValue(const uint8 *&in)
+{
+	T value;
+	memcpy(&value, in, sizeof(T));
+	in += sizeof(T);
+	return value;
+}
+
+static std::shared_ptr<const SeekIndex> loadIndex(uint64 key)
+{
+	auto fs = getCacheFilesystem();
+	if (fs == nullptr)
+		return nullptr;
+
+	std::string path = getCachePath(key);
+
+	filesystem::Filesystem::Info info = {};
+	if (!fs->getInfo(path.c_str(), info) || info.type != filesystem::Filesystem::FILETYPE_FILE)
+		return nullptr;
+
+	StrongRef<Data> data;
+	try
+	{
+		data.set(fs->read(path.c_str()), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return nullptr;
+	}
+
+	size_t size = data->getSize();
+	const uint8 *in = (const uint8 *) data->getData();
+
+	if (size < HEADER_SIZE || memcmp(in, SEEK_CACHE_MAGIC, 4) != 0)
+		return nullptr;
+
+	in += 4;
+	uint32 count = readValue<uint32>(in);
+
+	// Truncated entries are rebuilt and overwritten.
+	if (size != HEADER_SIZE + count * POINT_SIZE)
+		return nullptr;
+
+	auto index = std::make_shared<SeekIndex>();
+	index->totalSamples = readValue<uint64>(in);
+	index->totalFrames = readValue<uint64>(in);
+	index->points.resize(count);
+
+	for (SeekIndex::Point &p : index->points)
+	{
+		p.sample = readValue<uint64>(in);
+		p.offset = readValue<uint64>(in);
+		p.discardFrames = readValue<uint16>(in);
+		p.discardSamples = readValue<uint16>(in);
+	}
+
+	return index;
+}
+
+static void saveIndex(uint64 key, const SeekIndex &index)
+{
+	auto fs = getCacheFilesystem();
+	if (fs == nullptr)
+		return;
+
+	std::vector<uint8> out;
+	out.reserve(HEADER_SIZE + index.points.size() * POINT_SIZE);
+
+	out.insert(out.end(), SEEK_CACHE_MAGIC, SEEK_CACHE_MAGIC + 4);
+	writeValue<uint32>(out, (uint32) index.points.size());
+	writeValue<uint64>(out, index.totalSamples);
+	writeValue<uint64>(out, index.totalFrames);
+
+	for (const SeekIndex::Point &p : index.points)
+	{
+		writeValue<uint64>(out, p.sample);
+		writeValue<uint64>(out, p.offset);
+		writeValue<uint16>(out, p.discardFrames);
+		writeValue<uint16>(out, p.discardSamples);
+	}
+
+	try
+	{
+		fs->createDirectory(SEEK_CACHE_DIRECTORY);
+		fs->write(getCachePath(key).c_str(), out.data(), (int64) out.size());
+	}
+	catch (love::Exception &)
+	{
+		// No save directory: the index only lives in memory.
+	}
+}
+
+SeekIndex::SeekIndex()
+	: totalSamples(0)
+	, totalFrames(0)
+{
+}
+
+int SeekIndex::find(uint64 sample) const
+{
+	auto it = std::upper_bound(points.begin(), points.end(), sample, [](uint64 s, const Point &p)
+	{
+		return s < p.sample;
+	});
+
+	return (int) (it - points.begin()) - 1;
+}
+
+bool SeekIndex::verify(Stream *stream, int64 base, bool (*isHeader)(const uint8 *bytes)) const
+{
+	if (points.empty())
+		return true;
+
+	const size_t checks = 4;
+	int64 start = stream->tell();
+	bool valid = true;
+
+	for (size_t i = 0; i < checks && valid; i++)
+	{
+		const Point &p = points[(points.size() - 1) * i / (checks - 1)];
+
+		uint8 header[4];
+		valid = stream->seek(base + (int64) p.offset) && stream->read(header, 4) == 4 && isHeader(header);
+	}
+
+	stream->seek(start);
+	return valid;
+}
+
+uint64 SeekIndex::getKey(Stream *stream, const char *format)
+{
+	if (!stream->isSeekable())
+		return 0;
+
+	int64 start = stream->tell();
+	int64 size = stream->getSize();
+	if (start < 0 || size <= 0)
+		return 0;
+
+	XXH64_hash_t hash = XXH64(format, strlen(format), (XXH64_hash_t) size);
+
+	std::vector<uint8> bytes((size_t) std::min(size, KEY_SAMPLE_SIZE));
+
+	int64 read = stream->seek(0) ? stream->read(bytes.data(), (int64) bytes.size()) : 0;
+	hash = XXH64(bytes.data(), (size_t) std::max<int64>(read, 0), hash);
+
+	if (size > KEY_SAMPLE_SIZE)
+	{
+		read = stream->seek(size - KEY_SAMPLE_SIZE) ? stream->read(bytes.data(), (int64) bytes.size()) : 0;
+		hash = XXH64(bytes.data(), (size_t) std::max<int64>(read, 0), hash);
+	}
+
+	stream->seek(start);
+
+	// 0 means no key.
+	return hash != 0 ? hash : 1;
+}
+
+std::shared_ptr<const SeekIndex> SeekIndex::get(uint64 key)
+{
+	if (key == 0)
+		return nullptr;
+
+	{
+		thread::Lock lock(getCacheMutex());
+		auto index = findCached(key);
+		if (index)
+			return index;
+	}
+
+	auto index = loadIndex(key);
+	if (index)
+	{
+		thread::Lock lock(getCacheMutex());
+		addCached(key, index);
+	}
+
+	return index;
+}
+
+void SeekIndex::put(uint64 key, const std::shared_ptr<const SeekIndex> &index)
+{
+	if (key == 0 || !index)
+		return;
+
+	{
+		thread::Lock lock(getCacheMutex());
+		addCached(key, index);
+	}
+
+	saveIndex(key, *index);
+}
+
+} // sound
+} // love
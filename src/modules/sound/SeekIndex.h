@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_SEEK_INDEX_H
+#define LOVE_SOUND_SEEK_INDEX_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Stream.h"
+
+// STL
+#include <vector>
+#include <memory>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * A sparse table mapping sample positions to byte offsets in a compressed
+ * stream, so decoders can seek without scanning or bisecting the file.
+ *
+ * Indices are built by the decoders when first needed, and shared by every
+ * decoder of the same file: in memory for the most recently used files, and
+ * in the save directory's seekcache folder across runs when
+ * love.filesystem.setSeekCacheEnabled is on.
+ **/
+class SeekIndex
+{
+public:
+
+	struct Point
+	{
+		// Sample at which decoding from this point can start.
+		uint64 sample;
+		// Byte offset of the frame or page to start decoding from.
+		uint64 offset;
+		// Format specific: whole frames and samples to decode and drop.
+		uint16 discardFrames;
+		uint16 discardSamples;
+	};
+
+	std::vector<Point> points;
+
+	uint64 totalSamples;
+
+	// Format specific, e.g. the number of MP3 frames.
+	uint64 totalFrames;
+
+	SeekIndex();
+
+	/**
+	 * Finds the last point at or before the given sample.
+	 * @return The index of the point, or -1 if there is none.
+	 **/
+	int find(uint64 sample) const;
+
+	/**
+	 * Checks that a few of the points still land on a frame header, in case
+	 * the file changed without changing its key. The Stream's position is
+	 * restored.
+	 * @param base The byte offset the points are relative to.
+	 * @param isHeader Checks the first 4 bytes at a point's offset.
+	 **/
+	bool verify(Stream *stream, int64 base, bool (*isHeader)(const uint8 *bytes)) const;
+
+	/**
+	 * Gets the key identifying a Stream's contents. It hashes the size, the
+	 * start and the end of the Stream rather than all of it, as reading the
+	 * whole file would cost about as much as building the index. The Stream's
+	 * position is restored.
+	 * @return The key, or 0 if the Stream isn't seekable.
+	 **/
+	static uint64 getKey(Stream *stream, const char *format);
+
+	/**
+	 * Gets a previously built index, from memory or from the save directory.
+	 * @return The index, or null if there is none.
+	 **/
+	static std::shared_ptr<const SeekIndex> get(uint64 key);
+
+	/**
+	 * Stores an index in memory, and in the save directory if it exists and
+	 * the seek cache is enabled.
+	 **/
+	static void put(uint64 key, const std::shared_ptr<const SeekIndex> &index);
+
+	// Spacing between points, in samples. Seeking decodes at most about this
+	// much audio past the point it starts from.
+	static const uint64 POINT_INTERVAL = 11025;
+
+}; // SeekIndex
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_SEEK_INDEX_H
@@ -19,6 +19,11 @@
  **/
 
 #include "Sound.h"
+#include "data/DataStream.h"
+
+// STL
+#include <algorithm>
+#include <thread>
 
 namespace love
 {
@@ -27,13 +32,129 @@ namespace sound
 
 love::Type Sound::type("Sound", &Module::type);
 
+Sound::DecodeWorker::DecodeWorker(Sound *owner)
+	: owner(owner)
+{
+	threadName = "SoundDecode";
+}
+
+void Sound::DecodeWorker::threadFunction()
+{
+	while (true)
+	{
+		std::pair<SoundDataBatch *, int> job;
+
+		{
+			thread::Lock lock(owner->decodeMutex);
+
+			while (!owner->decodeFinish && owner->decodeQueue.empty())
+				owner->decodeCond->wait(owner->decodeMutex);
+
+			if (owner->decodeFinish)
+				return;
+
+			job = owner->decodeQueue.front();
+			owner->decodeQueue.pop_front();
+		}
+
+		owner->decode(job.first, job.second);
+		job.first->release();
+	}
+}
+
 Sound::Sound(const char *name)
 	: Module(M_SOUND, name)
+	, decodeFinish(false)
 {
 }
 
 Sound::~Sound()
 {
+	stopDecodeWorkers();
+}
+
+void Sound::decodeAsync(SoundDataBatch *batch)
+{
+	thread::Lock lock(decodeMutex);
+
+	if (decodeWorkers.empty() && !decodeFinish)
+	{
+		int count = getDefaultDecodeThreadCount();
+		for (int i = 0; i < count; i++)
+		{
+			DecodeWorker *worker = new DecodeWorker(this);
+			if (!worker->start())
+			{
+				delete worker;
+				break;
+			}
+			decodeWorkers.push_back(worker);
+		}
+	}
+
+	for (int i = 0; i < batch->getCount(); i++)
+	{
+		// Decode on the calling thread when no worker could be started.
+		if (decodeWorkers.empty())
+		{
+			decode(batch, i);
+			continue;
+		}
+
+		batch->retain();
+		decodeQueue.emplace_back(batch, i);
+	}
+
+	decodeCond->broadcast();
+}
+
+void Sound::decode(SoundDataBatch *batch, int index)
+{
+	StrongRef<SoundData> result;
+	std::string error;
+
+	try
+	{
+		StrongRef<Stream> stream(new data::DataStream(batch->getInput(index)), Acquire::NORETAIN);
+		StrongRef<Decoder> decoder(newDecoder(stream, Decoder::DEFAULT_BUFFER_SIZE), Acquire::NORETAIN);
+		result.set(new SoundData(decoder), Acquire::NORETAIN);
+	}
+	catch (std::exception &e)
+	{
+		error = e.what();
+	}
+
+	batch->complete(index, result, error);
+}
+
+void Sound::stopDecodeWorkers()
+{
+	{
+		thread::Lock lock(decodeMutex);
+		decodeFinish = true;
+		decodeCond->broadcast();
+	}
+
+	for (DecodeWorker *worker : decodeWorkers)
+	{
+		worker->wait();
+		delete worker;
+	}
+	decodeWorkers.clear();
+
+	for (const auto &job : decodeQueue)
+	{
+		job.first->complete(job.second, nullptr, "The sound module was destroyed before the file was decoded.");
+		job.first->release();
+	}
+	decodeQueue.clear();
+}
+
+int Sound::getDefaultDecodeThreadCount()
+{
+	// Load-time decoding is the only thing running, so use most cores.
+	int cores = (int) std::thread::hardware_concurrency();
+	return std::min(std::max(cores - 1, 1), 8);
 }
 
 SoundData *Sound::newSoundData(Decoder *decoder)
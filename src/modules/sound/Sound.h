@@ -26,7 +26,14 @@
 #include "common/Stream.h"
 
 #include "SoundData.h"
+#include "SoundDataBatch.h"
 #include "Decoder.h"
+#include "thread/threads.h"
+
+// STL
+#include <vector>
+#include <deque>
+#include <utility>
 
 namespace love
 {
@@ -59,7 +66,7 @@ class Sound : public Module
 	 * Creates a new SoundData with the specified number of samples and format.
 	 * @param samples The number of samples.
 	 * @param sampleRate Number of samples per second.
-	 * @param bitDepth Bits per sample (8 or 16).
+	 * @param bitDepth Bits per sample (8 or 16, or 32 for floats.)
 	 * @param channels Either 1 for mono, or 2 for stereo.
 	 * @return A new SoundData object, or zero in case of errors.
 	 **/
@@ -71,7 +78,7 @@ class Sound : public Module
 	 * @param data Buffer to load data from.
 	 * @param samples The number of samples.
 	 * @param sampleRate Number of samples per second.
-	 * @param bitDepth Bits per sample (8 or 16).
+	 * @param bitDepth Bits per sample (8 or 16, or 32 for floats.)
 	 * @param channels Either 1 for mono, or 2 for stereo.
 	 * @return A new SoundData object, or zero in case of errors.
 	 **/
@@ -86,10 +93,45 @@ class Sound : public Module
 	 **/
 	virtual Decoder *newDecoder(Stream *stream, int bufferSize) = 0;
 
+	/**
+	 * Decodes every item of a batch into SoundData on worker threads. The
+	 * workers are started on first use.
+	 **/
+	void decodeAsync(SoundDataBatch *batch);
+
+	static int getDefaultDecodeThreadCount();
+
 protected:
 
 	Sound(const char *name);
 
+	/**
+	 * Stops and joins the decode workers. Items which haven't started
+	 * decoding yet fail.
+	 **/
+	void stopDecodeWorkers();
+
+private:
+
+	class DecodeWorker : public thread::Threadable
+	{
+	public:
+		DecodeWorker(Sound *owner);
+		virtual ~DecodeWorker() {}
+		void threadFunction();
+	private:
+		Sound *owner;
+	};
+
+	void decode(SoundDataBatch *batch, int index);
+
+	std::vector<DecodeWorker *> decodeWorkers;
+	std::deque<std::pair<SoundDataBatch *, int>> decodeQueue;
+	bool decodeFinish;
+
+	thread::MutexRef decodeMutex;
+	thread::ConditionalRef decodeCond;
+
 }; // Sound
 
 } // sound
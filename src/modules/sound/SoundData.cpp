@@ -19,6 +19,8 @@
  **/
 
 #include "SoundData.h"
+#include "Kernels.h"
+#include "Resampler.h"
 
 // C
 #include <cstdlib>
@@ -28,6 +30,7 @@
 #include <limits>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 namespace love
 {
@@ -36,6 +39,15 @@ namespace sound
 
 love::Type SoundData::type("SoundData", &Data::type);
 
+// Bulk operations on integer samples convert through a float buffer of about
+// this many samples at a time.
+static const int CHUNK_SAMPLES = 1024;
+
+static int getChunkFrames(int channels)
+{
+	return std::max(CHUNK_SAMPLES / channels, 1);
+}
+
 SoundData::SoundData(Decoder *decoder)
 	: data(0)
 	, size(0)
@@ -43,7 +55,7 @@ SoundData::SoundData(Decoder *decoder)
 	, bitDepth(0)
 	, channels(0)
 {
-	if (decoder->getBitDepth() != 8 && decoder->getBitDepth() != 16)
+	if (decoder->getBitDepth() != 8 && decoder->getBitDepth() != 16 && decoder->getBitDepth() != 32)
 		throw love::Exception("Invalid bit depth: %d", decoder->getBitDepth());
 
 	size_t bufferSize = 524288; // 0x80000
@@ -137,7 +149,7 @@ void SoundData::load(int samples, int sampleRate, int bitDepth, int channels, co
 	if (sampleRate <= 0)
 		throw love::Exception("Invalid sample rate: %d", sampleRate);
 
-	if (bitDepth != 8 && bitDepth != 16)
+	if (bitDepth != 8 && bitDepth != 16 && bitDepth != 32)
 		throw love::Exception("Invalid bit depth: %d", bitDepth);
 
 	if (channels <= 0)
@@ -210,7 +222,13 @@ void SoundData::setSample(int i, float sample)
 	if (i < 0 || (size_t) i >= size/(bitDepth/8))
 		throw love::Exception("Attempt to set out-of-range sample!");
 
-	if (bitDepth == 16)
+	if (bitDepth == 32)
+	{
+		// 32-bit samples are floats.
+		float *s = (float *) data;
+		s[i] = sample;
+	}
+	else if (bitDepth == 16)
 	{
 		// 16-bit sample values are signed.
 		int16 *s = (int16 *) data;
@@ -237,7 +255,13 @@ float SoundData::getSample(int i) const
 	if (i < 0 || (size_t) i >= size/(bitDepth/8))
 		throw love::Exception("Attempt to get out-of-range sample!");
 
-	if (bitDepth == 16)
+	if (bitDepth == 32)
+	{
+		// 32-bit samples are floats.
+		float *s = (float *) data;
+		return s[i];
+	}
+	else if (bitDepth == 16)
 	{
 		// 16-bit sample values are signed.
 		int16 *s = (int16 *) data;
@@ -274,9 +298,17 @@ void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstS
 
 	if (bitDepth != src->bitDepth)
 	{
-		// Bit depth mismatch, use get/setSample at loop
-		for (int i = 0; i < count * channels; i++)
-			setSample(dstStart * channels + i, src->getSample(srcStart * channels + i));
+		// Bit depth mismatch, convert through floats.
+		int frames = getChunkFrames(channels);
+		std::vector<float> buffer((size_t) frames * channels);
+
+		// Different bit depths never share memory, so there's no overlap.
+		for (int i = 0; i < count; i += frames)
+		{
+			int n = std::min(frames, count - i);
+			src->getSamples(buffer.data(), srcStart + i, n);
+			setSamples(buffer.data(), dstStart + i, n);
+		}
 	}
 	else if (this->data == src->data)
 		// May overlap, use memmove
@@ -300,5 +332,182 @@ SoundData *SoundData::slice(int start, int length) const
 	return new SoundData(data + start * channels * bitDepth/8, length, sampleRate, bitDepth, channels);
 }
 
+void SoundData::checkRange(int start, int count, const char *what) const
+{
+	if (start < 0 || count < 0 || start > getSampleCount() - count)
+		throw love::Exception("Attempt to %s out-of-range samples!", what);
+}
+
+void SoundData::getSamples(float *dst, int start, int count) const
+{
+	checkRange(start, count, "get");
+
+	size_t bytesPerSample = (size_t) channels * bitDepth/8;
+	kernels::toFloat(dst, data + start * bytesPerSample, (size_t) count * channels, bitDepth);
+}
+
+void SoundData::setSamples(const float *src, int start, int count)
+{
+	checkRange(start, count, "set");
+
+	size_t bytesPerSample = (size_t) channels * bitDepth/8;
+	kernels::fromFloat(data + start * bytesPerSample, src, (size_t) count * channels, bitDepth);
+}
+
+void SoundData::mixInto(SoundData *dst, int srcStart, int count, int dstStart, float gain) const
+{
+	if (channels != dst->channels)
+		throw love::Exception("Channel count mismatch!");
+
+	checkRange(srcStart, count, "mix");
+	dst->checkRange(dstStart, count, "mix");
+
+	// Mixing a range into an overlapping one reads from a copy.
+	std::vector<float> copy;
+	if (dst == this && srcStart < dstStart + count && dstStart < srcStart + count)
+	{
+		copy.resize((size_t) count * channels);
+		getSamples(copy.data(), srcStart, count);
+	}
+
+	if (dst->bitDepth == 32 && (bitDepth == 32 || !copy.empty()))
+	{
+		const float *s = copy.empty() ? (const float *) data + (size_t) srcStart * channels : copy.data();
+		float *d = (float *) dst->data + (size_t) dstStart * channels;
+		kernels::mixGain(d, s, (size_t) count * channels, gain);
+		return;
+	}
+
+	int frames = getChunkFrames(channels);
+	std::vector<float> srcBuffer((size_t) frames * channels);
+	std::vector<float> dstBuffer((size_t) frames * channels);
+
+	for (int i = 0; i < count; i += frames)
+	{
+		int n = std::min(frames, count - i);
+
+		const float *s = copy.data() + (size_t) i * channels;
+		if (copy.empty())
+		{
+			getSamples(srcBuffer.data(), srcStart + i, n);
+			s = srcBuffer.data();
+		}
+
+		dst->getSamples(dstBuffer.data(), dstStart + i, n);
+		kernels::mixGain(dstBuffer.data(), s, (size_t) n * channels, gain);
+		dst->setSamples(dstBuffer.data(), dstStart + i, n);
+	}
+}
+
+void SoundData::applyGain(float gain, int start, int count)
+{
+	if (count < 0)
+		count = getSampleCount() - start;
+
+	checkRange(start, count, "set");
+
+	if (bitDepth == 32)
+	{
+		kernels::applyGain((float *) data + (size_t) start * channels, (size_t) count * channels, gain);
+		return;
+	}
+
+	int frames = getChunkFrames(channels);
+	std::vector<float> buffer((size_t) frames * channels);
+
+	for (int i = 0; i < count; i += frames)
+	{
+		int n = std::min(frames, count - i);
+		getSamples(buffer.data(), start + i, n);
+		kernels::applyGain(buffer.data(), (size_t) n * channels, gain);
+		setSamples(buffer.data(), start + i, n);
+	}
+}
+
+SoundData *SoundData::convert(int bitDepth, int channels) const
+{
+	if (channels != this->channels && channels != 1 && this->channels != 1)
+		throw love::Exception("Can only convert between %d and %d channels through mono.", this->channels, channels);
+
+	int count = getSampleCount();
+	SoundData *c = new SoundData(count, sampleRate, bitDepth, channels);
+
+	int frames = getChunkFrames(std::max(channels, this->channels));
+	std::vector<float> srcBuffer((size_t) frames * this->channels);
+	std::vector<float> dstBuffer((size_t) frames * channels);
+
+	for (int i = 0; i < count; i += frames)
+	{
+		int n = std::min(frames, count - i);
+		getSamples(srcBuffer.data(), i, n);
+
+		if (channels == this->channels)
+		{
+			c->setSamples(srcBuffer.data(), i, n);
+			continue;
+		}
+
+		for (int f = 0; f < n; f++)
+		{
+			if (this->channels == 1)
+			{
+				for (int ch = 0; ch < channels; ch++)
+					dstBuffer[f * channels + ch] = srcBuffer[f];
+			}
+			else
+			{
+				float sum = 0.0f;
+				for (int ch = 0; ch < this->channels; ch++)
+					sum += srcBuffer[f * this->channels + ch];
+				dstBuffer[f] = sum / this->channels;
+			}
+		}
+
+		c->setSamples(dstBuffer.data(), i, n);
+	}
+
+	return c;
+}
+
+SoundData *SoundData::resample(int sampleRate) const
+{
+	Resampler resampler(this->sampleRate, sampleRate, channels);
+
+	int count = getSampleCount();
+	size_t outCount = resampler.getOutputLength((size_t) count);
+	if (outCount > (size_t) std::numeric_limits<int>::max())
+		throw love::Exception("Resampled SoundData is too large.");
+
+	SoundData *r = new SoundData((int) outCount, sampleRate, bitDepth, channels);
+
+	int frames = getChunkFrames(channels);
+	std::vector<float> srcBuffer((size_t) frames * channels);
+	std::vector<float> dstBuffer((size_t) frames * channels);
+	int written = 0;
+
+	// Output is read as soon as it's available, so the resampler only ever
+	// holds about one chunk of input.
+	for (int i = 0; i < count || !resampler.isFlushed(); i += frames)
+	{
+		int n = std::min(frames, count - i);
+		if (n > 0)
+		{
+			getSamples(srcBuffer.data(), i, n);
+			resampler.write(srcBuffer.data(), n);
+		}
+		else
+			resampler.flush();
+
+		size_t read = 0;
+		while ((read = resampler.read(dstBuffer.data(), frames)) > 0)
+		{
+			r->setSamples(dstBuffer.data(), written, (int) read);
+			written += (int) read;
+		}
+	}
+
+	return r;
+}
+
 } // sound
 } // love
@@ -64,8 +64,37 @@ class SoundData : public love::Data
 	void copyFrom(const SoundData *src, int srcStart, int count, int dstStart);
 	SoundData *slice(int start, int length = -1) const;
 
+	/**
+	 * Reads or writes 'count' sample frames starting at frame 'start', as
+	 * interleaved floats.
+	 **/
+	void getSamples(float *dst, int start, int count) const;
+	void setSamples(const float *src, int start, int count);
+
+	/**
+	 * Adds 'count' frames of this SoundData, scaled by 'gain', to another one
+	 * with the same channel count. Integer samples saturate.
+	 **/
+	void mixInto(SoundData *dst, int srcStart, int count, int dstStart, float gain) const;
+
+	void applyGain(float gain, int start = 0, int count = -1);
+
+	/**
+	 * Creates a copy with a different bit depth and/or channel count. Mono
+	 * is duplicated to every channel, and anything is averaged down to mono.
+	 **/
+	SoundData *convert(int bitDepth, int channels) const;
+
+	/**
+	 * Creates a copy at a different sample rate, with the same bit depth and
+	 * channel count. The duration is kept, rounded up to a whole frame.
+	 **/
+	SoundData *resample(int sampleRate) const;
+
 private:
 
+	void checkRange(int start, int count, const char *what) const;
+
 	void load(int samples, int sampleRate, int bitDepth, int channels, const void *newData = 0);
 
 	uint8 *data;
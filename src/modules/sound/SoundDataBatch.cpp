@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SoundDataBatch.h"
+#include "event/Event.h"
+#include "timer/Timer.h"
+
+namespace love
+{
+namespace sound
+{
+
+love::Type SoundDataBatch::type("SoundDataBatch", &Object::type);
+
+SoundDataBatch::SoundDataBatch(const std::vector<StrongRef<Data>> &inputs, const std::string &eventName)
+	: items(inputs.size())
+	, eventName(eventName)
+	, completed(0)
+{
+	for (size_t i = 0; i < inputs.size(); i++)
+		items[i].input = inputs[i];
+}
+
+SoundDataBatch::~SoundDataBatch()
+{
+}
+
+int SoundDataBatch::getCount() const
+{
+	return (int) items.size();
+}
+
+int SoundDataBatch::getCompletedCount() const
+{
+	return completed;
+}
+
+bool SoundDataBatch::isDone() const
+{
+	return completed == (int) items.size();
+}
+
+SoundData *SoundDataBatch::getSoundData(int index) const
+{
+	thread::Lock lock(mutex);
+	return items[index].result.get();
+}
+
+std::string SoundDataBatch::getError(int index) const
+{
+	thread::Lock lock(mutex);
+	return items[index].error;
+}
+
+bool SoundDataBatch::wait(int timeout)
+{
+	thread::Lock lock(mutex);
+
+	if (timeout < 0)
+	{
+		while (!isDone())
+			cond->wait(mutex);
+
+		return true;
+	}
+
+	// Each completion wakes us up, so wait against a deadline rather than
+	// restarting the timeout every time.
+	double remaining = timeout / 1000.0;
+	while (!isDone() && remaining > 0.0)
+	{
+		double start = love::timer::Timer::getTime();
+		cond->wait(mutex, (int) (remaining * 1000));
+		remaining -= love::timer::Timer::getTime() - start;
+	}
+
+	return isDone();
+}
+
+Data *SoundDataBatch::getInput(int index) const
+{
+	return items[index].input.get();
+}
+
+void SoundDataBatch::complete(int index, SoundData *data, const std::string &error)
+{
+	{
+		thread::Lock lock(mutex);
+
+		Item &item = items[index];
+		if (item.done)
+			return;
+
+		item.result.set(data);
+		item.error = error;
+		item.done = true;
+
+		// The encoded file isn't needed anymore.
+		item.input.set(nullptr);
+
+		completed++;
+		cond->broadcast();
+	}
+
+	if (eventName.empty())
+		return;
+
+	auto eventmodule = Module::getInstance<event::Event>(Module::M_EVENT);
+	if (!eventmodule)
+		return;
+
+	std::vector<Variant> vargs = {
+		Variant(&SoundDataBatch::type, this),
+		Variant((double) (index + 1)),
+		data != nullptr ? Variant(&SoundData::type, data) : Variant(),
+		error.empty() ? Variant() : Variant(error),
+	};
+
+	StrongRef<event::Message> msg(new event::Message(eventName, vargs), Acquire::NORETAIN);
+	eventmodule->push(msg);
+}
+
+} // sound
+} // love
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_SOUND_SOUND_DATA_BATCH_H
+#define LOVE_SOUND_SOUND_DATA_BATCH_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/Data.h"
+#include "thread/threads.h"
+#include "SoundData.h"
+
+// STL
+#include <string>
+#include <vector>
+#include <atomic>
+
+namespace love
+{
+namespace sound
+{
+
+/**
+ * A list of encoded sound files which are decoded into SoundData on the
+ * Sound module's worker threads. The results can be polled, or waited on.
+ **/
+class SoundDataBatch : public Object
+{
+public:
+
+	static love::Type type;
+
+	/**
+	 * @param eventName If not empty, an event with this name is pushed when
+	 * each item finishes decoding.
+	 **/
+	SoundDataBatch(const std::vector<StrongRef<Data>> &inputs, const std::string &eventName);
+	virtual ~SoundDataBatch();
+
+	int getCount() const;
+	int getCompletedCount() const;
+	bool isDone() const;
+
+	/**
+	 * Gets the SoundData of an item, or null if it's still decoding or it
+	 * failed. Failed items have a non-empty error.
+	 **/
+	SoundData *getSoundData(int index) const;
+	std::string getError(int index) const;
+
+	/**
+	 * Blocks until every item is done, or until the timeout (in milliseconds)
+	 * expires. A negative timeout waits indefinitely.
+	 * @return Whether every item is done.
+	 **/
+	bool wait(int timeout = -1);
+
+	// Used by the worker threads.
+	Data *getInput(int index) const;
+	void complete(int index, SoundData *data, const std::string &error);
+
+private:
+
+	struct Item
+	{
+		StrongRef<Data> input;
+		StrongRef<SoundData> result;
+		std::string error;
+		bool done = false;
+	};
+
+	std::vector<Item> items;
+	std::string eventName;
+
+	std::atomic<int> completed;
+
+	thread::MutexRef mutex;
+	thread::ConditionalRef cond;
+
+}; // SoundDataBatch
+
+} // sound
+} // love
+
+#endif // LOVE_SOUND_SOUND_DATA_BATCH_H
@@ -62,14 +62,23 @@ FLACDecoder::~FLACDecoder()
 love::sound::Decoder *FLACDecoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new FLACDecoder(s, bufferSize);
+	FLACDecoder *d = new FLACDecoder(s, bufferSize);
+	d->setFloatOutput(floatOutput);
+	return d;
 }
 
 int FLACDecoder::decode()
 {
-	// `bufferSize` is in bytes, so divide by 2.
-	drflac_uint64 read = drflac_read_pcm_frames_s16(flac, bufferSize / 2 / flac->channels, (drflac_int16 *) buffer);
-	read *= 2 * flac->channels;
+	// `bufferSize` is in bytes, so divide by the frame size.
+	int frameSize = getBitDepth() / 8 * flac->channels;
+	drflac_uint64 read = 0;
+
+	if (floatOutput)
+		read = drflac_read_pcm_frames_f32(flac, bufferSize / frameSize, (float *) buffer);
+	else
+		read = drflac_read_pcm_frames_s16(flac, bufferSize / frameSize, (drflac_int16 *) buffer);
+
+	read *= frameSize;
 
 	if ((int) read < bufferSize)
 		eof = true;
@@ -105,7 +114,13 @@ int FLACDecoder::getChannelCount() const
 
 int FLACDecoder::getBitDepth() const
 {
-	return 16;
+	return floatOutput ? 32 : 16;
+}
+
+bool FLACDecoder::setFloatOutput(bool enable)
+{
+	floatOutput = enable;
+	return true;
 }
 
 int FLACDecoder::getSampleRate() const
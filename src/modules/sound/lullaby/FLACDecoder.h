@@ -48,6 +48,7 @@ class FLACDecoder : public Decoder
 	bool isSeekable() override;
 	int getChannelCount() const override;
 	int getBitDepth() const override;
+	bool setFloatOutput(bool enable) override;
 	int getSampleRate() const override;
 	double getDuration() override;
 
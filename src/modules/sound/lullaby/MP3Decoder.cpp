@@ -133,44 +133,87 @@ drmp3_bool32 MP3Decoder::onSeek(void *pUserData, int offset, drmp3_seek_origin o
 	return decoder->stream->seek(pos, Stream::SEEKORIGIN_BEGIN) ? DRMP3_TRUE : DRMP3_FALSE;
 }
 
-MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
+static bool isFrameHeader(const uint8 *bytes)
+{
+	return drmp3_hdr_valid(bytes) != 0;
+}
+
+MP3Decoder::MP3Decoder(Stream *stream, int bufferSize, std::shared_ptr<const SeekIndex> index)
 : Decoder(stream, bufferSize)
+, seekIndex(index)
+, seekPoint()
 {
+	uint64 key = seekIndex ? 0 : SeekIndex::getKey(stream, "mp3");
+
 	// Check for possible ID3 tag and skip it if necessary.
 	offset = findFirstValidHeader(stream);
 	if (offset == -1)
 		throw love::Exception("Could not find first valid mp3 header.");
 
+	if (!seekIndex)
+	{
+		seekIndex = SeekIndex::get(key);
+
+		// Seek points are relative to the first frame.
+		if (seekIndex && !seekIndex->verify(stream, offset, isFrameHeader))
+			seekIndex.reset();
+	}
+
 	// initialize mp3 handle
 	if (!drmp3_init(&mp3, onRead, onSeek, this, nullptr))
 		throw love::Exception("Could not read mp3 data.");
 
 	sampleRate = mp3.sampleRate;
 
-	// calculate duration
+	if (!seekIndex)
+	{
+		try
+		{
+			seekIndex = buildSeekIndex();
+		}
+		catch (love::Exception &)
+		{
+			drmp3_uninit(&mp3);
+			throw;
+		}
+
+		SeekIndex::put(key, seekIndex);
+	}
+
+	duration = ((double) seekIndex->totalSamples) / ((double) mp3.sampleRate);
+}
+
+std::shared_ptr<const SeekIndex> MP3Decoder::buildSeekIndex()
+{
+	// Both of these scan the whole file, which is why the result is cached.
 	drmp3_uint64 pcmCount, mp3FrameCount;
 	if (!drmp3_get_mp3_and_pcm_frame_count(&mp3, &mp3FrameCount, &pcmCount))
-	{
-		drmp3_uninit(&mp3);
 		throw love::Exception("Could not calculate mp3 duration.");
-	}
-	duration = ((double) pcmCount) / ((double) mp3.sampleRate);
 
-	// create seek table
-	drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
-	seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
-	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, seekTable.data()))
-	{
-		drmp3_uninit(&mp3);
+	// One point every POINT_INTERVAL samples rather than one per frame.
+	drmp3_uint64 pointCount = pcmCount / SeekIndex::POINT_INTERVAL;
+	if (pointCount > mp3FrameCount)
+		pointCount = mp3FrameCount;
+	if (pointCount < 1)
+		pointCount = 1;
+
+	drmp3_uint32 mp3PointCount = (drmp3_uint32) pointCount;
+	std::vector<drmp3_seek_point> seekTable((size_t) pointCount, {0ULL, 0ULL, 0, 0});
+	if (!drmp3_calculate_seek_points(&mp3, &mp3PointCount, seekTable.data()))
 		throw love::Exception("Could not calculate mp3 seek table");
-	}
 
-	// bind seek table
-	if (!drmp3_bind_seek_table(&mp3, mp3FrameInt, seekTable.data()))
+	auto index = std::make_shared<SeekIndex>();
+	index->totalSamples = pcmCount;
+	index->totalFrames = mp3FrameCount;
+	index->points.reserve(mp3PointCount);
+
+	for (drmp3_uint32 i = 0; i < mp3PointCount; i++)
 	{
-		drmp3_uninit(&mp3);
-		throw love::Exception("Could not bind mp3 seek table");
+		const drmp3_seek_point &p = seekTable[i];
+		index->points.push_back({p.pcmFrameIndex, p.seekPosInBytes, p.mp3FramesToDiscard, p.pcmFramesToDiscard});
 	}
+
+	return index;
 }
 
 MP3Decoder::~MP3Decoder()
@@ -181,24 +224,49 @@ MP3Decoder::~MP3Decoder()
 love::sound::Decoder *MP3Decoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new MP3Decoder(s, bufferSize);
+	MP3Decoder *d = new MP3Decoder(s, bufferSize, seekIndex);
+	d->setFloatOutput(floatOutput);
+	return d;
 }
 
 int MP3Decoder::decode()
 {
 	// bufferSize is in char
-	int maxRead = bufferSize / sizeof(int16_t) / mp3.channels;
-	int read = (int) drmp3_read_pcm_frames_s16(&mp3, maxRead, (drmp3_int16 *) buffer);
+	int frameSize = getBitDepth() / 8 * mp3.channels;
+	int maxRead = bufferSize / frameSize;
+	int read = 0;
+
+	if (floatOutput)
+		read = (int) drmp3_read_pcm_frames_f32(&mp3, maxRead, (float *) buffer);
+	else
+		read = (int) drmp3_read_pcm_frames_s16(&mp3, maxRead, (drmp3_int16 *) buffer);
 
 	if (read < maxRead)
 		eof = true;
 
-	return read * sizeof(int16_t) * mp3.channels;
+	return read * frameSize;
 }
 
 bool MP3Decoder::seek(double s)
 {
 	drmp3_uint64 targetSample = (drmp3_uint64) (s * mp3.sampleRate);
+
+	// dr_mp3 searches its seek table linearly, so find the point here and
+	// only hand it that one. With no point before the target, dr_mp3 starts
+	// from the first frame.
+	int point = seekIndex->find(targetSample);
+	if (point >= 0)
+	{
+		const SeekIndex::Point &p = seekIndex->points[point];
+		seekPoint.seekPosInBytes = p.offset;
+		seekPoint.pcmFrameIndex = p.sample;
+		seekPoint.mp3FramesToDiscard = p.discardFrames;
+		seekPoint.pcmFramesToDiscard = p.discardSamples;
+		drmp3_bind_seek_table(&mp3, 1, &seekPoint);
+	}
+	else
+		drmp3_bind_seek_table(&mp3, 0, nullptr);
+
 	drmp3_bool32 success = drmp3_seek_to_pcm_frame(&mp3, targetSample);
 
 	if (success)
@@ -224,7 +292,13 @@ int MP3Decoder::getChannelCount() const
 
 int MP3Decoder::getBitDepth() const
 {
-	return 16;
+	return floatOutput ? 32 : 16;
+}
+
+bool MP3Decoder::setFloatOutput(bool enable)
+{
+	floatOutput = enable;
+	return true;
 }
 
 double MP3Decoder::getDuration()
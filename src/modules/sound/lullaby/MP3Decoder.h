@@ -24,11 +24,13 @@
 // LOVE
 #include "common/Stream.h"
 #include "sound/Decoder.h"
+#include "sound/SeekIndex.h"
 
 // dr_mp3
 #include "dr/dr_mp3.h"
 
 #include <vector>
+#include <memory>
 
 namespace love
 {
@@ -41,7 +43,7 @@ class MP3Decoder: public love::sound::Decoder
 {
 public:
 
-	MP3Decoder(Stream *stream, int bufsize);
+	MP3Decoder(Stream *stream, int bufsize, std::shared_ptr<const SeekIndex> index = nullptr);
 	virtual ~MP3Decoder();
 
 	love::sound::Decoder *clone() override;
@@ -51,6 +53,7 @@ class MP3Decoder: public love::sound::Decoder
 	bool isSeekable() override;
 	int getChannelCount() const override;
 	int getBitDepth() const override;
+	bool setFloatOutput(bool enable) override;
 	double getDuration() override;
 
 private:
@@ -59,8 +62,12 @@ class MP3Decoder: public love::sound::Decoder
 
 	// MP3 handle
 	drmp3 mp3;
-	// Used for fast seeking
-	std::vector<drmp3_seek_point> seekTable;
+	std::shared_ptr<const SeekIndex> buildSeekIndex();
+
+	// Used for fast seeking. Shared with clones.
+	std::shared_ptr<const SeekIndex> seekIndex;
+	// The point dr_mp3 seeks from, found in seekIndex.
+	drmp3_seek_point seekPoint;
 	// Position of first MP3 frame found
 	int64 offset;
 
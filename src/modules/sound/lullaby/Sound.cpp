@@ -65,6 +65,8 @@ Sound::Sound()
 
 Sound::~Sound()
 {
+	// The workers call newDecoder, so they can't outlive this part of the object.
+	stopDecodeWorkers();
 }
 
 sound::Decoder *Sound::newDecoder(Stream *stream, int bufferSize)
@@ -21,6 +21,7 @@
 #include "VorbisDecoder.h"
 
 #include <string.h>
+#include <algorithm>
 #include "common/config.h"
 #include "common/Exception.h"
 
@@ -75,9 +76,97 @@ static long vorbisTell(void *datasource)
  * END CALLBACK FUNCTIONS
  **/
 
-VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
+static bool isPageHeader(const uint8 *bytes)
+{
+	return memcmp(bytes, "OggS", 4) == 0;
+}
+
+static uint64 readLE(const uint8 *bytes, int size)
+{
+	uint64 value = 0;
+	for (int i = size - 1; i >= 0; i--)
+		value = (value << 8) | bytes[i];
+	return value;
+}
+
+/**
+ * Walks the Ogg page headers, skipping the page bodies, and records where
+ * pages start along with the sample the previous page ended on. Returns null
+ * for streams with more than one logical bitstream, as granule positions
+ * aren't comparable across them. The Stream's position is restored.
+ **/
+static std::shared_ptr<const SeekIndex> buildSeekIndex(Stream *stream)
+{
+	if (!stream->isSeekable())
+		return nullptr;
+
+	int64 start = stream->tell();
+	int64 size = stream->getSize();
+
+	auto index = std::make_shared<SeekIndex>();
+
+	int64 pos = 0;
+	uint32 serial = 0;
+	uint64 lastGranule = 0;
+	uint64 nextPoint = 1;
+	bool valid = true;
+
+	uint8 header[27 + 255];
+
+	while (valid && pos + 27 <= size)
+	{
+		if (!stream->seek(pos) || stream->read(header, 27) != 27 || !isPageHeader(header))
+		{
+			valid = false;
+			break;
+		}
+
+		// A truncated last page ends the index, like it ends decoding.
+		int segments = header[26];
+		if (stream->read(header + 27, segments) != segments)
+			break;
+
+		int64 bodySize = 0;
+		for (int i = 0; i < segments; i++)
+			bodySize += header[27 + i];
+
+		uint32 pageSerial = (uint32) readLE(header + 14, 4);
+		if (pos == 0)
+			serial = pageSerial;
+		else if (pageSerial != serial)
+			valid = false;
+
+		// Pages on which no packet ends have a granule position of -1.
+		int64 granule = (int64) readLE(header + 6, 8);
+		if (granule >= 0)
+		{
+			// Decoding from here starts at or after the last page's end.
+			if (lastGranule >= nextPoint)
+			{
+				index->points.push_back({lastGranule, (uint64) pos, 0, 0});
+				nextPoint = lastGranule + SeekIndex::POINT_INTERVAL;
+			}
+
+			lastGranule = (uint64) granule;
+		}
+
+		pos += 27 + segments + bodySize;
+	}
+
+	stream->seek(start);
+
+	if (!valid)
+		return nullptr;
+
+	index->totalSamples = lastGranule;
+	return index;
+}
+
+VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize, std::shared_ptr<const SeekIndex> index)
 	: Decoder(stream, bufferSize)
 	, duration(-2.0)
+	, seekIndex(index)
+	, seekIndexLoaded(index != nullptr)
 {
 	ov_callbacks callbacks = {};
 	callbacks.close_func = vorbisClose;
@@ -100,11 +189,17 @@ VorbisDecoder::~VorbisDecoder()
 love::sound::Decoder *VorbisDecoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new VorbisDecoder(s, bufferSize);
+	VorbisDecoder *d = new VorbisDecoder(s, bufferSize, seekIndex);
+	d->seekIndexLoaded = seekIndexLoaded;
+	d->setFloatOutput(floatOutput);
+	return d;
 }
 
 int VorbisDecoder::decode()
 {
+	if (floatOutput)
+		return decodeFloat();
+
 	int size = 0;
 
 #ifdef LOVE_BIG_ENDIAN
@@ -133,14 +228,112 @@ int VorbisDecoder::decode()
 	return size;
 }
 
+int VorbisDecoder::decodeFloat()
+{
+	int channels = getChannelCount();
+	int frameSize = sizeof(float) * channels;
+	float *out = (float *) buffer;
+	int frames = 0;
+	int maxFrames = bufferSize / frameSize;
+
+	while (frames < maxFrames)
+	{
+		float **pcm = nullptr;
+		int bitstream = 0;
+
+		// ov_read_float hands out the decoder's planar buffers directly, so
+		// the only pass over the samples is this interleave.
+		long result = ov_read_float(&handle, &pcm, maxFrames - frames, &bitstream);
+		if (result == OV_HOLE)
+			continue;
+		else if (result <= OV_EREAD)
+			return -1;
+		else if (result == 0)
+		{
+			eof = true;
+			break;
+		}
+
+		for (long i = 0; i < result; i++)
+		{
+			for (int c = 0; c < channels; c++)
+				out[(frames + i) * channels + c] = pcm[c][i];
+		}
+
+		frames += (int) result;
+	}
+
+	return frames * frameSize;
+}
+
+bool VorbisDecoder::skip(int64 samples)
+{
+	while (samples > 0)
+	{
+		float **pcm = nullptr;
+		int bitstream = 0;
+
+		long result = ov_read_float(&handle, &pcm, (int) std::min<int64>(samples, 4096), &bitstream);
+		if (result == OV_HOLE)
+			continue;
+		else if (result <= 0)
+			return false;
+
+		samples -= result;
+	}
+
+	return true;
+}
+
+void VorbisDecoder::loadSeekIndex()
+{
+	seekIndexLoaded = true;
+
+	// Page offsets are absolute, and the Stream's position is restored, so
+	// this can run after libvorbisfile has started reading.
+	uint64 key = SeekIndex::getKey(stream, "ogg");
+
+	seekIndex = SeekIndex::get(key);
+	if (seekIndex && !seekIndex->verify(stream, 0, isPageHeader))
+		seekIndex.reset();
+
+	if (!seekIndex)
+	{
+		seekIndex = buildSeekIndex(stream);
+		SeekIndex::put(key, seekIndex);
+	}
+}
+
 bool VorbisDecoder::seek(double s)
 {
 	int result = 0;
 
+	if (!seekIndexLoaded && s > 0.000001)
+		loadSeekIndex();
+
 	// Avoid ov_time_seek (which calls ov_pcm_seek) when seeking to 0, to avoid
 	// a bug in libvorbis <= 1.3.4 when seeking to PCM 0 in multiplexed streams.
 	if (s <= 0.000001)
 		result = ov_raw_seek(&handle, 0);
+	else if (seekIndex)
+	{
+		// Jump to an indexed page instead of bisecting the file, then decode
+		// up to the target. A packet can start up to a long block before the
+		// page it ends on, so start a little earlier than the target.
+		int64 target = (int64) (s * vorbisInfo->rate);
+		int point = seekIndex->find((uint64) std::max<int64>(target - 8192, 0));
+		int64 offset = point >= 0 ? (int64) seekIndex->points[point].offset : 0;
+
+		result = ov_raw_seek(&handle, offset);
+		if (result == 0)
+		{
+			int64 pos = ov_pcm_tell(&handle);
+			if (pos < 0 || pos > target || !skip(target - pos))
+				result = ov_time_seek(&handle, s);
+		}
+		else
+			result = ov_time_seek(&handle, s);
+	}
 	else
 		result = ov_time_seek(&handle, s);
 
@@ -181,7 +374,13 @@ int VorbisDecoder::getChannelCount() const
 
 int VorbisDecoder::getBitDepth() const
 {
-	return 16;
+	return floatOutput ? 32 : 16;
+}
+
+bool VorbisDecoder::setFloatOutput(bool enable)
+{
+	floatOutput = enable;
+	return true;
 }
 
 int VorbisDecoder::getSampleRate() const
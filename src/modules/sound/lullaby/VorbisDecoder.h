@@ -25,12 +25,16 @@
 #include "common/Stream.h"
 #include "common/int.h"
 #include "sound/Decoder.h"
+#include "sound/SeekIndex.h"
 
 // vorbis
 #define OV_EXCLUDE_STATIC_CALLBACKS
 #include <vorbis/codec.h>
 #include <vorbis/vorbisfile.h>
 
+// STL
+#include <memory>
+
 namespace love
 {
 namespace sound
@@ -42,7 +46,7 @@ class VorbisDecoder : public Decoder
 {
 public:
 
-	VorbisDecoder(Stream *stream, int bufferSize);
+	VorbisDecoder(Stream *stream, int bufferSize, std::shared_ptr<const SeekIndex> index = nullptr);
 	virtual ~VorbisDecoder();
 
 	love::sound::Decoder *clone() override;
@@ -52,15 +56,26 @@ class VorbisDecoder : public Decoder
 	bool isSeekable() override;
 	int getChannelCount() const override;
 	int getBitDepth() const override;
+	bool setFloatOutput(bool enable) override;
 	int getSampleRate() const override;
 	double getDuration() override;
 
 private:
 
+	int decodeFloat();
+	bool skip(int64 samples);
+	void loadSeekIndex();
+
 	OggVorbis_File handle;
 	vorbis_info *vorbisInfo;
 	double duration;
 
+	// Null for chained or multiplexed streams, which use libvorbisfile's
+	// own bisection search. Only looked up or built on the first seek, so
+	// decoders that never seek don't walk the file.
+	std::shared_ptr<const SeekIndex> seekIndex;
+	bool seekIndexLoaded;
+
 }; // VorbisDecoder
 
 } // lullaby
@@ -94,7 +94,9 @@ WaveDecoder::~WaveDecoder()
 love::sound::Decoder *WaveDecoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new WaveDecoder(s, bufferSize);
+	WaveDecoder *d = new WaveDecoder(s, bufferSize);
+	d->setFloatOutput(floatOutput);
+	return d;
 }
 
 int WaveDecoder::decode()
@@ -158,9 +160,25 @@ int WaveDecoder::getChannelCount() const
 
 int WaveDecoder::getBitDepth() const
 {
+	if (floatOutput)
+		return 32;
+
 	return info.bits_per_sample == 8 ? 8 : 16;
 }
 
+bool WaveDecoder::setFloatOutput(bool enable)
+{
+	wuff_uint16 format = WUFF_FORMAT_IEEE_FLOAT_32;
+	if (!enable)
+		format = info.bits_per_sample == 8 ? WUFF_FORMAT_PCM_U8 : WUFF_FORMAT_PCM_S16;
+
+	if (wuff_format(handle, format) < 0)
+		return enable == floatOutput;
+
+	floatOutput = enable;
+	return true;
+}
+
 int WaveDecoder::getSampleRate() const
 {
 	return info.sample_rate;
@@ -19,6 +19,8 @@
  **/
 
 #include "wrap_Sound.h"
+#include "wrap_SoundDataBatch.h"
+#include "ResampledDecoder.h"
 
 #include "filesystem/wrap_Filesystem.h"
 #include "data/DataStream.h"
@@ -36,6 +38,14 @@ namespace sound
 int w_newDecoder(lua_State *L)
 {
 	int bufferSize = (int)luaL_optinteger(L, 2, Decoder::DEFAULT_BUFFER_SIZE);
+	int bitDepth = (int)luaL_optinteger(L, 4, 0);
+	int sampleRate = (int)luaL_optinteger(L, 5, 0);
+
+	if (bitDepth != 0 && bitDepth != 8 && bitDepth != 16 && bitDepth != 32)
+		return luaL_error(L, "Invalid bit depth: %d", bitDepth);
+	if (sampleRate < 0)
+		return luaL_error(L, "Invalid sample rate: %d", sampleRate);
+
 	love::Stream *stream = nullptr;
 
 	if (love::filesystem::luax_cangetfile(L, 1))
@@ -79,6 +89,19 @@ int w_newDecoder(lua_State *L)
 		[&](bool) { stream->release(); }
 	);
 
+	if (sampleRate != 0 && sampleRate != t->getSampleRate())
+	{
+		Decoder *source = t;
+		luax_catchexcept(L,
+			[&]() { t = new ResampledDecoder(source, sampleRate); },
+			[&](bool) { source->release(); }
+		);
+	}
+
+	// Decoders which can't produce float samples keep their own format.
+	if (bitDepth == 32)
+		t->setFloatOutput(true);
+
 	luax_pushtype(L, t);
 	t->release();
 	return 1;
@@ -115,11 +138,59 @@ int w_newSoundData(lua_State *L)
 	return 1;
 }
 
+static Data *checkEncodedData(lua_State *L, int idx)
+{
+	if (love::filesystem::luax_cangetfiledata(L, idx))
+	{
+		Data *data = nullptr;
+		luax_catchexcept(L, [&]() { data = love::filesystem::luax_getfiledata(L, idx); });
+		return data;
+	}
+
+	Data *data = luax_checktype<Data>(L, idx);
+	data->retain();
+	return data;
+}
+
+int w_newSoundDataAsync(lua_State *L)
+{
+	std::vector<StrongRef<Data>> inputs;
+
+	if (lua_istable(L, 1))
+	{
+		int count = (int) luax_objlen(L, 1);
+		inputs.reserve(count);
+
+		for (int i = 1; i <= count; i++)
+		{
+			lua_rawgeti(L, 1, i);
+			inputs.emplace_back(checkEncodedData(L, -1), Acquire::NORETAIN);
+			lua_pop(L, 1);
+		}
+	}
+	else
+		inputs.emplace_back(checkEncodedData(L, 1), Acquire::NORETAIN);
+
+	std::string eventname = luaL_optstring(L, 2, "");
+
+	SoundDataBatch *t = nullptr;
+	luax_catchexcept(L, [&]()
+	{
+		t = new SoundDataBatch(inputs, eventname);
+		instance()->decodeAsync(t);
+	});
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
 	{ "newDecoder",  w_newDecoder },
 	{ "newSoundData",  w_newSoundData },
+	{ "newSoundDataAsync",  w_newSoundDataAsync },
 	{ 0, 0 }
 };
 
@@ -127,6 +198,7 @@ static const lua_CFunction types[] =
 {
 	luaopen_sounddata,
 	luaopen_decoder,
+	luaopen_sounddatabatch,
 	0
 };
 
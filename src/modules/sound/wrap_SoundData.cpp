@@ -21,6 +21,10 @@
 #include "wrap_SoundData.h"
 
 #include "data/wrap_Data.h"
+#include "data/ByteData.h"
+
+// C++
+#include <algorithm>
 
 // Shove the wrap_SoundData.lua code directly into a raw string literal.
 static const char sounddata_lua[] =
@@ -146,6 +150,119 @@ int w_SoundData_slice(lua_State *L)
 	return 1;
 }
 
+// Gets the float destination or source of a bulk operation, checking that
+// 'count' sample frames fit in the Data at the byte offset.
+static float *checkFloatData(lua_State *L, int idx, SoundData *t, int count)
+{
+	Data *d = data::luax_checkdata(L, idx);
+	lua_Integer offset = luaL_optinteger(L, idx + 1, 0);
+	size_t size = (size_t) std::max(count, 0) * t->getChannelCount() * sizeof(float);
+
+	if (offset < 0 || (size_t) offset > d->getSize() || size > d->getSize() - (size_t) offset)
+		luaL_error(L, "The Data is too small for %d sample frames at offset %d.", count, (int) offset);
+
+	return (float *) ((uint8 *) d->getData() + offset);
+}
+
+int w_SoundData_getSamples(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	int start = (int) luaL_optinteger(L, 2, 0);
+	int count = (int) luaL_optinteger(L, 3, t->getSampleCount() - start);
+
+	if (!lua_isnoneornil(L, 4))
+	{
+		float *dst = checkFloatData(L, 4, t, count);
+		luax_catchexcept(L, [&](){ t->getSamples(dst, start, count); });
+		lua_pushvalue(L, 4);
+		return 1;
+	}
+
+	data::ByteData *d = nullptr;
+	luax_catchexcept(L,
+		[&]()
+		{
+			d = new data::ByteData((size_t) std::max(count, 0) * t->getChannelCount() * sizeof(float), false);
+			t->getSamples((float *) d->getData(), start, count);
+		},
+		[&](bool err) { if (err && d != nullptr) d->release(); }
+	);
+
+	luax_pushtype(L, d);
+	d->release();
+	return 1;
+}
+
+int w_SoundData_setSamples(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	Data *d = data::luax_checkdata(L, 2);
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+	int start = (int) luaL_optinteger(L, 4, 0);
+
+	// By default, as many frames as the Data holds.
+	int count = 0;
+	if (lua_isnoneornil(L, 5))
+	{
+		size_t frameSize = t->getChannelCount() * sizeof(float);
+		size_t available = offset >= 0 && (size_t) offset < d->getSize() ? d->getSize() - (size_t) offset : 0;
+		count = (int) std::min<size_t>(available / frameSize, (size_t) std::max(t->getSampleCount() - start, 0));
+	}
+	else
+		count = (int) luaL_checkinteger(L, 5);
+
+	const float *src = checkFloatData(L, 2, t, count);
+	luax_catchexcept(L, [&](){ t->setSamples(src, start, count); });
+	return 0;
+}
+
+int w_SoundData_mixInto(lua_State *L)
+{
+	SoundData *src = luax_checksounddata(L, 1);
+	SoundData *dst = luax_checksounddata(L, 2);
+	int srcStart = (int) luaL_optinteger(L, 3, 0);
+	int dstStart = (int) luaL_optinteger(L, 5, 0);
+	int count = (int) luaL_optinteger(L, 4, std::min(src->getSampleCount() - srcStart, dst->getSampleCount() - dstStart));
+	float gain = (float) luaL_optnumber(L, 6, 1.0);
+
+	luax_catchexcept(L, [&](){ src->mixInto(dst, srcStart, count, dstStart, gain); });
+	return 0;
+}
+
+int w_SoundData_applyGain(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1);
+	float gain = (float) luaL_checknumber(L, 2);
+	int start = (int) luaL_optinteger(L, 3, 0);
+	int count = (int) luaL_optinteger(L, 4, -1);
+
+	luax_catchexcept(L, [&](){ t->applyGain(gain, start, count); });
+	return 0;
+}
+
+int w_SoundData_convert(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
+	int bitDepth = (int) luaL_checkinteger(L, 2);
+	int channels = (int) luaL_optinteger(L, 3, t->getChannelCount());
+
+	luax_catchexcept(L, [&](){ c = t->convert(bitDepth, channels); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SoundData_resample(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *r = nullptr;
+	int sampleRate = (int) luaL_checkinteger(L, 2);
+
+	luax_catchexcept(L, [&](){ r = t->resample(sampleRate); });
+	luax_pushtype(L, r);
+	r->release();
+	return 1;
+}
+
 static const luaL_Reg w_SoundData_functions[] =
 {
 	{ "clone", w_SoundData_clone },
@@ -158,6 +275,12 @@ static const luaL_Reg w_SoundData_functions[] =
 	{ "getSample", w_SoundData_getSample },
 	{ "copyFrom", w_SoundData_copyFrom },
 	{ "slice", w_SoundData_slice },
+	{ "getSamples", w_SoundData_getSamples },
+	{ "setSamples", w_SoundData_setSamples },
+	{ "mixInto", w_SoundData_mixInto },
+	{ "applyGain", w_SoundData_applyGain },
+	{ "convert", w_SoundData_convert },
+	{ "resample", w_SoundData_resample },
 
 	{ 0, 0 }
 };
@@ -38,9 +38,13 @@ local tonumber, assert, error = tonumber, assert, error
 local floor = math.floor
 
 local float = ffi.typeof("float")
-local datatypes = {ffi.typeof("uint8_t *"), ffi.typeof("int16_t *")}
+local datatypes = {
+	[1] = ffi.typeof("uint8_t *"),
+	[2] = ffi.typeof("int16_t *"),
+	[4] = ffi.typeof("float *"),
+}
 
-local typemaxvals = {0x7F, 0x7FFF}
+local typemaxvals = {[1] = 0x7F, [2] = 0x7FFF, [4] = 1}
 
 local _getBitDepth = SoundData.getBitDepth
 local _getSampleCount = SoundData.getSampleCount
@@ -95,7 +99,10 @@ function SoundData:getSample(i, channel)
 		error("Attempt to get out-of-range sample!", 2)
 	end
 
-	if p.bytedepth == 2 then
+	if p.bytedepth == 4 then
+		-- 32-bit data is stored as floats.
+		return tonumber(p.pointer[i])
+	elseif p.bytedepth == 2 then
 		-- 16-bit data is stored as signed values internally.
 		return tonumber(p.pointer[i]) / p.maxvalue
 	else
@@ -128,7 +135,10 @@ function SoundData:setSample(i, channel, sample)
 		error("Attempt to set out-of-range sample!", 2)
 	end
 
-	if p.bytedepth == 2 then
+	if p.bytedepth == 4 then
+		-- 32-bit data is stored as floats.
+		p.pointer[i] = sample
+	elseif p.bytedepth == 2 then
 		-- 16-bit data is stored as signed values internally.
 		p.pointer[i] = sample * p.maxvalue
 	else
@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_SoundDataBatch.h"
+
+namespace love
+{
+namespace sound
+{
+
+SoundDataBatch *luax_checksounddatabatch(lua_State *L, int idx)
+{
+	return luax_checktype<SoundDataBatch>(L, idx);
+}
+
+static int checkIndex(lua_State *L, SoundDataBatch *t, int idx)
+{
+	int index = (int) luaL_checkinteger(L, idx) - 1;
+	if (index < 0 || index >= t->getCount())
+		luaL_error(L, "Invalid SoundDataBatch index: %d", index + 1);
+	return index;
+}
+
+int w_SoundDataBatch_getCount(lua_State *L)
+{
+	SoundDataBatch *t = luax_checksounddatabatch(L, 1);
+	lua_pushinteger(L, t->getCount());
+	return 1;
+}
+
+int w_SoundDataBatch_getProgress(lua_State *L)
+{
+	SoundDataBatch *t = luax_checksounddatabatch(L, 1);
+	lua_pushinteger(L, t->getCompletedCount());
+	lua_pushinteger(L, t->getCount());
+	return 2;
+}
+
+int w_SoundDataBatch_isDone(lua_State *L)
+{
+	SoundDataBatch *t = luax_checksounddatabatch(L, 1);
+	luax_pushboolean(L, t->isDone());
+	return 1;
+}
+
+int w_SoundDataBatch_getSoundData(lua_State *L)
+{
+	SoundDataBatch *t = luax_checksounddatabatch(L, 1);
+	int index = checkIndex(L, t, 2);
+
+	SoundData *s = t->getSoundData(index);
+	if (s != nullptr)
+	{
+		luax_pushtype(L, s);
+		return 1;
+	}
+
+	std::string error = t->getError(index);
+	lua_pushnil(L);
+	if (error.empty())
+		return 1;
+
+	luax_pushstring(L, error);
+	return 2;
+}
+
+int w_SoundDataBatch_getSoundDatas(lua_State *L)
+{
+	SoundDataBatch *t = luax_checksounddatabatch(L, 1);
+	int count = t->getCount();
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		SoundData *s = t->getSoundData(i);
+		if (s == nullptr)
+			continue;
+
+		luax_pushtype(L, s);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
+int w_SoundDataBatch_wait(lua_State *L)
+{
+	SoundDataBatch *t = luax_checksounddatabatch(L, 1);
+	int timeout = -1;
+	if (!lua_isnoneornil(L, 2))
+		timeout = (int) (luaL_checknumber(L, 2) * 1000.0);
+
+	luax_pushboolean(L, t->wait(timeout));
+	return 1;
+}
+
+static const luaL_Reg w_SoundDataBatch_functions[] =
+{
+	{ "getCount", w_SoundDataBatch_getCount },
+	{ "getProgress", w_SoundDataBatch_getProgress },
+	{ "isDone", w_SoundDataBatch_isDone },
+	{ "getSoundData", w_SoundDataBatch_getSoundData },
+	{ "getSoundDatas", w_SoundDataBatch_getSoundDatas },
+	{ "wait", w_SoundDataBatch_wait },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_sounddatabatch(lua_State *L)
+{
+	return luax_register_type(L, &SoundDataBatch::type, w_SoundDataBatch_functions, nullptr);
+}
+
+} // sound
+} // love
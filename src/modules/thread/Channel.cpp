@@ -20,6 +20,7 @@
 
 #include "Channel.h"
 
+#include "common/Exception.h"
 #include <timer/Timer.h>
 
 namespace love
@@ -29,104 +30,326 @@ namespace thread
 
 love::Type Channel::type("Channel", &Object::type);
 
-Channel::Channel()
-	: sent(0)
+Channel::Channel(Mode mode, int capacity)
+	: mode(mode)
+	, capacity(0)
+	, mask(0)
+	, head(0)
+	, tail(0)
+	, waiters(0)
+	, sent(0)
 	, received(0)
 {
+	if (mode == MODE_LOCKED)
+		return;
+
+	if (capacity <= 0 || capacity > MAX_CAPACITY)
+		throw love::Exception("Invalid Channel capacity: %d (must be between 1 and %d)", capacity, MAX_CAPACITY);
+
+	// Positions are mapped to slots with a mask.
+	this->capacity = 2;
+	while (this->capacity < (uint64) capacity)
+		this->capacity <<= 1;
+
+	mask = this->capacity - 1;
+	cells.reset(new Cell[this->capacity]);
+
+	for (uint64 i = 0; i < this->capacity; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
 }
 
 Channel::~Channel()
 {
 }
 
-uint64 Channel::push(const Variant &var)
+bool Channel::enqueue(const Variant &var, uint64 *id)
 {
-	Lock l(mutex);
+	if (mode == MODE_SPSC)
+	{
+		uint64 pos = head.load(std::memory_order_relaxed);
+		if (pos - tail.load(std::memory_order_acquire) >= capacity)
+			return false;
 
-	queue.push(var);
-	cond->broadcast();
+		cells[pos & mask].value = var;
+		head.store(pos + 1, std::memory_order_release);
+
+		*id = pos + 1;
+		return true;
+	}
+
+	// A slot is free to push into when its sequence equals the position,
+	// and holds a value once it's the position + 1.
+	uint64 pos = head.load(std::memory_order_relaxed);
+	Cell *cell = nullptr;
+
+	while (true)
+	{
+		cell = &cells[pos & mask];
+		uint64 seq = cell->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) pos;
+
+		if (diff == 0)
+		{
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false;
+		else
+			pos = head.load(std::memory_order_relaxed);
+	}
 
-	return ++sent;
+	cell->value = var;
+	cell->sequence.store(pos + 1, std::memory_order_release);
+
+	*id = pos + 1;
+	return true;
 }
 
-bool Channel::supply(const Variant &var)
+bool Channel::dequeue(Variant *var)
 {
-	Lock l(mutex);
-	uint64 id = push(var);
+	if (mode == MODE_SPSC)
+	{
+		uint64 pos = tail.load(std::memory_order_relaxed);
+		if (pos == head.load(std::memory_order_acquire))
+			return false;
 
-	while (received < id)
-		cond->wait(mutex);
+		*var = std::move(cells[pos & mask].value);
+		tail.store(pos + 1, std::memory_order_release);
+	}
+	else
+	{
+		uint64 pos = tail.load(std::memory_order_relaxed);
+		Cell *cell = nullptr;
+
+		while (true)
+		{
+			cell = &cells[pos & mask];
+			uint64 seq = cell->sequence.load(std::memory_order_acquire);
+			int64 diff = (int64) seq - (int64) (pos + 1);
+
+			if (diff == 0)
+			{
+				if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = tail.load(std::memory_order_relaxed);
+		}
+
+		*var = std::move(cell->value);
+
+		// Free for the push one lap later.
+		cell->sequence.store(pos + capacity, std::memory_order_release);
+	}
 
+	received.fetch_add(1, std::memory_order_release);
 	return true;
 }
 
-bool Channel::supply(const Variant &var, double timeout)
+void Channel::notify()
+{
+	// Pairs with the fence in waitUntil: either the waiter sees our change
+	// before it sleeps, or we see the waiter and wake it.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (waiters.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+template <typename F>
+bool Channel::waitUntil(F done, double timeout)
 {
 	Lock l(mutex);
-	uint64 id = push(var);
 
-	while (timeout >= 0)
+	waiters.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	bool forever = timeout < 0;
+	bool result = done();
+
+	while (!result && (forever || timeout >= 0))
 	{
-		if (received >= id)
-			return true;
+		if (forever)
+			cond->wait(mutex);
+		else
+		{
+			double start = love::timer::Timer::getTime();
+			cond->wait(mutex, timeout*1000);
+			double stop = love::timer::Timer::getTime();
+
+			timeout -= (stop-start);
+		}
+
+		result = done();
+	}
 
-		double start = love::timer::Timer::getTime();
-		cond->wait(mutex, timeout*1000);
-		double stop = love::timer::Timer::getTime();
+	waiters.fetch_sub(1, std::memory_order_relaxed);
+	return result;
+}
 
-		timeout -= (stop-start);
+uint64 Channel::push(const Variant &var)
+{
+	if (mode == MODE_LOCKED)
+	{
+		Lock l(mutex);
+
+		queue.push(var);
+		cond->broadcast();
+
+		return ++sent;
 	}
 
-	return false;
+	// Lock-free pushes wait for room while the ring is full.
+	uint64 id = 0;
+	if (!enqueue(var, &id))
+		waitUntil([&]() { return enqueue(var, &id); }, -1.0);
+
+	notify();
+	return id;
 }
 
-bool Channel::pop(Variant *var)
+uint64 Channel::push(const std::vector<Variant> &vars)
 {
-	Lock l(mutex);
+	if (mode == MODE_LOCKED)
+	{
+		Lock l(mutex);
 
-	if (queue.empty())
-		return false;
+		for (const Variant &var : vars)
+			queue.push(var);
 
-	*var = queue.front();
-	queue.pop();
+		if (!vars.empty())
+			cond->broadcast();
 
-	received++;
-	cond->broadcast();
+		return sent += vars.size();
+	}
 
-	return true;
+	uint64 id = head.load(std::memory_order_relaxed);
+
+	for (const Variant &var : vars)
+	{
+		if (enqueue(var, &id))
+			continue;
+
+		// Let poppers drain what's been pushed so far.
+		notify();
+		waitUntil([&]() { return enqueue(var, &id); }, -1.0);
+	}
+
+	if (!vars.empty())
+		notify();
+
+	return id;
 }
 
-bool Channel::demand(Variant *var)
+bool Channel::supply(const Variant &var)
 {
-	Lock l(mutex);
+	uint64 id = push(var);
+	return waitUntil([&]() { return received.load(std::memory_order_acquire) >= id; }, -1.0);
+}
+
+bool Channel::supply(const Variant &var, double timeout)
+{
+	uint64 id = push(var);
+
+	if (timeout < 0)
+		return false;
+
+	return waitUntil([&]() { return received.load(std::memory_order_acquire) >= id; }, timeout);
+}
+
+bool Channel::pop(Variant *var)
+{
+	if (mode == MODE_LOCKED)
+	{
+		Lock l(mutex);
+
+		if (queue.empty())
+			return false;
 
-	while (!pop(var))
-		cond->wait(mutex);
+		*var = std::move(queue.front());
+		queue.pop();
+
+		received++;
+		cond->broadcast();
+
+		return true;
+	}
 
+	if (!dequeue(var))
+		return false;
+
+	notify();
 	return true;
 }
 
-bool Channel::demand(Variant *var, double timeout)
+int Channel::pop(std::vector<Variant> &vars, int max)
 {
-	Lock l(mutex);
+	int count = 0;
 
-	while (timeout >= 0)
+	if (mode == MODE_LOCKED)
 	{
-		if (pop(var))
-			return true;
+		Lock l(mutex);
 
-		double start = love::timer::Timer::getTime();
-		cond->wait(mutex, timeout*1000);
-		double stop = love::timer::Timer::getTime();
+		for (; count < max && !queue.empty(); count++)
+		{
+			vars.push_back(std::move(queue.front()));
+			queue.pop();
+		}
 
-		timeout -= (stop-start);
+		if (count > 0)
+		{
+			received += count;
+			cond->broadcast();
+		}
+
+		return count;
 	}
 
-	return false;
+	Variant var;
+	for (; count < max && dequeue(&var); count++)
+		vars.push_back(std::move(var));
+
+	if (count > 0)
+		notify();
+
+	return count;
+}
+
+bool Channel::demand(Variant *var)
+{
+	return waitUntil([&]() { return pop(var); }, -1.0);
+}
+
+bool Channel::demand(Variant *var, double timeout)
+{
+	if (timeout < 0)
+		return false;
+
+	return waitUntil([&]() { return pop(var); }, timeout);
 }
 
 bool Channel::peek(Variant *var)
 {
+	if (mode == MODE_SPSC)
+	{
+		// Only the popping thread may peek, so the front can't be popped
+		// from under it.
+		uint64 pos = tail.load(std::memory_order_relaxed);
+		if (pos == head.load(std::memory_order_acquire))
+			return false;
+
+		*var = cells[pos & mask].value;
+		return true;
+	}
+	else if (mode == MODE_MPMC)
+		throw love::Exception("Channels in mpmc mode can't be peeked.");
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -138,18 +361,39 @@ bool Channel::peek(Variant *var)
 
 int Channel::getCount() const
 {
+	if (mode != MODE_LOCKED)
+	{
+		// Everything popped has been pushed, so read the pops first.
+		uint64 popped = received.load(std::memory_order_acquire);
+		uint64 pushed = head.load(std::memory_order_acquire);
+		return (int) (pushed - popped);
+	}
+
 	Lock l(mutex);
 	return (int) queue.size();
 }
 
 bool Channel::hasRead(uint64 id) const
 {
-	Lock l(mutex);
-	return received >= id;
+	return received.load(std::memory_order_acquire) >= id;
 }
 
 void Channel::clear()
 {
+	if (mode != MODE_LOCKED)
+	{
+		Variant var;
+		bool cleared = false;
+
+		while (dequeue(&var))
+			cleared = true;
+
+		if (cleared)
+			notify();
+
+		return;
+	}
+
 	Lock l(mutex);
 
 	// We're already empty.
@@ -160,10 +404,20 @@ void Channel::clear()
 		queue.pop();
 
 	// Finish all the supply waits
-	received = sent;
+	received = sent.load();
 	cond->broadcast();
 }
 
+Channel::Mode Channel::getMode() const
+{
+	return mode;
+}
+
+int Channel::getCapacity() const
+{
+	return (int) capacity;
+}
+
 void Channel::lockMutex()
 {
 	mutex->lock();
@@ -174,5 +428,13 @@ void Channel::unlockMutex()
 	mutex->unlock();
 }
 
+STRINGMAP_CLASS_BEGIN(Channel, Channel::Mode, Channel::MODE_MAX_ENUM, mode)
+{
+	{ "locked", Channel::MODE_LOCKED },
+	{ "spsc",   Channel::MODE_SPSC   },
+	{ "mpmc",   Channel::MODE_MPMC   },
+}
+STRINGMAP_CLASS_END(Channel, Channel::Mode, Channel::MODE_MAX_ENUM, mode)
+
 } // thread
 } // love
@@ -23,9 +23,13 @@
 
 // STL
 #include <queue>
+#include <vector>
+#include <atomic>
+#include <memory>
 
 // LOVE
 #include "common/Variant.h"
+#include "common/StringMap.h"
 #include "common/int.h"
 #include "threads.h"
 
@@ -38,33 +42,86 @@ class Channel : public love::Object
 {
 public:
 
+	/**
+	 * How pushes and pops are synchronized. Lock-free Channels are backed by
+	 * a fixed-size ring buffer, and only take the mutex to block: in demand
+	 * and supply, and in push while the ring is full.
+	 **/
+	enum Mode
+	{
+		MODE_LOCKED, // Unbounded queue behind a mutex.
+		MODE_SPSC,   // Lock-free, for one pushing and one popping thread.
+		MODE_MPMC,   // Lock-free, for any number of threads.
+		MODE_MAX_ENUM
+	};
+
 	static love::Type type;
 
-	Channel();
+	static const int DEFAULT_CAPACITY = 1024;
+	static const int MAX_CAPACITY = 1 << 24;
+
+	Channel(Mode mode = MODE_LOCKED, int capacity = DEFAULT_CAPACITY);
 	~Channel();
 
 	uint64 push(const Variant &var);
+	uint64 push(const std::vector<Variant> &vars); // returns the last id
 	bool supply(const Variant &var); // blocking push
 	bool supply(const Variant &var, double timeout);
 	bool pop(Variant *var);
 	bool demand(Variant *var); // blocking pop
 	bool demand(Variant *var, double timeout); // blocking pop
+	int pop(std::vector<Variant> &vars, int max); // appends up to max
 	bool peek(Variant *var);
 	int getCount() const;
 	bool hasRead(uint64 id) const;
 	void clear();
 
+	Mode getMode() const;
+	int getCapacity() const;
+
 	void lockMutex();
 	void unlockMutex();
 
+	STRINGMAP_CLASS_DECLARE(Mode);
+
 private:
 
+	// A slot in the ring. The sequence orders access to it in MPMC mode.
+	struct Cell
+	{
+		std::atomic<uint64> sequence;
+		Variant value;
+	};
+
+	bool enqueue(const Variant &var, uint64 *id);
+	bool dequeue(Variant *var);
+	void notify();
+
+	// Blocks until done() returns true, or the timeout (in seconds) runs
+	// out. A negative timeout waits forever.
+	template <typename F>
+	bool waitUntil(F done, double timeout);
+
+	Mode mode;
+
 	MutexRef mutex;
 	ConditionalRef cond;
 	std::queue<Variant> queue;
 
-	uint64 sent;
-	uint64 received;
+	std::unique_ptr<Cell[]> cells;
+	uint64 capacity;
+	uint64 mask;
+
+	// Ring positions: the next to push and the next to pop. Kept on separate
+	// cache lines, since different threads write them.
+	alignas(64) std::atomic<uint64> head;
+	alignas(64) std::atomic<uint64> tail;
+
+	// Threads blocked on the condition, which pushes and pops must wake.
+	alignas(64) std::atomic<int> waiters;
+
+	std::atomic<uint64> sent;
+	std::atomic<uint64> received;
 
 }; // Channel
 
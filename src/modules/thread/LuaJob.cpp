@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LuaJob.h"
+#include "common/runtime.h"
+
+namespace love
+{
+namespace thread
+{
+
+love::Type LuaJob::type("Job", &Object::type);
+
+// Converts the values returned by a job, after the destination vector.
+static int w_checkResults(lua_State *L)
+{
+	std::vector<Variant> *values = (std::vector<Variant> *) lua_touserdata(L, 1);
+	int top = lua_gettop(L);
+
+	values->reserve(top - 1);
+
+	for (int i = 2; i <= top; i++)
+	{
+		// luax_checkvariant would raise an argument error for these.
+		bool isobject = lua_type(L, i) != LUA_TUSERDATA || luax_istype(L, i, Object::type);
+
+		Variant v;
+		if (isobject)
+			luax_catchexcept(L, [&]() { v = luax_checkvariant(L, i); });
+		else
+			v = Variant::unknown();
+
+		if (v.getType() == Variant::UNKNOWN)
+			return luaL_error(L, "Job returned a value which can't be passed between threads (return value %d)", i - 1);
+
+		values->push_back(std::move(v));
+	}
+
+	return 0;
+}
+
+LuaJob::LuaJob(const std::string &name, love::Data *code, const std::vector<Variant> &args)
+	: code(code)
+	, name(name)
+	, args(args)
+	, done(false)
+{
+}
+
+LuaJob::~LuaJob()
+{
+}
+
+void LuaJob::submit(LuaWorkerPool *pool)
+{
+	// Released in complete().
+	retain();
+	pool->submitJob(this);
+}
+
+bool LuaJob::isDone() const
+{
+	Lock lock(mutex);
+	return done;
+}
+
+bool LuaJob::wait(int timeout)
+{
+	Lock lock(mutex);
+
+	while (!done)
+	{
+		if (!cond->wait(mutex, timeout) && timeout >= 0)
+			break;
+	}
+
+	return done;
+}
+
+std::vector<Variant> LuaJob::getResults() const
+{
+	Lock lock(mutex);
+	return results;
+}
+
+std::string LuaJob::getError() const
+{
+	Lock lock(mutex);
+	return error;
+}
+
+void LuaJob::run(lua_State *L)
+{
+	std::vector<Variant> values;
+	std::string err;
+
+	lua_pushcfunction(L, luax_traceback);
+	int tracebackidx = lua_gettop(L);
+
+	if (!LuaWorkerPool::loadChunk(L, code, name))
+		err = luax_tostring(L, -1);
+	else
+	{
+		int pushedargs = (int) args.size();
+
+		for (int i = 0; i < pushedargs; i++)
+			luax_pushvariant(L, args[i]);
+
+		args.clear();
+
+		if (lua_pcall(L, pushedargs, LUA_MULTRET, tracebackidx) != 0)
+			err = luax_tostring(L, -1);
+		else
+		{
+			// Converting a value can raise a Lua error or throw, so it's done
+			// in a protected call rather than on the worker's bare stack.
+			int nresults = lua_gettop(L) - tracebackidx;
+
+			if (!lua_checkstack(L, 2))
+				err = "Job returned too many values";
+			else
+			{
+				lua_pushcfunction(L, w_checkResults);
+				lua_insert(L, tracebackidx + 1);
+				lua_pushlightuserdata(L, &values);
+				lua_insert(L, tracebackidx + 2);
+			}
+
+			if (err.empty() && lua_pcall(L, nresults + 1, 0, 0) != 0)
+			{
+				err = luax_tostring(L, -1);
+				values.clear();
+			}
+		}
+	}
+
+	lua_settop(L, tracebackidx - 1);
+
+	{
+		Lock lock(mutex);
+		results = std::move(values);
+		error = err;
+	}
+
+	complete();
+}
+
+void LuaJob::cancel()
+{
+	{
+		Lock lock(mutex);
+		args.clear();
+		error = "The job was cancelled because love.thread was shut down.";
+	}
+
+	complete();
+}
+
+void LuaJob::complete()
+{
+	{
+		Lock lock(mutex);
+		done = true;
+		cond->broadcast();
+	}
+
+	// This was retained in submit().
+	release();
+}
+
+} // thread
+} // love
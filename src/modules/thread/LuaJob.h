@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LUA_JOB_H
+#define LOVE_THREAD_LUA_JOB_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "common/Variant.h"
+#include "LuaWorkerPool.h"
+#include "threads.h"
+
+// STL
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A chunk of Lua code which is called once with some arguments on one of the
+ * worker pool's Lua states. Its return values are kept for the thread which
+ * submitted it.
+ **/
+class LuaJob : public Object, public LuaWorkerPool::Task
+{
+public:
+
+	static love::Type type;
+
+	LuaJob(const std::string &name, love::Data *code, const std::vector<Variant> &args);
+	virtual ~LuaJob();
+
+	/**
+	 * Queues the job on the pool. The job stays alive until it's done.
+	 **/
+	void submit(LuaWorkerPool *pool);
+
+	bool isDone() const;
+
+	/**
+	 * Blocks until the job is done, or until the timeout (in milliseconds)
+	 * expires. A negative timeout waits indefinitely.
+	 * @return Whether the job is done.
+	 **/
+	bool wait(int timeout = -1);
+
+	/**
+	 * Gets the values returned by the job's code. Empty if the job isn't done
+	 * or failed.
+	 **/
+	std::vector<Variant> getResults() const;
+	std::string getError() const;
+
+	// Implements LuaWorkerPool::Task.
+	void run(lua_State *L) override;
+	void cancel() override;
+
+private:
+
+	void complete();
+
+	StrongRef<love::Data> code;
+	std::string name;
+	std::vector<Variant> args;
+
+	std::vector<Variant> results;
+	std::string error;
+	bool done;
+
+	MutexRef mutex;
+	ConditionalRef cond;
+
+}; // LuaJob
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LUA_JOB_H
@@ -23,11 +23,6 @@
 #include "common/config.h"
 #include "common/runtime.h"
 
-#ifdef LOVE_BUILD_STANDALONE
-extern "C" int luaopen_love(lua_State * L);
-extern "C" int luaopen_love_jitsetup(lua_State * L);
-#endif // LOVE_BUILD_STANDALONE
-
 namespace love
 {
 namespace thread
@@ -35,10 +30,12 @@ namespace thread
 
 love::Type LuaThread::type("Thread", &Threadable::type);
 
-LuaThread::LuaThread(const std::string &name, love::Data *code)
+LuaThread::LuaThread(const std::string &name, love::Data *code, LuaWorkerPool *pool)
 	: code(code)
 	, name(name)
 	, haserror(false)
+	, pool(pool)
+	, pooledRunning(false)
 {
 	threadName = name;
 }
@@ -49,38 +46,25 @@ LuaThread::~LuaThread()
 
 void LuaThread::threadFunction()
 {
-	error.clear();
-	haserror = false;
+	lua_State *L = LuaWorkerPool::newState();
 
-	lua_State *L = luaL_newstate();
-	luaL_openlibs(L);
+	runCode(L);
 
-#ifdef LOVE_BUILD_STANDALONE
-	// Call LuaJIT-specific setup again. While it's quite late to call it at
-	// this point, it still needed to turn off JIT compilation (if necessary)
-	// for this thread.
-	luax_preload(L, luaopen_love_jitsetup, "love.jitsetup");
-	luax_require(L, "love.jitsetup");
-	lua_pop(L, 1);
-
-	luax_preload(L, luaopen_love, "love");
-	luax_require(L, "love");
-	lua_pop(L, 1);
-#endif // LOVE_BUILD_STANDALONE
+	lua_close(L);
 
-	luax_require(L, "love.thread");
-	lua_pop(L, 1);
+	if (haserror)
+		onError();
+}
 
-	// We load love.filesystem by default, since require still exists without it
-	// but won't load files from the proper paths. love.filesystem also must be
-	// loaded before using any love function that can take a filepath argument.
-	luax_require(L, "love.filesystem");
-	lua_pop(L, 1);
+void LuaThread::runCode(lua_State *L)
+{
+	error.clear();
+	haserror = false;
 
 	lua_pushcfunction(L, luax_traceback);
 	int tracebackidx = lua_gettop(L);
 
-	if (luaL_loadbuffer(L, (const char *) code->getData(), code->getSize(), name.c_str()) != 0)
+	if (!LuaWorkerPool::loadChunk(L, code, name))
 	{
 		error = luax_tostring(L, -1);
 		haserror = true;
@@ -101,10 +85,7 @@ void LuaThread::threadFunction()
 		}
 	}
 
-	lua_close(L);
-
-	if (haserror)
-		onError();
+	lua_settop(L, tracebackidx - 1);
 }
 
 bool LuaThread::start(const std::vector<Variant> &args)
@@ -115,8 +96,66 @@ bool LuaThread::start(const std::vector<Variant> &args)
 	this->args = args;
 	error.clear();
 	haserror = false;
-	
-	return Threadable::start();
+
+	if (pool.get() == nullptr)
+		return Threadable::start();
+
+	{
+		Lock lock(mutex);
+		pooledRunning = true;
+	}
+
+	// Released in finishPooled, once the pool is done with this thread.
+	retain();
+	pool->runThread(this);
+
+	return true;
+}
+
+void LuaThread::wait()
+{
+	if (pool.get() == nullptr)
+		return Threadable::wait();
+
+	Lock lock(mutex);
+	while (pooledRunning)
+		cond->wait(mutex);
+}
+
+bool LuaThread::isRunning() const
+{
+	if (pool.get() == nullptr)
+		return Threadable::isRunning();
+
+	Lock lock(mutex);
+	return pooledRunning;
+}
+
+void LuaThread::run(lua_State *L)
+{
+	runCode(L);
+	finishPooled();
+}
+
+void LuaThread::cancel()
+{
+	args.clear();
+	finishPooled();
+}
+
+void LuaThread::finishPooled()
+{
+	if (haserror)
+		onError();
+
+	{
+		Lock lock(mutex);
+		pooledRunning = false;
+		cond->broadcast();
+	}
+
+	// This was retained in start().
+	release();
 }
 
 const std::string &LuaThread::getError() const
@@ -30,35 +30,55 @@
 #include "common/Object.h"
 #include "common/Variant.h"
 #include "threads.h"
+#include "LuaWorkerPool.h"
 
 namespace love
 {
 namespace thread
 {
 
-class LuaThread : public Threadable
+class LuaThread : public Threadable, public LuaWorkerPool::Task
 {
 public:
 
 	static love::Type type;
 
-	LuaThread(const std::string &name, love::Data *code);
+	/**
+	 * @param pool If not null, the thread runs its code on one of the pool's
+	 * workers instead of on a new thread with a new Lua state.
+	 **/
+	LuaThread(const std::string &name, love::Data *code, LuaWorkerPool *pool = nullptr);
 	virtual ~LuaThread();
 	void threadFunction();
 	const std::string &getError() const;
 	bool hasError() const { return haserror; }
 
 	bool start(const std::vector<Variant> &args);
+	void wait() override;
+	bool isRunning() const override;
+
+	bool isPooled() const { return pool.get() != nullptr; }
+
+	// Implements LuaWorkerPool::Task.
+	void run(lua_State *L) override;
+	void cancel() override;
 
 private:
 
+	void runCode(lua_State *L);
 	void onError();
+	void finishPooled();
 
 	StrongRef<love::Data> code;
 	std::string name;
 	std::string error;
 	bool haserror;
 
+	StrongRef<LuaWorkerPool> pool;
+	bool pooledRunning;
+	MutexRef mutex;
+	ConditionalRef cond;
+
 	std::vector<Variant> args;
 
 }; // LuaThread
@@ -0,0 +1,382 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "LuaWorkerPool.h"
+#include "common/config.h"
+#include "common/runtime.h"
+#include "timer/Timer.h"
+
+#include "libraries/xxHash/xxhash.h"
+
+// C++
+#include <algorithm>
+#include <thread>
+#include <cstdio>
+
+#ifdef LOVE_BUILD_STANDALONE
+extern "C" int luaopen_love(lua_State * L);
+extern "C" int luaopen_love_jitsetup(lua_State * L);
+#endif // LOVE_BUILD_STANDALONE
+
+// Shove the LuaWorkerPool.lua code directly into a raw string literal.
+static const char workerpool_lua[] =
+#include "LuaWorkerPool.lua"
+;
+
+namespace love
+{
+namespace thread
+{
+
+LuaWorkerPool::Worker::Worker(LuaWorkerPool *pool)
+	: pool(pool)
+{
+	threadName = "LuaWorker";
+}
+
+void LuaWorkerPool::Worker::threadFunction()
+{
+	lua_State *L = newState();
+
+	// Keep the function which resets the state between tasks.
+	int resetRef = LUA_NOREF;
+	if (luaL_loadbuffer(L, workerpool_lua, sizeof(workerpool_lua) - 1, "=[love \"LuaWorkerPool.lua\"]") == 0
+		&& lua_pcall(L, 0, 1, 0) == 0)
+		resetRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	else
+		lua_pop(L, 1);
+
+	pool->mutex->lock();
+	pool->startingWorkers--;
+
+	while (true)
+	{
+		bool isJob = false;
+		Task *task = pool->takeTask(&isJob);
+
+		if (task != nullptr)
+		{
+			pool->mutex->unlock();
+
+			task->run(L);
+
+			lua_settop(L, 0);
+			if (resetRef != LUA_NOREF)
+			{
+				lua_rawgeti(L, LUA_REGISTRYINDEX, resetRef);
+				if (lua_pcall(L, 0, 0, 0) != 0)
+					lua_pop(L, 1);
+			}
+
+			// Let go of what the task left behind, like love objects. Threads
+			// tend to hold on to more, so they get a full collection.
+			lua_gc(L, isJob ? LUA_GCSTEP : LUA_GCCOLLECT, 0);
+
+			pool->mutex->lock();
+
+			if (isJob)
+			{
+				pool->runningJobs--;
+
+				// Another worker may be waiting for a job slot.
+				if (!pool->jobQueue.empty())
+					pool->cond->broadcast();
+			}
+
+			continue;
+		}
+
+		if (pool->finish)
+			break;
+
+		pool->idleWorkers++;
+		bool signaled = pool->cond->wait(pool->mutex, IDLE_TIMEOUT);
+		pool->idleWorkers--;
+
+		// Don't hold on to a Lua state nobody has needed for a while.
+		if (!signaled && pool->threadQueue.empty() && pool->jobQueue.empty())
+			break;
+	}
+
+	bool removed = false;
+	auto it = std::find(pool->workers.begin(), pool->workers.end(), this);
+	if (it != pool->workers.end())
+	{
+		pool->workers.erase(it);
+		removed = true;
+	}
+
+	// shutdown() waits for the last worker to leave.
+	if (pool->finish)
+		pool->cond->broadcast();
+
+	pool->mutex->unlock();
+
+	lua_close(L);
+
+	// The pool's reference. The thread holds its own until this returns.
+	if (removed)
+		release();
+}
+
+LuaWorkerPool::LuaWorkerPool(int maxJobWorkers)
+	: startingWorkers(0)
+	, idleWorkers(0)
+	, runningJobs(0)
+	, maxJobWorkers(std::max(maxJobWorkers, 1))
+	, finish(false)
+{
+}
+
+LuaWorkerPool::~LuaWorkerPool()
+{
+}
+
+LuaWorkerPool::Task *LuaWorkerPool::takeTask(bool *isJob)
+{
+	if (!threadQueue.empty())
+	{
+		Task *task = threadQueue.front();
+		threadQueue.pop_front();
+		*isJob = false;
+		return task;
+	}
+
+	if (!jobQueue.empty() && runningJobs < maxJobWorkers)
+	{
+		Task *task = jobQueue.front();
+		jobQueue.pop_front();
+		runningJobs++;
+		*isJob = true;
+		return task;
+	}
+
+	return nullptr;
+}
+
+bool LuaWorkerPool::spawnWorker()
+{
+	Worker *worker = new Worker(this);
+
+	if (!worker->start())
+	{
+		worker->release();
+		return false;
+	}
+
+	workers.push_back(worker);
+	startingWorkers++;
+	return true;
+}
+
+void LuaWorkerPool::runThread(Task *task)
+{
+	Lock lock(mutex);
+
+	if (finish)
+	{
+		task->cancel();
+		return;
+	}
+
+	threadQueue.push_back(task);
+
+	// Every queued Thread needs a worker of its own: they don't wait on
+	// each other.
+	int available = idleWorkers + startingWorkers;
+	if ((int) threadQueue.size() > available && !spawnWorker() && available == 0)
+	{
+		threadQueue.pop_back();
+		task->cancel();
+		return;
+	}
+
+	cond->broadcast();
+}
+
+void LuaWorkerPool::submitJob(Task *task)
+{
+	Lock lock(mutex);
+
+	if (finish)
+	{
+		task->cancel();
+		return;
+	}
+
+	jobQueue.push_back(task);
+
+	// Workers busy with Threads don't count towards the job limit.
+	int jobWorkersNeeded = std::min((int) jobQueue.size(), maxJobWorkers - runningJobs);
+	if (jobWorkersNeeded > idleWorkers + startingWorkers)
+		spawnWorker();
+
+	cond->broadcast();
+}
+
+void LuaWorkerPool::shutdown()
+{
+	std::vector<Task *> cancelled;
+
+	{
+		Lock lock(mutex);
+
+		// Only the first call waits for the workers.
+		if (finish)
+			return;
+
+		finish = true;
+
+		cancelled.insert(cancelled.end(), threadQueue.begin(), threadQueue.end());
+		cancelled.insert(cancelled.end(), jobQueue.begin(), jobQueue.end());
+		threadQueue.clear();
+		jobQueue.clear();
+
+		cond->broadcast();
+	}
+
+	for (Task *task : cancelled)
+		task->cancel();
+
+	// Workers take themselves out of the list as they exit. Any which are
+	// left after the timeout keep their own references to the pool and
+	// their Threadable, so letting go of them here is safe.
+	Lock lock(mutex);
+
+	double timeout = SHUTDOWN_TIMEOUT / 1000.0;
+	while (!workers.empty() && timeout > 0.0)
+	{
+		double start = love::timer::Timer::getTime();
+		cond->wait(mutex, (int) (timeout * 1000));
+		timeout -= love::timer::Timer::getTime() - start;
+	}
+}
+
+int LuaWorkerPool::getWorkerCount() const
+{
+	Lock lock(mutex);
+	return (int) workers.size();
+}
+
+int LuaWorkerPool::getMaxJobWorkers() const
+{
+	return maxJobWorkers;
+}
+
+int LuaWorkerPool::getDefaultMaxJobWorkers()
+{
+	// Leave a core for the main thread.
+	int cores = (int) std::thread::hardware_concurrency();
+	return std::max(cores - 1, 1);
+}
+
+lua_State *LuaWorkerPool::newState()
+{
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+
+	// Tells love.thread this isn't the state which owns the engine.
+	lua_pushboolean(L, 1);
+	lua_setfield(L, LUA_REGISTRYINDEX, "_love_thread_state");
+
+#ifdef LOVE_BUILD_STANDALONE
+	// Call LuaJIT-specific setup again. While it's quite late to call it at
+	// this point, it still needed to turn off JIT compilation (if necessary)
+	// for this thread.
+	luax_preload(L, luaopen_love_jitsetup, "love.jitsetup");
+	luax_require(L, "love.jitsetup");
+	lua_pop(L, 1);
+
+	luax_preload(L, luaopen_love, "love");
+	luax_require(L, "love");
+	lua_pop(L, 1);
+#endif // LOVE_BUILD_STANDALONE
+
+	luax_require(L, "love.thread");
+	lua_pop(L, 1);
+
+	// We load love.filesystem by default, since require still exists without it
+	// but won't load files from the proper paths. love.filesystem also must be
+	// loaded before using any love function that can take a filepath argument.
+	luax_require(L, "love.filesystem");
+	lua_pop(L, 1);
+
+	return L;
+}
+
+bool LuaWorkerPool::loadChunk(lua_State *L, love::Data *code, const std::string &name)
+{
+	const char *data = (const char *) code->getData();
+	size_t size = code->getSize();
+
+	char hash[17];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long) XXH64(data, size, 0));
+	std::string key = std::string(hash) + name;
+
+	lua_getfield(L, LUA_REGISTRYINDEX, "_love_thread_chunks");
+	if (!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, "_love_thread_chunks");
+	}
+
+	lua_getfield(L, -1, key.c_str());
+	if (lua_isfunction(L, -1))
+	{
+		lua_remove(L, -2);
+		return true;
+	}
+	lua_pop(L, 1);
+
+	if (luaL_loadbuffer(L, data, size, name.c_str()) != 0)
+	{
+		lua_remove(L, -2);
+		return false;
+	}
+
+	// The chunk count is kept at index 1, which no chunk's key can be.
+	lua_rawgeti(L, -2, 1);
+	int count = (int) lua_tointeger(L, -1) + 1;
+	lua_pop(L, 1);
+
+	if (count > MAX_CACHED_CHUNKS)
+	{
+		// Start over rather than track which chunks were used least.
+		lua_newtable(L);
+		lua_replace(L, -3);
+		lua_pushvalue(L, -2);
+		lua_setfield(L, LUA_REGISTRYINDEX, "_love_thread_chunks");
+		count = 1;
+	}
+
+	lua_pushinteger(L, count);
+	lua_rawseti(L, -3, 1);
+
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -3, key.c_str());
+
+	lua_remove(L, -2);
+	return true;
+}
+
+} // thread
+} // love
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_LUA_WORKER_POOL_H
+#define LOVE_THREAD_LUA_WORKER_POOL_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "threads.h"
+
+// STL
+#include <string>
+#include <deque>
+#include <vector>
+
+struct lua_State;
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * Threads which each keep a Lua state with love, love.thread and
+ * love.filesystem loaded, and run Lua code in it one task at a time. After
+ * each task the globals, the standard library and love tables, and
+ * package.loaded are put back the way they were after startup (see
+ * LuaWorkerPool.lua for what isn't.)
+ *
+ * Idle workers wait for more work, and exit after being idle for a while.
+ **/
+class LuaWorkerPool : public Object
+{
+public:
+
+	/**
+	 * Work for a worker thread. The pool calls either run() or cancel()
+	 * exactly once; tasks keep themselves alive until then.
+	 **/
+	class Task
+	{
+	public:
+		virtual ~Task() {}
+		virtual void run(lua_State *L) = 0;
+
+		// The pool was shut down before the task could start.
+		virtual void cancel() = 0;
+	};
+
+	// Idle workers exit after this many milliseconds.
+	static const int IDLE_TIMEOUT = 10000;
+
+	// How long shutdown() waits for running workers, in milliseconds.
+	static const int SHUTDOWN_TIMEOUT = 1000;
+
+	// Compiled chunks kept per worker, so code which runs often isn't parsed
+	// every time.
+	static const int MAX_CACHED_CHUNKS = 64;
+
+	LuaWorkerPool(int maxJobWorkers);
+	virtual ~LuaWorkerPool();
+
+	/**
+	 * Runs a task right away, on an idle worker or a new one. For Threads,
+	 * which may run for as long as they like.
+	 **/
+	void runThread(Task *task);
+
+	/**
+	 * Queues a task. At most maxJobWorkers workers run queued tasks at once.
+	 **/
+	void submitJob(Task *task);
+
+	/**
+	 * Cancels queued tasks, and waits up to SHUTDOWN_TIMEOUT for the workers
+	 * to exit. Workers running a task exit when it returns. Threads may run
+	 * forever (e.g. looping on Channel:demand), so workers still busy after
+	 * the timeout are detached and left to finish on their own, like a
+	 * love.thread Thread which is collected while running.
+	 **/
+	void shutdown();
+
+	int getWorkerCount() const;
+	int getMaxJobWorkers() const;
+
+	static int getDefaultMaxJobWorkers();
+
+	/**
+	 * Creates a Lua state with love, love.thread and love.filesystem loaded,
+	 * for a Thread or a worker.
+	 **/
+	static lua_State *newState();
+
+	/**
+	 * Pushes the code as a function, compiling it only if this state hasn't
+	 * already. Pushes an error message on failure.
+	 * @return Whether the function was pushed.
+	 **/
+	static bool loadChunk(lua_State *L, love::Data *code, const std::string &name);
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+		Worker(LuaWorkerPool *pool);
+		virtual ~Worker() {}
+		void threadFunction();
+
+	private:
+		StrongRef<LuaWorkerPool> pool;
+	};
+
+	// Takes the next task a worker may run. Called with the mutex held.
+	Task *takeTask(bool *isJob);
+
+	// Starts another worker. Called with the mutex held.
+	bool spawnWorker();
+
+	std::deque<Task *> threadQueue;
+	std::deque<Task *> jobQueue;
+
+	std::vector<Worker *> workers;
+
+	// Workers which are started but haven't looked for a task yet count as
+	// idle when deciding whether to start another.
+	int startingWorkers;
+	int idleWorkers;
+	int runningJobs;
+	int maxJobWorkers;
+	bool finish;
+
+	mutable MutexRef mutex;
+	ConditionalRef cond;
+
+}; // LuaWorkerPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_LUA_WORKER_POOL_H
@@ -0,0 +1,93 @@
+R"luastring"--(
+-- DO NOT REMOVE THE ABOVE LINE. It is used to load this file as a C++ string.
+-- There is a matching delimiter at the bottom of the file.
+
+--[[
+Copyright (c) 2006-2024 LOVE Development Team
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+--]]
+
+-- Snapshots the globals and loaded modules of a worker's fresh Lua state, and
+-- returns a function which restores them after each task.
+--
+-- Tables up to two levels below _G are restored, which covers the standard
+-- libraries (string, math, ...), love and its modules (love.filesystem, ...)
+-- and package.loaded. Changes deeper than that, to the metatables of love
+-- objects, or to values captured as upvalues still carry over to later tasks.
+
+local G = _G
+local setmetatable, getmetatable = setmetatable, getmetatable
+local next, type, pcall, rawget, rawset, rawequal = next, type, pcall, rawget, rawset, rawequal
+
+local MAX_DEPTH = 2
+
+local saved = {}
+
+local function snapshot(t, depth, seen)
+	if seen[t] then
+		return
+	end
+	seen[t] = true
+
+	local contents = {}
+	for k, v in next, t do
+		contents[k] = v
+	end
+	saved[#saved + 1] = {t, contents, getmetatable(t)}
+
+	if depth < MAX_DEPTH then
+		for _, v in next, contents do
+			if type(v) == "table" then
+				snapshot(v, depth + 1, seen)
+			end
+		end
+	end
+end
+
+local function restore(t, contents)
+	local added = {}
+	for k in next, t do
+		if rawget(contents, k) == nil then
+			added[#added + 1] = k
+		end
+	end
+	for i = 1, #added do
+		rawset(t, added[i], nil)
+	end
+	for k, v in next, contents do
+		if not rawequal(rawget(t, k), v) then
+			rawset(t, k, v)
+		end
+	end
+end
+
+snapshot(G, 0, {})
+
+return function()
+	for i = 1, #saved do
+		local entry = saved[i]
+		-- A protected metatable can't be put back; keep what's there.
+		if not rawequal(getmetatable(entry[1]), entry[3]) then
+			pcall(setmetatable, entry[1], entry[3])
+		end
+		restore(entry[1], entry[2])
+	end
+end
+
+-- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
+--)luastring"--"
@@ -30,17 +30,29 @@ ThreadModule::ThreadModule()
 {
 }
 
-LuaThread *ThreadModule::newThread(const std::string &name, love::Data *data)
+ThreadModule::~ThreadModule()
 {
-	return new LuaThread(name, data);
+	shutdownPool();
 }
 
-Channel *ThreadModule::newChannel()
+LuaThread *ThreadModule::newThread(const std::string &name, love::Data *data, bool pooled)
 {
-	return new Channel();
+	return new LuaThread(name, data, pooled ? getPool() : nullptr);
 }
 
-Channel *ThreadModule::getChannel(const std::string &name)
+LuaJob *ThreadModule::runJob(const std::string &name, love::Data *data, const std::vector<Variant> &args)
+{
+	LuaJob *job = new LuaJob(name, data, args);
+	job->submit(getPool());
+	return job;
+}
+
+Channel *ThreadModule::newChannel(Channel::Mode mode, int capacity)
+{
+	return new Channel(mode, capacity);
+}
+
+Channel *ThreadModule::getChannel(const std::string &name, Channel::Mode mode, int capacity)
 {
 	Lock lock(namedChannelMutex);
 
@@ -48,10 +60,33 @@ Channel *ThreadModule::getChannel(const std::string &name)
 	if (it != namedChannels.end())
 		return it->second;
 
-	Channel *c = new Channel();
+	Channel *c = new Channel(mode, capacity);
 	namedChannels[name].set(c, Acquire::NORETAIN);
 	return c;
 }
 
+void ThreadModule::shutdownPool()
+{
+	StrongRef<LuaWorkerPool> p;
+
+	{
+		Lock lock(poolMutex);
+		p = pool;
+	}
+
+	if (p.get() != nullptr)
+		p->shutdown();
+}
+
+LuaWorkerPool *ThreadModule::getPool()
+{
+	Lock lock(poolMutex);
+
+	if (pool.get() == nullptr)
+		pool.set(new LuaWorkerPool(LuaWorkerPool::getDefaultMaxJobWorkers()), Acquire::NORETAIN);
+
+	return pool;
+}
+
 } // thread
 } // love
@@ -33,6 +33,8 @@
 #include "Thread.h"
 #include "Channel.h"
 #include "LuaThread.h"
+#include "LuaJob.h"
+#include "LuaWorkerPool.h"
 #include "threads.h"
 
 namespace love
@@ -44,13 +46,40 @@ class ThreadModule : public love::Module
 public:
 
 	ThreadModule();
-	virtual ~ThreadModule() {}
-	virtual LuaThread *newThread(const std::string &name, love::Data *data);
-	virtual Channel *newChannel();
-	virtual Channel *getChannel(const std::string &name);
+	virtual ~ThreadModule();
+
+	/**
+	 * @param pooled Whether the thread should run on one of the worker pool's
+	 * Lua states, rather than on a new thread with a new Lua state.
+	 **/
+	virtual LuaThread *newThread(const std::string &name, love::Data *data, bool pooled = false);
+
+	/**
+	 * Queues code to be called with the given arguments on the worker pool.
+	 **/
+	virtual LuaJob *runJob(const std::string &name, love::Data *data, const std::vector<Variant> &args);
+
+	/**
+	 * Cancels queued jobs and pooled Threads, and waits for the worker pool's
+	 * threads to exit. Called when the Lua state which owns the engine is
+	 * closed, since worker states keep this module alive.
+	 **/
+	void shutdownPool();
+	virtual Channel *newChannel(Channel::Mode mode = Channel::MODE_LOCKED, int capacity = Channel::DEFAULT_CAPACITY);
+
+	/**
+	 * The mode and capacity are only used when the named Channel doesn't
+	 * exist yet.
+	 **/
+	virtual Channel *getChannel(const std::string &name, Channel::Mode mode = Channel::MODE_LOCKED, int capacity = Channel::DEFAULT_CAPACITY);
 
 private:
 
+	LuaWorkerPool *getPool();
+
+	StrongRef<LuaWorkerPool> pool;
+	MutexRef poolMutex;
+
 	std::map<std::string, StrongRef<Channel>> namedChannels;
 	MutexRef namedChannelMutex;
 
@@ -92,6 +92,8 @@ int Thread::thread_runner(void *data)
 {
 	Thread *self = (Thread *) data; // some compilers don't like 'this'
 
+	EngineContext::Scope scope(self->t->getEngineContext());
+
 	self->t->threadFunction();
 
 	{
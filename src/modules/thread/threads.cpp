@@ -88,6 +88,7 @@ void EmptyLock::setLock(Mutex &m)
 love::Type Threadable::type("Threadable", &Object::type);
 
 Threadable::Threadable()
+	: context(EngineContext::getCurrent())
 {
 	owner = newThread(this);
 }
@@ -117,6 +118,11 @@ const char *Threadable::getThreadName() const
 	return threadName.empty() ? nullptr : threadName.c_str();
 }
 
+EngineContext *Threadable::getEngineContext() const
+{
+	return context.get();
+}
+
 MutexRef::MutexRef()
 	: mutex(newMutex())
 {
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/EngineContext.h"
 #include "Thread.h"
 
 // C++
@@ -88,14 +89,21 @@ class Threadable : public love::Object
 	virtual void threadFunction() = 0;
 
 	bool start();
-	void wait();
-	bool isRunning() const;
+	virtual void wait();
+	virtual bool isRunning() const;
 	const char *getThreadName() const;
 
+	/**
+	 * Gets the EngineContext the thread runs in. This is the context of the
+	 * thread which created the Threadable.
+	 **/
+	EngineContext *getEngineContext() const;
+
 protected:
 
 	Thread *owner;
 	std::string threadName;
+	StrongRef<EngineContext> context;
 
 };
 
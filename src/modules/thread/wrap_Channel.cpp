@@ -20,6 +20,10 @@
 
 #include "wrap_Channel.h"
 
+// C++
+#include <limits>
+#include <vector>
+
 namespace love
 {
 namespace thread
@@ -43,6 +47,41 @@ int w_Channel_push(lua_State *L)
 	return 1;
 }
 
+int w_Channel_pushMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, 2);
+	int invalid = 0;
+	uint64 id = 0;
+
+	luax_catchexcept(L, [&]() {
+		std::vector<Variant> vars;
+		vars.reserve(count);
+
+		for (int i = 1; i <= count && invalid == 0; i++)
+		{
+			lua_rawgeti(L, 2, i);
+			vars.push_back(luax_checkvariant(L, -1));
+			lua_pop(L, 1);
+
+			if (vars.back().getType() == Variant::UNKNOWN)
+				invalid = i;
+		}
+
+		// Nothing is pushed unless every value can be.
+		if (invalid == 0)
+			id = c->push(vars);
+	});
+
+	if (invalid != 0)
+		return luaL_error(L, "Value %d: boolean, number, string, love type, or table expected", invalid);
+
+	lua_pushnumber(L, (lua_Number) id);
+	return 1;
+}
+
 int w_Channel_supply(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -72,6 +111,23 @@ int w_Channel_pop(lua_State *L)
 	return 1;
 }
 
+int w_Channel_popAll(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	int max = (int) luaL_optinteger(L, 2, std::numeric_limits<int>::max());
+
+	std::vector<Variant> vars;
+	int count = c->pop(vars, max);
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		luax_pushvariant(L, vars[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
 int w_Channel_demand(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -94,7 +150,9 @@ int w_Channel_peek(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	Variant var;
-	if (c->peek(&var))
+	bool result = false;
+	luax_catchexcept(L, [&]() { result = c->peek(&var); });
+	if (result)
 		luax_pushvariant(L, var);
 	else
 		lua_pushnil(L);
@@ -123,11 +181,26 @@ int w_Channel_clear(lua_State *L)
 	return 0;
 }
 
+int w_Channel_getMode(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	const char *str = nullptr;
+	if (!Channel::getConstant(c->getMode(), str))
+		return luaL_error(L, "Unknown Channel mode.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_Channel_performAtomic(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	luaL_checktype(L, 2, LUA_TFUNCTION);
 
+	// Lock-free pushes and pops don't take the mutex, so it can't make them
+	// atomic.
+	if (c->getMode() != Channel::MODE_LOCKED)
+		return luaL_error(L, "performAtomic can only be used with locked Channels.");
+
 	// Pass this channel as an argument to the function.
 	lua_pushvalue(L, 1);
 	lua_insert(L, 3);
@@ -153,13 +226,16 @@ int w_Channel_performAtomic(lua_State *L)
 static const luaL_Reg w_Channel_functions[] =
 {
 	{ "push", w_Channel_push },
+	{ "pushMany", w_Channel_pushMany },
 	{ "supply", w_Channel_supply },
 	{ "pop", w_Channel_pop },
+	{ "popAll", w_Channel_popAll },
 	{ "demand", w_Channel_demand },
 	{ "peek", w_Channel_peek },
 	{ "getCount", w_Channel_getCount },
 	{ "hasRead", w_Channel_hasRead },
 	{ "clear", w_Channel_clear },
+	{ "getMode", w_Channel_getMode },
 	{ "performAtomic", w_Channel_performAtomic },
 	{ 0, 0 }
 };
@@ -77,12 +77,20 @@ int w_Thread_isRunning(lua_State *L)
 	return 1;
 }
 
+int w_Thread_isPooled(lua_State *L)
+{
+	LuaThread *t = luax_checkthread(L, 1);
+	luax_pushboolean(L, t->isPooled());
+	return 1;
+}
+
 static const luaL_Reg w_Thread_functions[] =
 {
 	{ "start", w_Thread_start },
 	{ "wait", w_Thread_wait },
 	{ "getError", w_Thread_getError },
 	{ "isRunning", w_Thread_isRunning },
+	{ "isPooled", w_Thread_isPooled },
 	{ 0, 0 }
 };
 
@@ -22,6 +22,7 @@
 #include "wrap_ThreadModule.h"
 #include "wrap_LuaThread.h"
 #include "wrap_Channel.h"
+#include "wrap_LuaJob.h"
 #include "ThreadModule.h"
 
 #include "filesystem/File.h"
@@ -37,9 +38,9 @@ namespace thread
 
 #define instance() (Module::getInstance<ThreadModule>(Module::M_THREAD))
 
-int w_newThread(lua_State *L)
+// Converts the code argument of newThread and runJob to a Data.
+static love::Data *checkCode(lua_State *L, std::string &name)
 {
-	std::string name = "Thread code";
 	love::Data *data = nullptr;
 
 	if (lua_isstring(L, 1))
@@ -75,15 +76,65 @@ int w_newThread(lua_State *L)
 		data = luax_checktype<love::Data>(L, 1);
 	}
 
-	LuaThread *t = instance()->newThread(name, data);
+	return data;
+}
+
+int w_newThread(lua_State *L)
+{
+	std::string name = "Thread code";
+	love::Data *data = checkCode(L, name);
+	bool pooled = luax_optboolean(L, 2, false);
+
+	LuaThread *t = instance()->newThread(name, data, pooled);
 	luax_pushtype(L, t);
 	t->release();
 	return 1;
 }
 
+int w_runJob(lua_State *L)
+{
+	std::string name = "Job code";
+	love::Data *data = checkCode(L, name);
+
+	std::vector<Variant> args;
+	int nargs = lua_gettop(L) - 1;
+
+	for (int i = 0; i < nargs; ++i)
+	{
+		luax_catchexcept(L, [&]() {
+			args.push_back(luax_checkvariant(L, i+2));
+		});
+
+		if (args.back().getType() == Variant::UNKNOWN)
+		{
+			args.clear();
+			return luaL_argerror(L, i+2, "boolean, number, string, love type, or flat table expected");
+		}
+	}
+
+	LuaJob *j = nullptr;
+	luax_catchexcept(L, [&]() { j = instance()->runJob(name, data, args); });
+	luax_pushtype(L, j);
+	j->release();
+	return 1;
+}
+
+static Channel::Mode checkChannelMode(lua_State *L, int idx)
+{
+	Channel::Mode mode = Channel::MODE_LOCKED;
+	const char *str = lua_isnoneornil(L, idx) ? nullptr : luaL_checkstring(L, idx);
+	if (str != nullptr && !Channel::getConstant(str, mode))
+		luax_enumerror(L, "channel mode", Channel::getConstants(mode), str);
+	return mode;
+}
+
 int w_newChannel(lua_State *L)
 {
-	Channel *c = instance()->newChannel();
+	Channel::Mode mode = checkChannelMode(L, 1);
+	int capacity = (int) luaL_optinteger(L, 2, Channel::DEFAULT_CAPACITY);
+
+	Channel *c = nullptr;
+	luax_catchexcept(L, [&]() { c = instance()->newChannel(mode, capacity); });
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
@@ -92,7 +143,11 @@ int w_newChannel(lua_State *L)
 int w_getChannel(lua_State *L)
 {
 	std::string name = luax_checkstring(L, 1);
-	Channel *c = instance()->getChannel(name);
+	Channel::Mode mode = checkChannelMode(L, 2);
+	int capacity = (int) luaL_optinteger(L, 3, Channel::DEFAULT_CAPACITY);
+
+	Channel *c = nullptr;
+	luax_catchexcept(L, [&]() { c = instance()->getChannel(name, mode, capacity); });
 	luax_pushtype(L, c);
 	return 1;
 }
@@ -101,6 +156,7 @@ int w_getChannel(lua_State *L)
 static const luaL_Reg module_functions[] =
 {
 	{ "newThread", w_newThread },
+	{ "runJob", w_runJob },
 	{ "newChannel", w_newChannel },
 	{ "getChannel", w_getChannel },
 	{ 0, 0 }
@@ -109,9 +165,18 @@ static const luaL_Reg module_functions[] =
 static const lua_CFunction types[] = {
 	luaopen_thread,
 	luaopen_channel,
+	luaopen_job,
 	0
 };
 
+static int w_poolSentinel_gc(lua_State *L)
+{
+	ThreadModule *m = *(ThreadModule **) lua_touserdata(L, 1);
+	m->shutdownPool();
+	m->release();
+	return 0;
+}
+
 extern "C" int luaopen_love_thread(lua_State *L)
 {
 	ThreadModule *instance = instance();
@@ -122,6 +187,26 @@ extern "C" int luaopen_love_thread(lua_State *L)
 	else
 		instance->retain();
 
+	// Worker states keep the module alive, so the destructor can't be relied
+	// on to stop them. Stop them when the state which owns the engine closes
+	// instead, before its modules go away.
+	lua_getfield(L, LUA_REGISTRYINDEX, "_love_thread_state");
+	bool isthreadstate = lua_toboolean(L, -1) != 0;
+	lua_pop(L, 1);
+
+	if (!isthreadstate)
+	{
+		ThreadModule **sentinel = (ThreadModule **) lua_newuserdata(L, sizeof(ThreadModule *));
+		*sentinel = instance;
+		instance->retain();
+
+		lua_newtable(L);
+		lua_pushcfunction(L, w_poolSentinel_gc);
+		lua_setfield(L, -2, "__gc");
+		lua_setmetatable(L, -2);
+		lua_setfield(L, LUA_REGISTRYINDEX, "_love_thread_pool_sentinel");
+	}
+
 	WrappedModule w;
 	w.module = instance;
 	w.name = "thread";
@@ -22,6 +22,8 @@
 #include "common/config.h"
 #include "common/int.h"
 #include "common/delay.h"
+#include "common/EngineContext.h"
+#include "plugin/Host.h"
 #include "Timer.h"
 
 #include <iostream>
@@ -51,6 +53,7 @@ Timer::Timer()
 	, fpsUpdateFrequency(1)
 	, frames(0)
 	, dt(0)
+	, usingHostClock(false)
 {
 	prevFpsUpdate = currTime = getTime();
 }
@@ -63,8 +66,27 @@ double Timer::step()
 	// "Current" time is previous time by now.
 	prevTime = currTime;
 
-	// Get time from system.
-	currTime = getTime();
+	// When a plugin host renders offline, game time follows its sample clock.
+	plugin::Host *host = EngineContext::getCurrent()->getHost();
+	double hostDelta = host != nullptr ? host->advanceTick() : -1.0;
+
+	if (hostDelta >= 0.0)
+	{
+		currTime = prevTime + hostDelta;
+		usingHostClock = true;
+	}
+	else if (usingHostClock)
+	{
+		// Back to real time. Restart from the system clock without a jump.
+		usingHostClock = false;
+		prevTime = prevFpsUpdate = currTime = getTime();
+		frames = 0;
+	}
+	else
+	{
+		// Get time from system.
+		currTime = getTime();
+	}
 
 	// Convert to number of seconds.
 	dt = currTime - prevTime;
@@ -38,7 +38,9 @@ class Timer : public Module
 
 	/**
 	 * Measures the time between this call and the previous call,
-	 * and updates internal values accordingly.
+	 * and updates internal values accordingly. While a plugin host renders
+	 * offline, this instead waits for the host's sample clock and returns
+	 * the fixed tick length.
 	 **/
 	double step();
 
@@ -97,6 +99,9 @@ class Timer : public Module
 	// The current timestep.
 	double dt;
 
+	// Whether the last step was timed by a plugin host's offline clock.
+	bool usingHostClock;
+
 }; // Timer
 
 } // timer
@@ -20,6 +20,7 @@
 
 // LOVE
 #include "common/config.h"
+#include "common/EngineContext.h"
 #include "graphics/Graphics.h"
 #ifdef LOVE_GRAPHICS_VULKAN
 #	include "graphics/vulkan/Graphics.h"
@@ -328,7 +329,6 @@ bool Window::createWindowAndContext(int x, int y, int w, int h, Uint32 windowfla
 		if (window)
 		{
 			SDL_DestroyWindow(window);
-			SDL_FlushEvents(SDL_EVENT_WINDOW_FIRST, SDL_EVENT_WINDOW_LAST);
 			window = nullptr;
 		}
 
@@ -338,11 +338,9 @@ bool Window::createWindowAndContext(int x, int y, int w, int h, Uint32 windowfla
 			return 0;
 		}
 		
-		// Awful hack pt.2
-		std::string wndStr;
-		wndStr.reserve(32768);
-		GetEnvironmentVariable("WNDVAL_BALATROVST", &wndStr[0], 32768);
-		unsigned _int64 windowProc = std::stoi(wndStr);
+		// When embedded by a host (e.g. a plugin instance), the host hands
+		// each EngineContext the native window to render into.
+		void *hostWindow = EngineContext::getCurrent()->getParentWindow();
 
 		SDL_SetStringProperty(props, SDL_PROP_WINDOW_CREATE_TITLE_STRING, title.c_str());
 		SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_RESIZABLE_BOOLEAN, true);
@@ -350,7 +348,12 @@ bool Window::createWindowAndContext(int x, int y, int w, int h, Uint32 windowfla
 		SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_VULKAN_BOOLEAN, true);
 		SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_WIDTH_NUMBER, 1280);
 		SDL_SetNumberProperty(props, SDL_PROP_WINDOW_CREATE_HEIGHT_NUMBER, 720);
-		SDL_SetPointerProperty(props, SDL_PROP_WINDOW_CREATE_WIN32_HWND_POINTER, (HWND)windowProc);
+#ifdef LOVE_WINDOWS
+		if (hostWindow != nullptr)
+			SDL_SetPointerProperty(props, SDL_PROP_WINDOW_CREATE_WIN32_HWND_POINTER, (HWND) hostWindow);
+#else
+		LOVE_UNUSED(hostWindow);
+#endif
 
 		window = SDL_CreateWindowWithProperties(props);
 		//window = SDL_CreateWindow(title.c_str(), w, h, windowflags);
@@ -863,8 +866,8 @@ void Window::close(bool allowExceptions)
 		window = nullptr;
 
 		// The old window may have generated pending events which are no longer
-		// relevant. Destroy them all!
-		SDL_FlushEvents(SDL_EVENT_WINDOW_FIRST, SDL_EVENT_WINDOW_LAST);
+		// relevant. love.event drops them once it sees the window is gone;
+		// flushing SDL's queue here would also lose other contexts' events.
 	}
 
 	open = false;
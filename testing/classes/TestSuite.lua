@@ -41,6 +41,7 @@ TestSuite = {
       math = {},
       mouse = {},
       physics = {},
+      plugin = {},
       sensor = {},
       sound = {},
       system = {},
@@ -7,6 +7,14 @@ function love.conf(t)
   t.window.resizable = true
   t.window.depth = true
   t.window.stencil = true
+  -- '--audio soft' runs the tests against another audio backend
+  local args = love.parsedGameArguments or {}
+  for a=1,#args-1 do
+    if args[a] == '--audio' then
+      AUDIO_BACKEND = args[a+1]
+      t.audio.backend = AUDIO_BACKEND
+    end
+  end
 end
 
 -- custom crash message here to catch anything that might occur with modules 
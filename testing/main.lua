@@ -21,6 +21,7 @@ if love.keyboard ~= nil then require('tests.keyboard') end
 if love.math ~= nil then require('tests.math') end
 if love.mouse ~= nil then require('tests.mouse') end
 if love.physics ~= nil then require('tests.physics') end
+if love.plugin ~= nil then require('tests.plugin') end
 if love.sensor ~= nil then require('tests.sensor') end
 if love.sound ~= nil then require('tests.sound') end
 if love.system ~= nil then require('tests.system') end
@@ -80,7 +81,7 @@ love.load = function(args)
   local cmderr = 'Invalid flag used'
   local modules = {
     'audio', 'data', 'event', 'filesystem', 'font', 'graphics', 'image',
-    'joystick', 'keyboard', 'love', 'math', 'mouse', 'physics', 'sensor',
+    'joystick', 'keyboard', 'love', 'math', 'mouse', 'physics', 'plugin', 'sensor',
     'sound', 'system', 'thread', 'timer', 'touch', 'video', 'window'
   }
   GITHUB_RUNNER = false
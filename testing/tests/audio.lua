@@ -86,6 +86,31 @@ love.test.audio.Source = function(test)
   stereo:stop()
   test:assertFalse(stereo:isPlaying(), 'check stopped playing')
 
+  -- check priority
+  test:assertEquals(0, stereo:getPriority(), 'check default priority')
+  stereo:setPriority(2)
+  test:assertEquals(2, stereo:getPriority(), 'check set priority')
+  test:assertFalse(stereo:isVirtual(), 'check stopped not virtual')
+
+  -- check playing more sources than there are voices
+  local voices = {}
+  for i=1,80 do
+    voices[i] = stereo:clone()
+    voices[i]:setLooping(true)
+    test:assertTrue(voices[i]:play(), 'check voice ' .. tostring(i) .. ' plays')
+  end
+  -- the software mixer has enough voices for all of them
+  if love.audio.getBackend() == 'openal' then
+    local virtual = 0
+    for i=1,80 do
+      if voices[i]:isVirtual() then virtual = virtual + 1 end
+    end
+    test:assertTrue(virtual > 0, 'check some voices are virtual')
+  end
+  test:assertEquals(80, love.audio.getActiveSourceCount(), 'check virtual voices are active')
+  love.audio.stop(voices)
+  test:assertFalse(voices[80]:isVirtual(), 'check stopped voices not virtual')
+
   -- check volume limits
   stereo:setVolumeLimits(0.1, 0.5)
   local min, max = stereo:getVolumeLimits()
@@ -184,7 +209,9 @@ love.test.audio.Source = function(test)
   })
 
   -- both these fail on 12 using stereo or mono, no err
-  test:assertTrue(seteffect, 'check effect was applied')
+  if love.audio.getBackend() == 'openal' then
+    test:assertTrue(seteffect, 'check effect was applied')
+  end
   local filtersettings = effsource:getEffect('effectthatdoesntexist', {})
   test:assertNotNil(filtersettings)
 
@@ -204,6 +231,9 @@ end
 
 -- love.audio.getActiveEffects
 love.test.audio.getActiveEffects = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('effects need the openal backend')
+  end
   -- check we get a value
   test:assertNotNil(love.audio.getActiveEffects())
   -- check setting an effect active
@@ -231,6 +261,47 @@ love.test.audio.getActiveSourceCount = function(test)
 end
 
 
+-- love.audio.getBackend
+love.test.audio.getBackend = function(test)
+  local backend = love.audio.getBackend()
+  test:assertMatch({'openal', 'soft', 'null'}, backend, 'check known backend')
+  -- set with '--audio soft', see conf.lua
+  if AUDIO_BACKEND ~= nil then
+    test:assertEquals(AUDIO_BACKEND, backend, 'check configured backend')
+  end
+  -- the software mixer always knows its rate
+  if backend == 'soft' then
+    test:assertGreaterEqual(1, love.audio.getOutputSampleRate(), 'check mixer rate')
+  end
+end
+
+
+-- love.audio.getCacheStats
+love.test.audio.getCacheStats = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('cached sources need the openal backend')
+  end
+  -- check loading the same file twice shares the decoded audio
+  love.audio.setCacheLimit(0)
+  love.audio.setCacheLimit(64*1024*1024)
+  local before = love.audio.getCacheStats()
+  test:assertEquals(0, before.entries, 'check cache emptied')
+  local first = love.audio.newSource('resources/pop.ogg', 'static')
+  local second = love.audio.newSource('resources/pop.ogg', 'static')
+  local after = love.audio.getCacheStats()
+  test:assertEquals(1, after.entries, 'check one entry')
+  test:assertEquals(before.hits + 1, after.hits, 'check second load hit')
+  test:assertEquals(first:getDuration(), second:getDuration(), 'check same audio')
+  -- check lowering the limit evicts
+  love.audio.setCacheLimit(1)
+  test:assertEquals(0, love.audio.getCacheStats().entries, 'check evicted')
+  test:assertEquals(1, love.audio.getCacheLimit(), 'check limit set')
+  love.audio.setCacheLimit(64*1024*1024)
+  first:release()
+  second:release()
+end
+
+
 -- love.audio.getDistanceModel
 love.test.audio.getDistanceModel = function(test)
   -- check we get a value
@@ -256,6 +327,9 @@ end
 
 -- love.audio.getEffect
 love.test.audio.getEffect = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('effects need the openal backend')
+  end
   -- check getting a non-existent effect
   test:assertEquals(nil, love.audio.getEffect('madeupname'), 'check wrong name')
   -- check getting a valid effect
@@ -299,6 +373,12 @@ love.test.audio.getOrientation = function(test)
 end
 
 
+-- love.audio.getOutputSampleRate
+love.test.audio.getOutputSampleRate = function(test)
+  test:assertGreaterEqual(0, love.audio.getOutputSampleRate(), 'check not negative')
+end
+
+
 -- love.audio.getPlaybackDevice
 love.test.audio.getPlaybackDevice = function(test)
   test:assertNotNil(love.audio.getPlaybackDevice)
@@ -332,6 +412,51 @@ love.test.audio.getRecordingDevices = function(test)
 end
 
 
+-- love.audio.getStats
+love.test.audio.getStats = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('stream stats need the openal backend')
+  end
+  -- check we get totals
+  local before = love.audio.getStats()
+  test:assertNotNil(before.activesources)
+  test:assertNotNil(before.lockwaittime)
+  -- check playing a stream uploads buffers and is listed
+  local stream = love.audio.newSource('resources/tone.ogg', 'stream')
+  stream:play()
+  local stats = love.audio.getStats()
+  test:assertGreaterEqual(before.buffersqueued + 1, stats.buffersqueued, 'check buffers queued')
+  test:assertGreaterEqual(before.bytesuploaded + 1, stats.bytesuploaded, 'check bytes uploaded')
+  test:assertNotNil(stats.streams[stream], 'check stream listed')
+  test:assertGreaterEqual(1, stream:getStats().buffersqueued, 'check source counters')
+  stream:stop()
+  test:assertEquals(nil, love.audio.getStats().streams[stream], 'check stopped stream not listed')
+  stream:release()
+  -- check the stream's decoder is freed once a worker is done with it
+  local prefetchers = love.audio.getStats().prefetchers
+  for i=1,100 do
+    if prefetchers <= before.prefetchers then break end
+    love.timer.sleep(0.01)
+    prefetchers = love.audio.getStats().prefetchers
+  end
+  test:assertEquals(before.prefetchers, prefetchers, 'check stream prefetcher destroyed')
+end
+
+
+-- love.audio.getStreamReadAhead
+love.test.audio.getStreamReadAhead = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('stream prefetchers need the openal backend')
+  end
+  -- check default value
+  test:assertEquals(2, love.audio.getStreamReadAhead(), 'check default 2')
+  -- check value is clamped
+  love.audio.setStreamReadAhead(1000)
+  test:assertEquals(16, love.audio.getStreamReadAhead(), 'check clamped to 16')
+  love.audio.setStreamReadAhead(2)
+end
+
+
 -- love.audio.getVelocity
 love.test.audio.getVelocity = function(test)
   -- check getting values matches what was set
@@ -361,6 +486,27 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.audio.newQueueableSource = function(test)
   test:assertObject(love.audio.newQueueableSource(32, 8, 1, 8))
+  -- check blocks are handed out until every buffer is queued
+  local queue = love.audio.newQueueableSource(44100, 16, 1, 3, 512)
+  local blocks = {}
+  for i=1,3 do
+    local block = queue:getFreeBlock()
+    blocks[i] = block
+    test:assertObject(block)
+    test:assertEquals(512, block:getSampleCount(), 'check block size')
+    test:assertTrue(queue:queue(block), 'check block queued')
+  end
+  test:assertEquals(nil, queue:getFreeBlock(), 'check no free block')
+  -- clones get their own blocks
+  local clone = queue:clone()
+  local block = clone:getFreeBlock()
+  test:assertObject(block)
+  test:assertEquals(512, block:getSampleCount(), 'check cloned block size')
+  for i=1,3 do
+    test:assertNotEquals(blocks[i], block, 'check cloned block not shared')
+  end
+  clone:release()
+  queue:stop()
 end
 
 
@@ -393,6 +539,13 @@ love.test.audio.play = function(test)
   love.audio.play(source)
   test:assertTrue(source:isPlaying(), 'check something playing')
   love.audio.stop()
+  -- check the software mixer finishes short sources by itself
+  if love.audio.getBackend() == 'soft' then
+    source:play()
+    love.timer.sleep(0.3)
+    test:assertFalse(source:isPlaying(), 'check finished playing')
+    test:assertEquals(0, love.audio.getActiveSourceCount(), 'check retired')
+  end
 end
 
 
@@ -423,6 +576,9 @@ end
 
 -- love.audio.setEffect
 love.test.audio.setEffect = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('effects need the openal backend')
+  end
   -- check effect is set correctly
   local effect = love.audio.setEffect('testeffect', {
     type = 'chorus',
@@ -436,6 +592,26 @@ love.test.audio.setEffect = function(test)
 end
 
 
+-- love.audio.setLoadResamplingEnabled
+love.test.audio.setLoadResamplingEnabled = function(test)
+  -- check default value
+  test:assertTrue(love.audio.isLoadResamplingEnabled(), 'check default enabled')
+  -- check sources load the same audio either way
+  local durations = {}
+  for _, enabled in ipairs({false, true}) do
+    love.audio.setLoadResamplingEnabled(enabled)
+    test:assertEquals(enabled, love.audio.isLoadResamplingEnabled(), 'check set')
+    local source = love.audio.newSource('resources/click.ogg', 'static')
+    table.insert(durations, source:getDuration())
+    source:play()
+    source:stop()
+    source:release()
+  end
+  test:assertRange(durations[2], durations[1] - 0.001, durations[1] + 0.001, 'check same duration')
+  love.audio.setLoadResamplingEnabled(true)
+end
+
+
 -- love.audio.setMixWithSystem
 love.test.audio.setMixWithSystem = function(test)
   test:assertNotNil(love.audio.setMixWithSystem(true))
@@ -458,6 +634,9 @@ end
 
 -- love.audio.setPlaybackDevice
 love.test.audio.setPlaybackDevice = function(test)
+  if love.audio.getBackend() ~= 'openal' then
+    return test:skipTest('playback devices need the openal backend')
+  end
   -- check method
   test:assertNotNil(love.audio.setPlaybackDevice)
 
@@ -505,6 +684,26 @@ love.test.audio.setPosition = function(test)
 end
 
 
+-- love.audio.setStreamReadAhead
+love.test.audio.setStreamReadAhead = function(test)
+  -- check streaming still plays and seeks with read-ahead disabled and enabled
+  for _, chunks in ipairs({0, 4}) do
+    love.audio.setStreamReadAhead(chunks)
+    if love.audio.getBackend() == 'openal' then
+      test:assertEquals(chunks, love.audio.getStreamReadAhead(), 'check set to ' .. chunks)
+    end
+    local source = love.audio.newSource('resources/tone.ogg', 'stream')
+    source:play()
+    test:assertTrue(source:isPlaying(), 'check playing with ' .. chunks)
+    source:seek(0.01)
+    test:assertTrue(source:isPlaying(), 'check seek with ' .. chunks)
+    source:stop()
+    source:release()
+  end
+  love.audio.setStreamReadAhead(2)
+end
+
+
 -- love.audio.setVelocity
 love.test.audio.setVelocity = function(test)
   -- check setting velocity vals are returned
@@ -501,6 +501,67 @@ love.test.filesystem.remove = function(test)
 end
 
 
+-- love.filesystem.setBytecodeCacheEnabled
+-- @NOTE also tests love.filesystem.isBytecodeCacheEnabled
+love.test.filesystem.setBytecodeCacheEnabled = function(test)
+  local original = love.filesystem.isBytecodeCacheEnabled()
+  love.filesystem.setBytecodeCacheEnabled(true)
+  test:assertTrue(love.filesystem.isBytecodeCacheEnabled(), 'check enabled')
+  -- load twice so the second load comes from the cache
+  love.filesystem.write('cached.lua', 'return 1')
+  test:assertEquals(1, love.filesystem.load('cached.lua')(), 'check first load')
+  test:assertEquals(1, love.filesystem.load('cached.lua')(), 'check cached load')
+  local entries = #love.filesystem.getDirectoryItems('bytecodecache')
+  test:assertGreaterEqual(1, entries, 'check entry written')
+  -- changing the source must not hit the stale entry, and replaces it
+  love.filesystem.write('cached.lua', 'return 2')
+  test:assertEquals(2, love.filesystem.load('cached.lua')(), 'check changed source')
+  test:assertEquals(entries, #love.filesystem.getDirectoryItems('bytecodecache'), 'check stale entry removed')
+  love.filesystem.setBytecodeCacheEnabled(false)
+  test:assertFalse(love.filesystem.isBytecodeCacheEnabled(), 'check disabled')
+  test:assertEquals(2, love.filesystem.load('cached.lua')(), 'check uncached load')
+  -- cleanup
+  love.filesystem.setBytecodeCacheEnabled(original)
+  love.filesystem.remove('cached.lua')
+end
+
+
+-- love.filesystem.setSeekCacheEnabled
+-- @NOTE also tests love.filesystem.isSeekCacheEnabled
+love.test.filesystem.setSeekCacheEnabled = function(test)
+  local original = love.filesystem.isSeekCacheEnabled()
+  local function clearEntries()
+    for _, item in ipairs(love.filesystem.getDirectoryItems('seekcache')) do
+      love.filesystem.remove('seekcache/' .. item)
+    end
+  end
+  -- seeking past the start makes the decoder look up its index
+  local function seekFile(path)
+    local decoder = love.sound.newDecoder(path)
+    decoder:seek(0.5)
+    decoder:release()
+  end
+  local contents = love.filesystem.read('resources/tone.ogg')
+  clearEntries()
+  love.filesystem.setSeekCacheEnabled(false)
+  test:assertFalse(love.filesystem.isSeekCacheEnabled(), 'check disabled')
+  -- trailing bytes change the key, so neither file is cached in memory yet
+  love.filesystem.write('seekcache_a.ogg', contents .. 'a')
+  seekFile('seekcache_a.ogg')
+  test:assertEquals(0, #love.filesystem.getDirectoryItems('seekcache'), 'check nothing written when disabled')
+  love.filesystem.setSeekCacheEnabled(true)
+  test:assertTrue(love.filesystem.isSeekCacheEnabled(), 'check enabled')
+  love.filesystem.write('seekcache_b.ogg', contents .. 'b')
+  seekFile('seekcache_b.ogg')
+  test:assertEquals(1, #love.filesystem.getDirectoryItems('seekcache'), 'check index written when enabled')
+  -- cleanup
+  clearEntries()
+  love.filesystem.setSeekCacheEnabled(original)
+  love.filesystem.remove('seekcache_a.ogg')
+  love.filesystem.remove('seekcache_b.ogg')
+end
+
+
 -- love.filesystem.setCRequirePath
 love.test.filesystem.setCRequirePath = function(test)
   -- check setting path val is returned
@@ -0,0 +1,99 @@
+-- love.plugin
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+----------------------------------METHODS---------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- love.plugin.getBufferStats
+love.test.plugin.getBufferStats = function(test)
+  love.plugin.resetBufferStats()
+  local stats = love.plugin.getBufferStats()
+  test:assertEquals(0, stats.underruns, 'check underruns reset')
+  test:assertEquals(0, stats.overruns, 'check overruns reset')
+  test:assertNotNil(stats.underrunframes)
+  test:assertNotNil(stats.overrunframes)
+end
+
+
+-- love.plugin.getDroppedMidiCount
+love.test.plugin.getDroppedMidiCount = function(test)
+  local dropped = love.plugin.getDroppedMidiCount()
+  test:assertGreaterEqual(0, dropped, 'check count')
+  if not love.plugin.isHosted() then
+    test:assertEquals(0, dropped, 'check nothing dropped when standalone')
+  end
+end
+
+
+-- love.plugin.getLatency
+love.test.plugin.getLatency = function(test)
+  local frames, seconds = love.plugin.getLatency()
+  test:assertGreaterEqual(0, frames, 'check frames')
+  test:assertGreaterEqual(0, seconds, 'check seconds')
+  if not love.plugin.isHosted() then
+    test:assertEquals(0, frames, 'check no latency when standalone')
+  elseif love.audio ~= nil and love.audio.getBackend() == 'soft' then
+    test:assertEquals(0, frames, 'check no latency when rendering on demand')
+  end
+end
+
+
+-- love.plugin.getTransport
+love.test.plugin.getTransport = function(test)
+  local transport = love.plugin.getTransport()
+  test:assertNotNil(transport)
+  test:assertEquals('boolean', type(transport.playing), 'check playing flag')
+  test:assertEquals('boolean', type(transport.looping), 'check looping flag')
+  test:assertEquals('boolean', type(transport.recording), 'check recording flag')
+  if not love.plugin.isHosted() then
+    test:assertEquals(false, transport.playing, 'check stopped when standalone')
+    test:assertEquals(nil, transport.bpm, 'check no tempo when standalone')
+    test:assertEquals(nil, transport.beat, 'check no playhead when standalone')
+  end
+end
+
+
+-- love.plugin.isHosted
+love.test.plugin.isHosted = function(test)
+  test:assertEquals('boolean', type(love.plugin.isHosted()), 'check type')
+end
+
+
+-- love.plugin.isVisible
+love.test.plugin.isVisible = function(test)
+  test:assertEquals('boolean', type(love.plugin.isVisible()), 'check type')
+  if not love.plugin.isHosted() then
+    test:assertTrue(love.plugin.isVisible(), 'check visible when standalone')
+  end
+end
+
+
+-- love.plugin.setTargetFPS
+-- @NOTE also tests love.plugin.getTargetFPS
+love.test.plugin.setTargetFPS = function(test)
+  local original = love.plugin.getTargetFPS()
+  love.plugin.setTargetFPS(30)
+  test:assertEquals(30, love.plugin.getTargetFPS(), 'check set')
+  love.plugin.setTargetFPS(-1)
+  test:assertEquals(0, love.plugin.getTargetFPS(), 'check clamped')
+  love.plugin.setTargetFPS(original)
+end
+
+
+-- love.plugin.setTickFrames
+-- @NOTE also tests love.plugin.getTickFrames
+love.test.plugin.setTickFrames = function(test)
+  local original = love.plugin.getTickFrames()
+  love.plugin.setTickFrames(512)
+  test:assertEquals(512, love.plugin.getTickFrames(), 'check set')
+  love.plugin.setTickFrames(-1)
+  test:assertEquals(0, love.plugin.getTickFrames(), 'check clamped')
+  if not love.plugin.isHosted() then
+    test:assertFalse(love.plugin.isOfflineRendering(), 'check realtime when standalone')
+  end
+  love.plugin.setTickFrames(original)
+end
@@ -37,6 +37,21 @@ love.test.sound.Decoder = function(test)
   test:assertRange(clone:getDuration(), 0.06, 0.07, 'check cloned duration')
   test:assertEquals(44100, clone:getSampleRate(), 'check cloned sample rate')
 
+  -- check seeking lands on the same samples as decoding from the start
+  local full = love.sound.newSoundData('resources/tone.ogg')
+  local channels = full:getChannelCount()
+  local seeker = love.sound.newDecoder('resources/tone.ogg')
+  for _, decoded in ipairs({seeker, seeker:clone()}) do
+    local time = decoded:getDuration() / 2
+    decoded:seek(time)
+    local chunk = decoded:decode()
+    local start = math.floor(time * decoded:getSampleRate())
+    for i=0,15 do
+      local expected = full:getSample(start * channels + i)
+      test:assertRange(chunk:getSample(i), expected - 0.001, expected + 0.001, 'check seeked sample ' .. i)
+    end
+  end
+
 end
 
 
@@ -92,6 +107,41 @@ love.test.sound.SoundData = function(test)
   local slice = copy1:slice(0, count)
   test:assertEquals(count, slice:getSampleCount(), 'check slice length')
 
+  -- check bulk sample access matches getSample
+  local channels = copy1:getChannelCount()
+  local floats = copy1:getSamples(10, 4)
+  test:assertEquals(4 * channels * 4, floats:getSize(), 'check bulk size')
+  for i=0,4*channels-1 do
+    test:assertRange(floats:getFloat(i * 4), copy1:getSample(10 * channels + i) - 0.0001,
+      copy1:getSample(10 * channels + i) + 0.0001, 'check bulk sample ' .. i)
+  end
+  local bulk = love.sound.newSoundData(4, 44100, copy1:getBitDepth(), channels)
+  bulk:setSamples(floats)
+  test:assertEquals(copy1:getSample(10 * channels), bulk:getSample(0), 'check bulk round trip')
+
+  -- check gain and mixing
+  local mixed = love.sound.newSoundData(64, 44100, 16, 1)
+  local ones = love.sound.newSoundData(64, 44100, 32, 1)
+  for i=0,63 do ones:setSample(i, 0.5) end
+  ones:mixInto(mixed)
+  ones:mixInto(mixed, 0, 64, 0, 2)
+  test:assertRange(mixed:getSample(3), 0.999, 1, 'check mixed saturates')
+  mixed:applyGain(0.25)
+  test:assertRange(mixed:getSample(3), 0.249, 0.251, 'check gain')
+
+  -- check format conversion
+  local converted = copy1:convert(32, 1)
+  test:assertEquals(32, converted:getBitDepth(), 'check converted bit depth')
+  test:assertEquals(1, converted:getChannelCount(), 'check converted channels')
+  test:assertEquals(copy1:getSampleCount(), converted:getSampleCount(), 'check converted length')
+
+  -- check resampling keeps the duration
+  local resampled = copy1:resample(48000)
+  test:assertEquals(48000, resampled:getSampleRate(), 'check resampled rate')
+  test:assertEquals(copy1:getBitDepth(), resampled:getBitDepth(), 'check resampled bit depth')
+  test:assertEquals(math.ceil(copy1:getSampleCount() * 48000 / copy1:getSampleRate()),
+    resampled:getSampleCount(), 'check resampled length')
+
 end
 
 
@@ -107,6 +157,21 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.sound.newDecoder = function(test)
   test:assertObject(love.sound.newDecoder('resources/click.ogg'))
+  -- check float output
+  local decoder = love.sound.newDecoder('resources/click.ogg', nil, nil, 32)
+  test:assertEquals(32, decoder:getBitDepth(), 'check float bit depth')
+  test:assertEquals(32, decoder:clone():getBitDepth(), 'check cloned float bit depth')
+  local sdata = love.sound.newSoundData(decoder)
+  test:assertEquals(32, sdata:getBitDepth(), 'check float sounddata')
+  test:assertRange(sdata:getSample(0), -1, 1, 'check float sample')
+  -- check resampled decoding
+  local original = love.sound.newSoundData('resources/click.ogg')
+  local resampled = love.sound.newDecoder('resources/click.ogg', nil, nil, nil, 48000)
+  test:assertEquals(48000, resampled:getSampleRate(), 'check resampled rate')
+  test:assertEquals(original:getChannelCount(), resampled:getChannelCount(), 'check resampled channels')
+  sdata = love.sound.newSoundData(resampled)
+  test:assertEquals(math.ceil(original:getSampleCount() * 48000 / original:getSampleRate()),
+    sdata:getSampleCount(), 'check resampled length')
 end
 
 
@@ -115,4 +180,36 @@ end
 love.test.sound.newSoundData = function(test)
   test:assertObject(love.sound.newSoundData('resources/click.ogg'))
   test:assertObject(love.sound.newSoundData(math.floor((1/32)*44100), 44100, 16, 1))
+  -- check float samples are stored as is
+  local sdata = love.sound.newSoundData(64, 44100, 32, 1)
+  sdata:setSample(1, 0.25)
+  test:assertEquals(0.25, sdata:getSample(1), 'check float sample')
+end
+
+
+-- love.sound.newSoundDataAsync
+love.test.sound.newSoundDataAsync = function(test)
+  local batch = love.sound.newSoundDataAsync({
+    'resources/click.ogg', 'resources/tone.ogg', 'resources/pop.ogg'
+  })
+  test:assertObject(batch)
+  test:assertEquals(3, batch:getCount(), 'check item count')
+  test:assertTrue(batch:wait(), 'check batch finished')
+  test:assertTrue(batch:isDone(), 'check batch done')
+  local done, total = batch:getProgress()
+  test:assertEquals(3, done, 'check progress')
+  test:assertEquals(3, total, 'check progress total')
+  -- results match synchronous decoding
+  local sdata = batch:getSoundData(1)
+  test:assertObject(sdata)
+  local expected = love.sound.newSoundData('resources/click.ogg')
+  test:assertEquals(expected:getSampleCount(), sdata:getSampleCount(), 'check sample count')
+  test:assertEquals(expected:getSample(10), sdata:getSample(10), 'check sample')
+  test:assertEquals(3, #batch:getSoundDatas(), 'check all sounddata')
+  -- failures are reported per item
+  local bad = love.sound.newSoundDataAsync(love.data.newByteData('not a sound file'))
+  bad:wait()
+  local none, err = bad:getSoundData(1)
+  test:assertEquals(nil, none, 'check failed item')
+  test:assertNotEquals(nil, err, 'check failed item error')
 end
@@ -76,6 +76,55 @@ love.test.thread.Channel = function(test)
   test:assertEquals('pong', msg4, 'check message recieved 2')
   test:assertEquals(0, channel:getCount())
 
+  -- check batched push and pop
+  local id = channel:pushMany({1, 'two', true})
+  test:assertEquals(3, channel:getCount(), 'check batch pushed')
+  test:assertTrue(not channel:hasRead(id), 'check batch not read')
+  local values = channel:popAll(2)
+  test:assertEquals(2, #values, 'check popAll max')
+  test:assertEquals('two', values[2], 'check popAll order')
+  test:assertEquals(true, channel:popAll()[1], 'check popAll rest')
+  test:assertTrue(channel:hasRead(id), 'check batch read')
+
+  -- check tables keep their contents through a thread
+  local data = love.data.newByteData(4)
+  local tbl = {10, 20, 30, name = 'save', nested = {flag = true, [2.5] = 'x', {1, 2}}, data = data}
+  local echo = love.thread.newThread([[
+    local channel = ...
+    channel:push(channel:demand())
+  ]])
+  echo:start(channel)
+  channel:push(tbl)
+  echo:wait()
+  local copy = channel:pop()
+  test:assertEquals(3, #copy, 'check table array')
+  test:assertEquals(30, copy[3], 'check table array value')
+  test:assertEquals('save', copy.name, 'check table field')
+  test:assertEquals(true, copy.nested.flag, 'check nested table')
+  test:assertEquals('x', copy.nested[2.5], 'check float key')
+  test:assertEquals(2, copy.nested[1][2], 'check nested array')
+  test:assertEquals(data, copy.data, 'check love object')
+
+  -- check lock-free channels with a thread on each side
+  for _, mode in ipairs({'spsc', 'mpmc'}) do
+    local ring = love.thread.newChannel(mode, 16)
+    test:assertEquals(mode, ring:getMode(), 'check ' .. mode .. ' mode')
+    local producer = love.thread.newThread([[
+      local ring = ...
+      for i=1,1000 do ring:push(i) end
+      ring:pushMany({'done'})
+    ]])
+    producer:start(ring)
+    local sum, value = 0, ring:demand(1)
+    while value ~= 'done' and value ~= nil do
+      sum = sum + value
+      value = ring:demand(1)
+    end
+    producer:wait()
+    test:assertEquals(500500, sum, 'check ' .. mode .. ' received everything')
+    test:assertEquals(0, ring:getCount(), 'check ' .. mode .. ' empty')
+  end
+
 end
 
 
@@ -106,6 +155,81 @@ love.test.thread.Thread = function(test)
   badthread:wait()
   test:assertNotNil(badthread:getError())
 
+  -- check a pooled thread runs and reports errors the same way
+  local pooled = love.thread.newThread(threadcode, true)
+  test:assertTrue(pooled:isPooled(), 'check pooled')
+  test:assertFalse(thread:isPooled(), 'check not pooled by default')
+  pooled:start()
+  pooled:wait()
+  test:assertFalse(pooled:isRunning(), 'check pooled finished')
+  test:assertEquals(nil, pooled:getError(), 'check pooled no errors')
+  local badpooled = love.thread.newThread(badthreadcode, true)
+  badpooled:start()
+  badpooled:wait()
+  test:assertNotNil(badpooled:getError())
+
+  -- check a pooled thread can be started again
+  pooled:start()
+  pooled:wait()
+  test:assertEquals(nil, pooled:getError(), 'check pooled restart')
+
+end
+
+
+-- Job (love.thread.runJob)
+love.test.thread.Job = function(test)
+
+  -- check results come back
+  local job = love.thread.runJob('local a, b = ...\nreturn a + b, tostring(a)', 2, 3)
+  test:assertObject(job)
+  test:assertTrue(job:wait(), 'check done')
+  test:assertTrue(job:isDone(), 'check is done')
+  local sum, str = job:getResults()
+  test:assertEquals(5, sum, 'check first result')
+  test:assertEquals('2', str, 'check second result')
+  test:assertEquals(nil, job:getError(), 'check no errors')
+
+  -- check errors are kept
+  local badjob = love.thread.runJob('error("job failed")\n')
+  badjob:wait()
+  test:assertNotNil(badjob:getError())
+  test:assertEquals(0, select('#', badjob:getResults()), 'check no results')
+
+  -- check values which can't cross threads fail the job, not the worker
+  local badresults = {
+    'return io.stdout\n',
+    'local t = {}\nt.t = t\nreturn t\n',
+    'return function() end\n'
+  }
+  for i=1,#badresults do
+    local job = love.thread.runJob(badresults[i])
+    job:wait()
+    test:assertNotNil(job:getError(), 'check bad result ' .. i)
+    test:assertEquals(0, select('#', job:getResults()), 'check no bad results ' .. i)
+  end
+  local after = love.thread.runJob('return 1\n')
+  after:wait()
+  test:assertEquals(1, after:getResults(), 'check workers still run jobs')
+
+  -- check globals don't leak from one job to the next
+  local jobs = {}
+  for i=1,16 do
+    jobs[i] = love.thread.runJob('local i = ...\nlocal seen = leaked\nleaked = i\nreturn seen', i)
+  end
+  for i=1,16 do
+    jobs[i]:wait()
+    test:assertEquals(nil, jobs[i]:getResults(), 'check no leaked global ' .. i)
+  end
+
+  -- check changes to library tables don't leak either
+  for i=1,8 do
+    jobs[i] = love.thread.runJob('local seen = string.leaked or love.thread.leaked\nstring.leaked = true\nlove.thread.leaked = true\nreturn seen')
+  end
+  for i=1,8 do
+    jobs[i]:wait()
+    test:assertEquals(nil, jobs[i]:getResults(), 'check no leaked library field ' .. i)
+  end
+
 end
 
 
@@ -127,6 +251,17 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.thread.newChannel = function(test)
   test:assertObject(love.thread.newChannel())
+  test:assertEquals('locked', love.thread.newChannel():getMode(), 'check default mode')
+  test:assertEquals('mpmc', love.thread.newChannel('mpmc', 100):getMode(), 'check mode')
+end
+
+
+-- love.thread.runJob
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.thread.runJob = function(test)
+  local job = love.thread.runJob('return 1\n')
+  test:assertObject(job)
+  job:wait()
 end
 
 